@@ -0,0 +1,154 @@
+/****************************************************************************
+ * arch/sim/src/up_chksum.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <string.h>
+#include <emmintrin.h>
+
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
+
+#ifdef CONFIG_NET_ARCH_CHKSUM
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Add the one's complement sum of all 16-bit words in a buffer to a
+ *   partial sum using SSE2 instructions.
+ *
+ *   Each 128-bit load is split into the low and the high 16-bit words of
+ *   its four 32-bit lanes, which are added to 32-bit lane accumulators.
+ *   A lane cannot overflow for buffers shorter than 64KiB.  x86 is
+ *   little-endian and permits unaligned accesses, so the words are summed
+ *   in host byte order as they are and the result is byte swapped once at
+ *   the end.
+ *
+ * Input Parameters:
+ *   sum  - The partial sum in host byte order
+ *   data - The buffer to be summed.
+ *   len  - The length of the buffer in bytes
+ *
+ * Returned Value:
+ *   The new partial sum in host byte order (not complemented).
+ *
+ ****************************************************************************/
+
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
+{
+  uint64_t acc = 0;
+  uint16_t result;
+
+  if (len >= 32)
+    {
+      const __m128i mask = _mm_set1_epi32(0xffff);
+      __m128i acc0 = _mm_setzero_si128();
+      __m128i acc1 = _mm_setzero_si128();
+      uint32_t lanes[4];
+
+      do
+        {
+          __m128i v0 = _mm_loadu_si128((FAR const __m128i *)data);
+          __m128i v1 = _mm_loadu_si128((FAR const __m128i *)(data + 16));
+
+          acc0  = _mm_add_epi32(acc0, _mm_and_si128(v0, mask));
+          acc1  = _mm_add_epi32(acc1, _mm_and_si128(v1, mask));
+          acc0  = _mm_add_epi32(acc0, _mm_srli_epi32(v0, 16));
+          acc1  = _mm_add_epi32(acc1, _mm_srli_epi32(v1, 16));
+
+          data += 32;
+          len  -= 32;
+        }
+      while (len >= 32);
+
+      _mm_storeu_si128((FAR __m128i *)lanes, _mm_add_epi32(acc0, acc1));
+      acc = (uint64_t)lanes[0] + lanes[1] + lanes[2] + lanes[3];
+    }
+
+  while (len >= 8)
+    {
+      uint64_t word;
+
+      memcpy(&word, data, 8);
+      acc  += (word & 0xffffffff) + (word >> 32);
+      data += 8;
+      len  -= 8;
+    }
+
+  while (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
+
+  /* A trailing byte is the low order byte of a little-endian word */
+
+  if (len > 0)
+    {
+      acc  += *data;
+    }
+
+  /* Fold the carries back into 16 bits */
+
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  /* Convert the sum to host byte order and add the initial sum */
+
+  result  = ntohs((uint16_t)acc);
+  result += sum;
+  if (result < sum)
+    {
+      result++; /* carry */
+    }
+
+  return result;
+}
+
+#endif /* CONFIG_NET_ARCH_CHKSUM */
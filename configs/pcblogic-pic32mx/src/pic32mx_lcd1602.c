@@ -837,7 +837,7 @@ static int lcd_poll(FAR struct file *filep, FAR struct pollfd *fds,
       fds->revents |= (fds->events & (POLLIN|POLLOUT));
       if (fds->revents != 0)
         {
-          sem_post(fds->sem);
+          poll_notify(fds);
         }
     }
   return OK;
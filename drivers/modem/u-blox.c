@@ -259,7 +259,7 @@ static int ubxmdm_poll(FAR struct file* filep,
       fds->revents |= (fds->events & (POLLIN | POLLOUT));
       if (fds->revents != 0)
         {
-          sem_post(fds->sem);
+          poll_notify(fds);
         }
     }
 
@@ -219,7 +219,7 @@ static void ramlog_pollnotify(FAR struct ramlog_dev_s *priv,
           fds->revents |= (fds->events & eventset);
           if (fds->revents != 0)
             {
-              sem_post(fds->sem);
+              poll_notify(fds);
             }
         }
       leave_critical_section(flags);
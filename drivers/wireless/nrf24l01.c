@@ -61,6 +61,7 @@
 #include <debug.h>
 
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
 
 #ifdef CONFIG_WL_NRF24L01_RXSUPPORT
 #  include <nuttx/wqueue.h>
@@ -600,7 +601,7 @@ static void nrf24l01_worker(FAR void *arg)
           dev->pfd->revents |= POLLIN;  /* Data available for input */
 
           winfo("Wake up polled fd");
-          sem_post(dev->pfd->sem);
+          poll_notify(dev->pfd);
         }
 #endif
     }
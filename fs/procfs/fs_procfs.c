@@ -76,8 +76,11 @@
 
 extern const struct procfs_operations proc_operations;
 extern const struct procfs_operations cpuload_operations;
+extern const struct procfs_operations heap_operations;
 extern const struct procfs_operations kmm_operations;
+extern const struct procfs_operations locks_operations;
 extern const struct procfs_operations module_operations;
+extern const struct procfs_operations pool_operations;
 extern const struct procfs_operations uptime_operations;
 
 /* This is not good.  These are implemented in other sub-systems.  Having to
@@ -124,10 +127,27 @@ static const struct procfs_entry_s g_procfs_entries[] =
   { "kmm",              &kmm_operations },
 #endif
 
+#if defined(CONFIG_MM_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+#ifndef CONFIG_BUILD_KERNEL
+  { "heap",             &heap_operations },
+#endif
+#ifdef CONFIG_MM_KERNEL_HEAP
+  { "kheap",            &heap_operations },
+#endif
+#endif
+
+#if defined(CONFIG_SMP_LOCK_STATS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+  { "locks",            &locks_operations },
+#endif
+
 #if defined(CONFIG_MODULE) && !defined(CONFIG_FS_PROCFS_EXCLUDE_MODULE)
   { "modules",          &module_operations },
 #endif
 
+#if !defined(CONFIG_FS_PROCFS_EXCLUDE_POOLS)
+  { "pools",            &pool_operations },
+#endif
+
 #if defined(CONFIG_FS_SMARTFS) && !defined(CONFIG_FS_PROCFS_EXCLUDE_SMARTFS)
 //{ "fs/smartfs",       &smartfs_procfsoperations },
   { "fs/smartfs**",     &smartfs_procfsoperations },
@@ -0,0 +1,454 @@
+/****************************************************************************
+ * fs/procfs/fs_procfsheap.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/mm.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#ifdef CONFIG_BUILD_PROTECTED
+#  include <nuttx/userspace.h>
+#endif
+
+#if defined(CONFIG_MM_STATS) && defined(CONFIG_FS_PROCFS) && \
+   !defined(CONFIG_FS_PROCFS_EXCLUDE_HEAP)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define HEAP_LINELEN 80
+
+/* In the kernel build, there is no single user heap */
+
+#ifndef CONFIG_BUILD_KERNEL
+#  define HAVE_USER_HEAP 1
+#  ifdef CONFIG_BUILD_PROTECTED
+#    define USER_HEAP (USERSPACE->us_heap)
+#  else
+#    define USER_HEAP (&g_mmheap)
+#  endif
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct heap_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  FAR struct mm_heap_s *heap;     /* The heap being reported */
+  struct mm_stats_s stats;        /* Snapshot of the heap statistics */
+  FAR char *buffer;               /* User buffer (during read) */
+  size_t buflen;                  /* Remaining space in the user buffer */
+  size_t totalsize;               /* Number of bytes returned */
+  off_t offset;                   /* Offset into the virtual file */
+  char line[HEAP_LINELEN];        /* Buffer for formatted lines */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     heap_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     heap_close(FAR struct file *filep);
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     heap_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     heap_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations heap_operations =
+{
+  heap_open,      /* open */
+  heap_close,     /* close */
+  heap_read,      /* read */
+  NULL,           /* write */
+  heap_dup,       /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  heap_stat       /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: heap_select
+ *
+ * Description:
+ *   Map a relpath to the heap that it describes.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_heap_s *heap_select(FAR const char *relpath)
+{
+#ifdef HAVE_USER_HEAP
+  if (strcmp(relpath, "heap") == 0)
+    {
+      return USER_HEAP;
+    }
+#endif
+
+#ifdef CONFIG_MM_KERNEL_HEAP
+  if (strcmp(relpath, "kheap") == 0)
+    {
+      return &g_kmmheap;
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: heap_printf
+ *
+ * Description:
+ *   Format one line and copy it to the user buffer (if it lies beyond the
+ *   file offset).
+ *
+ ****************************************************************************/
+
+static void heap_printf(FAR struct heap_file_s *procfile,
+                        FAR const char *fmt, ...)
+{
+  size_t linesize;
+  size_t copysize;
+  va_list ap;
+
+  if (procfile->buflen > 0)
+    {
+      va_start(ap, fmt);
+      linesize = vsnprintf(procfile->line, HEAP_LINELEN, fmt, ap);
+      va_end(ap);
+
+      if (linesize >= HEAP_LINELEN)
+        {
+          linesize = HEAP_LINELEN - 1;
+        }
+
+      copysize = procfs_memcpy(procfile->line, linesize, procfile->buffer,
+                               procfile->buflen, &procfile->offset);
+
+      procfile->buffer    += copysize;
+      procfile->buflen    -= copysize;
+      procfile->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: heap_open
+ ****************************************************************************/
+
+static int heap_open(FAR struct file *filep, FAR const char *relpath,
+                     int oflags, mode_t mode)
+{
+  FAR struct heap_file_s *procfile;
+  FAR struct mm_heap_s *heap;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  heap = heap_select(relpath);
+  if (heap == NULL)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct heap_file_s *)
+    kmm_zalloc(sizeof(struct heap_file_s));
+
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  procfile->heap = heap;
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_close
+ ****************************************************************************/
+
+static int heap_close(FAR struct file *filep)
+{
+  FAR struct heap_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_read
+ ****************************************************************************/
+
+static ssize_t heap_read(FAR struct file *filep, FAR char *buffer,
+                         size_t buflen)
+{
+  FAR struct heap_file_s *procfile;
+  FAR struct mm_stats_s *stats;
+  int i;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct heap_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Take a new snapshot of the statistics when reading from the beginning
+   * of the file.  All subsequent reads use the same snapshot so that the
+   * output is consistent.
+   */
+
+  stats = &procfile->stats;
+  if (filep->f_pos == 0)
+    {
+      mm_heapstats(procfile->heap, stats);
+    }
+
+  procfile->buffer    = buffer;
+  procfile->buflen    = buflen;
+  procfile->totalsize = 0;
+  procfile->offset    = filep->f_pos;
+
+  /* Totals */
+
+  heap_printf(procfile, "Allocs: %lu Frees: %lu Largest free: %lu\n",
+              (unsigned long)stats->ms_nallocs,
+              (unsigned long)stats->ms_nfrees,
+              (unsigned long)stats->ms_maxfree);
+
+  /* The free and allocated chunks in each size class */
+
+  heap_printf(procfile, "%10s%8s%11s%8s%11s%11s\n",
+              "Size", "Free", "FreeBytes", "Used", "UsedBytes", "Allocs");
+
+  for (i = 0; i < MM_NNODES; i++)
+    {
+      FAR struct mm_classstats_s *cstats = &stats->ms_class[i];
+
+      if (cstats->nfree > 0 || cstats->nused > 0 || cstats->nallocs > 0)
+        {
+          heap_printf(procfile, "%10lu%8lu%11lu%8lu%11lu%11lu\n",
+                      (unsigned long)MM_MIN_CHUNK << i,
+                      (unsigned long)cstats->nfree,
+                      (unsigned long)cstats->freebytes,
+                      (unsigned long)cstats->nused,
+                      (unsigned long)cstats->usedbytes,
+                      (unsigned long)cstats->nallocs);
+        }
+    }
+
+#ifdef CONFIG_MM_STATS_PID
+  /* The memory owned by each task.  Tasks that did not fit in the table are
+   * shown as PID -1.
+   */
+
+  heap_printf(procfile, "%10s%8s%11s\n", "PID", "Used", "UsedBytes");
+
+  for (i = 0; i <= CONFIG_MM_STATS_NPIDS; i++)
+    {
+      FAR struct mm_pidstats_s *pidstats =
+        i < CONFIG_MM_STATS_NPIDS ? &stats->ms_pid[i] : &stats->ms_pidother;
+
+      if (pidstats->nused > 0)
+        {
+          heap_printf(procfile, "%10d%8lu%11lu\n",
+                      (int)pidstats->pid,
+                      (unsigned long)pidstats->nused,
+                      (unsigned long)pidstats->usedbytes);
+        }
+    }
+#endif
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+  /* Sampled allocations that are still in use */
+
+  heap_printf(procfile, "%18s%8s%8s%18s\n",
+              "Sample", "Size", "PID", "Caller");
+
+  for (i = 0; i < CONFIG_MM_STATS_NSAMPLES; i++)
+    {
+      FAR struct mm_sample_s *sample = &stats->ms_sample[i];
+
+      if (sample->mem != NULL)
+        {
+          heap_printf(procfile, "%18p%8lu%8d%18p\n",
+                      sample->mem, (unsigned long)sample->size,
+                      (int)sample->pid, sample->caller);
+        }
+    }
+#endif
+
+  /* Update the file offset */
+
+  filep->f_pos += procfile->totalsize;
+  return procfile->totalsize;
+}
+
+/****************************************************************************
+ * Name: heap_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int heap_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct heap_file_s *oldattr;
+  FAR struct heap_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct heap_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct heap_file_s *)
+    kmm_malloc(sizeof(struct heap_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct heap_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: heap_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int heap_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  if (heap_select(relpath) == NULL)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "heap" and "kheap" are the names for read-only files */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_MM_STATS && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_HEAP */
@@ -0,0 +1,351 @@
+/****************************************************************************
+ * fs/procfs/fs_procfslocks.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <sys/stat.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <fcntl.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/irqlock.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/fs/procfs.h>
+
+#if defined(CONFIG_FS_PROCFS) && defined(CONFIG_SMP_LOCK_STATS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_LOCKS)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+/* Determines the size of an intermediate buffer that must be large enough
+ * to handle the longest line generated by this logic.
+ */
+
+#define LOCKS_LINELEN 80
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* This structure describes one open "file" */
+
+struct locks_file_s
+{
+  struct procfs_file_s base;      /* Base open file structure */
+  unsigned int linesize;          /* Number of valid characters in line[] */
+  char line[LOCKS_LINELEN];       /* Buffer for formatted lines */
+};
+
+/* This structure holds the state of one read operation while traversing the
+ * list of locks.
+ */
+
+struct locks_read_s
+{
+  FAR struct locks_file_s *procfile;
+  FAR char *buffer;               /* User buffer */
+  size_t buflen;                  /* Remaining space in the user buffer */
+  size_t totalsize;               /* Number of bytes returned */
+  off_t offset;                   /* Offset into the virtual file */
+};
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+/* File system methods */
+
+static int     locks_open(FAR struct file *filep, FAR const char *relpath,
+                 int oflags, mode_t mode);
+static int     locks_close(FAR struct file *filep);
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer,
+                 size_t buflen);
+static int     locks_dup(FAR const struct file *oldp,
+                 FAR struct file *newp);
+static int     locks_stat(FAR const char *relpath, FAR struct stat *buf);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* See fs_mount.c -- this structure is explicitly externed there.
+ * We use the old-fashioned kind of initializers so that this will compile
+ * with any compiler.
+ */
+
+const struct procfs_operations locks_operations =
+{
+  locks_open,     /* open */
+  locks_close,    /* close */
+  locks_read,     /* read */
+  NULL,           /* write */
+  locks_dup,      /* dup */
+  NULL,           /* opendir */
+  NULL,           /* closedir */
+  NULL,           /* readdir */
+  NULL,           /* rewinddir */
+  locks_stat      /* stat */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: locks_copyline
+ ****************************************************************************/
+
+static void locks_copyline(FAR struct locks_read_s *info, size_t linesize)
+{
+  size_t copysize;
+
+  if (info->buflen > 0)
+    {
+      copysize = procfs_memcpy(info->procfile->line, linesize, info->buffer,
+                               info->buflen, &info->offset);
+
+      info->buffer    += copysize;
+      info->buflen    -= copysize;
+      info->totalsize += copysize;
+    }
+}
+
+/****************************************************************************
+ * Name: locks_readone
+ ****************************************************************************/
+
+static void locks_readone(FAR struct irqlock_s *lock, FAR void *arg)
+{
+  FAR struct locks_read_s *info = (FAR struct locks_read_s *)arg;
+  size_t linesize;
+
+  linesize = snprintf(info->procfile->line, LOCKS_LINELEN,
+                      "%-12s%6u%11lu%11lu%11lu\n",
+                      lock->name, lock->level,
+                      (unsigned long)lock->nacquired,
+                      (unsigned long)lock->ncontended,
+                      (unsigned long)lock->nspins);
+
+  locks_copyline(info, linesize);
+}
+
+/****************************************************************************
+ * Name: locks_open
+ ****************************************************************************/
+
+static int locks_open(FAR struct file *filep, FAR const char *relpath,
+                      int oflags, mode_t mode)
+{
+  FAR struct locks_file_s *procfile;
+
+  finfo("Open '%s'\n", relpath);
+
+  /* PROCFS is read-only.  Any attempt to open with any kind of write
+   * access is not permitted.
+   */
+
+  if ((oflags & O_WRONLY) != 0 || (oflags & O_RDONLY) == 0)
+    {
+      ferr("ERROR: Only O_RDONLY supported\n");
+      return -EACCES;
+    }
+
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* Allocate a container to hold the file attributes */
+
+  procfile = (FAR struct locks_file_s *)
+    kmm_zalloc(sizeof(struct locks_file_s));
+
+  if (!procfile)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* Save the attributes as the open-specific state in filep->f_priv */
+
+  filep->f_priv = (FAR void *)procfile;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_close
+ ****************************************************************************/
+
+static int locks_close(FAR struct file *filep)
+{
+  FAR struct locks_file_s *procfile;
+
+  /* Recover our private data from the struct file instance */
+
+  procfile = (FAR struct locks_file_s *)filep->f_priv;
+  DEBUGASSERT(procfile);
+
+  /* Release the file attributes structure */
+
+  kmm_free(procfile);
+  filep->f_priv = NULL;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_read
+ ****************************************************************************/
+
+static ssize_t locks_read(FAR struct file *filep, FAR char *buffer,
+                          size_t buflen)
+{
+  struct locks_read_s info;
+  size_t linesize;
+
+  finfo("buffer=%p buflen=%d\n", buffer, (int)buflen);
+
+  DEBUGASSERT(filep != NULL && buffer != NULL && buflen > 0);
+
+  /* Recover our private data from the struct file instance */
+
+  info.procfile  = (FAR struct locks_file_s *)filep->f_priv;
+  info.buffer    = buffer;
+  info.buflen    = buflen;
+  info.totalsize = 0;
+  info.offset    = filep->f_pos;
+  DEBUGASSERT(info.procfile);
+
+  /* The first line is the headers */
+
+  linesize = snprintf(info.procfile->line, LOCKS_LINELEN,
+                      "%-12s%6s%11s%11s%11s\n",
+                      "Lock", "Level", "Acquired", "Contended", "Spins");
+
+  locks_copyline(&info, linesize);
+
+  /* Followed by one line for each registered lock */
+
+  irqlock_foreach(locks_readone, &info);
+
+  /* Update the file offset */
+
+  filep->f_pos += info.totalsize;
+  return info.totalsize;
+}
+
+/****************************************************************************
+ * Name: locks_dup
+ *
+ * Description:
+ *   Duplicate open file data in the new file structure.
+ *
+ ****************************************************************************/
+
+static int locks_dup(FAR const struct file *oldp, FAR struct file *newp)
+{
+  FAR struct locks_file_s *oldattr;
+  FAR struct locks_file_s *newattr;
+
+  finfo("Dup %p->%p\n", oldp, newp);
+
+  /* Recover our private data from the old struct file instance */
+
+  oldattr = (FAR struct locks_file_s *)oldp->f_priv;
+  DEBUGASSERT(oldattr);
+
+  /* Allocate a new container to hold the task and attribute selection */
+
+  newattr = (FAR struct locks_file_s *)
+    kmm_malloc(sizeof(struct locks_file_s));
+
+  if (!newattr)
+    {
+      ferr("ERROR: Failed to allocate file attributes\n");
+      return -ENOMEM;
+    }
+
+  /* The copy the file attributes from the old attributes to the new */
+
+  memcpy(newattr, oldattr, sizeof(struct locks_file_s));
+
+  /* Save the new attributes in the new file structure */
+
+  newp->f_priv = (FAR void *)newattr;
+  return OK;
+}
+
+/****************************************************************************
+ * Name: locks_stat
+ *
+ * Description: Return information about a file or directory
+ *
+ ****************************************************************************/
+
+static int locks_stat(FAR const char *relpath, FAR struct stat *buf)
+{
+  /* "locks" is the only acceptable value for the relpath */
+
+  if (strcmp(relpath, "locks") != 0)
+    {
+      ferr("ERROR: relpath is '%s'\n", relpath);
+      return -ENOENT;
+    }
+
+  /* "locks" is the name for a read-only file */
+
+  memset(buf, 0, sizeof(struct stat));
+  buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+  return OK;
+}
+
+#endif /* CONFIG_FS_PROCFS && CONFIG_SMP_LOCK_STATS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_LOCKS */
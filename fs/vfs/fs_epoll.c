@@ -42,15 +42,384 @@
 #include <sys/epoll.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <poll.h>
+#include <semaphore.h>
+#include <queue.h>
+#include <assert.h>
 #include <errno.h>
-#include <string.h>
 #include <debug.h>
 
+#include <nuttx/irq.h>
+#include <nuttx/clock.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
 #include <nuttx/kmalloc.h>
+#include <nuttx/fs/fs.h>
+#include <nuttx/net/net.h>
 
 #ifndef CONFIG_DISABLE_POLL
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* These events are always reported, whether requested or not */
+
+#define EPOLL_ALWAYS  (POLLERR | POLLHUP)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One registered file or socket descriptor.  Each holds a poll structure
+ * that remains set up in the driver for as long as the descriptor is
+ * registered and armed.  The driver's notification callback places the
+ * item in the ready list of the epoll instance.
+ */
+
+struct epoll_item_s
+{
+  dq_entry_t node;                 /* Ready list link (must be first) */
+  FAR struct epoll_item_s *flink;  /* Registered list link */
+  FAR struct epoll_head_s *eph;    /* The epoll instance */
+  int fd;                          /* The registered descriptor */
+  struct epoll_event ev;           /* Requested events and user data */
+  struct pollfd pfd;               /* The persistent poll setup */
+  bool queued;                     /* In the ready or re-arm list */
+  bool armed;                      /* The poll is set up in the driver */
+};
+
+/* An epoll instance */
+
+struct epoll_head_s
+{
+  sem_t exclsem;                   /* Serializes epoll_ctl/epoll_wait */
+  sem_t waitsem;                   /* Posted on each poll notification */
+  FAR struct epoll_item_s *items;  /* All registered descriptors */
+  dq_queue_t ready;                /* Descriptors with pending events */
+  uint16_t nnotify;                /* Un-consumed posts from the callback */
+  bool rescan;                     /* A driver posted without the callback */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: epoll_semtake
+ ****************************************************************************/
+
+static void epoll_semtake(FAR struct epoll_head_s *eph)
+{
+  while (sem_wait(&eph->exclsem) != 0)
+    {
+      /* The only case that an error should occur here is if the wait were
+       * awakened by a signal.
+       */
+
+      DEBUGASSERT(get_errno() == EINTR);
+    }
+}
+
+#define epoll_semgive(eph) sem_post(&(eph)->exclsem)
+
+/****************************************************************************
+ * Name: epoll_fdsetup
+ *
+ * Description:
+ *   Set up or tear down the poll on a file or socket descriptor.
+ *
+ ****************************************************************************/
+
+static int epoll_fdsetup(int fd, FAR struct pollfd *fds, bool setup)
+{
+#if defined(CONFIG_NET) && CONFIG_NSOCKET_DESCRIPTORS > 0
+  if ((unsigned int)fd >= CONFIG_NFILE_DESCRIPTORS)
+    {
+      return net_poll(fd, fds, setup);
+    }
+#endif
+
+  return fdesc_poll(fd, fds, setup);
+}
+
+/****************************************************************************
+ * Name: epoll_callback
+ *
+ * Description:
+ *   The poll notification callback.  Called by the driver (via
+ *   poll_notify()) after it has set bits in the revents field, possibly
+ *   from an interrupt handler.  The cost is constant:  The item is appended
+ *   to the ready list, if it is not already there, and the waiter is woken.
+ *   An item that is already in the ready list will be collected by the
+ *   waiter anyway, so the waiter is woken only when the item is queued.
+ *
+ ****************************************************************************/
+
+static void epoll_callback(FAR struct pollfd *fds)
+{
+  FAR struct epoll_item_s *item = (FAR struct epoll_item_s *)fds->arg;
+  FAR struct epoll_head_s *eph = item->eph;
+  irqstate_t flags;
+  bool wakeup = false;
+
+  flags = enter_critical_section();
+  if (!item->queued)
+    {
+      dq_addlast(&item->node, &eph->ready);
+      item->queued = true;
+      eph->nnotify++;
+      wakeup = true;
+    }
+
+  leave_critical_section(flags);
+
+  if (wakeup)
+    {
+      sem_post(&eph->waitsem);
+    }
+}
+
+/****************************************************************************
+ * Name: epoll_arm
+ *
+ * Description:
+ *   Set up the persistent poll for one registered descriptor.  If the
+ *   descriptor is already ready, the driver reports that immediately and
+ *   the item is placed in the ready list.
+ *
+ ****************************************************************************/
+
+static int epoll_arm(FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_head_s *eph = item->eph;
+  int ret;
+
+  item->pfd.fd      = item->fd;
+  item->pfd.sem     = &eph->waitsem;
+  item->pfd.events  = (pollevent_t)item->ev.events | EPOLL_ALWAYS;
+  item->pfd.revents = 0;
+  item->pfd.priv    = NULL;
+  item->pfd.cb      = epoll_callback;
+  item->pfd.arg     = item;
+
+  ret = epoll_fdsetup(item->pfd.fd, &item->pfd, true);
+  item->armed = (ret >= 0);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: epoll_disarm
+ *
+ * Description:
+ *   Tear down the persistent poll for one registered descriptor and remove
+ *   it from the ready list.
+ *
+ ****************************************************************************/
+
+static void epoll_disarm(FAR struct epoll_item_s *item)
+{
+  irqstate_t flags;
+
+  if (item->armed)
+    {
+      (void)epoll_fdsetup(item->pfd.fd, &item->pfd, false);
+      item->armed = false;
+    }
+
+  flags = enter_critical_section();
+  if (item->queued)
+    {
+      dq_rem(&item->node, &item->eph->ready);
+      item->queued = false;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_account
+ *
+ * Description:
+ *   Account for one post of the wait semaphore.  Posts that were not made
+ *   by epoll_callback() come from drivers that do not use poll_notify().
+ *   Those drivers have set revents but have not queued the item, so the
+ *   registered list must be scanned once for them.
+ *
+ ****************************************************************************/
+
+static void epoll_account(FAR struct epoll_head_s *eph)
+{
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  if (eph->nnotify > 0)
+    {
+      eph->nnotify--;
+    }
+  else
+    {
+      eph->rescan = true;
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_rescan
+ *
+ * Description:
+ *   Queue every armed item that has pending events but is not queued.
+ *   This is the fallback for drivers that post the semaphore directly.
+ *
+ ****************************************************************************/
+
+static void epoll_rescan(FAR struct epoll_head_s *eph)
+{
+  FAR struct epoll_item_s *item;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  eph->rescan = false;
+
+  for (item = eph->items; item != NULL; item = item->flink)
+    {
+      if (item->armed && !item->queued &&
+          (item->pfd.revents & item->pfd.events) != 0)
+        {
+          dq_addlast(&item->node, &eph->ready);
+          item->queued = true;
+        }
+    }
+
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: epoll_harvest
+ *
+ * Description:
+ *   Move up to maxevents ready descriptors from the ready list into the
+ *   caller's event array.  The cost is proportional to the number of ready
+ *   descriptors.
+ *
+ *   Edge-triggered items are simply removed from the ready list; they are
+ *   queued again by the next notification from the driver.  Level-
+ *   triggered items are re-armed once all events have been collected so
+ *   that the driver re-evaluates the current state:  If the descriptor is
+ *   still ready, it is queued again at once.  One-shot items are disarmed.
+ *
+ ****************************************************************************/
+
+static int epoll_harvest(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_event *evs, int maxevents)
+{
+  FAR struct epoll_item_s *item;
+  dq_queue_t rearm;
+  irqstate_t flags;
+  pollevent_t revents;
+  int nevents = 0;
+
+  dq_init(&rearm);
+
+  while (nevents < maxevents)
+    {
+      /* Remove the next item from the ready list and collect its events */
+
+      flags = enter_critical_section();
+      item  = (FAR struct epoll_item_s *)dq_remfirst(&eph->ready);
+      if (item == NULL)
+        {
+          leave_critical_section(flags);
+          break;
+        }
+
+      revents = item->pfd.revents & item->pfd.events;
+      item->pfd.revents = 0;
+
+      if (revents != 0 &&
+          ((item->ev.events & EPOLLET) == 0 ||
+           (item->ev.events & EPOLLONESHOT) != 0))
+        {
+          /* Level-triggered or one-shot.  The item stays marked as queued
+           * so that the callback leaves it alone until it is re-armed.
+           */
+
+          dq_addlast(&item->node, &rearm);
+        }
+      else
+        {
+          item->queued = false;
+        }
+
+      leave_critical_section(flags);
+
+      if (revents != 0)
+        {
+          evs[nevents].events = revents;
+          evs[nevents].data   = item->ev.data;
+          nevents++;
+        }
+    }
+
+  /* Re-arm the level-triggered items; disarm the one-shot items */
+
+  while ((item = (FAR struct epoll_item_s *)dq_remfirst(&rearm)) != NULL)
+    {
+      item->queued = false;
+
+      (void)epoll_fdsetup(item->pfd.fd, &item->pfd, false);
+      item->armed = false;
+
+      if ((item->ev.events & EPOLLONESHOT) == 0)
+        {
+          (void)epoll_arm(item);
+        }
+    }
+
+  return nevents;
+}
+
+/****************************************************************************
+ * Name: epoll_find
+ ****************************************************************************/
+
+static FAR struct epoll_item_s *epoll_find(FAR struct epoll_head_s *eph,
+                                           int fd)
+{
+  FAR struct epoll_item_s *item;
+
+  for (item = eph->items; item != NULL; item = item->flink)
+    {
+      if (item->fd == fd)
+        {
+          break;
+        }
+    }
+
+  return item;
+}
+
+/****************************************************************************
+ * Name: epoll_unlink
+ ****************************************************************************/
+
+static void epoll_unlink(FAR struct epoll_head_s *eph,
+                         FAR struct epoll_item_s *item)
+{
+  FAR struct epoll_item_s **pprev;
+
+  for (pprev = &eph->items; *pprev != NULL; pprev = &(*pprev)->flink)
+    {
+      if (*pprev == item)
+        {
+          *pprev = item->flink;
+          break;
+        }
+    }
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -59,24 +428,47 @@
  * Name: epoll_create
  *
  * Description:
+ *   Create an epoll instance.
  *
  * Input Parameters:
+ *   size - Ignored, but must be greater than zero.
  *
  * Returned Value:
+ *   A handle for the epoll instance.  On failure, -1 is returned and errno
+ *   is set appropriately.
  *
  ****************************************************************************/
 
 int epoll_create(int size)
 {
-  FAR struct epoll_head *eph =
-    (FAR struct epoll_head *)kmm_malloc(sizeof(struct epoll_head));
+  FAR struct epoll_head_s *eph;
+
+  if (size <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  eph = (FAR struct epoll_head_s *)kmm_zalloc(sizeof(struct epoll_head_s));
+  if (eph == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
 
-  eph->size = size;
-  eph->occupied = 0;
-  eph->evs = kmm_malloc(sizeof(struct epoll_event) * eph->size);
+  sem_init(&eph->exclsem, 0, 1);
+
+  /* The wait semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  sem_init(&eph->waitsem, 0, 0);
+  sem_setprotocol(&eph->waitsem, SEM_PRIO_NONE);
+
+  dq_init(&eph->ready);
 
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
   return (int)((intptr_t)eph);
@@ -86,22 +478,37 @@ int epoll_create(int size)
  * Name: epoll_close
  *
  * Description:
+ *   Tear down all registrations and free an epoll instance.
  *
  * Input Parameters:
+ *   epfd - The handle returned by epoll_create()
  *
  * Returned Value:
+ *   None
  *
  ****************************************************************************/
 
 void epoll_close(int epfd)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  FAR struct epoll_item_s *item;
+
+  epoll_semtake(eph);
+  while ((item = eph->items) != NULL)
+    {
+      eph->items = item->flink;
+      epoll_disarm(item);
+      kmm_free(item);
+    }
+
+  epoll_semgive(eph);
 
-  kmm_free(eph->evs);
+  sem_destroy(&eph->waitsem);
+  sem_destroy(&eph->exclsem);
   kmm_free(eph);
 }
 
@@ -109,84 +516,153 @@ void epoll_close(int epfd)
  * Name: epoll_ctl
  *
  * Description:
+ *   Add, modify or remove the registration of a file or socket descriptor.
+ *   The poll on the descriptor is set up here and remains set up until the
+ *   descriptor is removed.  A descriptor must be removed before it is
+ *   closed.
  *
  * Input Parameters:
+ *   epfd - The handle returned by epoll_create()
+ *   op   - EPOLL_CTL_ADD, EPOLL_CTL_MOD, or EPOLL_CTL_DEL
+ *   fd   - The file or socket descriptor
+ *   ev   - The events of interest (EPOLLIN, EPOLLOUT, ...), possibly with
+ *          EPOLLET or EPOLLONESHOT, and the user data to report with them.
+ *          Ignored for EPOLL_CTL_DEL.
  *
  * Returned Value:
+ *   Zero (OK) on success.  On failure, -1 is returned and errno is set
+ *   appropriately:
+ *
+ *   EEXIST - op is EPOLL_CTL_ADD and fd is already registered.
+ *   ENOENT - op is EPOLL_CTL_MOD or EPOLL_CTL_DEL and fd is not registered.
+ *   EINVAL - op is not supported.
+ *   ENOMEM - There was no memory for the registration.
+ *
+ *   Other errors may be reported by the poll method of the driver.
  *
  ****************************************************************************/
 
-int epoll_ctl(int epfd, int op, int fd, struct epoll_event *ev)
+int epoll_ctl(int epfd, int op, int fd, FAR struct epoll_event *ev)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  FAR struct epoll_item_s *item;
+  int ret;
+
+  DEBUGASSERT(op == EPOLL_CTL_DEL || ev != NULL);
+
+  epoll_semtake(eph);
+  item = epoll_find(eph, fd);
 
   switch (op)
     {
       case EPOLL_CTL_ADD:
-        finfo("%08x CTL ADD(%d): fd=%d ev=%08x\n",
-              epfd, eph->occupied, fd, ev->events);
-
-        eph->evs[eph->occupied].events = ev->events | POLLERR | POLLHUP;
-        eph->evs[eph->occupied++].data.fd = fd;
-        return 0;
+        finfo("%08x CTL ADD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (item != NULL)
+          {
+            ret = -EEXIST;
+            break;
+          }
+
+        item = (FAR struct epoll_item_s *)
+          kmm_zalloc(sizeof(struct epoll_item_s));
+        if (item == NULL)
+          {
+            ret = -ENOMEM;
+            break;
+          }
+
+        item->eph       = eph;
+        item->fd        = fd;
+        item->ev.events = ev->events;
+        item->ev.data   = ev->data;
+
+        ret = epoll_arm(item);
+        if (ret < 0)
+          {
+            kmm_free(item);
+            break;
+          }
+
+        item->flink = eph->items;
+        eph->items  = item;
+        break;
 
       case EPOLL_CTL_DEL:
-        {
-          int i;
+        finfo("%08x CTL DEL: fd=%d\n", epfd, fd);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  if (i != eph->occupied-1)
-                    {
-                      memmove(&eph->evs[i], &eph->evs[i + 1],
-                              eph->occupied - i);
-                    }
-
-                  eph->occupied--;
-                  return 0;
-                }
-            }
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
 
-          return -ENOENT;
-        }
+        epoll_disarm(item);
+        epoll_unlink(eph, item);
+        kmm_free(item);
+        ret = OK;
+        break;
 
       case EPOLL_CTL_MOD:
-        {
-          int i;
+        finfo("%08x CTL MOD: fd=%d ev=%08x\n", epfd, fd, ev->events);
+
+        if (item == NULL)
+          {
+            ret = -ENOENT;
+            break;
+          }
+
+        /* Re-arm with the new event set.  This also re-enables a one-shot
+         * descriptor.
+         */
+
+        epoll_disarm(item);
+        item->ev.events = ev->events;
+        item->ev.data   = ev->data;
+        ret = epoll_arm(item);
+        break;
+
+      default:
+        ret = -EINVAL;
+        break;
+    }
 
-          finfo("%08x CTL MOD(%d): fd=%d ev=%08x\n",
-                epfd, eph->occupied, fd, ev->events);
+  epoll_semgive(eph);
 
-          for (i = 0; i < eph->occupied; i++)
-            {
-              if (eph->evs[i].data.fd == fd)
-                {
-                  eph->evs[i].events = ev->events | POLLERR | POLLHUP;
-                  return 0;
-                }
-            }
-
-          return -ENOENT;
-        }
+  if (ret < 0)
+    {
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return -EINVAL;
+  return OK;
 }
 
 /****************************************************************************
  * Name: epoll_wait
  *
  * Description:
+ *   Wait for events on the registered descriptors.  Only the descriptors
+ *   in the ready list are examined, so the cost does not depend on the
+ *   number of registered descriptors.
  *
  * Input Parameters:
+ *   epfd      - The handle returned by epoll_create()
+ *   evs       - The array that receives the events
+ *   maxevents - The size of the evs array
+ *   timeout   - The maximum wait in milliseconds.  Zero means do not wait;
+ *               a negative value means wait forever.
  *
  * Returned Value:
+ *   The number of events returned in evs, zero in the event of a timeout.
+ *   On failure, -1 is returned and errno is set appropriately:
+ *
+ *   EINVAL - maxevents is not greater than zero.
+ *   EINTR  - A signal occurred before any event.
  *
  ****************************************************************************/
 
@@ -194,38 +670,85 @@ int epoll_wait(int epfd, FAR struct epoll_event *evs, int maxevents,
                int timeout)
 {
   /* REVISIT: This will not work on machines where:
-   * sizeof(struct epoll_head *) > sizeof(int)
+   * sizeof(struct epoll_head_s *) > sizeof(int)
    */
 
-  FAR struct epoll_head *eph = (FAR struct epoll_head *)((intptr_t)epfd);
-  int rc;
-  int i;
+  FAR struct epoll_head_s *eph = (FAR struct epoll_head_s *)((intptr_t)epfd);
+  systime_t start = clock_systimer();
+  int ret;
+
+  if (maxevents <= 0)
+    {
+      set_errno(EINVAL);
+      return ERROR;
+    }
+
+  /* epoll_wait() is a cancellation point */
 
-  rc = poll((FAR struct pollfd *)eph->evs, eph->occupied, timeout);
+  (void)enter_cancellation_point();
 
-  if (rc <= 0)
+  for (; ; )
     {
-      if (rc < 0)
+      /* Consume the posts of the wait semaphore that are already pending.
+       * Without this, a level-triggered descriptor that is always ready
+       * could hide the events of drivers that do not use poll_notify().
+       */
+
+      while (sem_trywait(&eph->waitsem) == OK)
         {
-          ferr("ERROR: %08x poll fail: %d for %d, %d msecs\n",
-               epfd, rc, eph->occupied, timeout);
+          epoll_account(eph);
+        }
+
+      epoll_semtake(eph);
+      if (eph->rescan)
+        {
+          epoll_rescan(eph);
+        }
+
+      ret = epoll_harvest(eph, evs, maxevents);
+      epoll_semgive(eph);
 
-          for (i = 0; i < eph->occupied; i++)
+      if (ret > 0 || timeout == 0)
+        {
+          break;
+        }
+
+      /* Nothing is ready.  Wait for the next notification. */
+
+      if (timeout > 0)
+        {
+          ret = sem_tickwait(&eph->waitsem, start, MSEC2TICK(timeout));
+        }
+      else
+        {
+          ret = sem_wait(&eph->waitsem) < 0 ? -get_errno() : OK;
+        }
+
+      if (ret < 0)
+        {
+          /* Return zero (OK) in the event of a timeout */
+
+          if (ret == -ETIMEDOUT)
             {
-              ferr("  %02d: fd=%d\n", i, eph->evs[i].data.fd);
+              ret = OK;
             }
+
+          break;
         }
 
-      return rc;
+      epoll_account(eph);
     }
 
-  for (i = 0; i < rc; i++)
+  leave_cancellation_point();
+
+  if (ret < 0)
     {
-      evs[i].data.fd = (pollevent_t)eph->evs[i].data.fd;
-      evs[i].events = (pollevent_t)eph->evs[i].revents;
+      ferr("ERROR: %08x wait failed: %d\n", epfd, ret);
+      set_errno(-ret);
+      return ERROR;
     }
 
-  return rc;
+  return ret;
 }
 
 #endif /* CONFIG_DISABLE_POLL */
@@ -150,6 +150,7 @@ static inline int poll_setup(FAR struct pollfd *fds, nfds_t nfds, sem_t *sem)
       fds[i].sem     = sem;
       fds[i].revents = 0;
       fds[i].priv    = NULL;
+      fds[i].cb      = NULL;
 
       /* Check for invalid descriptors. "If the value of fd is less than 0,
        * events shall be ignored, and revents shall be set to 0 in that entry
@@ -328,6 +329,36 @@ int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup)
 }
 #endif
 
+/****************************************************************************
+ * Function: poll_notify
+ *
+ * Description:
+ *   Called by drivers after they have set bits in fds->revents in order to
+ *   wake up the waiter.  Normally that just posts the poll semaphore.  If
+ *   the poll structure was set up with a callback (as by epoll), the
+ *   callback is called instead.  This may be called from an interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds)
+{
+  if (fds->cb != NULL)
+    {
+      fds->cb(fds);
+    }
+  else
+    {
+      poll_semgive(fds->sem);
+    }
+}
+
 /****************************************************************************
  * Name: poll
  *
@@ -117,7 +117,7 @@ ssize_t sendfile(int outfd, int infd, off_t *offset, size_t count)
        * structure.
        */
 
-      filep = fs_getfilep(fd);
+      filep = fs_getfilep(infd);
       if (!filep)
         {
           /* The errno value has already been set */
@@ -2262,6 +2262,32 @@ int arch_phy_irq(FAR const char *intf, xcpt_t handler, void *arg,
                  phy_enable_t *enable);
 #endif
 
+/****************************************************************************
+ * Name: up_chksum
+ *
+ * Description:
+ *   Add the one's complement sum of all 16-bit words in a buffer to a
+ *   partial sum.  This is the core of all of the Internet checksums
+ *   computed by the network.  If the buffer length is odd, the last byte is
+ *   padded with a zero byte.  The buffer may have any alignment.
+ *
+ *   This is provided by architecture-specific logic (possibly using SIMD
+ *   instructions) only if CONFIG_NET_ARCH_CHKSUM is selected.
+ *
+ * Input Parameters:
+ *   sum  - The partial sum in host byte order
+ *   data - The buffer to be summed.
+ *   len  - The length of the buffer in bytes
+ *
+ * Returned Value:
+ *   The new partial sum in host byte order (not complemented).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_ARCH_CHKSUM
+uint16_t up_chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len);
+#endif
+
 /****************************************************************************
  * Debug interfaces exported by the architecture-specific logic
  ****************************************************************************/
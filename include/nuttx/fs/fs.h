@@ -1019,6 +1019,26 @@ int file_poll(FAR struct file *filep, FAR struct pollfd *fds, bool setup);
 int fdesc_poll(int fd, FAR struct pollfd *fds, bool setup);
 #endif
 
+/****************************************************************************
+ * Function: poll_notify
+ *
+ * Description:
+ *   Called by drivers after they have set bits in fds->revents in order to
+ *   wake up the waiter.  Normally that just posts the poll semaphore.  If
+ *   the poll structure was set up with a callback (as by epoll), the
+ *   callback is called instead.  This may be called from an interrupt
+ *   handler.
+ *
+ * Input Parameters:
+ *   fds   - The structure describing the events to be monitored
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void poll_notify(FAR struct pollfd *fds);
+
 #undef EXTERN
 #if defined(__cplusplus)
 }
@@ -0,0 +1,221 @@
+/****************************************************************************
+ * include/nuttx/irqlock.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_IRQLOCK_H
+#define __INCLUDE_NUTTX_IRQLOCK_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/spinlock.h>
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Lock ordering levels.  A CPU may only acquire a subsystem lock whose
+ * level is greater than the level of every other subsystem lock that it
+ * already holds.  The global critical section is the outermost lock of
+ * all:  It may be entered before any subsystem lock is taken, but never
+ * while one is held.
+ *
+ * Not all of these subsystems use their own lock yet;  those that do not
+ * still rely on enter_critical_section().
+ */
+
+#define IRQLOCK_LEVEL_DEVICE    1  /* Per-device driver locks */
+#define IRQLOCK_LEVEL_SEM       2  /* Semaphores */
+#define IRQLOCK_LEVEL_SCHED     3  /* Scheduler task lists */
+#define IRQLOCK_LEVEL_WDOG      4  /* Watchdog timer queue */
+
+#define IRQLOCK_NLEVELS         32
+
+/* Statically initialize a subsystem lock */
+
+#if defined(CONFIG_SMP_LOCK_STATS)
+#  define IRQLOCK_INITIALIZER(n,l) \
+     { SP_UNLOCKED, (uint8_t)-1, (l), 0, NULL, (n), 0, 0, 0 }
+#elif defined(CONFIG_SMP_FINE_LOCKS)
+#  define IRQLOCK_INITIALIZER(n,l) { SP_UNLOCKED, (uint8_t)-1, (l), 0 }
+#else
+#  define IRQLOCK_INITIALIZER(n,l) { 0 }
+#endif
+
+/* Without CONFIG_SMP_FINE_LOCKS, a subsystem lock is simply an alias for
+ * the global critical section.  This is always the case in the single CPU
+ * case where disabling interrupts is sufficient.
+ */
+
+#ifndef CONFIG_SMP_FINE_LOCKS
+#  define irqlock_enter(l)      enter_critical_section()
+#  define irqlock_leave(l,f)    leave_critical_section(f)
+#  define irqlock_register(l)
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* This structure describes one subsystem lock.  The lock is re-entrant on
+ * the CPU that holds it:  Nested calls to irqlock_enter() from the same CPU
+ * do not block.
+ *
+ * The holder of a subsystem lock must not do anything that may cause a
+ * context switch or that may pause another CPU (up_cpu_pause()).  Other
+ * CPUs spin for the lock with their interrupts disabled and could not
+ * respond.
+ */
+
+struct irqlock_s
+{
+#ifdef CONFIG_SMP_FINE_LOCKS
+  volatile spinlock_t lock;       /* The spinlock itself */
+  volatile uint8_t cpu;           /* CPU holding the lock */
+  uint8_t level;                  /* Lock ordering level */
+  uint16_t count;                 /* Nested acquisitions by that CPU */
+#ifdef CONFIG_SMP_LOCK_STATS
+  FAR struct irqlock_s *flink;    /* Supports a list of registered locks */
+  FAR const char *name;           /* Name shown at /proc/locks */
+  uint32_t nacquired;             /* Number of (non-nested) acquisitions */
+  uint32_t ncontended;            /* Acquisitions that had to wait */
+  uint32_t nspins;                /* Total spin iterations while waiting */
+#endif
+#else
+  uint8_t unused;
+#endif
+};
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+#ifdef CONFIG_SMP_FINE_LOCKS
+/****************************************************************************
+ * Name: irqlock_enter
+ *
+ * Description:
+ *   Disable interrupts on the local CPU and take a subsystem lock.  Unlike
+ *   enter_critical_section(), this serializes only with the other users of
+ *   the same subsystem lock.
+ *
+ * Input Parameters:
+ *   lock - The subsystem lock to take.
+ *
+ * Returned Value:
+ *   The interrupt state that must be passed to irqlock_leave().
+ *
+ ****************************************************************************/
+
+irqstate_t irqlock_enter(FAR struct irqlock_s *lock);
+
+/****************************************************************************
+ * Name: irqlock_leave
+ *
+ * Description:
+ *   Release a subsystem lock taken by irqlock_enter() and restore the
+ *   interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - The subsystem lock to release.
+ *   flags - The value returned by the matching irqlock_enter().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void irqlock_leave(FAR struct irqlock_s *lock, irqstate_t flags);
+
+/****************************************************************************
+ * Name: irqlock_held
+ *
+ * Description:
+ *   Return a bit set of the levels of the subsystem locks held by a CPU.
+ *   Used for lock ordering validation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_LOCK_DEBUG
+uint32_t irqlock_held(int cpu);
+#endif
+
+/****************************************************************************
+ * Name: irqlock_register
+ *
+ * Description:
+ *   Add a subsystem lock to the list of locks whose contention counters are
+ *   shown at /proc/locks.  Locks are never unregistered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_LOCK_STATS
+void irqlock_register(FAR struct irqlock_s *lock);
+
+/****************************************************************************
+ * Name: irqlock_foreach
+ *
+ * Description:
+ *   Call 'handler' for each registered subsystem lock.
+ *
+ ****************************************************************************/
+
+typedef void (*irqlock_handler_t)(FAR struct irqlock_s *lock, FAR void *arg);
+void irqlock_foreach(irqlock_handler_t handler, FAR void *arg);
+#else
+#  define irqlock_register(l)
+#endif
+#endif /* CONFIG_SMP_FINE_LOCKS */
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_IRQLOCK_H */
@@ -164,6 +164,50 @@
 #define MM_ALIGN_UP(a)   (((a) + MM_GRAN_MASK) & ~MM_GRAN_MASK)
 #define MM_ALIGN_DOWN(a) ((a) & ~MM_GRAN_MASK)
 
+/* Two-level segregated fit (TLSF) free list definitions.
+ *
+ * MM_TLSF_SLBITS - log2 of the number of second-level lists per first-level
+ *   (power-of-two) size range.
+ * MM_TLSF_FLSHIFT - Chunks smaller than (1 << MM_TLSF_FLSHIFT) are kept in
+ *   first-level list zero which is divided linearly in units of
+ *   MM_MIN_CHUNK.
+ * MM_TLSF_FLCOUNT - The number of first-level size ranges.  The last range
+ *   also holds all chunks of size MM_MAX_CHUNK and above.
+ */
+
+#ifdef CONFIG_MM_TLSF
+#  define MM_TLSF_SLBITS   CONFIG_MM_TLSF_SLBITS
+#  define MM_TLSF_SLCOUNT  (1 << MM_TLSF_SLBITS)
+#  define MM_TLSF_FLSHIFT  (MM_MIN_SHIFT + MM_TLSF_SLBITS)
+#  define MM_TLSF_FLCOUNT  (MM_MAX_SHIFT - MM_TLSF_FLSHIFT + 2)
+
+#  if MM_TLSF_FLSHIFT > MM_MAX_SHIFT
+#    error CONFIG_MM_TLSF_SLBITS is too large for this memory model
+#  endif
+#endif
+
+/* Heap statistics.  If per-task statistics are enabled, the ID of the task
+ * that allocated each chunk is kept in a tag at the end of the chunk.
+ */
+
+#ifdef CONFIG_MM_STATS_PID
+#  define SIZEOF_MM_ALLOCTAG sizeof(pid_t)
+#else
+#  define SIZEOF_MM_ALLOCTAG 0
+#endif
+
+#ifndef CONFIG_MM_STATS_SAMPLE
+#  define CONFIG_MM_STATS_SAMPLE 0
+#endif
+
+/* The return address of an allocator identifies the allocation site */
+
+#ifdef __GNUC__
+#  define MM_RETURN_ADDRESS() __builtin_return_address(0)
+#else
+#  define MM_RETURN_ADDRESS() NULL
+#endif
+
 /* An allocated chunk is distinguished from a free chunk by bit 31 (or 15)
  * of the 'preceding' chunk size.  If set, then this is an allocated chunk.
  */
@@ -230,6 +274,74 @@ struct mm_freenode_s
 #define CHECK_FREENODE_SIZE \
   DEBUGASSERT(sizeof(struct mm_freenode_s) == SIZEOF_MM_FREENODE)
 
+#ifdef CONFIG_MM_STATS
+/* Statistics for one size class.  The size classes are the same power-of-
+ * two ranges of chunk sizes used by mm_size2ndx().
+ */
+
+struct mm_classstats_s
+{
+  uint32_t nfree;                  /* Number of free chunks */
+  uint32_t nused;                  /* Number of allocated chunks */
+  size_t   freebytes;              /* Size of all free chunks */
+  size_t   usedbytes;              /* Size of all allocated chunks */
+  uint32_t nallocs;                /* Total number of allocations */
+};
+
+#ifdef CONFIG_MM_STATS_PID
+/* Allocated memory owned by one task */
+
+struct mm_pidstats_s
+{
+  pid_t    pid;                    /* ID of the allocating task */
+  uint32_t nused;                  /* Number of allocated chunks */
+  size_t   usedbytes;              /* Size of all allocated chunks */
+};
+#endif
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+/* One sampled allocation that is still in use */
+
+struct mm_sample_s
+{
+  FAR void *mem;                   /* Allocated memory (NULL if unused) */
+  FAR void *caller;                /* Return address of the allocator */
+  size_t    size;                  /* Chunk size */
+  pid_t     pid;                   /* ID of the allocating task */
+};
+#endif
+
+/* Heap statistics.  These are maintained as chunks are allocated and freed
+ * so that they can be read without walking the heap.
+ */
+
+struct mm_stats_s
+{
+  uint32_t ms_nallocs;             /* Total number of allocations */
+  uint32_t ms_nfrees;              /* Total number of frees */
+  size_t   ms_maxfree;             /* Largest free chunk (snapshots only) */
+  struct mm_classstats_s ms_class[MM_NNODES];
+
+#ifdef CONFIG_MM_STATS_PID
+  /* Per-task usage.  Tasks that do not fit in the table are accumulated in
+   * ms_pidother.
+   */
+
+  struct mm_pidstats_s ms_pid[CONFIG_MM_STATS_NPIDS];
+  struct mm_pidstats_s ms_pidother;
+#endif
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+  /* Every CONFIG_MM_STATS_SAMPLE'th allocation is recorded here until it
+   * is freed.
+   */
+
+  uint16_t ms_nextsample;
+  struct mm_sample_s ms_sample[CONFIG_MM_STATS_NSAMPLES];
+#endif
+};
+#endif
+
 /* This describes one heap (possibly with multiple regions) */
 
 struct mm_heap_s
@@ -255,12 +367,27 @@ struct mm_heap_s
   int mm_nregions;
 #endif
 
+#ifdef CONFIG_MM_TLSF
+  /* Free nodes are kept in segregated, unordered lists, one for each
+   * (first-level, second-level) size class.  The bitmaps mark which lists
+   * are non-empty so that a suitable list can be found in constant time.
+   */
+
+  uint32_t mm_flmap;
+  uint32_t mm_slmap[MM_TLSF_FLCOUNT];
+  FAR struct mm_freenode_s *mm_freelist[MM_TLSF_FLCOUNT][MM_TLSF_SLCOUNT];
+#else
   /* All free nodes are maintained in a doubly linked list.  This
    * array provides some hooks into the list at various points to
    * speed searches for free nodes.
    */
 
   struct mm_freenode_s mm_nodelist[MM_NNODES];
+#endif
+
+#ifdef CONFIG_MM_STATS
+  struct mm_stats_s mm_stats;
+#endif
 };
 
 /****************************************************************************
@@ -494,16 +621,62 @@ int kmm_mallinfo(struct mallinfo *info);
 #endif /* CONFIG_CAN_PASS_STRUCTS */
 #endif /* CONFIG_MM_KERNEL_HEAP */
 
+/* Functions contained in mm_heapstats.c ************************************/
+
+#ifdef CONFIG_MM_STATS
+void mm_heapstats(FAR struct mm_heap_s *heap, FAR struct mm_stats_s *stats);
+#endif
+
+/* Functions contained in mm_stats.c ****************************************/
+
+#ifdef CONFIG_MM_STATS
+void mm_stataddfree(FAR struct mm_heap_s *heap,
+                    FAR struct mm_freenode_s *node);
+void mm_statdelfree(FAR struct mm_heap_s *heap,
+                    FAR struct mm_freenode_s *node);
+void mm_statalloc(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *node, FAR void *caller);
+void mm_statextend(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node);
+void mm_statunuse(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *node);
+void mm_statuse(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node,
+                FAR void *oldmem, FAR void *caller);
+void mm_statfree(FAR struct mm_heap_s *heap,
+                 FAR struct mm_allocnode_s *node);
+#else
+#  define mm_stataddfree(heap,node)
+#  define mm_statdelfree(heap,node)
+#  define mm_statalloc(heap,node,caller)
+#  define mm_statextend(heap,node)
+#  define mm_statunuse(heap,node)
+#  define mm_statuse(heap,node,oldmem,caller)
+#  define mm_statfree(heap,node)
+#endif
+
 /* Functions contained in mm_shrinkchunk.c **********************************/
 
 void mm_shrinkchunk(FAR struct mm_heap_s *heap,
                     FAR struct mm_allocnode_s *node, size_t size);
 
-/* Functions contained in mm_addfreechunk.c *********************************/
+/* Functions contained in mm_addfreechunk.c or mm_tlsf.c ********************/
 
 void mm_addfreechunk(FAR struct mm_heap_s *heap,
                      FAR struct mm_freenode_s *node);
 
+/* Functions contained in mm_delfreechunk.c or mm_tlsf.c ********************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node);
+
+/* Functions contained in mm_findfreechunk.c or mm_tlsf.c *******************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size);
+#ifdef CONFIG_MM_STATS
+size_t mm_maxfreechunk(FAR struct mm_heap_s *heap);
+#endif
+
 /* Functions contained in mm_size2ndx.c.c ***********************************/
 
 int mm_size2ndx(size_t size);
@@ -0,0 +1,198 @@
+/****************************************************************************
+ * include/nuttx/mm/pool.h
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+#ifndef __INCLUDE_NUTTX_MM_POOL_H
+#define __INCLUDE_NUTTX_MM_POOL_H
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <queue.h>
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* Block constructor.  This is called once for each block when the block is
+ * first added to the pool (at initialization or when the pool grows).  Freed
+ * blocks are expected to be returned to the pool in the constructed state.
+ */
+
+typedef CODE void (*mm_poolctor_t)(FAR void *block, FAR void *arg);
+
+/* This describes one fixed-size block pool.  The contents should be treated
+ * as private by users of the pool, except for the statistics which may be
+ * read (with care) by monitoring logic.
+ */
+
+struct mm_pool_s
+{
+  FAR struct mm_pool_s *flink; /* Supports a singly linked list of pools */
+  FAR const char *name;        /* Name of the pool (for procfs) */
+  mm_poolctor_t ctor;          /* Optional block constructor */
+  FAR void *arg;               /* Argument passed to the constructor */
+  sq_queue_t freelist;         /* List of free blocks */
+  size_t blocksize;            /* Size of one block */
+  uint16_t nexpand;            /* Blocks added when exhausted (0=fixed) */
+  uint16_t nreserve;           /* Blocks reserved for interrupt handlers */
+
+  /* Statistics */
+
+  uint16_t ntotal;             /* Total number of blocks in the pool */
+  uint16_t nfree;              /* Number of free blocks */
+  uint16_t nmaxused;           /* High water mark of blocks in use */
+  uint16_t ngrow;              /* Number of times that the pool has grown */
+  uint32_t nfail;              /* Number of failed allocations */
+};
+
+/* Used with mm_poolforeach() */
+
+typedef CODE void (*mm_poolhandler_t)(FAR struct mm_pool_s *pool,
+                                      FAR void *arg);
+
+/****************************************************************************
+ * Public Function Prototypes
+ ****************************************************************************/
+
+#ifdef __cplusplus
+#define EXTERN extern "C"
+extern "C"
+{
+#else
+#define EXTERN extern
+#endif
+
+/****************************************************************************
+ * Name: mm_poolinit
+ *
+ * Description:
+ *   Initialize a fixed-size block pool and register it so that its
+ *   statistics are visible via mm_poolforeach().  The pool is initially
+ *   populated with the caller provided blocks (which may be statically
+ *   allocated).
+ *
+ *   In normal task context, an exhausted pool is grown by allocating
+ *   'nexpand' blocks at a time from the kernel heap.  Memory added to a pool
+ *   is never returned to the heap.  Interrupt handlers can never grow a
+ *   pool but can use the last 'nreserve' free blocks which are not
+ *   available to normal tasks.
+ *
+ * Input Parameters:
+ *   pool      - The pool to be initialized
+ *   name      - The name of the pool
+ *   blocksize - The size of one block
+ *   blocks    - Memory holding the initial blocks (may be NULL if
+ *               nblocks is zero)
+ *   nblocks   - The number of initial blocks
+ *   nexpand   - The number of blocks to add when the pool is exhausted.
+ *               Zero prevents the pool from growing.
+ *   nreserve  - The number of blocks reserved for interrupt handlers
+ *   ctor      - Optional block constructor (may be NULL)
+ *   arg       - Argument passed to the constructor
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_poolinit(FAR struct mm_pool_s *pool, FAR const char *name,
+                 size_t blocksize, FAR void *blocks, unsigned int nblocks,
+                 unsigned int nexpand, unsigned int nreserve,
+                 mm_poolctor_t ctor, FAR void *arg);
+
+/****************************************************************************
+ * Name: mm_poolalloc
+ *
+ * Description:
+ *   Allocate one block from a pool.  This may be called from interrupt
+ *   handlers.
+ *
+ * Input Parameters:
+ *   pool - The pool to allocate from
+ *
+ * Returned Value:
+ *   The allocated block or NULL if the pool is exhausted and could not be
+ *   grown.
+ *
+ ****************************************************************************/
+
+FAR void *mm_poolalloc(FAR struct mm_pool_s *pool);
+
+/****************************************************************************
+ * Name: mm_poolfree
+ *
+ * Description:
+ *   Return one block to the pool that it was allocated from.  This may be
+ *   called from interrupt handlers.
+ *
+ * Input Parameters:
+ *   pool  - The pool that the block was allocated from
+ *   block - The block to be freed
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_poolfree(FAR struct mm_pool_s *pool, FAR void *block);
+
+/****************************************************************************
+ * Name: mm_poolforeach
+ *
+ * Description:
+ *   Call the provided handler for each registered pool.
+ *
+ * Input Parameters:
+ *   handler - The function to be called for each pool
+ *   arg     - An argument passed to the handler
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void mm_poolforeach(mm_poolhandler_t handler, FAR void *arg);
+
+#undef EXTERN
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* __INCLUDE_NUTTX_MM_POOL_H */
@@ -63,6 +63,8 @@
 #if !defined(CONFIG_NET_TCP_WRITE_BUFFERS) || !defined(CONFIG_NET_TCP_READAHEAD)
 #  undef CONFIG_IOB_THROTTLE
 #  define CONFIG_IOB_THROTTLE 0
+#  undef CONFIG_IOB_LARGE_THROTTLE
+#  define CONFIG_IOB_LARGE_THROTTLE 0
 #endif
 
 /* The correct way to disable throttling is to the the throttle value to
@@ -73,6 +75,11 @@
 #  define CONFIG_IOB_THROTTLE 0
 #endif
 
+#if !defined(CONFIG_IOB_LARGE) || !defined(CONFIG_IOB_LARGE_THROTTLE)
+#  undef CONFIG_IOB_LARGE_THROTTLE
+#  define CONFIG_IOB_LARGE_THROTTLE 0
+#endif
+
 /* Some I/O buffers should be allocated */
 
 #if !defined(CONFIG_IOB_NBUFFERS)
@@ -88,10 +95,54 @@
 #  error CONFIG_IOB_NBUFFERS <= CONFIG_IOB_THROTTLE
 #endif
 
+/* The optional pool of large I/O buffers */
+
+#ifdef CONFIG_IOB_LARGE
+#  if CONFIG_IOB_LARGE_NBUFFERS < 1
+#    error CONFIG_IOB_LARGE_NBUFFERS is zero
+#  endif
+
+#  if CONFIG_IOB_LARGE_NBUFFERS <= CONFIG_IOB_LARGE_THROTTLE
+#    error CONFIG_IOB_LARGE_NBUFFERS <= CONFIG_IOB_LARGE_THROTTLE
+#  endif
+
+#  if CONFIG_IOB_LARGE_BUFSIZE <= CONFIG_IOB_BUFSIZE
+#    error CONFIG_IOB_LARGE_BUFSIZE must be larger than CONFIG_IOB_BUFSIZE
+#  endif
+
+#  if CONFIG_IOB_LARGE_BUFSIZE > 65535
+#    error CONFIG_IOB_LARGE_BUFSIZE is too large
+#  endif
+#endif
+
+/* I/O buffer size classes.  Each class has its own pool of pre-allocated
+ * I/O buffers.  IOB_POOL_SMALL holds the CONFIG_IOB_BUFSIZE buffers that
+ * are used by default; IOB_POOL_LARGE holds the CONFIG_IOB_LARGE_BUFSIZE
+ * buffers that are selected for larger packets.
+ */
+
+#define IOB_POOL_SMALL   0
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_POOL_LARGE 1
+#  define IOB_NPOOLS     2
+#else
+#  define IOB_NPOOLS     1
+#endif
+
 /* IOB helpers */
 
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_BUFSIZE(p) \
+     ((p)->io_pool == IOB_POOL_LARGE ? CONFIG_IOB_LARGE_BUFSIZE : \
+      CONFIG_IOB_BUFSIZE)
+#  define IOB_MAXBUFSIZE CONFIG_IOB_LARGE_BUFSIZE
+#else
+#  define IOB_BUFSIZE(p) CONFIG_IOB_BUFSIZE
+#  define IOB_MAXBUFSIZE CONFIG_IOB_BUFSIZE
+#endif
+
 #define IOB_DATA(p)      (&(p)->io_data[(p)->io_offset])
-#define IOB_FREESPACE(p) (CONFIG_IOB_BUFSIZE - (p)->io_len - (p)->io_offset)
+#define IOB_FREESPACE(p) (IOB_BUFSIZE(p) - (p)->io_len - (p)->io_offset)
 
 #if CONFIG_IOB_NCHAINS > 0
 /* Queue helpers */
@@ -117,7 +168,7 @@ struct iob_s
 
   /* Payload */
 
-#if CONFIG_IOB_BUFSIZE < 256
+#if CONFIG_IOB_BUFSIZE < 256 && !defined(CONFIG_IOB_LARGE)
   uint8_t  io_len;      /* Length of the data in the entry */
   uint8_t  io_offset;   /* Data begins at this offset */
 #else
@@ -126,8 +177,32 @@ struct iob_s
 #endif
   uint16_t io_pktlen;   /* Total length of the packet */
 
+#ifdef CONFIG_IOB_LARGE
+  /* With more than one size class, the payload is kept apart from the
+   * I/O buffer structure and its size depends on the class.
+   */
+
+  uint8_t  io_pool;     /* Size class, see IOB_POOL_* */
+  FAR uint8_t *io_data; /* IOB_BUFSIZE() bytes of payload */
+#else
   uint8_t  io_data[CONFIG_IOB_BUFSIZE];
+#endif
+};
+
+#ifdef CONFIG_IOB_STATISTICS
+/* Usage statistics of one I/O buffer size class */
+
+struct iob_stats_s
+{
+  uint16_t is_bufsize;    /* Payload size of one I/O buffer */
+  uint16_t is_nbuffers;   /* Number of I/O buffers in the pool */
+  uint16_t is_nfree;      /* Number of free I/O buffers */
+  uint16_t is_minfree;    /* Lowest number of free I/O buffers seen */
+  uint32_t is_nalloc;     /* Number of successful allocations */
+  uint32_t is_nfail;      /* Allocations that failed; pool exhausted */
+  uint32_t is_nthrottled; /* Allocations denied by the throttle */
 };
+#endif
 
 #if CONFIG_IOB_NCHAINS > 0
 /* This container structure supports queuing of I/O buffer chains.  This
@@ -184,6 +259,21 @@ void iob_initialize(void);
 
 FAR struct iob_s *iob_alloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_sized
+ *
+ * Description:
+ *   Try to allocate an I/O buffer for 'len' bytes of data without waiting.
+ *   The buffer is taken from the smallest size class that holds 'len'
+ *   bytes (or from the largest class if none does).  If that class is
+ *   exhausted or throttled, a buffer of another class is returned, larger
+ *   classes first.  The caller must check IOB_BUFSIZE() and extend the
+ *   chain as necessary.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_sized(unsigned int len, bool throttled);
+
 /****************************************************************************
  * Name: iob_free
  *
@@ -417,6 +507,26 @@ void iob_dump(FAR const char *msg, FAR struct iob_s *iob, unsigned int len,
 #  define iob_dump(wrb)
 #endif
 
+/****************************************************************************
+ * Name: iob_statistics
+ *
+ * Description:
+ *   Return the usage statistics of one I/O buffer size class.
+ *
+ * Input Parameters:
+ *   pool  - The size class, one of IOB_POOL_*
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'pool' is
+ *   not a valid size class.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_STATISTICS
+int iob_statistics(int pool, FAR struct iob_stats_s *stats);
+#endif
+
 #endif /* CONFIG_NET_IOB */
 #endif /* _INCLUDE_NUTTX_NET_IOB_H */
 
@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 #ifdef CONFIG_NET
 
+#include <sys/types.h>
 #include <sys/socket.h>
 #include <stdint.h>
 #include <stdbool.h>
@@ -67,6 +68,19 @@
 /****************************************************************************
  * Public Types
  ****************************************************************************/
+
+/* A re-entrant mutex.  The global network lock is one of these.  With
+ * CONFIG_NET_FINE_LOCKS, the connection tables, each connection, and each
+ * network device have their own as well.
+ */
+
+struct net_rmutex_s
+{
+  sem_t        sem;    /* Binary semaphore providing mutual exclusion */
+  pid_t        holder; /* The thread holding the mutex */
+  unsigned int count;  /* Number of times the holder has taken it */
+};
+
 /* Data link layer type */
 
 enum net_lltype_e
@@ -208,8 +222,50 @@ void net_initialize(void);
  *   net_lockedwait()    - Like pthread_cond_wait(); releases the semaphore
  *                         momentarily to wait on another semaphore()
  *
+ * With CONFIG_NET_FINE_LOCKS, some state is protected by finer grained
+ * re-entrant mutexes instead of, or in addition to, the global lock.  When
+ * more than one is held, they must be taken in this order:
+ *
+ *   1. The global network lock,
+ *   2. A network device lock (d_lock),
+ *   3. A connection lock, then
+ *   4. A connection table lock.
+ *
+ * None of the finer grained locks may be held across net_lockedwait().
+ * Without CONFIG_NET_FINE_LOCKS, all of them are the global lock.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_rmutex_init
+ *
+ * Description:
+ *   Initialize a re-entrant mutex
+ *
+ ****************************************************************************/
+
+void net_rmutex_init(FAR struct net_rmutex_s *rmutex);
+
+/****************************************************************************
+ * Function: net_rmutex_lock
+ *
+ * Description:
+ *   Take a re-entrant mutex, waiting if it is held by another thread.
+ *
  ****************************************************************************/
 
+void net_rmutex_lock(FAR struct net_rmutex_s *rmutex);
+
+/****************************************************************************
+ * Function: net_rmutex_unlock
+ *
+ * Description:
+ *   Release a re-entrant mutex taken by net_rmutex_lock().
+ *
+ ****************************************************************************/
+
+void net_rmutex_unlock(FAR struct net_rmutex_s *rmutex);
+
 /****************************************************************************
  * Function: net_lock
  *
@@ -825,6 +881,54 @@ ssize_t psock_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 #define psock_recv(psock,buf,len,flags) \
   psock_recvfrom(psock,buf,len,flags,NULL,0)
 
+/****************************************************************************
+ * Function: psock_recvmmsg
+ *
+ * Description:
+ *   Receive up to vlen messages from a socket in one call.  For UDP sockets
+ *   with read-ahead buffering, all datagrams already buffered are copied
+ *   out with the network locked once.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags (MSG_DONTWAIT and MSG_WAITFORONE are honored)
+ *   timeout  Time to wait for messages (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received and msg_len of
+ *   each is set to the number of bytes received.  On error, -1 is
+ *   returned and errno is set appropriately (see psock_recvfrom()).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout);
+
+/****************************************************************************
+ * Function: psock_sendmmsg
+ *
+ * Description:
+ *   Send up to vlen messages on a socket in one call.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent and msg_len of each is
+ *   set to the number of bytes sent.  If the first message cannot be sent,
+ *   -1 is returned and errno is set appropriately (see psock_sendto()).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags);
+
 /****************************************************************************
  * Function: psock_getsockopt
  *
@@ -60,6 +60,14 @@
 #  include <nuttx/net/igmp.h>
 #endif
 
+#ifdef CONFIG_NETDEV_RXWORK
+#  include <nuttx/wqueue.h>
+#endif
+
+#ifdef CONFIG_NET_FINE_LOCKS
+#  include <nuttx/net/net.h>
+#endif
+
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/ip.h>
 
@@ -109,6 +117,21 @@
 
 #  define NETDEV_ERRORS(dev)      _NETDEV_STATISTIC(dev,errors)
 
+#  ifdef CONFIG_NETDEV_IOB
+#    define NETDEV_RXBATCH(dev,n) \
+       do \
+         { \
+           (dev)->d_statistics.rx_batches++; \
+           if ((n) > (dev)->d_statistics.rx_maxbatch) \
+             { \
+               (dev)->d_statistics.rx_maxbatch = (n); \
+             } \
+         } \
+       while (0)
+#    define NETDEV_RXBUDGET(dev)  _NETDEV_STATISTIC(dev,rx_budget)
+#    define NETDEV_TXACKCOAL(dev) _NETDEV_STATISTIC(dev,tx_ackcoal)
+#  endif
+
 #else
 #  define NETDEV_RESET_STATISTICS(dev)
 #  define NETDEV_RXPACKETS(dev)
@@ -125,6 +148,10 @@
 #  define NETDEV_TXTIMEOUTS(dev)
 
 #  define NETDEV_ERRORS(dev)
+
+#  define NETDEV_RXBATCH(dev,n)
+#  define NETDEV_RXBUDGET(dev)
+#  define NETDEV_TXACKCOAL(dev)
 #endif
 
 /****************************************************************************
@@ -162,6 +189,15 @@ struct netdev_statistics_s
   uint32_t tx_errors;      /* Number of receive errors (incl timeouts) */
   uint32_t tx_timeouts;    /* Number of Tx timeout errors */
 
+#ifdef CONFIG_NETDEV_IOB
+  /* Batch status */
+
+  uint32_t rx_batches;     /* Number of Rx batches processed */
+  uint32_t rx_maxbatch;    /* Largest Rx batch */
+  uint32_t rx_budget;      /* Number of times the Rx budget was exhausted */
+  uint32_t tx_ackcoal;     /* Number of TCP ACKs superseded within a batch */
+#endif
+
   /* Other status */
 
   uint32_t errors;         /* Total umber of errors */
@@ -241,6 +277,16 @@ struct net_driver_s
 
   FAR uint8_t *d_buf;
 
+#ifdef CONFIG_NETDEV_IOB
+  /* When the I/O buffer interface is used, d_buf is not owned by the
+   * driver.  It points to the data of the I/O buffer d_iob and is valid
+   * only during netdev_iob_input(), netdev_iob_poll(), and
+   * netdev_iob_timer().
+   */
+
+  FAR struct iob_s *d_iob;
+#endif
+
   /* d_appdata points to the location where application data can be read from
    * or written to in the the packet buffer.
    */
@@ -333,6 +379,42 @@ struct net_driver_s
 #ifdef CONFIG_NETDEV_PHY_IOCTL
   int (*d_ioctl)(FAR struct net_driver_s *dev, int cmd, long arg);
 #endif
+#ifdef CONFIG_NETDEV_IOB
+  /* Send one frame.  The frame is described by the I/O buffer chain pkt:
+   * Each I/O buffer in the chain provides one scatter-gather segment of
+   * io_len bytes beginning at io_data[io_offset].  The driver takes
+   * ownership of the chain and must free it with iob_free_chain() when the
+   * transfer completes (or fails).  A negated errno value is returned if
+   * the frame cannot be queued;  the network then frees the chain.
+   */
+
+  int (*d_transmit)(FAR struct net_driver_s *dev, FAR struct iob_s *pkt);
+#endif
+#ifdef CONFIG_NETDEV_RXWORK
+  /* Remove up to 'budget' received frames from the device and return them
+   * in the array 'pkts'.  The number of frames returned is the return
+   * value.  Called by the receive worker after netdev_rxschedule().  The
+   * driver normally disables its receive interrupt before calling
+   * netdev_rxschedule() and must re-enable it when fewer than 'budget'
+   * frames are returned:  The worker does not run again until the next
+   * netdev_rxschedule() in that case.
+   */
+
+  int (*d_rxpoll)(FAR struct net_driver_s *dev, FAR struct iob_s **pkts,
+                  unsigned int budget);
+
+  /* Work structure used by the receive worker */
+
+  struct work_s d_rxwork;
+#endif
+
+#ifdef CONFIG_NET_FINE_LOCKS
+  /* Serializes calls into the driver's I/O buffer methods and protects
+   * d_buf, d_len and d_iob while a frame is being processed.
+   */
+
+  struct net_rmutex_s d_lock;
+#endif
 
   /* Drivers may attached device-specific, private information */
 
@@ -341,6 +423,10 @@ struct net_driver_s
 
 typedef int (*devif_poll_callback_t)(FAR struct net_driver_s *dev);
 
+#ifdef CONFIG_NETDEV_IOB
+struct iob_s;  /* Forward reference */
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -519,6 +605,64 @@ void neighbor_out(FAR struct net_driver_s *dev);
 int netdev_carrier_on(FAR struct net_driver_s *dev);
 int netdev_carrier_off(FAR struct net_driver_s *dev);
 
+/****************************************************************************
+ * I/O buffer driver interface
+ *
+ * With CONFIG_NETDEV_IOB, a driver does not need a packet buffer of its
+ * own and does not copy frames into or out of d_buf.  Instead:
+ *
+ * - The driver receives each frame into an I/O buffer and passes a batch
+ *   of received frames to netdev_iob_input().  Each frame is processed in
+ *   place:  The frame is dispatched on its link layer type, ARP is handled
+ *   for Ethernet devices, and any response generated by the network is
+ *   built in the same I/O buffer and passed to d_transmit().  The network
+ *   is locked only once per batch.
+ *
+ * - In place of devif_poll() and devif_timer() with a driver callback,
+ *   the driver calls netdev_iob_poll() or netdev_iob_timer().  Each
+ *   outgoing frame is built in a newly allocated I/O buffer and passed to
+ *   d_transmit().
+ *
+ * A frame must fit into a single I/O buffer, so CONFIG_IOB_BUFSIZE or,
+ * with CONFIG_IOB_LARGE, CONFIG_IOB_LARGE_BUFSIZE must be at least the size
+ * of the largest link layer frame.  A driver should receive into an I/O
+ * buffer allocated with iob_tryalloc_sized() for the largest frame;  a
+ * frame received into a smaller I/O buffer is copied.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_IOB
+int netdev_iob_input(FAR struct net_driver_s *dev, FAR struct iob_s **pkts,
+                     unsigned int npkts);
+int netdev_iob_poll(FAR struct net_driver_s *dev);
+int netdev_iob_timer(FAR struct net_driver_s *dev);
+#endif
+
+/****************************************************************************
+ * Function: netdev_rxschedule
+ *
+ * Description:
+ *   Schedule deferred, batched receive processing for a device that uses
+ *   the I/O buffer driver interface.  This is normally called from the
+ *   receive interrupt handler with the receive interrupt disabled.  The
+ *   receive worker then calls the driver's d_rxpoll() method to collect up
+ *   to CONFIG_NETDEV_RXBUDGET frames at a time, passes each batch to
+ *   netdev_iob_input(), and polls for outgoing frames once per batch.  If
+ *   the budget was exhausted, the worker requeues itself so that other
+ *   work can run.
+ *
+ * Parameters:
+ *   dev - The device with received frames pending
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NETDEV_RXWORK
+int netdev_rxschedule(FAR struct net_driver_s *dev);
+#endif
+
 /****************************************************************************
  * Name: net_chksum
  *
@@ -530,9 +674,6 @@ int netdev_carrier_off(FAR struct net_driver_s *dev);
  *
  *   See RFC1071.
  *
- *   If CONFIG_NET_ARCH_CHKSUM is defined, then this function must be
- *   provided by architecture-specific logic.
- *
  * Input Parameters:
  *
  *   buf - A pointer to the buffer over which the checksum is to be computed.
@@ -567,6 +708,36 @@ uint16_t net_chksum(FAR uint16_t *data, uint16_t len);
 
 void net_incr32(FAR uint8_t *op32, uint16_t op16);
 
+/****************************************************************************
+ * Name: net_chksum_adjust and net_chksum_adjust32
+ *
+ * Description:
+ *   Update an Internet checksum after a 16-bit or 32-bit field of the
+ *   checksummed data was rewritten, without summing all of the data again.
+ *   This uses equation 3 of RFC 1624:
+ *
+ *     HC' = ~(~HC + ~m + m')
+ *
+ *   The checksum and the field values may be in either byte order as long
+ *   as it is the same for all of them.  Normally all are just loaded from
+ *   the packet (i.e., are in network byte order).  The fields must be
+ *   16-bit aligned within the checksummed data.
+ *
+ * Input Parameters:
+ *   chksum - The checksum before the field was rewritten
+ *   oldval - The previous value of the field
+ *   newval - The new value of the field
+ *
+ * Returned Value:
+ *   The updated checksum.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_adjust(uint16_t chksum, uint16_t oldval,
+                           uint16_t newval);
+uint16_t net_chksum_adjust32(uint16_t chksum, uint32_t oldval,
+                             uint32_t newval);
+
 /****************************************************************************
  * Name: ipv4_chksum
  *
@@ -576,9 +747,6 @@ void net_incr32(FAR uint8_t *op32, uint16_t op16);
  *   The IPv4 header checksum is the Internet checksum of the 20 bytes of
  *   the IPv4 header.
  *
- *   If CONFIG_NET_ARCH_CHKSUM is defined, then this function must be
- *   provided by architecture-specific logic.
- *
  * Returned Value:
  *   The IPv4 header checksum of the IPv4 header in the d_buf buffer.
  *
@@ -597,9 +765,6 @@ uint16_t ipv4_chksum(FAR struct net_driver_s *dev);
  *   The IPv6 header checksum is the Internet checksum of the 40 bytes of
  *   the IPv6 header.
  *
- *   If CONFIG_NET_ARCH_CHKSUM is defined, then this function must be
- *   provided by architecture-specific logic.
- *
  * Returned Value:
  *   The IPv6 header checksum of the IPv6 header in the d_buf buffer.
  *
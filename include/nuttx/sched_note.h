@@ -106,6 +106,10 @@ enum note_type_e
   NOTE_SPINLOCK_UNLOCK = 16,
   NOTE_SPINLOCK_ABORT  = 17
 #endif
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  ,
+  NOTE_SPINLOCK_STATS  = 18
+#endif
 };
 
 /* This structure provides the common header of each note */
@@ -234,6 +238,18 @@ struct note_spinlock_s
   uint8_t nsp_value;            /* Value of spinlock */
 };
 #endif /* CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS */
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+/* This is the specific form of the NOTE_SPINLOCK_STATS note */
+
+struct note_spinstats_s
+{
+  struct note_common_s nss_cmn; /* Common note parameters */
+  FAR void *nss_spinlock;       /* Address of spinlock */
+  uint8_t nss_spins[4];         /* Spins before the lock was taken */
+  uint8_t nss_holdtime[4];      /* Hold time in SP_TIMESTAMP() units */
+};
+#endif /* CONFIG_SCHED_INSTRUMENTATION_SPINSTATS */
 #endif /* CONFIG_SCHED_INSTRUMENTATION_BUFFER */
 
 /****************************************************************************
@@ -305,6 +321,13 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock);
 #  define sched_note_spinabort(t,s)
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+void sched_note_spinstats(FAR struct tcb_s *tcb, FAR volatile void *spinlock,
+                          uint32_t nspins, uint32_t holdtime);
+#else
+#  define sched_note_spinstats(t,s,n,h)
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
@@ -387,6 +410,7 @@ int note_register(void);
 #  define sched_note_spinlocked(t,s)
 #  define sched_note_spinunlock(t,s)
 #  define sched_note_spinabort(t,s)
+#  define sched_note_spinstats(t,s,n,h)
 
 #endif /* CONFIG_SCHED_INSTRUMENTATION */
 #endif /* __INCLUDE_NUTTX_SCHED_NOTE_H */
@@ -42,6 +42,9 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
+#include <limits.h>
 #include <semaphore.h>
 
 #include <nuttx/clock.h>
@@ -57,6 +60,37 @@
 #define SEM_PRIO_INHERIT          1
 #define SEM_PRIO_PROTECT          2
 
+/* The semaphore fast path needs a lock-free compare-and-swap of semcount */
+
+#if defined(CONFIG_SEM_FASTPATH) && !defined(__ASSEMBLY__) && \
+    !__GCC_ATOMIC_SHORT_LOCK_FREE
+#  error CONFIG_SEM_FASTPATH requires a lock-free 16-bit compare-and-swap
+#endif
+
+/* With CONFIG_SEM_FASTPATH, counts may be taken and given by
+ * sem_fastwait() and sem_fastpost() outside of the critical section, so
+ * every other change to semcount within the OS must be atomic too.
+ * sem_count_dec() and sem_count_inc() return the count before the change.
+ * sem_count_trydec() decrements a positive count and returns true if it
+ * did so.  sem_count_set() stores a new count.
+ */
+
+#ifdef CONFIG_SEM_FASTPATH
+#  define sem_count_dec(s) \
+     __atomic_fetch_sub(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#  define sem_count_inc(s) \
+     __atomic_fetch_add(&(s)->semcount, 1, __ATOMIC_ACQ_REL)
+#  define sem_count_trydec(s) sem_fastdec(s)
+#  define sem_count_set(s,v) \
+     __atomic_store_n(&(s)->semcount, (v), __ATOMIC_RELEASE)
+#else
+#  define sem_count_dec(s) ((s)->semcount--)
+#  define sem_count_inc(s) ((s)->semcount++)
+#  define sem_count_trydec(s) \
+     ((s)->semcount > 0 ? ((s)->semcount--, true) : false)
+#  define sem_count_set(s,v) ((s)->semcount = (v))
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -200,6 +234,120 @@ int sem_getprotocol(FAR sem_t *sem, FAR int *protocol);
 
 int sem_setprotocol(FAR sem_t *sem, int protocol);
 
+/****************************************************************************
+ * Name: sem_fastdec
+ *
+ * Description:
+ *   Decrement a positive semaphore count with an atomic compare-and-swap.
+ *
+ * Parameters:
+ *   sem - Semaphore object
+ *
+ * Return Value:
+ *   True if the count was decremented; false if it was not positive.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+static inline bool sem_fastdec(FAR sem_t *sem)
+{
+  int16_t count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+
+  while (count > 0)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count - 1,
+                                      true, __ATOMIC_ACQUIRE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
+/****************************************************************************
+ * Name: sem_fastwait
+ *
+ * Description:
+ *   Try to take a count on an uncontended semaphore with an atomic
+ *   compare-and-swap, without entering a critical section.  Used by
+ *   sem_wait(), sem_trywait() and the pthread mutex logic before they fall
+ *   back to the normal logic.
+ *
+ * Parameters:
+ *   sem - Semaphore object
+ *
+ * Return Value:
+ *   True if a count was taken.  False if no count is available or if the
+ *   semaphore uses priority inheritance; the normal logic must then be
+ *   used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+static inline bool sem_fastwait(FAR sem_t *sem)
+{
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  /* The holders of semaphores with priority inheritance must be known */
+
+  if ((sem->flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return false;
+    }
+#endif
+
+  return sem_fastdec(sem);
+}
+#endif
+
+/****************************************************************************
+ * Name: sem_fastpost
+ *
+ * Description:
+ *   Try to give a count to a semaphore that no thread is waiting for with
+ *   an atomic compare-and-swap, without entering a critical section.
+ *
+ * Parameters:
+ *   sem - Semaphore object
+ *
+ * Return Value:
+ *   True if the count was given.  False if a thread may be waiting or if
+ *   the semaphore uses priority inheritance; the normal logic must then be
+ *   used.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SEM_FASTPATH
+static inline bool sem_fastpost(FAR sem_t *sem)
+{
+  int16_t count;
+
+#ifdef CONFIG_PRIORITY_INHERITANCE
+  if ((sem->flags & PRIOINHERIT_FLAGS_DISABLE) == 0)
+    {
+      return false;
+    }
+#endif
+
+  /* A negative count means that threads are waiting to be awakened */
+
+  count = __atomic_load_n(&sem->semcount, __ATOMIC_RELAXED);
+  while (count >= 0 && count < SEM_VALUE_MAX)
+    {
+      if (__atomic_compare_exchange_n(&sem->semcount, &count, count + 1,
+                                      true, __ATOMIC_RELEASE,
+                                      __ATOMIC_RELAXED))
+        {
+          return true;
+        }
+    }
+
+  return false;
+}
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
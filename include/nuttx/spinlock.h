@@ -44,6 +44,7 @@
 
 #include <sys/types.h>
 #include <stdint.h>
+#include <stdbool.h>
 
 #ifdef CONFIG_SPINLOCK
 
@@ -96,6 +97,22 @@
 #  define SP_SECTION
 #endif
 
+/* The hold time of fair spinlocks is measured with SP_TIMESTAMP().  By
+ * default, this is the system timer which is too coarse for most locks;
+ * arch/spinlock.h may provide a finer time base such as a cycle counter.
+ */
+
+#if defined(CONFIG_SCHED_INSTRUMENTATION_SPINSTATS) && !defined(SP_TIMESTAMP)
+#  define SP_TIMESTAMP() ((uint32_t)clock_systimer())
+#endif
+
+#ifdef CONFIG_SPINLOCK_FAIR
+/* Static initializers for the fair spinlocks */
+
+#  define TICKETLOCK_INITIALIZER { 0 }
+#  define MCSLOCK_INITIALIZER    { NULL }
+#endif
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -112,6 +129,44 @@ struct spinlock_s
 #endif
 };
 
+#ifdef CONFIG_SPINLOCK_FAIR
+/* A ticket lock.  Each CPU that wants the lock takes the next ticket and
+ * then waits for its ticket to be served, so that the lock is granted in
+ * FIFO order.
+ */
+
+struct ticketlock_s
+{
+  volatile uint32_t tl_next;    /* The next ticket to be taken */
+  volatile uint32_t tl_owner;   /* The ticket now being served */
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  uint32_t tl_spins;            /* Spins by the holder to get the lock */
+  uint32_t tl_start;            /* SP_TIMESTAMP() when the lock was taken */
+#endif
+};
+
+/* An MCS queue lock.  The waiting CPUs form a queue of mcs_node_s
+ * structures provided by the callers.  Each waiter spins on a flag in its
+ * own node, so that only the next waiter's cache line is touched when the
+ * lock is released.
+ */
+
+struct mcs_node_s
+{
+  FAR struct mcs_node_s *volatile mn_next; /* Next waiter in the queue */
+  volatile bool mn_locked;      /* True while this waiter must wait */
+};
+
+struct mcslock_s
+{
+  FAR struct mcs_node_s *volatile ml_tail; /* Last waiter or holder */
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  uint32_t ml_spins;            /* Spins by the holder to get the lock */
+  uint32_t ml_start;            /* SP_TIMESTAMP() when the lock was taken */
+#endif
+};
+#endif /* CONFIG_SPINLOCK_FAIR */
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -363,5 +418,122 @@ void spin_clrbit(FAR volatile cpu_set_t *set, unsigned int cpu,
                  FAR volatile spinlock_t *setlock,
                  FAR volatile spinlock_t *orlock);
 
+#ifdef CONFIG_SPINLOCK_FAIR
+/****************************************************************************
+ * Name: ticket_lock
+ *
+ * Description:
+ *   Take a ticket and wait until it is served.  Unlike spin_lock(), the
+ *   waiting CPUs only read the lock while they wait and they get the lock
+ *   in the order in which they asked for it.
+ *
+ *   Like spin_lock(), this does not disable interrupts.  The caller must do
+ *   that if the lock is also taken by interrupt handlers.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_lock(FAR struct ticketlock_s *lock);
+
+/****************************************************************************
+ * Name: ticket_trylock
+ *
+ * Description:
+ *   Take the ticket lock only if no other CPU holds it or waits for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   True if the lock was taken; false if not.
+ *
+ ****************************************************************************/
+
+bool ticket_trylock(FAR struct ticketlock_s *lock);
+
+/****************************************************************************
+ * Name: ticket_unlock
+ *
+ * Description:
+ *   Release a ticket lock, serving the next ticket.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void ticket_unlock(FAR struct ticketlock_s *lock);
+
+/* bool ticket_islocked(FAR struct ticketlock_s *lock); */
+#define ticket_islocked(l) ((l)->tl_next != (l)->tl_owner)
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Join the queue of CPUs waiting for an MCS lock and wait to reach the
+ *   head of the queue.
+ *
+ *   Like spin_lock(), this does not disable interrupts.  The caller must do
+ *   that if the lock is also taken by interrupt handlers.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of this CPU.  It is usually on the caller's stack
+ *          and must remain valid until the matching mcs_unlock().
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Take the MCS lock only if no other CPU holds it or waits for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of this CPU, as for mcs_lock().
+ *
+ * Returned Value:
+ *   True if the lock was taken; false if not.
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node);
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release an MCS lock, passing it to the next CPU in the queue, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The same queue node that was passed to mcs_lock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node);
+
+/* bool mcs_islocked(FAR struct mcslock_s *lock); */
+#define mcs_islocked(l) ((l)->ml_tail != NULL)
+#endif /* CONFIG_SPINLOCK_FAIR */
+
 #endif /* CONFIG_SPINLOCK */
 #endif /* __INCLUDE_NUTTX_SPINLOCK_H */
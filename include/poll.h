@@ -103,6 +103,14 @@ typedef unsigned int nfds_t;
 
 typedef uint8_t pollevent_t;
 
+/* A poll callback.  If non-NULL, drivers call this instead of posting the
+ * semaphore when an event is reported (see poll_notify()).  poll() always
+ * sets this to NULL; it is used by the kernel epoll logic.
+ */
+
+struct pollfd;
+typedef CODE void (*pollcb_t)(FAR struct pollfd *fds);
+
 /* This is the Nuttx variant of the standard pollfd structure. */
 
 struct pollfd
@@ -112,6 +120,8 @@ struct pollfd
   pollevent_t events;   /* The input event flags */
   pollevent_t revents;  /* The output event flags */
   FAR void   *priv;     /* For use by drivers */
+  pollcb_t    cb;       /* Notification callback (or NULL) */
+  FAR void   *arg;      /* For use by the owner of the callback */
 };
 
 /****************************************************************************
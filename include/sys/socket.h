@@ -41,6 +41,7 @@
  ****************************************************************************/
 
 #include <sys/types.h>
+#include <sys/uio.h>
 
 /****************************************************************************
  * Pre-processor Definitions
@@ -105,6 +106,28 @@
 #define MSG_ERRQUEUE   0x2000 /* Fetch message from error queue.  */
 #define MSG_NOSIGNAL   0x4000 /* Do not generate SIGPIPE.  */
 #define MSG_MORE       0x8000 /* Sender will send more.  */
+#define MSG_WAITFORONE 0x10000 /* recvmmsg(): Block for the first packet */
+
+/* Access to the ancillary data (control messages) of a struct msghdr */
+
+#define CMSG_ALIGN(len) \
+  (((len) + sizeof(long) - 1) & ~(sizeof(long) - 1))
+#define CMSG_DATA(cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN(sizeof(struct cmsghdr)))
+#define CMSG_SPACE(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + CMSG_ALIGN(len))
+#define CMSG_LEN(len) \
+  (CMSG_ALIGN(sizeof(struct cmsghdr)) + (len))
+#define CMSG_FIRSTHDR(mhdr) \
+  ((mhdr)->msg_controllen >= sizeof(struct cmsghdr) ? \
+   (FAR struct cmsghdr *)(mhdr)->msg_control : (FAR struct cmsghdr *)NULL)
+#define CMSG_NXTHDR(mhdr, cmsg) \
+  ((FAR unsigned char *)(cmsg) + CMSG_ALIGN((cmsg)->cmsg_len) + \
+   sizeof(struct cmsghdr) > \
+   (FAR unsigned char *)(mhdr)->msg_control + (mhdr)->msg_controllen ? \
+   (FAR struct cmsghdr *)NULL : \
+   (FAR struct cmsghdr *)((FAR unsigned char *)(cmsg) + \
+                          CMSG_ALIGN((cmsg)->cmsg_len)))
 
 /* Socket options */
 
@@ -195,6 +218,38 @@ struct linger
   int  l_linger;  /* Linger time, in seconds. */
 };
 
+/* Describes one message for sendmmsg() and recvmmsg().  The only ancillary
+ * data supported is the UDP_GRO segment size returned by recvmmsg() (see
+ * netinet/udp.h).  On return, msg_controllen is set to the length of the
+ * control messages that were stored.
+ */
+
+struct msghdr
+{
+  FAR void *msg_name;           /* Optional address */
+  socklen_t msg_namelen;        /* Size of address */
+  FAR struct iovec *msg_iov;    /* Scatter/gather array */
+  int msg_iovlen;               /* Number of elements in msg_iov */
+  FAR void *msg_control;        /* Ancillary data (not supported) */
+  socklen_t msg_controllen;     /* Ancillary data buffer length */
+  int msg_flags;                /* Flags on received message */
+};
+
+/* Header of one control message in msg_control */
+
+struct cmsghdr
+{
+  socklen_t cmsg_len;           /* Length including this header */
+  int cmsg_level;               /* Originating protocol */
+  int cmsg_type;                /* Protocol-specific type */
+};
+
+struct mmsghdr
+{
+  struct msghdr msg_hdr;        /* Message header */
+  unsigned int msg_len;         /* Number of bytes transferred */
+};
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -223,6 +278,12 @@ ssize_t recv(int sockfd, FAR void *buf, size_t len, int flags);
 ssize_t recvfrom(int sockfd, FAR void *buf, size_t len, int flags,
                  FAR struct sockaddr *from, FAR socklen_t *fromlen);
 
+struct timespec;
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout);
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags);
+
 int shutdown(int sockfd, int how);
 
 int setsockopt(int sockfd, int level, int option,
@@ -508,7 +508,9 @@
 #  define SYS_sendto                   (__SYS_network+8)
 #  define SYS_setsockopt               (__SYS_network+9)
 #  define SYS_socket                   (__SYS_network+10)
-#  define SYS_nnetsocket               (__SYS_network+11)
+#  define SYS_recvmmsg                 (__SYS_network+11)
+#  define SYS_sendmmsg                 (__SYS_network+12)
+#  define SYS_nnetsocket               (__SYS_network+13)
 #else
 #  define SYS_nnetsocket               __SYS_network
 #endif
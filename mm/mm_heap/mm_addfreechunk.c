@@ -59,9 +59,13 @@ void mm_addfreechunk(FAR struct mm_heap_s *heap, FAR struct mm_freenode_s *node)
   FAR struct mm_freenode_s *next;
   FAR struct mm_freenode_s *prev;
 
+  int ndx;
+
+  mm_stataddfree(heap, node);
+
   /* Convert the size to a nodelist index */
 
-  int ndx = mm_size2ndx(node->size);
+  ndx = mm_size2ndx(node->size);
 
   /* Now put the new node int the next */
 
@@ -117,6 +117,12 @@ void mm_extend(FAR struct mm_heap_s *heap, FAR void *mem, size_t size,
   newnode->preceding = oldnode->size | MM_ALLOC_BIT;
 
   heap->mm_heapend[region] = newnode;
+
+  /* The statistics must also see the old node as in use before it is
+   * freed, but that is not an allocation.
+   */
+
+  mm_statextend(heap, oldnode);
   mm_givesemaphore(heap);
 
   /* Finally "free" the new block of memory where the old terminal node was
@@ -90,7 +90,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
    * not include SIZEOF_MM_ALLOCNODE.
    */
 
-  size      = MM_ALIGN_UP(size);   /* Make multiples of our granule size */
+  size      = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCTAG); /* Granule multiple */
   allocsize = size + 2*alignment;  /* Add double full alignment size */
 
   /* Then malloc that size */
@@ -113,6 +113,12 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
 
   node = (FAR struct mm_allocnode_s *)(rawchunk - SIZEOF_MM_ALLOCNODE);
 
+  /* mm_malloc() counted the allocation.  The aligned chunk will be
+   * accounted as in use with its final size below.
+   */
+
+  mm_statunuse(heap, node);
+
   /* Find the aligned subregion */
 
   alignedchunk = (rawchunk + mask) & ~mask;
@@ -201,6 +207,7 @@ FAR void *mm_memalign(FAR struct mm_heap_s *heap, size_t alignment,
       mm_shrinkchunk(heap, node, size + SIZEOF_MM_ALLOCNODE);
     }
 
+  mm_statuse(heap, node, (FAR void *)rawchunk, MM_RETURN_ADDRESS());
   mm_givesemaphore(heap);
   return (FAR void *)alignedchunk;
 }
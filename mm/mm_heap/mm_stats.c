@@ -0,0 +1,370 @@
+/****************************************************************************
+ * mm/mm_heap/mm_stats.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <unistd.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_STATS
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pidstats
+ *
+ * Description:
+ *   Return the per-task statistics for a task, allocating a table entry if
+ *   'alloc' is true.  Entries are released when all of the task's chunks
+ *   have been freed.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_STATS_PID
+static FAR struct mm_pidstats_s *mm_pidstats(FAR struct mm_stats_s *stats,
+                                             pid_t pid, bool alloc)
+{
+  FAR struct mm_pidstats_s *unused = NULL;
+  int i;
+
+  for (i = 0; i < CONFIG_MM_STATS_NPIDS; i++)
+    {
+      FAR struct mm_pidstats_s *entry = &stats->ms_pid[i];
+
+      if (entry->nused == 0)
+        {
+          if (unused == NULL)
+            {
+              unused = entry;
+            }
+        }
+      else if (entry->pid == pid)
+        {
+          return entry;
+        }
+    }
+
+  if (alloc && unused != NULL)
+    {
+      unused->pid = pid;
+      return unused;
+    }
+
+  /* The table is full (or the task is not in the table) */
+
+  stats->ms_pidother.pid = -1;
+  return &stats->ms_pidother;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_classstats
+ *
+ * Description:
+ *   Return the size class statistics for a chunk size
+ *
+ ****************************************************************************/
+
+static inline FAR struct mm_classstats_s *
+mm_classstats(FAR struct mm_heap_s *heap, size_t size)
+{
+  return &heap->mm_stats.ms_class[mm_size2ndx(size)];
+}
+
+/****************************************************************************
+ * Name: mm_statinuse and mm_statnotinuse
+ *
+ * Description:
+ *   Add an allocated chunk to or remove it from the in-use counts of its
+ *   size class and of the task that owns it.  Neither an allocation nor a
+ *   free is counted.  mm_statinuse() makes the current task the owner.
+ *
+ ****************************************************************************/
+
+static void mm_statinuse(FAR struct mm_heap_s *heap,
+                         FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_classstats_s *cstats = mm_classstats(heap, node->size);
+#ifdef CONFIG_MM_STATS_PID
+  FAR struct mm_pidstats_s *pidstats;
+  pid_t pid = getpid();
+#endif
+
+  cstats->nused++;
+  cstats->usedbytes += node->size;
+
+#ifdef CONFIG_MM_STATS_PID
+  /* Tag the chunk with the ID of its owner and charge it to that task */
+
+  *(FAR pid_t *)((FAR char *)node + node->size - SIZEOF_MM_ALLOCTAG) = pid;
+
+  pidstats = mm_pidstats(&heap->mm_stats, pid, true);
+  pidstats->nused++;
+  pidstats->usedbytes += node->size;
+#endif
+}
+
+static void mm_statnotinuse(FAR struct mm_heap_s *heap,
+                            FAR struct mm_allocnode_s *node)
+{
+  FAR struct mm_classstats_s *cstats = mm_classstats(heap, node->size);
+#ifdef CONFIG_MM_STATS_PID
+  FAR struct mm_pidstats_s *pidstats;
+  pid_t pid;
+#endif
+
+  DEBUGASSERT(cstats->nused > 0 && cstats->usedbytes >= node->size);
+
+  cstats->nused--;
+  cstats->usedbytes -= node->size;
+
+#ifdef CONFIG_MM_STATS_PID
+  /* Credit the chunk back to the task that allocated it */
+
+  pid = *(FAR pid_t *)((FAR char *)node + node->size - SIZEOF_MM_ALLOCTAG);
+
+  pidstats = mm_pidstats(&heap->mm_stats, pid, false);
+  if (pidstats->nused > 0)
+    {
+      pidstats->nused--;
+      pidstats->usedbytes -= node->size;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_findsample
+ *
+ * Description:
+ *   Return the sample of the chunk at 'mem' or NULL if it was not sampled.
+ *
+ ****************************************************************************/
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+static FAR struct mm_sample_s *mm_findsample(FAR struct mm_stats_s *stats,
+                                             FAR void *mem)
+{
+  int i;
+
+  for (i = 0; i < CONFIG_MM_STATS_NSAMPLES; i++)
+    {
+      if (stats->ms_sample[i].mem == mem)
+        {
+          return &stats->ms_sample[i];
+        }
+    }
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_stataddfree and mm_statdelfree
+ *
+ * Description:
+ *   Account for a chunk that is being added to or removed from the free
+ *   list(s).  It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_stataddfree(FAR struct mm_heap_s *heap,
+                    FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_classstats_s *cstats = mm_classstats(heap, node->size);
+
+  cstats->nfree++;
+  cstats->freebytes += node->size;
+}
+
+void mm_statdelfree(FAR struct mm_heap_s *heap,
+                    FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_classstats_s *cstats = mm_classstats(heap, node->size);
+
+  DEBUGASSERT(cstats->nfree > 0 && cstats->freebytes >= node->size);
+  cstats->nfree--;
+  cstats->freebytes -= node->size;
+}
+
+/****************************************************************************
+ * Name: mm_statalloc
+ *
+ * Description:
+ *   Account for a chunk that has just been allocated by the current task.
+ *   'caller' is the return address of the allocator (which identifies the
+ *   allocation site when the heap interfaces are reached by tail calls).
+ *   It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_statalloc(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *node, FAR void *caller)
+{
+  FAR struct mm_stats_s *stats = &heap->mm_stats;
+
+  stats->ms_nallocs++;
+  mm_classstats(heap, node->size)->nallocs++;
+  mm_statinuse(heap, node);
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+  /* Record every CONFIG_MM_STATS_SAMPLE'th allocation.  The samples are
+   * kept in a ring so the oldest sample is replaced when the ring is full.
+   */
+
+  if ((stats->ms_nallocs % CONFIG_MM_STATS_SAMPLE) == 0)
+    {
+      FAR struct mm_sample_s *sample =
+        &stats->ms_sample[stats->ms_nextsample];
+
+      sample->mem    = (FAR char *)node + SIZEOF_MM_ALLOCNODE;
+      sample->caller = caller;
+      sample->size   = node->size;
+      sample->pid    = getpid();
+
+      if (++stats->ms_nextsample >= CONFIG_MM_STATS_NSAMPLES)
+        {
+          stats->ms_nextsample = 0;
+        }
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_statextend
+ *
+ * Description:
+ *   Account for the old terminal node of a heap region that is about to be
+ *   released by mm_free() when the region is extended.  The node is counted
+ *   as in use so that the free can be credited back, but neither the
+ *   allocation nor the following free is counted.  It is assumed that the
+ *   caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_statextend(FAR struct mm_heap_s *heap,
+                   FAR struct mm_allocnode_s *node)
+{
+  /* mm_statfree() will count one free */
+
+  heap->mm_stats.ms_nfrees--;
+  mm_statinuse(heap, node);
+}
+
+/****************************************************************************
+ * Name: mm_statunuse and mm_statuse
+ *
+ * Description:
+ *   Account for an allocated chunk that is rearranged in place, as when
+ *   mm_memalign() trims an allocation to the aligned chunk.
+ *   mm_statunuse() removes the old chunk from the in-use counts before it
+ *   is changed and mm_statuse() adds the resulting chunk back.  This is
+ *   still the same allocation:  Neither a free nor a new allocation is
+ *   counted, and a sample of the old chunk at 'oldmem' is moved to the new
+ *   chunk with the new 'caller'.  It is assumed that the caller holds the
+ *   mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_statunuse(FAR struct mm_heap_s *heap,
+                  FAR struct mm_allocnode_s *node)
+{
+  mm_classstats(heap, node->size)->nallocs--;
+  mm_statnotinuse(heap, node);
+}
+
+void mm_statuse(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node,
+                FAR void *oldmem, FAR void *caller)
+{
+#if CONFIG_MM_STATS_SAMPLE > 0
+  FAR struct mm_sample_s *sample;
+#endif
+
+  mm_classstats(heap, node->size)->nallocs++;
+  mm_statinuse(heap, node);
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+  sample = mm_findsample(&heap->mm_stats, oldmem);
+  if (sample != NULL)
+    {
+      sample->mem    = (FAR char *)node + SIZEOF_MM_ALLOCNODE;
+      sample->caller = caller;
+      sample->size   = node->size;
+    }
+#endif
+}
+
+/****************************************************************************
+ * Name: mm_statfree
+ *
+ * Description:
+ *   Account for an allocated chunk that is about to be freed or resized.
+ *   It is assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+void mm_statfree(FAR struct mm_heap_s *heap, FAR struct mm_allocnode_s *node)
+{
+#if CONFIG_MM_STATS_SAMPLE > 0
+  FAR struct mm_sample_s *sample;
+#endif
+
+  heap->mm_stats.ms_nfrees++;
+  mm_statnotinuse(heap, node);
+
+#if CONFIG_MM_STATS_SAMPLE > 0
+  /* Discard the sample of this chunk, if there is one */
+
+  sample = mm_findsample(&heap->mm_stats,
+                         (FAR char *)node + SIZEOF_MM_ALLOCNODE);
+  if (sample != NULL)
+    {
+      sample->mem = NULL;
+    }
+#endif
+}
+
+#endif /* CONFIG_MM_STATS */
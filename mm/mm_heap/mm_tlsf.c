@@ -0,0 +1,371 @@
+/****************************************************************************
+ * mm/mm_heap/mm_tlsf.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/mm/mm.h>
+
+#ifdef CONFIG_MM_TLSF
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Bit operations.  These should compile to single instructions on most
+ * architectures when GCC is used.
+ */
+
+#ifdef __GNUC__
+#  define mm_ffs(m) __builtin_ctz(m)
+#  define mm_fls(m) (31 - __builtin_clz(m))
+#else
+#  define mm_ffs(m) (ffs((int)(m)) - 1)
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_fls
+ *
+ * Description:
+ *   Return the bit number of the most significant bit set in a non-zero
+ *   value.  A fixed number of steps is used.
+ *
+ ****************************************************************************/
+
+#ifndef __GNUC__
+static int mm_fls(uint32_t value)
+{
+  int bit = 0;
+
+  if (value & 0xffff0000)
+    {
+      value >>= 16;
+      bit    += 16;
+    }
+
+  if (value & 0x0000ff00)
+    {
+      value >>= 8;
+      bit    += 8;
+    }
+
+  if (value & 0x000000f0)
+    {
+      value >>= 4;
+      bit    += 4;
+    }
+
+  if (value & 0x0000000c)
+    {
+      value >>= 2;
+      bit    += 2;
+    }
+
+  if (value & 0x00000002)
+    {
+      bit    += 1;
+    }
+
+  return bit;
+}
+#endif
+
+/****************************************************************************
+ * Name: mm_mapping
+ *
+ * Description:
+ *   Map a chunk size to its first- and second-level free list indices.
+ *   Chunks of size MM_MAX_CHUNK and above all map to the last list.
+ *
+ ****************************************************************************/
+
+static void mm_mapping(size_t size, FAR int *fl, FAR int *sl)
+{
+  int msb;
+
+  if (size < (1 << MM_TLSF_FLSHIFT))
+    {
+      /* Small chunks are divided linearly in units of MM_MIN_CHUNK */
+
+      *fl = 0;
+      *sl = (int)(size >> MM_MIN_SHIFT);
+      return;
+    }
+
+  if (size >= MM_MAX_CHUNK << 1)
+    {
+      *fl = MM_TLSF_FLCOUNT - 1;
+      *sl = MM_TLSF_SLCOUNT - 1;
+      return;
+    }
+
+  msb = mm_fls((uint32_t)size);
+  *fl = msb - MM_TLSF_FLSHIFT + 1;
+  *sl = (int)(size >> (msb - MM_TLSF_SLBITS)) & (MM_TLSF_SLCOUNT - 1);
+}
+
+/****************************************************************************
+ * Name: mm_searchlist
+ *
+ * Description:
+ *   Search one free list for the first chunk of at least 'size' bytes.
+ *   This is only necessary for the last list (which is unbounded in size)
+ *   or as a fallback for the list that the request size maps to.
+ *
+ ****************************************************************************/
+
+static FAR struct mm_freenode_s *mm_searchlist(FAR struct mm_heap_s *heap,
+                                               int fl, int sl, size_t size)
+{
+  FAR struct mm_freenode_s *node;
+
+  for (node = heap->mm_freelist[fl][sl];
+       node && node->size < size;
+       node = node->flink);
+
+  return node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_addfreechunk
+ *
+ * Description:
+ *   Add a free chunk to the head of the free list for its size class.  It
+ *   is assumed that the caller holds the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_addfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  FAR struct mm_freenode_s *head;
+  int fl;
+  int sl;
+
+  mm_stataddfree(heap, node);
+  mm_mapping(node->size, &fl, &sl);
+
+  head        = heap->mm_freelist[fl][sl];
+  node->blink = NULL;
+  node->flink = head;
+
+  if (head)
+    {
+      head->blink = node;
+    }
+
+  heap->mm_freelist[fl][sl] = node;
+  heap->mm_slmap[fl]       |= (uint32_t)1 << sl;
+  heap->mm_flmap           |= (uint32_t)1 << fl;
+}
+
+/****************************************************************************
+ * Name: mm_delfreechunk
+ *
+ * Description:
+ *   Remove a free chunk from the free list for its size class, clearing the
+ *   bitmaps if the list becomes empty.  It is assumed that the caller holds
+ *   the mm semaphore
+ *
+ ****************************************************************************/
+
+void mm_delfreechunk(FAR struct mm_heap_s *heap,
+                     FAR struct mm_freenode_s *node)
+{
+  int fl;
+  int sl;
+
+  mm_statdelfree(heap, node);
+
+  if (node->flink)
+    {
+      node->flink->blink = node->blink;
+    }
+
+  if (node->blink)
+    {
+      node->blink->flink = node->flink;
+      return;
+    }
+
+  /* This node was the head of its list */
+
+  mm_mapping(node->size, &fl, &sl);
+  DEBUGASSERT(heap->mm_freelist[fl][sl] == node);
+
+  heap->mm_freelist[fl][sl] = node->flink;
+  if (node->flink == NULL)
+    {
+      heap->mm_slmap[fl] &= ~((uint32_t)1 << sl);
+      if (heap->mm_slmap[fl] == 0)
+        {
+          heap->mm_flmap &= ~((uint32_t)1 << fl);
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: mm_findfreechunk
+ *
+ * Description:
+ *   Find a free chunk that can hold 'size' bytes (including the chunk
+ *   header).  The request is rounded up to the next size class so that the
+ *   head of any non-empty list found through the bitmaps is guaranteed to
+ *   be large enough.  The chunk is not removed from its list.  It is
+ *   assumed that the caller holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+FAR struct mm_freenode_s *mm_findfreechunk(FAR struct mm_heap_s *heap,
+                                           size_t size)
+{
+  FAR struct mm_freenode_s *node;
+  uint32_t map;
+  size_t search;
+  int fl;
+  int sl;
+
+  /* Round the request up to the beginning of the next size class */
+
+  if (size < (1 << MM_TLSF_FLSHIFT))
+    {
+      search = MM_ALIGN_UP(size);
+    }
+  else if (size < MM_MAX_CHUNK << 1)
+    {
+      search = size +
+               ((size_t)1 << (mm_fls((uint32_t)size) - MM_TLSF_SLBITS)) - 1;
+    }
+  else
+    {
+      search = size;
+    }
+
+  mm_mapping(search, &fl, &sl);
+
+  /* Find the first non-empty list in this first-level range at or above
+   * the second-level index; otherwise the first non-empty list in the
+   * next non-empty first-level range.
+   */
+
+  map = heap->mm_slmap[fl] & (~(uint32_t)0 << sl);
+  if (map == 0)
+    {
+      map = heap->mm_flmap & (~(uint32_t)0 << (fl + 1));
+      if (map != 0)
+        {
+          fl  = mm_ffs(map);
+          map = heap->mm_slmap[fl];
+        }
+    }
+
+  if (map != 0)
+    {
+      sl   = mm_ffs(map);
+      node = heap->mm_freelist[fl][sl];
+
+      /* Only the last list may hold chunks smaller than the request */
+
+      if (fl == MM_TLSF_FLCOUNT - 1 && sl == MM_TLSF_SLCOUNT - 1)
+        {
+          node = mm_searchlist(heap, fl, sl, size);
+        }
+
+      if (node)
+        {
+          return node;
+        }
+    }
+
+  /* Nothing was found in the rounded up size classes.  Before failing the
+   * request, check the chunks that share the request's own size class.
+   */
+
+  mm_mapping(size, &fl, &sl);
+  return mm_searchlist(heap, fl, sl, size);
+}
+
+#endif /* CONFIG_MM_TLSF */
+
+/****************************************************************************
+ * Name: mm_maxfreechunk
+ *
+ * Description:
+ *   Return the size of the largest free chunk.  Only the nodes in the
+ *   largest non-empty free list are visited.  It is assumed that the caller
+ *   holds the mm semaphore.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_MM_STATS
+size_t mm_maxfreechunk(FAR struct mm_heap_s *heap)
+{
+  FAR struct mm_freenode_s *node;
+  size_t maxsize = 0;
+  int fl;
+  int sl;
+
+  if (heap->mm_flmap != 0)
+    {
+      fl = mm_fls(heap->mm_flmap);
+      sl = mm_fls(heap->mm_slmap[fl]);
+
+      for (node = heap->mm_freelist[fl][sl]; node; node = node->flink)
+        {
+          if (node->size > maxsize)
+            {
+              maxsize = node->size;
+            }
+        }
+    }
+
+  return maxsize;
+}
+#endif
@@ -0,0 +1,155 @@
+/****************************************************************************
+ * mm/mm_pool/mm_poolalloc.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+#include <errno.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_poolgrow
+ *
+ * Description:
+ *   Grow the pool by allocating pool->nexpand blocks from the kernel heap.
+ *
+ * Assumptions:
+ *   Called from normal task context (not from an interrupt handler).
+ *
+ ****************************************************************************/
+
+static int mm_poolgrow(FAR struct mm_pool_s *pool)
+{
+  FAR void *blocks;
+  irqstate_t flags;
+
+  if (pool->nexpand == 0 ||
+      (unsigned int)pool->ntotal + pool->nexpand > UINT16_MAX)
+    {
+      return -ENOSPC;
+    }
+
+  blocks = kmm_malloc(pool->blocksize * pool->nexpand);
+  if (blocks == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  mm_pooladdblocks(pool, blocks, pool->nexpand);
+
+  flags = enter_critical_section();
+  pool->ngrow++;
+  leave_critical_section(flags);
+  return OK;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_poolalloc
+ *
+ * Description:
+ *   Allocate one block from a pool.  This may be called from interrupt
+ *   handlers.
+ *
+ ****************************************************************************/
+
+FAR void *mm_poolalloc(FAR struct mm_pool_s *pool)
+{
+  FAR void *block;
+  irqstate_t flags;
+  bool intctx = up_interrupt_context();
+
+  DEBUGASSERT(pool != NULL);
+
+  for (; ; )
+    {
+      /* Interrupt handlers may use any free block.  Normal tasks may not use
+       * the blocks reserved for interrupt handlers.
+       */
+
+      flags = enter_critical_section();
+      if (intctx || pool->nfree > pool->nreserve)
+        {
+          block = sq_remfirst(&pool->freelist);
+          if (block != NULL)
+            {
+              uint16_t nused;
+
+              pool->nfree--;
+              nused = pool->ntotal - pool->nfree;
+              if (nused > pool->nmaxused)
+                {
+                  pool->nmaxused = nused;
+                }
+
+              leave_critical_section(flags);
+              return block;
+            }
+        }
+
+      leave_critical_section(flags);
+
+      /* The pool is exhausted.  Only normal tasks may grow the pool. */
+
+      if (intctx || mm_poolgrow(pool) < 0)
+        {
+          break;
+        }
+    }
+
+  flags = enter_critical_section();
+  pool->nfail++;
+  leave_critical_section(flags);
+  return NULL;
+}
@@ -0,0 +1,145 @@
+/****************************************************************************
+ * mm/mm_pool/mm_poolinit.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/mm/pool.h>
+
+#include "mm_pool/mm_pool.h"
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+/* This is the list of all registered pools */
+
+FAR struct mm_pool_s *g_mm_pools;
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mm_pooladdblocks
+ *
+ * Description:
+ *   Construct a contiguous array of blocks and add them to the free list of
+ *   the pool.
+ *
+ ****************************************************************************/
+
+void mm_pooladdblocks(FAR struct mm_pool_s *pool, FAR void *blocks,
+                      unsigned int nblocks)
+{
+  FAR uint8_t *block = (FAR uint8_t *)blocks;
+  sq_queue_t newblocks;
+  irqstate_t flags;
+  unsigned int i;
+
+  /* Construct the new blocks outside of the critical section */
+
+  sq_init(&newblocks);
+  for (i = 0; i < nblocks; i++, block += pool->blocksize)
+    {
+      if (pool->ctor != NULL)
+        {
+          pool->ctor(block, pool->arg);
+        }
+
+      sq_addlast((FAR sq_entry_t *)block, &newblocks);
+    }
+
+  /* Then add them all to the free list */
+
+  flags = enter_critical_section();
+  sq_cat(&newblocks, &pool->freelist);
+  pool->ntotal += nblocks;
+  pool->nfree  += nblocks;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: mm_poolinit
+ *
+ * Description:
+ *   Initialize a fixed-size block pool and register it so that its
+ *   statistics are visible via mm_poolforeach().
+ *
+ ****************************************************************************/
+
+void mm_poolinit(FAR struct mm_pool_s *pool, FAR const char *name,
+                 size_t blocksize, FAR void *blocks, unsigned int nblocks,
+                 unsigned int nexpand, unsigned int nreserve,
+                 mm_poolctor_t ctor, FAR void *arg)
+{
+  irqstate_t flags;
+
+  DEBUGASSERT(pool != NULL && name != NULL);
+  DEBUGASSERT(blocksize >= sizeof(sq_entry_t));
+  DEBUGASSERT(blocks != NULL || nblocks == 0);
+
+  pool->name      = name;
+  pool->ctor      = ctor;
+  pool->arg       = arg;
+  pool->blocksize = blocksize;
+  pool->nexpand   = nexpand;
+  pool->nreserve  = nreserve;
+  pool->ntotal    = 0;
+  pool->nfree     = 0;
+  pool->nmaxused  = 0;
+  pool->ngrow     = 0;
+  pool->nfail     = 0;
+
+  sq_init(&pool->freelist);
+
+  /* Add the initial blocks */
+
+  mm_pooladdblocks(pool, blocks, nblocks);
+
+  /* And add the pool to the list of all pools */
+
+  flags       = enter_critical_section();
+  pool->flink = g_mm_pools;
+  g_mm_pools  = pool;
+  leave_critical_section(flags);
+}
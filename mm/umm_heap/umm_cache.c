@@ -0,0 +1,359 @@
+/****************************************************************************
+ * mm/umm_heap/umm_cache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irq.h>
+#include <nuttx/mm/mm.h>
+
+#include "umm_heap/umm_heap.h"
+
+#ifdef CONFIG_MM_CACHE
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Objects are moved between the per-CPU caches and the heap in batches of
+ * half of the cache depth.
+ */
+
+#define UMM_CACHE_BATCH   (CONFIG_MM_CACHE_DEPTH >> 1)
+
+/* There is one cache for each CPU */
+
+#ifdef CONFIG_SMP
+#  define UMM_CACHE_NCPUS CONFIG_SMP_NCPUS
+#  define umm_cpuindex()  up_cpu_index()
+#else
+#  define UMM_CACHE_NCPUS 1
+#  define umm_cpuindex()  (0)
+#endif
+
+/* Map a chunk size (including the chunk header) to a cache class */
+
+#define umm_chunk2class(s) ((int)((s) >> MM_MIN_SHIFT) - 1)
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* A cached chunk is still marked as allocated in the heap.  The link to the
+ * next cached chunk is kept in the chunk payload.
+ */
+
+struct umm_cacheobj_s
+{
+  FAR struct umm_cacheobj_s *co_flink;
+};
+
+/* This is the list of cached chunks for one size class */
+
+struct umm_cachelist_s
+{
+  FAR struct umm_cacheobj_s *cl_head;
+  uint16_t cl_count;
+};
+
+/* This is the cache for one CPU.  It is only accessed by that CPU with
+ * local interrupts disabled.
+ */
+
+struct umm_cache_s
+{
+  struct umm_cachelist_s uc_list[CONFIG_MM_CACHE_NCLASSES];
+};
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+static struct umm_cache_s g_umm_cache[UMM_CACHE_NCPUS];
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_cacheput
+ *
+ * Description:
+ *   Add a chunk to the cache of the current CPU.
+ *
+ * Assumptions:
+ *   Local interrupts are disabled.
+ *
+ ****************************************************************************/
+
+static inline void umm_cacheput(FAR struct umm_cachelist_s *list,
+                                FAR void *mem)
+{
+  FAR struct umm_cacheobj_s *obj = (FAR struct umm_cacheobj_s *)mem;
+
+  obj->co_flink = list->cl_head;
+  list->cl_head = obj;
+  list->cl_count++;
+}
+
+/****************************************************************************
+ * Name: umm_cachedrain
+ *
+ * Description:
+ *   Return a list of cached chunks to the heap.  The heap semaphore is
+ *   taken only once for the whole list.
+ *
+ ****************************************************************************/
+
+static void umm_cachedrain(FAR struct umm_cacheobj_s *obj)
+{
+  FAR struct umm_cacheobj_s *next;
+
+  mm_takesemaphore(USR_HEAP);
+  for (; obj != NULL; obj = next)
+    {
+      next = obj->co_flink;
+      mm_free(USR_HEAP, obj);
+    }
+
+  mm_givesemaphore(USR_HEAP);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: umm_cachealloc
+ *
+ * Description:
+ *   Allocate a small chunk from the cache of the current CPU.  If the cache
+ *   is empty, it is refilled with a batch of chunks from the user heap.
+ *
+ * Parameters:
+ *   size - Size (in bytes) of the memory region to be allocated.
+ *
+ * Return Value:
+ *   The address of the allocated memory or NULL if the size is not cached
+ *   or if the cache could not be refilled.
+ *
+ ****************************************************************************/
+
+FAR void *umm_cachealloc(size_t size)
+{
+  FAR struct umm_cachelist_s *list;
+  FAR struct umm_cacheobj_s *obj;
+  FAR void *mem;
+  irqstate_t flags;
+  size_t chunksize;
+  int ndx;
+  int i;
+
+  if (size < 1)
+    {
+      return NULL;
+    }
+
+  chunksize = MM_ALIGN_UP(size + SIZEOF_MM_ALLOCNODE + SIZEOF_MM_ALLOCTAG);
+  ndx       = umm_chunk2class(chunksize);
+  if (ndx >= CONFIG_MM_CACHE_NCLASSES)
+    {
+      return NULL;
+    }
+
+  /* Try to take a chunk from the cache of this CPU */
+
+  flags = up_irq_save();
+  list  = &g_umm_cache[umm_cpuindex()].uc_list[ndx];
+  obj   = list->cl_head;
+  if (obj != NULL)
+    {
+      list->cl_head = obj->co_flink;
+      list->cl_count--;
+      up_irq_restore(flags);
+      return obj;
+    }
+
+  up_irq_restore(flags);
+
+  /* The cache is empty.  Allocate one chunk for the caller, then a batch
+   * of chunks to refill the cache, all with a single acquisition of the
+   * heap semaphore.
+   */
+
+  mm_takesemaphore(USR_HEAP);
+
+  size = chunksize - SIZEOF_MM_ALLOCNODE - SIZEOF_MM_ALLOCTAG;
+  mem  = mm_malloc(USR_HEAP, size);
+  if (mem != NULL)
+    {
+      for (i = 1; i < UMM_CACHE_BATCH; i++)
+        {
+          FAR void *extra = mm_malloc(USR_HEAP, size);
+          if (extra == NULL)
+            {
+              break;
+            }
+
+          /* We may be running on a different CPU now */
+
+          flags = up_irq_save();
+          list  = &g_umm_cache[umm_cpuindex()].uc_list[ndx];
+          if (list->cl_count >= CONFIG_MM_CACHE_DEPTH)
+            {
+              up_irq_restore(flags);
+              mm_free(USR_HEAP, extra);
+              break;
+            }
+
+          umm_cacheput(list, extra);
+          up_irq_restore(flags);
+        }
+    }
+
+  mm_givesemaphore(USR_HEAP);
+  return mem;
+}
+
+/****************************************************************************
+ * Name: umm_cachefree
+ *
+ * Description:
+ *   Return a small chunk to the cache of the current CPU.  If the cache is
+ *   full, a batch of chunks is first returned to the user heap.
+ *
+ * Parameters:
+ *   mem - The memory to be freed (not NULL).
+ *
+ * Return Value:
+ *   true if the memory was cached; false if the chunk is too large to be
+ *   cached and must be freed to the heap by the caller.
+ *
+ ****************************************************************************/
+
+bool umm_cachefree(FAR void *mem)
+{
+  FAR struct mm_allocnode_s *node;
+  FAR struct umm_cachelist_s *list;
+  FAR struct umm_cacheobj_s *drain = NULL;
+  irqstate_t flags;
+  int ndx;
+  int i;
+
+  DEBUGASSERT(mem != NULL);
+
+  node = (FAR struct mm_allocnode_s *)((FAR char *)mem - SIZEOF_MM_ALLOCNODE);
+  DEBUGASSERT((node->preceding & MM_ALLOC_BIT) != 0);
+
+  ndx = umm_chunk2class(node->size);
+  if (ndx < 0 || ndx >= CONFIG_MM_CACHE_NCLASSES)
+    {
+      return false;
+    }
+
+  flags = up_irq_save();
+  list  = &g_umm_cache[umm_cpuindex()].uc_list[ndx];
+
+  /* If the cache is full, detach a batch of chunks to return to the heap */
+
+  if (list->cl_count >= CONFIG_MM_CACHE_DEPTH)
+    {
+      FAR struct umm_cacheobj_s *last;
+
+      drain = list->cl_head;
+      last  = drain;
+
+      for (i = 1; i < UMM_CACHE_BATCH; i++)
+        {
+          last = last->co_flink;
+        }
+
+      list->cl_head   = last->co_flink;
+      list->cl_count -= UMM_CACHE_BATCH;
+      last->co_flink  = NULL;
+    }
+
+  umm_cacheput(list, mem);
+  up_irq_restore(flags);
+
+  if (drain != NULL)
+    {
+      umm_cachedrain(drain);
+    }
+
+  return true;
+}
+
+/****************************************************************************
+ * Name: umm_cacheflush
+ *
+ * Description:
+ *   Return all chunks in the cache of the current CPU to the user heap.
+ *   The caches of other CPUs are not affected.
+ *
+ ****************************************************************************/
+
+void umm_cacheflush(void)
+{
+  FAR struct umm_cachelist_s *list;
+  FAR struct umm_cacheobj_s *obj;
+  irqstate_t flags;
+  int ndx;
+
+  for (ndx = 0; ndx < CONFIG_MM_CACHE_NCLASSES; ndx++)
+    {
+      flags          = up_irq_save();
+      list           = &g_umm_cache[umm_cpuindex()].uc_list[ndx];
+      obj            = list->cl_head;
+      list->cl_head  = NULL;
+      list->cl_count = 0;
+      up_irq_restore(flags);
+
+      if (obj != NULL)
+        {
+          umm_cachedrain(obj);
+        }
+    }
+}
+
+#endif /* CONFIG_MM_CACHE */
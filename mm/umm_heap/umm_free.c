@@ -60,5 +60,14 @@
 
 void free(FAR void *mem)
 {
+#ifdef CONFIG_MM_CACHE
+  /* Small chunks are returned to the per-CPU cache if possible */
+
+  if (mem != NULL && umm_cachefree(mem))
+    {
+      return;
+    }
+#endif
+
   mm_free(USR_HEAP, mem);
 }
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdbool.h>
+
 #include <nuttx/mm/mm.h>
 
 /****************************************************************************
@@ -75,7 +77,15 @@
 #endif
 
 /****************************************************************************
- * Public Functions
+ * Public Function Prototypes
  ****************************************************************************/
 
+/* Functions contained in umm_cache.c ***************************************/
+
+#ifdef CONFIG_MM_CACHE
+FAR void *umm_cachealloc(size_t size);
+bool umm_cachefree(FAR void *mem);
+void umm_cacheflush(void);
+#endif
+
 #endif /* __MM_UMM_HEAP_UMM_HEAP_H */
@@ -63,6 +63,11 @@
 struct mallinfo mallinfo(void)
 {
   struct mallinfo info;
+
+#ifdef CONFIG_MM_CACHE
+  umm_cacheflush();
+#endif
+
   mm_mallinfo(USR_HEAP, &info);
   return info;
 }
@@ -71,6 +76,10 @@ struct mallinfo mallinfo(void)
 
 int mallinfo(FAR struct mallinfo *info)
 {
+#ifdef CONFIG_MM_CACHE
+  umm_cacheflush();
+#endif
+
   return mm_mallinfo(USR_HEAP, info);
 }
 
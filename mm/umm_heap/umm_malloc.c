@@ -95,6 +95,25 @@ FAR void *malloc(size_t size)
     }
   while (mem == NULL);
 
+  return mem;
+#elif defined(CONFIG_MM_CACHE)
+  FAR void *mem;
+
+  /* Small allocations are satisfied from the per-CPU cache if possible */
+
+  mem = umm_cachealloc(size);
+  if (mem == NULL)
+    {
+      mem = mm_malloc(USR_HEAP, size);
+      if (mem == NULL)
+        {
+          /* Return the memory held in this CPU's cache and try again */
+
+          umm_cacheflush();
+          mem = mm_malloc(USR_HEAP, size);
+        }
+    }
+
   return mem;
 #else
   return mm_malloc(USR_HEAP, size);
@@ -66,8 +66,10 @@
 
 FAR void *zalloc(size_t size)
 {
-#ifdef CONFIG_ARCH_ADDRENV
-  /* Use malloc() because it implements the sbrk() logic */
+#if defined(CONFIG_ARCH_ADDRENV) || defined(CONFIG_MM_CACHE)
+  /* Use malloc() because it implements the sbrk() logic and the per-CPU
+   * small allocation cache.
+   */
 
   FAR void *alloc = malloc(size);
   if (alloc)
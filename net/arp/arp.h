@@ -53,6 +53,7 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <semaphore.h>
 
 #include <netinet/in.h>
@@ -76,6 +77,15 @@
 #  define CONFIG_ARP_SEND_DELAYMSEC 20
 #endif
 
+#ifndef CONFIG_NET_ARP_NEGATIVE_AGE
+#  define CONFIG_NET_ARP_NEGATIVE_AGE 2
+#endif
+
+#if !defined(CONFIG_NET_ARP_PENDING) || !defined(CONFIG_NET_IOB)
+#  undef CONFIG_NET_ARP_PENDING
+#  define CONFIG_NET_ARP_PENDING 0
+#endif
+
 /* ARP Definitions **********************************************************/
 
 #define ARP_REQUEST    1
@@ -397,20 +407,90 @@ FAR struct arp_entry *arp_find(in_addr_t ipaddr);
  * Input parameters:
  *   ipaddr - Refers to an IP address in network order
  *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no entry for the address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr);
+
+/****************************************************************************
+ * Name: arp_negative
+ *
+ * Description:
+ *   Check for -OR- create a negative entry for an IP address that could
+ *   not be resolved.  While the negative entry exists, packets to the
+ *   address are dropped without sending further ARP requests.
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *   create - True: Create the negative entry, False: Check only
+ *
+ * Returned Value:
+ *   True if there is a negative entry for the address.
+ *
  * Assumptions
- *   Interrupts are disabled to assure exclusive access to the ARP table
- *   (and because arp_find() is called).
+ *   The network is locked to assure exclusive access to the ARP table
  *
  ****************************************************************************/
 
-#define arp_delete(ipaddr) \
-{ \
-  struct arp_entry *tabptr = arp_find(ipaddr); \
-  if (tabptr) \
-    { \
-      tabptr->at_ipaddr = 0; \
-    } \
-}
+bool arp_negative(in_addr_t ipaddr, bool create);
+
+/****************************************************************************
+ * Name: arp_miss
+ *
+ * Description:
+ *   Called by arp_out() when there is no resolved entry for the next hop
+ *   of the outgoing packet.  Unless there is a negative entry, an entry
+ *   for the unresolved address is created and the outgoing IP packet is
+ *   copied so that it can be sent once the address is resolved.
+ *
+ * Input parameters:
+ *   dev    - The device with the outgoing IP packet in d_buf
+ *   ipaddr - The next hop IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) if an ARP request should be sent in place of the packet;
+ *   -ENETUNREACH if the address recently failed to resolve.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_miss(FAR struct net_driver_s *dev, in_addr_t ipaddr);
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets that were held while their next hop address was being
+ *   resolved.  Called from devif_poll().  Each packet is placed in d_buf
+ *   and passed to the driver callback which will call arp_out() to add the
+ *   Ethernet header.
+ *
+ * Input parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The non-zero value returned by the callback if it stopped the poll;
+ *   zero otherwise.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARP_PENDING > 0
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback);
+#else
+#  define arp_pending_poll(d,c) (0)
+#endif
 
 /****************************************************************************
  * Name: arp_update
@@ -491,7 +571,10 @@ void arp_dump(FAR struct arp_hdr_s *arp);
 #  define arp_wait(n,t) (0)
 #  define arp_notify(i)
 #  define arp_find(i) (NULL)
-#  define arp_delete(i)
+#  define arp_delete(i) (-ENOENT)
+#  define arp_negative(i,c) (false)
+#  define arp_miss(d,i) (0)
+#  define arp_pending_poll(d,c) (0)
 #  define arp_update(i,m);
 #  define arp_hdr_update(i,m);
 #  define arp_dump(arp)
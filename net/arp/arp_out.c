@@ -231,6 +231,18 @@ void arp_out(FAR struct net_driver_s *dev)
       tabptr = arp_find(ipaddr);
       if (!tabptr)
         {
+          /* If the address could not be resolved recently, just drop the
+           * packet.  Otherwise, the packet may be held until the address
+           * is resolved.
+           */
+
+          if (arp_miss(dev, ipaddr) < 0)
+            {
+              ninfo("IP %08lx unreachable\n", (unsigned long)ipaddr);
+              dev->d_len = 0;
+              return;
+            }
+
            ninfo("ARP request for IP %08lx\n", (unsigned long)ipaddr);
 
           /* The destination address was not in our ARP table, so we
@@ -276,6 +276,14 @@ int arp_send(in_addr_t ipaddr)
       ipaddr = dripaddr;
     }
 
+  /* Don't try again if the address recently failed to resolve */
+
+  if (arp_negative(ipaddr, false))
+    {
+      ret = -ENETUNREACH;
+      goto errout;
+    }
+
   /* Allocate resources to receive a callback.  This and the following
    * initialization is performed with the network lock because we don't
    * want anything to happen until we are ready.
@@ -405,6 +413,13 @@ int arp_send(in_addr_t ipaddr)
       nerr("ERROR: arp_wait failed: %d\n", ret);
     }
 
+  /* Remember the failure so that other senders do not retry at once */
+
+  if (ret == -ETIMEDOUT)
+    {
+      (void)arp_negative(ipaddr, true);
+    }
+
   sem_destroy(&state.snd_sem);
   arp_callback_free(dev, state.snd_cb);
 errout_with_lock:
@@ -47,12 +47,16 @@
 
 #include <sys/ioctl.h>
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
+#include <queue.h>
+#include <errno.h>
 #include <debug.h>
 
 #include <netinet/in.h>
 #include <net/ethernet.h>
 
+#include <nuttx/irq.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
@@ -60,17 +64,227 @@
 
 #include <arp/arp.h>
 
+#if CONFIG_NET_ARP_PENDING > 0
+#  include <nuttx/net/iob.h>
+#  include "iob/iob.h"
+#  include "netdev/netdev.h"
+#endif
+
 #ifdef CONFIG_NET_ARP
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* States of an ARP table entry */
+
+#define ARP_STATE_FREE       0  /* Not in use */
+#define ARP_STATE_INCOMPLETE 1  /* ARP request sent, no reply yet */
+#define ARP_STATE_RESOLVED   2  /* Valid IP to MAC address mapping */
+#define ARP_STATE_NEGATIVE   3  /* Recently failed to resolve */
+
+/* An unresolved entry becomes negative once it is this old (in units of
+ * the 10 second ARP timer).
+ */
+
+#define ARP_INCOMPLETE_MAXAGE 2
+
+#define ETHBUF ((FAR struct eth_hdr_s *)&dev->d_buf[0])
+#define IPBUF  (&dev->d_buf[ETH_HDRLEN])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One ARP table entry.  Entries in use are in a hash bucket chain, for
+ * lookup, and in the LRU list, for replacement.
+ */
+
+struct arp_tabent_s
+{
+  dq_entry_t at_node;                  /* LRU list link (must be first) */
+  FAR struct arp_tabent_s *at_hnext;   /* Hash bucket chain */
+  struct arp_entry at_entry;           /* Address mapping and age */
+  uint8_t at_state;                    /* See ARP_STATE_* definitions */
+#if CONFIG_NET_ARP_PENDING > 0
+  uint8_t at_npending;                 /* Number of packets held */
+  FAR struct net_driver_s *at_dev;     /* Device of the held packets */
+  FAR struct arp_tabent_s *at_fnext;   /* Flush list link */
+  FAR struct iob_s *at_pending[CONFIG_NET_ARP_PENDING];
+#endif
+};
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
 /* The table of known address mappings */
 
-static struct arp_entry g_arptable[CONFIG_NET_ARPTAB_SIZE];
+static struct arp_tabent_s g_arptable[CONFIG_NET_ARPTAB_SIZE];
 static uint8_t g_arptime;
 
+/* Hash buckets, the LRU list (least recently used first) and free list */
+
+static FAR struct arp_tabent_s *g_arphash[CONFIG_NET_ARPTAB_SIZE];
+static dq_queue_t g_arplru;
+static sq_queue_t g_arpfree;
+
+#if CONFIG_NET_ARP_PENDING > 0
+/* Entries that were resolved with packets still held */
+
+static FAR struct arp_tabent_s *g_arpflush;
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: arp_hash
+ ****************************************************************************/
+
+static inline FAR struct arp_tabent_s **arp_hash(in_addr_t ipaddr)
+{
+  uint32_t hash = (uint32_t)ipaddr * 2654435761u;
+  return &g_arphash[(hash >> 16) % CONFIG_NET_ARPTAB_SIZE];
+}
+
+/****************************************************************************
+ * Name: arp_lookup
+ *
+ * Description:
+ *   Find the entry for an IP address in any state.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_tabent_s *arp_lookup(in_addr_t ipaddr)
+{
+  FAR struct arp_tabent_s *ent;
+
+  for (ent = *arp_hash(ipaddr); ent != NULL; ent = ent->at_hnext)
+    {
+      if (net_ipv4addr_cmp(ipaddr, ent->at_entry.at_ipaddr))
+        {
+          break;
+        }
+    }
+
+  return ent;
+}
+
+/****************************************************************************
+ * Name: arp_touch
+ *
+ * Description:
+ *   Make an entry the most recently used one.
+ *
+ ****************************************************************************/
+
+static inline void arp_touch(FAR struct arp_tabent_s *ent)
+{
+  if (ent->at_node.flink != NULL)
+    {
+      dq_rem(&ent->at_node, &g_arplru);
+      dq_addlast(&ent->at_node, &g_arplru);
+    }
+}
+
+/****************************************************************************
+ * Name: arp_dropheld
+ *
+ * Description:
+ *   Free the packets held by an entry.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARP_PENDING > 0
+static void arp_dropheld(FAR struct arp_tabent_s *ent)
+{
+  FAR struct arp_tabent_s **pprev;
+
+  while (ent->at_npending > 0)
+    {
+      iob_free_chain(ent->at_pending[--ent->at_npending]);
+    }
+
+  for (pprev = &g_arpflush; *pprev != NULL; pprev = &(*pprev)->at_fnext)
+    {
+      if (*pprev == ent)
+        {
+          *pprev = ent->at_fnext;
+          break;
+        }
+    }
+}
+#else
+#  define arp_dropheld(ent)
+#endif
+
+/****************************************************************************
+ * Name: arp_release
+ *
+ * Description:
+ *   Remove an entry from the table and return it to the free list.
+ *
+ ****************************************************************************/
+
+static void arp_release(FAR struct arp_tabent_s *ent)
+{
+  FAR struct arp_tabent_s **pprev;
+
+  for (pprev = arp_hash(ent->at_entry.at_ipaddr); *pprev != NULL;
+       pprev = &(*pprev)->at_hnext)
+    {
+      if (*pprev == ent)
+        {
+          *pprev = ent->at_hnext;
+          break;
+        }
+    }
+
+  arp_dropheld(ent);
+  dq_rem(&ent->at_node, &g_arplru);
+
+  ent->at_entry.at_ipaddr = 0;
+  ent->at_state           = ARP_STATE_FREE;
+  sq_addlast((FAR sq_entry_t *)ent, &g_arpfree);
+}
+
+/****************************************************************************
+ * Name: arp_alloc
+ *
+ * Description:
+ *   Add a new entry for an IP address, replacing the least recently used
+ *   entry if the table is full.
+ *
+ ****************************************************************************/
+
+static FAR struct arp_tabent_s *arp_alloc(in_addr_t ipaddr, uint8_t state)
+{
+  FAR struct arp_tabent_s **bucket;
+  FAR struct arp_tabent_s *ent;
+
+  ent = (FAR struct arp_tabent_s *)sq_remfirst(&g_arpfree);
+  if (ent == NULL)
+    {
+      arp_release((FAR struct arp_tabent_s *)dq_peek(&g_arplru));
+      ent = (FAR struct arp_tabent_s *)sq_remfirst(&g_arpfree);
+    }
+
+  DEBUGASSERT(ent != NULL);
+
+  ent->at_entry.at_ipaddr = ipaddr;
+  ent->at_entry.at_time   = g_arptime;
+  ent->at_state           = state;
+
+  bucket        = arp_hash(ipaddr);
+  ent->at_hnext = *bucket;
+  *bucket       = ent;
+
+  dq_addlast(&ent->at_node, &g_arplru);
+  return ent;
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -85,12 +299,26 @@ static uint8_t g_arptime;
 
 void arp_reset(void)
 {
+  irqstate_t flags;
   int i;
 
+  flags = enter_critical_section();
+
+  dq_init(&g_arplru);
+  sq_init(&g_arpfree);
+#if CONFIG_NET_ARP_PENDING > 0
+  g_arpflush = NULL;
+#endif
+
   for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
     {
-      memset(&g_arptable[i].at_ipaddr, 0, sizeof(in_addr_t));
+      arp_dropheld(&g_arptable[i]);
+      memset(&g_arptable[i], 0, sizeof(struct arp_tabent_s));
+      sq_addlast((FAR sq_entry_t *)&g_arptable[i], &g_arpfree);
+      g_arphash[i] = NULL;
     }
+
+  leave_critical_section(flags);
 }
 
 /****************************************************************************
@@ -100,26 +328,58 @@ void arp_reset(void)
  *   This function performs periodic timer processing in the ARP module
  *   and should be called at regular intervals. The recommended interval
  *   is 10 seconds between the calls.  It is responsible for flushing old
- *   entries in the ARP table.
+ *   entries in the ARP table and for turning entries that could not be
+ *   resolved into negative entries.
  *
  ****************************************************************************/
 
 void arp_timer(void)
 {
-  FAR struct arp_entry *tabptr;
-  int i;
+  FAR struct arp_tabent_s *ent;
+  FAR struct arp_tabent_s *next;
+  irqstate_t flags;
+  uint8_t age;
+
+  flags = enter_critical_section();
 
   ++g_arptime;
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  for (ent = (FAR struct arp_tabent_s *)dq_peek(&g_arplru);
+       ent != NULL;
+       ent = next)
     {
-      tabptr = &g_arptable[i];
+      next = (FAR struct arp_tabent_s *)dq_next(&ent->at_node);
+      age  = g_arptime - ent->at_entry.at_time;
 
-      if (tabptr->at_ipaddr != 0 &&
-          g_arptime - tabptr->at_time >= CONFIG_NET_ARP_MAXAGE)
+      switch (ent->at_state)
         {
-          tabptr->at_ipaddr = 0;
+          case ARP_STATE_INCOMPLETE:
+            if (age >= ARP_INCOMPLETE_MAXAGE)
+              {
+                /* No reply:  Don't bother the network for a while */
+
+                arp_dropheld(ent);
+                ent->at_state         = ARP_STATE_NEGATIVE;
+                ent->at_entry.at_time = g_arptime;
+              }
+            break;
+
+          case ARP_STATE_NEGATIVE:
+            if (age >= CONFIG_NET_ARP_NEGATIVE_AGE)
+              {
+                arp_release(ent);
+              }
+            break;
+
+          default:
+            if (age >= CONFIG_NET_ARP_MAXAGE)
+              {
+                arp_release(ent);
+              }
+            break;
         }
     }
+
+  leave_critical_section(flags);
 }
 
 /****************************************************************************
@@ -127,7 +387,8 @@ void arp_timer(void)
  *
  * Description:
  *   Add the IP/HW address mapping to the ARP table -OR- change the IP
- *   address of an existing association.
+ *   address of an existing association.  Packets held while the address
+ *   was being resolved are scheduled for transmission.
  *
  * Input parameters:
  *   ipaddr  - The IP address as an inaddr_t
@@ -144,79 +405,50 @@ void arp_timer(void)
 
 int arp_update(in_addr_t ipaddr, FAR uint8_t *ethaddr)
 {
-  struct arp_entry *tabptr = NULL;
-  int               i;
-
-  /* Walk through the ARP mapping table and try to find an entry to
-   * update. If none is found, the IP -> MAC address mapping is
-   * inserted in the ARP table.
-   */
+  FAR struct arp_tabent_s *ent;
+  irqstate_t flags;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  if (ipaddr == 0)
     {
-      tabptr = &g_arptable[i];
-
-      /* Only check those entries that are actually in use. */
-
-      if (tabptr->at_ipaddr != 0)
-        {
-          /* Check if the source IP address of the incoming packet matches
-           * the IP address in this ARP table entry.
-           */
-
-          if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
-            {
-              /* An old entry found, update this and return. */
-
-              memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-              tabptr->at_time = g_arptime;
-              return OK;
-            }
-        }
+      return -EINVAL;
     }
 
-  /* If we get here, no existing ARP table entry was found, so we create one. */
-  /* First, we try to find an unused entry in the ARP table. */
+  flags = enter_critical_section();
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  /* Update the existing entry (in any state) or create one */
+
+  ent = arp_lookup(ipaddr);
+  if (ent == NULL)
     {
-      tabptr = &g_arptable[i];
-      if (tabptr->at_ipaddr == 0)
-        {
-          break;
-        }
+      ent = arp_alloc(ipaddr, ARP_STATE_RESOLVED);
     }
 
-  /* If no unused entry is found, we try to find the oldest entry and
-   * throw it away.
-   */
+  memcpy(ent->at_entry.at_ethaddr.ether_addr_octet, ethaddr,
+         ETHER_ADDR_LEN);
+  ent->at_entry.at_time = g_arptime;
+  ent->at_state         = ARP_STATE_RESOLVED;
+
+#if CONFIG_NET_ARP_PENDING > 0
+  /* If packets were held for this address, have the device poll for them */
 
-  if (i == CONFIG_NET_ARPTAB_SIZE)
+  if (ent->at_npending > 0)
     {
-      uint8_t tmpage = 0;
-      int j = 0;
+      FAR struct arp_tabent_s *tmp;
 
-      for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+      for (tmp = g_arpflush; tmp != NULL && tmp != ent; tmp = tmp->at_fnext);
+      if (tmp == NULL)
         {
-          tabptr = &g_arptable[i];
-          if (g_arptime - tabptr->at_time > tmpage)
-            {
-              tmpage = g_arptime - tabptr->at_time;
-              j = i;
-            }
+          ent->at_fnext = g_arpflush;
+          g_arpflush    = ent;
         }
 
-      i = j;
-      tabptr = &g_arptable[i];
+      leave_critical_section(flags);
+      netdev_txnotify_dev(ent->at_dev);
+      return OK;
     }
+#endif
 
-  /* Now, i is the ARP table entry which we will fill with the new
-   * information.
-   */
-
-  tabptr->at_ipaddr = ipaddr;
-  memcpy(tabptr->at_ethaddr.ether_addr_octet, ethaddr, ETHER_ADDR_LEN);
-  tabptr->at_time = g_arptime;
+  leave_critical_section(flags);
   return OK;
 }
 
@@ -253,7 +485,8 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
  * Name: arp_find
  *
  * Description:
- *   Find the ARP entry corresponding to this IP address.
+ *   Find the ARP entry corresponding to this IP address.  Only resolved
+ *   entries are returned.  The entry becomes the most recently used one.
  *
  * Input parameters:
  *   ipaddr - Refers to an IP address in network order
@@ -266,20 +499,258 @@ void arp_hdr_update(FAR uint16_t *pipaddr, FAR uint8_t *ethaddr)
 
 FAR struct arp_entry *arp_find(in_addr_t ipaddr)
 {
-  FAR struct arp_entry *tabptr;
+  FAR struct arp_tabent_s *ent;
+  irqstate_t flags;
+
+  flags = enter_critical_section();
+  ent   = arp_lookup(ipaddr);
+  if (ent != NULL && ent->at_state == ARP_STATE_RESOLVED)
+    {
+      arp_touch(ent);
+    }
+  else
+    {
+      ent = NULL;
+    }
+
+  leave_critical_section(flags);
+  return ent != NULL ? &ent->at_entry : NULL;
+}
+
+/****************************************************************************
+ * Name: arp_delete
+ *
+ * Description:
+ *   Remove an IP association from the ARP table
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) on success; -ENOENT if there is no entry for the address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_delete(in_addr_t ipaddr)
+{
+  FAR struct arp_tabent_s *ent;
+  irqstate_t flags;
+  int ret = -ENOENT;
+
+  flags = enter_critical_section();
+  ent   = arp_lookup(ipaddr);
+  if (ent != NULL)
+    {
+      arp_release(ent);
+      ret = OK;
+    }
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: arp_negative
+ *
+ * Description:
+ *   Check for -OR- create a negative entry for an IP address that could
+ *   not be resolved.  While the negative entry exists, packets to the
+ *   address are dropped without sending further ARP requests.
+ *
+ * Input parameters:
+ *   ipaddr - Refers to an IP address in network order
+ *   create - True: Create the negative entry, False: Check only
+ *
+ * Returned Value:
+ *   True if there is a negative entry for the address.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+bool arp_negative(in_addr_t ipaddr, bool create)
+{
+  FAR struct arp_tabent_s *ent;
+  irqstate_t flags;
+  bool negative = false;
+
+  flags = enter_critical_section();
+  ent   = arp_lookup(ipaddr);
+
+  if (create)
+    {
+      if (ent == NULL)
+        {
+          ent = arp_alloc(ipaddr, ARP_STATE_NEGATIVE);
+        }
+      else if (ent->at_state != ARP_STATE_RESOLVED)
+        {
+          arp_dropheld(ent);
+          ent->at_state         = ARP_STATE_NEGATIVE;
+          ent->at_entry.at_time = g_arptime;
+        }
+    }
+
+  negative = (ent != NULL && ent->at_state == ARP_STATE_NEGATIVE);
+  leave_critical_section(flags);
+  return negative;
+}
+
+/****************************************************************************
+ * Name: arp_miss
+ *
+ * Description:
+ *   Called by arp_out() when there is no resolved entry for the next hop
+ *   of the outgoing packet.  Unless there is a negative entry, an entry
+ *   for the unresolved address is created and the outgoing IP packet is
+ *   copied so that it can be sent once the address is resolved.
+ *
+ * Input parameters:
+ *   dev    - The device with the outgoing IP packet in d_buf
+ *   ipaddr - The next hop IP address in network order
+ *
+ * Returned Value:
+ *   Zero (OK) if an ARP request should be sent in place of the packet;
+ *   -ENETUNREACH if the address recently failed to resolve.
+ *
+ * Assumptions
+ *   The network is locked to assure exclusive access to the ARP table
+ *
+ ****************************************************************************/
+
+int arp_miss(FAR struct net_driver_s *dev, in_addr_t ipaddr)
+{
+  FAR struct arp_tabent_s *ent;
+  irqstate_t flags;
+  int ret = OK;
+
+  flags = enter_critical_section();
+  ent   = arp_lookup(ipaddr);
+
+  if (ent == NULL)
+    {
+      ent = arp_alloc(ipaddr, ARP_STATE_INCOMPLETE);
+    }
+  else if (ent->at_state == ARP_STATE_NEGATIVE)
+    {
+      ret = -ENETUNREACH;
+    }
+
+#if CONFIG_NET_ARP_PENDING > 0
+  if (ret == OK && ent->at_state == ARP_STATE_INCOMPLETE &&
+      ent->at_npending < CONFIG_NET_ARP_PENDING && dev->d_len > 0)
+    {
+      FAR struct iob_s *iob;
+
+      /* Hold a copy of the IP packet.  If no I/O buffer is available, the
+       * packet is dropped as it would be without this feature.
+       */
+
+      iob = iob_tryalloc(false);
+      if (iob != NULL)
+        {
+          if (iob_trycopyin(iob, IPBUF, dev->d_len, 0, false) == dev->d_len)
+            {
+              ent->at_dev = dev;
+              ent->at_pending[ent->at_npending++] = iob;
+            }
+          else
+            {
+              iob_free_chain(iob);
+            }
+        }
+    }
+#endif
+
+  leave_critical_section(flags);
+  return ret;
+}
+
+/****************************************************************************
+ * Name: arp_pending_poll
+ *
+ * Description:
+ *   Send the packets that were held while their next hop address was being
+ *   resolved.  Called from devif_poll().  Each packet is placed in d_buf
+ *   and passed to the driver callback which will call arp_out() to add the
+ *   Ethernet header.
+ *
+ * Input parameters:
+ *   dev      - The device being polled
+ *   callback - The driver poll callback
+ *
+ * Returned Value:
+ *   The non-zero value returned by the callback if it stopped the poll;
+ *   zero otherwise.
+ *
+ * Assumptions
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ARP_PENDING > 0
+int arp_pending_poll(FAR struct net_driver_s *dev,
+                     devif_poll_callback_t callback)
+{
+  FAR struct arp_tabent_s **pprev;
+  FAR struct arp_tabent_s *ent;
+  FAR struct iob_s *iob;
+  irqstate_t flags;
+  int bstop = 0;
   int i;
 
-  for (i = 0; i < CONFIG_NET_ARPTAB_SIZE; ++i)
+  flags = enter_critical_section();
+
+  for (pprev = &g_arpflush; (ent = *pprev) != NULL && bstop == 0; )
     {
-      tabptr = &g_arptable[i];
-      if (net_ipv4addr_cmp(ipaddr, tabptr->at_ipaddr))
+      if (ent->at_dev != dev)
+        {
+          pprev = &ent->at_fnext;
+          continue;
+        }
+
+      /* Remove the oldest held packet */
+
+      iob = ent->at_pending[0];
+      ent->at_npending--;
+      for (i = 0; i < ent->at_npending; i++)
+        {
+          ent->at_pending[i] = ent->at_pending[i + 1];
+        }
+
+      if (ent->at_npending == 0)
         {
-          return tabptr;
+          *pprev = ent->at_fnext;
         }
+
+      leave_critical_section(flags);
+
+      /* Send it */
+
+      dev->d_len    = iob_copyout(IPBUF, iob, iob->io_pktlen, 0);
+      dev->d_sndlen = 0;
+      iob_free_chain(iob);
+
+#ifdef CONFIG_NET_IPv6
+      IFF_SET_IPv4(dev->d_flags);
+#endif
+      bstop = callback(dev);
+
+      flags = enter_critical_section();
+
+      /* The list may have changed while it was unlocked.  Start over. */
+
+      pprev = &g_arpflush;
     }
 
-  return NULL;
+  leave_critical_section(flags);
+  return bstop;
 }
+#endif /* CONFIG_NET_ARP_PENDING > 0 */
 
 #endif /* CONFIG_NET_ARP */
 #endif /* CONFIG_NET */
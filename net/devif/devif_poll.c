@@ -197,13 +197,24 @@ static int devif_poll_udp_connections(FAR struct net_driver_s *dev,
 
   while (!bstop && (conn = udp_nextconn(conn)))
     {
-      /* Perform the UDP TX poll */
+      bool sent;
 
-      udp_poll(dev, conn);
+      /* Poll the same connection again as long as it has more datagrams
+       * ready (UDP_SEGMENT and sendmmsg()) and the driver accepts them.
+       */
 
-      /* Call back into the driver */
+      do
+        {
+          /* Perform the UDP TX poll */
 
-      bstop = callback(dev);
+          udp_poll(dev, conn);
+          sent = (dev->d_len > 0);
+
+          /* Call back into the driver */
+
+          bstop = callback(dev);
+        }
+      while (!bstop && sent && conn->txmore);
     }
 
   return bstop;
@@ -325,6 +336,12 @@ int devif_poll(FAR struct net_driver_s *dev, devif_poll_callback_t callback)
    * action.
    */
 
+#if defined(CONFIG_NET_ARP) && CONFIG_NET_ARP_PENDING > 0
+  /* Send packets that were waiting for address resolution */
+
+  bstop = arp_pending_poll(dev, callback);
+  if (!bstop)
+#endif
 #ifdef CONFIG_NET_ARP_SEND
   /* Check for pending ARP requests */
 
@@ -48,13 +48,55 @@
 
 #ifdef CONFIG_NET_IOB
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Is any size class throttled? */
+
+#if CONFIG_IOB_THROTTLE > 0 || CONFIG_IOB_LARGE_THROTTLE > 0
+#  define IOB_HAVE_THROTTLE 1
+#endif
+
+/* The size class of an I/O buffer */
+
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_POOLID(p) ((p)->io_pool)
+#else
+#  define IOB_POOLID(p) IOB_POOL_SMALL
+#endif
+
+/****************************************************************************
+ * Public Types
+ ****************************************************************************/
+
+/* The pool of pre-allocated I/O buffers of one size class */
+
+struct iob_pool_s
+{
+  FAR struct iob_s *ip_freelist; /* List of free I/O buffers */
+  sem_t ip_sem;                  /* Counts free I/O buffers */
+#ifdef IOB_HAVE_THROTTLE
+  sem_t ip_throttle;             /* Counts I/O buffers available when
+                                  * throttled */
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  uint16_t ip_bufsize;           /* Payload size of one I/O buffer */
+  uint16_t ip_nbuffers;          /* Number of I/O buffers in the pool */
+  uint16_t ip_minfree;           /* Lowest number of free I/O buffers */
+  uint32_t ip_nalloc;            /* Number of successful allocations */
+  uint32_t ip_nfail;             /* Failed allocations; pool exhausted */
+  uint32_t ip_nthrottled;        /* Allocations denied by the throttle */
+#endif
+};
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
 
-/* A list of all free, unallocated I/O buffers */
+/* The pools of free, unallocated I/O buffers, one per size class */
 
-extern FAR struct iob_s *g_iob_freelist;
+extern struct iob_pool_s g_iob_pools[IOB_NPOOLS];
 
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -62,12 +104,8 @@ extern FAR struct iob_s *g_iob_freelist;
 extern FAR struct iob_qentry_s *g_iob_freeqlist;
 #endif
 
-/* Counting semaphores that tracks the number of free IOBs/qentries */
+/* Counting semaphore that tracks the number of free qentries */
 
-extern sem_t g_iob_sem;       /* Counts free I/O buffers */
-#if CONFIG_IOB_THROTTLE > 0
-extern sem_t g_throttle_sem;  /* Counts available I/O buffers when throttled */
-#endif
 #if CONFIG_IOB_NCHAINS > 0
 extern sem_t g_qentry_sem;    /* Counts free I/O buffer queue containers */
 #endif
@@ -111,6 +149,18 @@ FAR struct iob_qentry_s *iob_tryalloc_qentry(void);
 
 FAR struct iob_s *iob_tryalloc(bool throttled);
 
+/****************************************************************************
+ * Name: iob_tryalloc_pool
+ *
+ * Description:
+ *   Try to allocate an I/O buffer of the size class 'pool' by taking the
+ *   buffer at the head of its free list without waiting for a buffer to
+ *   become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_pool(int pool, bool throttled);
+
 /****************************************************************************
  * Name: iob_free_qentry
  *
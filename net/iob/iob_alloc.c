@@ -52,6 +52,7 @@
 
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
+#include <nuttx/semaphore.h>
 #include <nuttx/net/iob.h>
 
 #include "iob.h"
@@ -76,12 +77,13 @@ static FAR struct iob_s *iob_allocwait(bool throttled)
   FAR sem_t *sem;
   int ret = OK;
 
-#if CONFIG_IOB_THROTTLE > 0
+#ifdef IOB_HAVE_THROTTLE
   /* Select the semaphore count to check. */
 
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+  sem = (throttled ? &g_iob_pools[IOB_POOL_SMALL].ip_throttle :
+                     &g_iob_pools[IOB_POOL_SMALL].ip_sem);
 #else
-  sem = &g_iob_sem;
+  sem = &g_iob_pools[IOB_POOL_SMALL].ip_sem;
 #endif
 
   /* The following must be atomic; interrupt must be disabled so that there
@@ -204,16 +206,80 @@ FAR struct iob_s *iob_alloc(bool throttled)
 
 FAR struct iob_s *iob_tryalloc(bool throttled)
 {
+  return iob_tryalloc_pool(IOB_POOL_SMALL, throttled);
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_sized
+ *
+ * Description:
+ *   Try to allocate an I/O buffer for 'len' bytes of data without waiting.
+ *   The buffer is taken from the smallest size class that holds 'len'
+ *   bytes (or from the largest class if none does).  If that class is
+ *   exhausted or throttled, a buffer of another class is returned, larger
+ *   classes first.  The caller must check IOB_BUFSIZE() and extend the
+ *   chain as necessary.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_sized(unsigned int len, bool throttled)
+{
+#ifdef CONFIG_IOB_LARGE
+  FAR struct iob_s *iob;
+
+  if (len > CONFIG_IOB_BUFSIZE)
+    {
+      /* Prefer one large I/O buffer, but a chain of small ones will do */
+
+      iob = iob_tryalloc_pool(IOB_POOL_LARGE, throttled);
+      if (iob == NULL)
+        {
+          iob = iob_tryalloc_pool(IOB_POOL_SMALL, throttled);
+        }
+    }
+  else
+    {
+      /* Do not waste a large I/O buffer unless the small ones are gone */
+
+      iob = iob_tryalloc_pool(IOB_POOL_SMALL, throttled);
+      if (iob == NULL)
+        {
+          iob = iob_tryalloc_pool(IOB_POOL_LARGE, throttled);
+        }
+    }
+
+  return iob;
+#else
+  return iob_tryalloc_pool(IOB_POOL_SMALL, throttled);
+#endif
+}
+
+/****************************************************************************
+ * Name: iob_tryalloc_pool
+ *
+ * Description:
+ *   Try to allocate an I/O buffer of the size class 'pool' by taking the
+ *   buffer at the head of its free list without waiting for a buffer to
+ *   become free.
+ *
+ ****************************************************************************/
+
+FAR struct iob_s *iob_tryalloc_pool(int pool, bool throttled)
+{
+  FAR struct iob_pool_s *ipool;
   FAR struct iob_s *iob;
   irqstate_t flags;
-#if CONFIG_IOB_THROTTLE > 0
+#ifdef IOB_HAVE_THROTTLE
   FAR sem_t *sem;
 #endif
 
-#if CONFIG_IOB_THROTTLE > 0
+  DEBUGASSERT(pool >= 0 && pool < IOB_NPOOLS);
+  ipool = &g_iob_pools[pool];
+
+#ifdef IOB_HAVE_THROTTLE
   /* Select the semaphore count to check. */
 
-  sem = (throttled ? &g_throttle_sem : &g_iob_sem);
+  sem = (throttled ? &ipool->ip_throttle : &ipool->ip_sem);
 #endif
 
   /* We don't know what context we are called from so we use extreme measures
@@ -222,7 +288,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
 
   flags = enter_critical_section();
 
-#if CONFIG_IOB_THROTTLE > 0
+#ifdef IOB_HAVE_THROTTLE
   /* If there are free I/O buffers for this allocation */
 
   if (sem->semcount > 0)
@@ -230,7 +296,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
     {
       /* Take the I/O buffer from the head of the free list */
 
-      iob = g_iob_freelist;
+      iob = ipool->ip_freelist;
       if (iob)
         {
           /* Remove the I/O buffer from the free list and decrement the
@@ -238,7 +304,7 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
            * IOBs.
            */
 
-          g_iob_freelist = iob->io_flink;
+          ipool->ip_freelist = iob->io_flink;
 
           /* Take a semaphore count.  Note that we cannot do this in
            * in the orthodox way by calling sem_wait() or sem_trywait()
@@ -247,16 +313,23 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
            * so a simple decrement is all that is needed.
            */
 
-          g_iob_sem.semcount--;
-          DEBUGASSERT(g_iob_sem.semcount >= 0);
+          (void)sem_count_dec(&ipool->ip_sem);
+          DEBUGASSERT(ipool->ip_sem.semcount >= 0);
 
-#if CONFIG_IOB_THROTTLE > 0
+#ifdef IOB_HAVE_THROTTLE
           /* The throttle semaphore is a little more complicated because
            * it can be negative!  Decrementing is still safe, however.
            */
 
-          g_throttle_sem.semcount--;
-          DEBUGASSERT(g_throttle_sem.semcount >= -CONFIG_IOB_THROTTLE);
+          (void)sem_count_dec(&ipool->ip_throttle);
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+          ipool->ip_nalloc++;
+          if (ipool->ip_sem.semcount < ipool->ip_minfree)
+            {
+              ipool->ip_minfree = ipool->ip_sem.semcount;
+            }
 #endif
           leave_critical_section(flags);
 
@@ -270,6 +343,19 @@ FAR struct iob_s *iob_tryalloc(bool throttled)
         }
     }
 
+#ifdef CONFIG_IOB_STATISTICS
+  /* Was the allocation denied with free I/O buffers in the pool? */
+
+  if (ipool->ip_freelist != NULL)
+    {
+      ipool->ip_nthrottled++;
+    }
+  else
+    {
+      ipool->ip_nfail++;
+    }
+#endif
+
   leave_critical_section(flags);
   return NULL;
 }
@@ -155,7 +155,7 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
               /* Yes.. We can extend this buffer to the up to the very end. */
 
-              maxlen = CONFIG_IOB_BUFSIZE - iob->io_offset;
+              maxlen = IOB_BUFSIZE(iob) - iob->io_offset;
 
               /* This is the new buffer length that we need.  Of course,
                * clipped to the maximum possible size in this buffer.
@@ -203,17 +203,15 @@ static int iob_copyin_internal(FAR struct iob_s *iob, FAR const uint8_t *src,
 
       if (len > 0 && !next)
         {
-          /* Yes.. allocate a new buffer.
+          /* Yes.. allocate a new buffer, preferably one that holds all of
+           * the remaining data.
            *
            * Copy as many bytes as possible.  If we have successfully copied
            * any already don't block, otherwise block if we're allowed.
            */
 
-          if (!can_block || len < total)
-            {
-              next = iob_tryalloc(throttled);
-            }
-          else
+          next = iob_tryalloc_sized(len, throttled);
+          if (next == NULL && can_block && len == total)
             {
               next = iob_alloc(throttled);
             }
@@ -72,6 +72,7 @@
 FAR struct iob_s *iob_free(FAR struct iob_s *iob)
 {
   FAR struct iob_s *next = iob->io_flink;
+  FAR struct iob_pool_s *ipool;
   irqstate_t flags;
 
   ninfo("iob=%p io_pktlen=%u io_len=%u next=%p\n",
@@ -108,20 +109,23 @@ FAR struct iob_s *iob_free(FAR struct iob_s *iob)
             next, next->io_pktlen, next->io_len);
     }
 
-  /* Free the I/O buffer by adding it to the head of the free list. We don't
-   * know what context we are called from so we use extreme measures to
-   * protect the free list:  We disable interrupts very briefly.
+  /* Free the I/O buffer by adding it to the head of the free list of its
+   * size class. We don't know what context we are called from so we use
+   * extreme measures to protect the free list:  We disable interrupts very
+   * briefly.
    */
 
+  ipool = &g_iob_pools[IOB_POOLID(iob)];
+
   flags = enter_critical_section();
-  iob->io_flink = g_iob_freelist;
-  g_iob_freelist = iob;
+  iob->io_flink = ipool->ip_freelist;
+  ipool->ip_freelist = iob;
 
   /* Signal that an IOB is available */
 
-  sem_post(&g_iob_sem);
-#if CONFIG_IOB_THROTTLE > 0
-  sem_post(&g_throttle_sem);
+  sem_post(&ipool->ip_sem);
+#ifdef IOB_HAVE_THROTTLE
+  sem_post(&ipool->ip_throttle);
 #endif
   leave_critical_section(flags);
 
@@ -46,6 +46,8 @@
 #  define CONFIG_DEBUG_NET 1
 #endif
 
+#include <stdint.h>
+#include <stddef.h>
 #include <stdbool.h>
 #include <semaphore.h>
 
@@ -53,6 +55,21 @@
 
 #include "iob.h"
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* With more than one size class, the payloads are kept in separate arrays.
+ * Each payload is padded to a multiple of 32-bits so that all payloads are
+ * aligned like the packet buffer of a network device.
+ */
+
+#ifdef CONFIG_IOB_LARGE
+#  define IOB_NWORDS(n)     (((n) + 3) >> 2)
+#  define IOB_SMALL_NWORDS  IOB_NWORDS(CONFIG_IOB_BUFSIZE)
+#  define IOB_LARGE_NWORDS  IOB_NWORDS(CONFIG_IOB_LARGE_BUFSIZE)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -60,6 +77,12 @@
 /* This is a pool of pre-allocated I/O buffers */
 
 static struct iob_s        g_iob_pool[CONFIG_IOB_NBUFFERS];
+#ifdef CONFIG_IOB_LARGE
+static struct iob_s        g_iob_largepool[CONFIG_IOB_LARGE_NBUFFERS];
+static uint32_t            g_iob_data[CONFIG_IOB_NBUFFERS * IOB_SMALL_NWORDS];
+static uint32_t            g_iob_largedata[CONFIG_IOB_LARGE_NBUFFERS *
+                                           IOB_LARGE_NWORDS];
+#endif
 #if CONFIG_IOB_NCHAINS > 0
 static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
 #endif
@@ -68,9 +91,9 @@ static struct iob_qentry_s g_iob_qpool[CONFIG_IOB_NCHAINS];
  * Public Data
  ****************************************************************************/
 
-/* A list of all free, unallocated I/O buffers */
+/* The pools of free, unallocated I/O buffers, one per size class */
 
-FAR struct iob_s *g_iob_freelist;
+struct iob_pool_s g_iob_pools[IOB_NPOOLS];
 
 /* A list of all free, unallocated I/O buffer queue containers */
 
@@ -78,16 +101,63 @@ FAR struct iob_s *g_iob_freelist;
 FAR struct iob_qentry_s *g_iob_freeqlist;
 #endif
 
-/* Counting semaphores that tracks the number of free IOBs/qentries */
+/* Counting semaphore that tracks the number of free qentries */
 
-sem_t g_iob_sem;            /* Counts free I/O buffers */
-#if CONFIG_IOB_THROTTLE > 0
-sem_t g_throttle_sem;       /* Counts available I/O buffers when throttled */
-#endif
 #if CONFIG_IOB_NCHAINS > 0
 sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 #endif
 
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_initpool
+ *
+ * Description:
+ *   Add the 'nbuffers' I/O buffers 'iobs' to the free list of the size
+ *   class 'pool'.  With more than one size class, each I/O buffer is given
+ *   'bufsize' bytes of the payload array 'data'.
+ *
+ ****************************************************************************/
+
+static void iob_initpool(int pool, FAR struct iob_s *iobs,
+                         FAR uint32_t *data, int nbuffers, int bufsize,
+                         int throttle)
+{
+  FAR struct iob_pool_s *ipool = &g_iob_pools[pool];
+  int i;
+
+  for (i = 0; i < nbuffers; i++)
+    {
+      FAR struct iob_s *iob = &iobs[i];
+
+#ifdef CONFIG_IOB_LARGE
+      /* Assign the payload and the size class */
+
+      iob->io_pool = pool;
+      iob->io_data = (FAR uint8_t *)&data[i * IOB_NWORDS(bufsize)];
+#endif
+
+      /* Add the pre-allocate I/O buffer to the head of the free list */
+
+      iob->io_flink      = ipool->ip_freelist;
+      ipool->ip_freelist = iob;
+    }
+
+  sem_init(&ipool->ip_sem, 0, nbuffers);
+
+#ifdef IOB_HAVE_THROTTLE
+  sem_init(&ipool->ip_throttle, 0, nbuffers - throttle);
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+  ipool->ip_bufsize  = bufsize;
+  ipool->ip_nbuffers = nbuffers;
+  ipool->ip_minfree  = nbuffers;
+#endif
+}
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -103,28 +173,27 @@ sem_t g_qentry_sem;         /* Counts free I/O buffer queue containers */
 void iob_initialize(void)
 {
   static bool initialized = false;
+#if CONFIG_IOB_NCHAINS > 0
   int i;
+#endif
 
   /* Perform one-time initialization */
 
   if (!initialized)
     {
-      /* Add each I/O buffer to the free list */
-
-      for (i = 0; i < CONFIG_IOB_NBUFFERS; i++)
-        {
-          FAR struct iob_s *iob = &g_iob_pool[i];
-
-          /* Add the pre-allocate I/O buffer to the head of the free list */
-
-          iob->io_flink  = g_iob_freelist;
-          g_iob_freelist = iob;
-        }
-
-      sem_init(&g_iob_sem, 0, CONFIG_IOB_NBUFFERS);
-
-#if CONFIG_IOB_THROTTLE > 0
-      sem_init(&g_throttle_sem, 0, CONFIG_IOB_NBUFFERS - CONFIG_IOB_THROTTLE);
+      /* Add each I/O buffer to the free list of its size class */
+
+#ifdef CONFIG_IOB_LARGE
+      iob_initpool(IOB_POOL_SMALL, g_iob_pool, g_iob_data,
+                   CONFIG_IOB_NBUFFERS, CONFIG_IOB_BUFSIZE,
+                   CONFIG_IOB_THROTTLE);
+      iob_initpool(IOB_POOL_LARGE, g_iob_largepool, g_iob_largedata,
+                   CONFIG_IOB_LARGE_NBUFFERS, CONFIG_IOB_LARGE_BUFSIZE,
+                   CONFIG_IOB_LARGE_THROTTLE);
+#else
+      iob_initpool(IOB_POOL_SMALL, g_iob_pool, NULL,
+                   CONFIG_IOB_NBUFFERS, CONFIG_IOB_BUFSIZE,
+                   CONFIG_IOB_THROTTLE);
 #endif
 
 #if CONFIG_IOB_NCHAINS > 0
@@ -0,0 +1,102 @@
+/****************************************************************************
+ * net/iob/iob_statistics.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <errno.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/net/iob.h>
+
+#include "iob.h"
+
+#ifdef CONFIG_IOB_STATISTICS
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: iob_statistics
+ *
+ * Description:
+ *   Return the usage statistics of one I/O buffer size class.
+ *
+ * Input Parameters:
+ *   pool  - The size class, one of IOB_POOL_*
+ *   stats - Location to return the statistics
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; -EINVAL is returned if 'pool' is
+ *   not a valid size class.
+ *
+ ****************************************************************************/
+
+int iob_statistics(int pool, FAR struct iob_stats_s *stats)
+{
+  FAR struct iob_pool_s *ipool;
+  irqstate_t flags;
+  int nfree;
+
+  if (pool < 0 || pool >= IOB_NPOOLS)
+    {
+      return -EINVAL;
+    }
+
+  ipool = &g_iob_pools[pool];
+
+  /* Take a consistent snapshot of the counts */
+
+  flags = enter_critical_section();
+
+  nfree = ipool->ip_sem.semcount;
+  stats->is_bufsize    = ipool->ip_bufsize;
+  stats->is_nbuffers   = ipool->ip_nbuffers;
+  stats->is_nfree      = nfree > 0 ? nfree : 0;
+  stats->is_minfree    = ipool->ip_minfree;
+  stats->is_nalloc     = ipool->ip_nalloc;
+  stats->is_nfail      = ipool->ip_nfail;
+  stats->is_nthrottled = ipool->ip_nthrottled;
+
+  leave_critical_section(flags);
+  return OK;
+}
+
+#endif /* CONFIG_IOB_STATISTICS */
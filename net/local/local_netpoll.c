@@ -53,6 +53,28 @@
 
 #ifdef HAVE_LOCAL_POLL
 
+/****************************************************************************
+ * Function: local_shadow_notify
+ *
+ * Description:
+ *   Notification callback of the shadow pollfds used to monitor both the
+ *   input and the output FIFO of a connected stream socket:  Pass the
+ *   events on to the caller's pollfd so that they are reported at once,
+ *   also when the caller's pollfd was set up with a callback (as by
+ *   epoll).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_LOCAL_STREAM
+static void local_shadow_notify(FAR struct pollfd *shadowfd)
+{
+  FAR struct pollfd *fds = (FAR struct pollfd *)shadowfd->arg;
+
+  fds->revents |= shadowfd->revents;
+  poll_notify(fds);
+}
+#endif
+
 /****************************************************************************
  * Function: local_accept_pollsetup
  ****************************************************************************/
@@ -152,7 +174,7 @@ void local_accept_pollnotify(FAR struct local_conn_s *conn,
           if (fds->revents != 0)
             {
               ninfo("Report events: %02x\n", fds->revents);
-              sem_post(fds->sem);
+              poll_notify(fds);
             }
         }
     }
@@ -225,10 +247,14 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
           shadowfds[0].fd = conn->lc_infd;
           shadowfds[0].sem = fds->sem;
           shadowfds[0].events = fds->events & ~POLLOUT;
+          shadowfds[0].cb = local_shadow_notify;
+          shadowfds[0].arg = fds;
 
           shadowfds[1].fd = conn->lc_outfd;
           shadowfds[1].sem = fds->sem;
           shadowfds[1].events = fds->events & ~POLLIN;
+          shadowfds[1].cb = local_shadow_notify;
+          shadowfds[1].arg = fds;
 
           /* Setup poll for both shadow pollfds. */
 
@@ -294,7 +320,7 @@ int local_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds)
 
 pollerr:
   fds->revents |= POLLERR;
-  sem_post(fds->sem);
+  poll_notify(fds);
   return OK;
 }
 
@@ -47,6 +47,8 @@
 
 #include <stdint.h>
 
+#include <stdint.h>
+#include <queue.h>
 #include <net/ethernet.h>
 
 #include <nuttx/clock.h>
@@ -64,6 +66,10 @@
 
 #define NEIGHBOR_MAXTIME 128
 
+/* The number of hash buckets is the same as the number of entries */
+
+#define NEIGHBOR_NHASH CONFIG_NET_IPv6_NCONF_ENTRIES
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -80,10 +86,15 @@ struct neighbor_addr_s
 
 /* This structure describes on entry in the neighbor table.  This is intended
  * for internal use within the Neighbor implementation.
+ *
+ * Every entry is in the LRU list, least recently used first.  Entries that
+ * hold an address are also in the hash bucket chain for that address.
  */
 
 struct neighbor_entry
 {
+  dq_entry_t             ne_node;    /* LRU list link (must be first) */
+  FAR struct neighbor_entry *ne_hnext; /* Hash bucket chain */
   net_ipv6addr_t         ne_ipaddr;  /* IPv6 address of the Neighbor */
   struct neighbor_addr_s ne_addr;    /* Link layer address of the Neighbor */
   uint8_t                ne_time;    /* For aging, units of half seconds */
@@ -99,10 +110,36 @@ struct neighbor_entry
 
 extern struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash buckets and the LRU list of the Neighbor table */
+
+extern FAR struct neighbor_entry *g_nbhash[NEIGHBOR_NHASH];
+extern dq_queue_t g_nblru;
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: neighbor_hash
+ *
+ * Description:
+ *   Return the hash bucket for an IPv6 address.  Only the interface
+ *   identifier part of the address is hashed.
+ *
+ ****************************************************************************/
+
+static inline FAR struct neighbor_entry **
+neighbor_hash(const net_ipv6addr_t ipaddr)
+{
+  uint32_t hash;
+
+  hash = ((uint32_t)ipaddr[4] << 16 | ipaddr[5]) ^
+         ((uint32_t)ipaddr[6] << 16 | ipaddr[7]);
+  hash *= 2654435761u;
+
+  return &g_nbhash[(hash >> 16) % NEIGHBOR_NHASH];
+}
+
 /****************************************************************************
  * Name: neighbor_initialize
  *
@@ -128,6 +165,7 @@ void neighbor_initialize(void);
  * Description:
  *   Find an entry in the Neighbor Table.  This interface is internal to
  *   the neighbor implementation; Consider using neighbor_lookup() instead;
+ *   Expired entries are not returned.
  *
  * Input Parameters:
  *   ipaddr - The IPv6 address to use in the lookup;
@@ -44,6 +44,7 @@
 #include <nuttx/config.h>
 
 #include <string.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <nuttx/net/ip.h>
@@ -72,9 +73,8 @@
 
 void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
 {
-  uint8_t oldest_time;
-  int     oldest_ndx;
-  int     i;
+  FAR struct neighbor_entry **pprev;
+  FAR struct neighbor_entry *neighbor;
 
   ninfo("Add neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
         ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
@@ -88,37 +88,54 @@ void neighbor_add(FAR net_ipv6addr_t ipaddr, FAR struct neighbor_addr_s *addr)
         addr->na_addr.ether_addr_octet[4],
         addr->na_addr.ether_addr_octet[5]);
 
-  /* Find the first unused entry or the oldest used entry. */
+  /* Is there already an entry for this address (expired or not)? */
 
-  oldest_time = 0;
-  oldest_ndx  = 0;
-
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *neighbor_hash(ipaddr);
+       neighbor != NULL;
+       neighbor = neighbor->ne_hnext)
     {
-      if (g_neighbors[i].ne_time == NEIGHBOR_MAXTIME)
+      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
-          oldest_ndx = i;
           break;
         }
+    }
 
-      if (net_ipv6addr_cmp(g_neighbors[i].ne_ipaddr, ipaddr))
-        {
-          oldest_ndx = i;
-          break;
-        }
+  if (neighbor == NULL)
+    {
+      /* No.. Replace the least recently used entry.  Unused and expired
+       * entries are always at the head of the LRU list.
+       */
 
-      if (g_neighbors[i].ne_time > oldest_time)
+      neighbor = (FAR struct neighbor_entry *)dq_peek(&g_nblru);
+      DEBUGASSERT(neighbor != NULL);
+
+      /* Remove it from the hash bucket chain of its old address */
+
+      for (pprev = neighbor_hash(neighbor->ne_ipaddr);
+           *pprev != NULL;
+           pprev = &(*pprev)->ne_hnext)
         {
-          oldest_ndx = i;
-          oldest_time = g_neighbors[i].ne_time;
+          if (*pprev == neighbor)
+            {
+              *pprev = neighbor->ne_hnext;
+              break;
+            }
         }
+
+      /* And add it to the chain of the new address */
+
+      net_ipv6addr_copy(neighbor->ne_ipaddr, ipaddr);
+
+      pprev              = neighbor_hash(ipaddr);
+      neighbor->ne_hnext = *pprev;
+      *pprev             = neighbor;
     }
 
-  /* Use the oldest or first free entry (either pointed to by the
-   * "oldest_ndx" variable).
-   */
+  /* Make this the most recently used entry */
+
+  dq_rem(&neighbor->ne_node, &g_nblru);
+  dq_addlast(&neighbor->ne_node, &g_nblru);
 
-  g_neighbors[oldest_ndx].ne_time = 0;
-  net_ipv6addr_copy(g_neighbors[oldest_ndx].ne_ipaddr, ipaddr);
-  memcpy(&g_neighbors[oldest_ndx].ne_addr, addr, sizeof(struct neighbor_addr_s));
+  neighbor->ne_time = 0;
+  memcpy(&neighbor->ne_addr, addr, sizeof(struct neighbor_addr_s));
 }
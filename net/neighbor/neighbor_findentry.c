@@ -49,7 +49,7 @@
 #include "neighbor/neighbor.h"
 
 /****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
@@ -70,18 +70,19 @@
 
 FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
 {
-  int i;
+  FAR struct neighbor_entry *neighbor;
 
   ninfo("Find neighbor: %04x:%04x:%04x:%04x:%04x:%04x:%04x:%04x\n",
         ntohs(ipaddr[0]), ntohs(ipaddr[1]), ntohs(ipaddr[2]),
         ntohs(ipaddr[3]), ntohs(ipaddr[4]), ntohs(ipaddr[5]),
         ntohs(ipaddr[6]), ntohs(ipaddr[7]));
 
-  for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
+  for (neighbor = *neighbor_hash(ipaddr);
+       neighbor != NULL;
+       neighbor = neighbor->ne_hnext)
     {
-      FAR struct neighbor_entry *neighbor = &g_neighbors[i];
-
-      if (net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
+      if (neighbor->ne_time < NEIGHBOR_MAXTIME &&
+          net_ipv6addr_cmp(neighbor->ne_ipaddr, ipaddr))
         {
           ninfo("  at: %02x:%02x:%02x:%02x:%02x:%02x\n",
                 neighbor->ne_addr.na_addr.ether_addr_octet[0],
@@ -91,7 +92,7 @@ FAR struct neighbor_entry *neighbor_findentry(const net_ipv6addr_t ipaddr)
                 neighbor->ne_addr.na_addr.ether_addr_octet[4],
                 neighbor->ne_addr.na_addr.ether_addr_octet[5]);
 
-          return &g_neighbors[i];
+          return neighbor;
         }
     }
 
@@ -56,6 +56,11 @@
 
 struct neighbor_entry g_neighbors[CONFIG_NET_IPv6_NCONF_ENTRIES];
 
+/* Hash buckets and the LRU list of the Neighbor table */
+
+FAR struct neighbor_entry *g_nbhash[NEIGHBOR_NHASH];
+dq_queue_t g_nblru;
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -81,8 +86,17 @@ void neighbor_initialize(void)
 {
   int i;
 
+  dq_init(&g_nblru);
+
   for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
     {
-      g_neighbors[i].ne_time = NEIGHBOR_MAXTIME;
+      g_neighbors[i].ne_hnext = NULL;
+      g_neighbors[i].ne_time  = NEIGHBOR_MAXTIME;
+      dq_addlast(&g_neighbors[i].ne_node, &g_nblru);
+    }
+
+  for (i = 0; i < NEIGHBOR_NHASH; ++i)
+    {
+      g_nbhash[i] = NULL;
     }
 }
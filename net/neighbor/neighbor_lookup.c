@@ -76,6 +76,11 @@ FAR const struct neighbor_addr_s *neighbor_lookup(const net_ipv6addr_t ipaddr)
   neighbor = neighbor_findentry(ipaddr);
   if (neighbor != NULL)
     {
+      /* Make this the most recently used entry */
+
+      dq_rem(&neighbor->ne_node, &g_nblru);
+      dq_addlast(&neighbor->ne_node, &g_nblru);
+
       ninfo("Lookup neighbor: %02x:%02x:%02x:%02x:%02x:%02x\n",
             neighbor->ne_addr.na_addr.ether_addr_octet[0],
             neighbor->ne_addr.na_addr.ether_addr_octet[1],
@@ -78,13 +78,25 @@ void neighbor_periodic(int hsec)
 
       for (i = 0; i < CONFIG_NET_IPv6_NCONF_ENTRIES; ++i)
         {
-          uint32_t newtime = g_neighbors[i].ne_time + hsec;
-          if (newtime > NEIGHBOR_MAXTIME)
+          FAR struct neighbor_entry *neighbor = &g_neighbors[i];
+          uint32_t newtime;
+
+          if (neighbor->ne_time >= NEIGHBOR_MAXTIME)
             {
+              continue;
+            }
+
+          newtime = neighbor->ne_time + hsec;
+          if (newtime >= NEIGHBOR_MAXTIME)
+            {
+              /* The entry has expired.  Make it the first to be reused. */
+
               newtime = NEIGHBOR_MAXTIME;
+              dq_rem(&neighbor->ne_node, &g_nblru);
+              dq_addfirst(&neighbor->ne_node, &g_nblru);
             }
 
-          g_neighbors[i].ne_time = newtime;
+          neighbor->ne_time = newtime;
         }
     }
 }
@@ -73,5 +73,8 @@ void neighbor_update(const net_ipv6addr_t ipaddr)
   if (neighbor != NULL)
     {
       neighbor->ne_time = 0;
+
+      dq_rem(&neighbor->ne_node, &g_nblru);
+      dq_addlast(&neighbor->ne_node, &g_nblru);
     }
 }
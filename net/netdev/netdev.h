@@ -47,6 +47,22 @@
 
 #include <nuttx/net/ip.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Take and release the lock that serializes calls into the driver of a
+ * device.  Without CONFIG_NET_FINE_LOCKS, that is the network lock.
+ */
+
+#ifdef CONFIG_NET_FINE_LOCKS
+#  define netdev_lock(dev)   net_rmutex_lock(&(dev)->d_lock)
+#  define netdev_unlock(dev) net_rmutex_unlock(&(dev)->d_lock)
+#else
+#  define netdev_lock(dev)   net_lock()
+#  define netdev_unlock(dev) net_unlock()
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -0,0 +1,774 @@
+/****************************************************************************
+ * net/netdev/netdev_iob.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NETDEV_IOB)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <assert.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/ethernet.h>
+#include <nuttx/net/arp.h>
+#include <nuttx/net/pkt.h>
+#include <nuttx/net/tcp.h>
+#include <nuttx/net/iob.h>
+
+#include "iob/iob.h"
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Each frame is processed in place, so the largest frame must fit into a
+ * single I/O buffer.  Frames are held in the smallest I/O buffer size class
+ * that is large enough.
+ */
+
+#define NETDEV_IOB_FRAMELEN (MAX_NET_DEV_MTU + CONFIG_NET_GUARDSIZE)
+
+#if CONFIG_IOB_BUFSIZE >= NETDEV_IOB_FRAMELEN
+#  define NETDEV_IOB_POOL IOB_POOL_SMALL
+#elif defined(CONFIG_IOB_LARGE) && \
+      CONFIG_IOB_LARGE_BUFSIZE >= NETDEV_IOB_FRAMELEN
+#  define NETDEV_IOB_POOL IOB_POOL_LARGE
+#else
+#  error No I/O buffer size class can hold a complete frame
+#endif
+
+#define ETHBUF ((FAR struct eth_hdr_s *)&dev->d_buf[0])
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+typedef int (*netdev_poll_t)(FAR struct net_driver_s *dev,
+                             devif_poll_callback_t callback);
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_iob_isether
+ *
+ * Description:
+ *   Return true if the device uses an Ethernet link layer and, hence,
+ *   requires ARP and IPv6 neighbor resolution.
+ *
+ ****************************************************************************/
+
+static inline bool netdev_iob_isether(FAR struct net_driver_s *dev)
+{
+#if defined(CONFIG_NET_MULTILINK)
+  return dev->d_lltype == NET_LL_ETHERNET;
+#elif defined(CONFIG_NET_ETHERNET)
+  return true;
+#else
+  return false;
+#endif
+}
+
+/****************************************************************************
+ * Function: netdev_iob_llout
+ *
+ * Description:
+ *   Add the Ethernet header to an outgoing IP packet.  The packet may be
+ *   replaced with an ARP request or an IPv6 neighbor solicitation if the
+ *   destination MAC address is not yet known.
+ *
+ ****************************************************************************/
+
+static void netdev_iob_llout(FAR struct net_driver_s *dev)
+{
+  if (netdev_iob_isether(dev))
+    {
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (IFF_IS_IPv4(dev->d_flags))
+#endif
+        {
+          arp_out(dev);
+        }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          neighbor_out(dev);
+        }
+#endif /* CONFIG_NET_IPv6 */
+    }
+}
+
+/****************************************************************************
+ * Function: netdev_iob_attach
+ *
+ * Description:
+ *   Make the I/O buffer iob the packet buffer of the device.
+ *
+ ****************************************************************************/
+
+static void netdev_iob_attach(FAR struct net_driver_s *dev,
+                              FAR struct iob_s *iob)
+{
+  dev->d_iob = iob;
+  dev->d_buf = iob->io_data;
+  dev->d_len = iob->io_len;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_detach
+ *
+ * Description:
+ *   Release any I/O buffer still attached to the device.
+ *
+ ****************************************************************************/
+
+static void netdev_iob_detach(FAR struct net_driver_s *dev)
+{
+  if (dev->d_iob != NULL)
+    {
+      iob_free_chain(dev->d_iob);
+    }
+
+  dev->d_iob = NULL;
+  dev->d_buf = NULL;
+  dev->d_len = 0;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_transmit
+ *
+ * Description:
+ *   Pass a frame to the driver.  Ownership of the I/O buffer passes to the
+ *   driver.  If the driver does not accept the frame, it is dropped.
+ *
+ ****************************************************************************/
+
+static int netdev_iob_transmit(FAR struct net_driver_s *dev,
+                               FAR struct iob_s *iob)
+{
+  int ret;
+
+  ret = dev->d_transmit(dev, iob);
+  if (ret < 0)
+    {
+      nerr("ERROR: d_transmit failed: %d\n", ret);
+      NETDEV_TXERRORS(dev);
+      iob_free_chain(iob);
+    }
+
+  return ret;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_detachframe
+ *
+ * Description:
+ *   Detach the I/O buffer holding the d_len bytes frame from the device
+ *   and set up the I/O buffer lengths to describe the frame.
+ *
+ ****************************************************************************/
+
+static FAR struct iob_s *netdev_iob_detachframe(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob = dev->d_iob;
+
+  DEBUGASSERT(iob != NULL && iob->io_flink == NULL &&
+              dev->d_len <= IOB_BUFSIZE(iob));
+
+  iob->io_offset = 0;
+  iob->io_len    = dev->d_len;
+  iob->io_pktlen = dev->d_len;
+
+  dev->d_iob     = NULL;
+  dev->d_buf     = NULL;
+  return iob;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_send
+ *
+ * Description:
+ *   Pass the d_len bytes frame in the attached I/O buffer to the driver.
+ *   The I/O buffer is detached from the device; ownership passes to the
+ *   driver.
+ *
+ ****************************************************************************/
+
+static int netdev_iob_send(FAR struct net_driver_s *dev)
+{
+  return netdev_iob_transmit(dev, netdev_iob_detachframe(dev));
+}
+
+/****************************************************************************
+ * Function: netdev_iob_getu32
+ *
+ * Description:
+ *   Return a 32-bit value stored in network byte order.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+static inline uint32_t netdev_iob_getu32(FAR const uint8_t *value)
+{
+  return ((uint32_t)value[0] << 24) | ((uint32_t)value[1] << 16) |
+         ((uint32_t)value[2] << 8)  |  (uint32_t)value[3];
+}
+#endif
+
+/****************************************************************************
+ * Function: netdev_iob_pureack
+ *
+ * Description:
+ *   Check if an outgoing frame is a pure TCP ACK:  A TCP segment with no
+ *   payload, no TCP options, no IP options, and only the ACK flag set.
+ *
+ * Parameters:
+ *   dev     - The network device
+ *   iob     - The I/O buffer holding the frame
+ *   addr    - Location to return the address of the IP source and
+ *             destination addresses in the frame
+ *   addrlen - Location to return the size of both IP addresses
+ *
+ * Returned Value:
+ *   A reference to the TCP header or NULL if the frame is not a pure ACK.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP
+static FAR struct tcp_hdr_s *
+  netdev_iob_pureack(FAR struct net_driver_s *dev, FAR struct iob_s *iob,
+                     FAR uint8_t **addr, FAR unsigned int *addrlen)
+{
+  FAR struct tcp_hdr_s *tcp = NULL;
+  FAR uint8_t *ip = &iob->io_data[NET_LL_HDRLEN(dev)];
+  unsigned int vers;
+
+  if (iob->io_len < NET_LL_HDRLEN(dev) + IPv4_HDRLEN + TCP_HDRLEN)
+    {
+      return NULL;
+    }
+
+  /* Get the IP version from the Ethernet type or the IP header */
+
+  if (netdev_iob_isether(dev))
+    {
+      FAR struct eth_hdr_s *eth = (FAR struct eth_hdr_s *)iob->io_data;
+
+      vers = eth->type == HTONS(ETHTYPE_IP)  ? 4 :
+             eth->type == HTONS(ETHTYPE_IP6) ? 6 : 0;
+    }
+  else
+    {
+      vers = ip[0] >> 4;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (vers == 4)
+    {
+      FAR struct ipv4_hdr_s *ipv4 = (FAR struct ipv4_hdr_s *)ip;
+
+      if (ipv4->vhl == 0x45 && ipv4->proto == IP_PROTO_TCP &&
+          ((ipv4->len[0] << 8) | ipv4->len[1]) == IPv4_HDRLEN + TCP_HDRLEN)
+        {
+          *addr    = (FAR uint8_t *)ipv4->srcipaddr;
+          *addrlen = 2 * sizeof(in_addr_t);
+          tcp      = (FAR struct tcp_hdr_s *)&ip[IPv4_HDRLEN];
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (vers == 6 &&
+      iob->io_len >= NET_LL_HDRLEN(dev) + IPv6_HDRLEN + TCP_HDRLEN)
+    {
+      FAR struct ipv6_hdr_s *ipv6 = (FAR struct ipv6_hdr_s *)ip;
+
+      if (ipv6->proto == IP_PROTO_TCP &&
+          ((ipv6->len[0] << 8) | ipv6->len[1]) == TCP_HDRLEN)
+        {
+          *addr    = (FAR uint8_t *)ipv6->srcipaddr;
+          *addrlen = 2 * sizeof(net_ipv6addr_t);
+          tcp      = (FAR struct tcp_hdr_s *)&ip[IPv6_HDRLEN];
+        }
+    }
+#endif
+
+  if (tcp != NULL &&
+      (tcp->flags & TCP_CTL) == TCP_ACK &&
+      tcp->tcpoffset == (TCP_HDRLEN / 4) << 4)
+    {
+      return tcp;
+    }
+
+  return NULL;
+}
+#endif /* CONFIG_NET_TCP */
+
+/****************************************************************************
+ * Function: netdev_iob_xmit
+ *
+ * Description:
+ *   Pass a response frame generated while processing a batch of received
+ *   frames to the driver.
+ *
+ *   A pure TCP ACK is not sent immediately but retained in *pendack.  If
+ *   the next response is a pure ACK for the same connection that
+ *   acknowledges more data, it supersedes the retained ACK which is then
+ *   discarded.  Otherwise, the retained ACK is sent first.  Duplicate ACKs
+ *   are never coalesced since the peer relies on them for fast
+ *   retransmission.
+ *
+ ****************************************************************************/
+
+static void netdev_iob_xmit(FAR struct net_driver_s *dev,
+                            FAR struct iob_s **pendack)
+{
+  FAR struct iob_s *iob = netdev_iob_detachframe(dev);
+#ifdef CONFIG_NET_TCP
+  FAR struct iob_s *prev = *pendack;
+  FAR struct tcp_hdr_s *tcp;
+  FAR struct tcp_hdr_s *prevtcp;
+  FAR uint8_t *addr;
+  FAR uint8_t *prevaddr;
+  unsigned int addrlen;
+  unsigned int prevlen;
+
+  tcp = netdev_iob_pureack(dev, iob, &addr, &addrlen);
+  if (tcp != NULL)
+    {
+      if (prev != NULL)
+        {
+          prevtcp = netdev_iob_pureack(dev, prev, &prevaddr, &prevlen);
+          if (prevtcp != NULL && prevlen == addrlen &&
+              memcmp(prevaddr, addr, addrlen) == 0 &&
+              prevtcp->srcport == tcp->srcport &&
+              prevtcp->destport == tcp->destport &&
+              (int32_t)(netdev_iob_getu32(tcp->ackno) -
+                        netdev_iob_getu32(prevtcp->ackno)) > 0)
+            {
+              NETDEV_TXACKCOAL(dev);
+              iob_free_chain(prev);
+            }
+          else
+            {
+              (void)netdev_iob_transmit(dev, prev);
+            }
+        }
+
+      *pendack = iob;
+      return;
+    }
+
+  /* Not a pure ACK.  Preserve the order of the frames */
+
+  if (prev != NULL)
+    {
+      *pendack = NULL;
+      (void)netdev_iob_transmit(dev, prev);
+    }
+#endif
+
+  (void)netdev_iob_transmit(dev, iob);
+}
+
+/****************************************************************************
+ * Function: netdev_iob_prepare
+ *
+ * Description:
+ *   Attach a newly allocated, empty I/O buffer to the device in which the
+ *   next outgoing frame can be built.
+ *
+ * Returned Value:
+ *   true on success; false if no I/O buffer is available.
+ *
+ ****************************************************************************/
+
+static bool netdev_iob_prepare(FAR struct net_driver_s *dev)
+{
+  FAR struct iob_s *iob;
+
+  /* We must not wait for an I/O buffer here:  The network is locked and
+   * only the network can free I/O buffers.
+   */
+
+  iob = iob_tryalloc_pool(NETDEV_IOB_POOL, false);
+  if (iob == NULL)
+    {
+      return false;
+    }
+
+  netdev_iob_attach(dev, iob);
+  return true;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_rxframe
+ *
+ * Description:
+ *   Process one received frame in place and send any response.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void netdev_iob_rxframe(FAR struct net_driver_s *dev,
+                               FAR struct iob_s *iob,
+                               FAR struct iob_s **pendack)
+{
+  bool ipout = false;
+
+  /* The network expects the frame to begin at d_buf[0] and to be
+   * contiguous.  This is normally the case; otherwise, the frame must be
+   * copied to the beginning of the first I/O buffer.
+   */
+
+  if (iob->io_pktlen == 0)
+    {
+      NETDEV_RXDROPPED(dev);
+      iob_free_chain(iob);
+      return;
+    }
+
+#ifdef CONFIG_IOB_LARGE
+  /* Any response is built in the same I/O buffer, so a frame that was
+   * received into I/O buffers of a smaller size class is copied.
+   */
+
+  if (IOB_BUFSIZE(iob) < NETDEV_IOB_FRAMELEN &&
+      iob->io_pktlen <= NETDEV_IOB_FRAMELEN)
+    {
+      FAR struct iob_s *frame;
+
+      frame = iob_tryalloc_pool(NETDEV_IOB_POOL, false);
+      if (frame == NULL)
+        {
+          NETDEV_RXDROPPED(dev);
+          iob_free_chain(iob);
+          return;
+        }
+
+      frame->io_len    = iob_copyout(frame->io_data, iob, iob->io_pktlen, 0);
+      frame->io_pktlen = frame->io_len;
+
+      iob_free_chain(iob);
+      iob = frame;
+    }
+#endif
+
+  if (iob->io_offset != 0 || iob->io_flink != NULL)
+    {
+      iob = iob_pack(iob);
+      if (iob->io_flink != NULL)
+        {
+          nwarn("WARNING: Dropping oversized frame: %u\n", iob->io_pktlen);
+          NETDEV_RXDROPPED(dev);
+          iob_free_chain(iob);
+          return;
+        }
+    }
+
+  netdev_iob_attach(dev, iob);
+
+#ifdef CONFIG_NET_PKT
+  /* When packet sockets are enabled, feed the frame into the packet tap */
+
+  pkt_input(dev);
+#endif
+
+  if (netdev_iob_isether(dev))
+    {
+      /* Dispatch on the Ethernet type */
+
+#ifdef CONFIG_NET_IPv4
+      if (ETHBUF->type == HTONS(ETHTYPE_IP))
+        {
+          NETDEV_RXIPV4(dev);
+
+          /* Handle ARP on input then give the IPv4 packet to the network
+           * layer.
+           */
+
+          arp_ipin(dev);
+          ipv4_input(dev);
+          ipout = true;
+        }
+      else
+#endif
+#ifdef CONFIG_NET_IPv6
+      if (ETHBUF->type == HTONS(ETHTYPE_IP6))
+        {
+          NETDEV_RXIPV6(dev);
+          ipv6_input(dev);
+          ipout = true;
+        }
+      else
+#endif
+#ifdef CONFIG_NET_ARP
+      if (ETHBUF->type == HTONS(ETHTYPE_ARP))
+        {
+          NETDEV_RXARP(dev);
+          arp_arpin(dev);
+        }
+      else
+#endif
+        {
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+
+      /* An IP response needs an Ethernet header */
+
+      if (ipout && dev->d_len > 0)
+        {
+          netdev_iob_llout(dev);
+        }
+    }
+  else
+    {
+      /* There is no link layer header:  Dispatch on the IP version */
+
+#ifdef CONFIG_NET_IPv4
+      if ((dev->d_buf[0] & 0xf0) == 0x40)
+        {
+          NETDEV_RXIPV4(dev);
+          ipv4_input(dev);
+        }
+      else
+#endif
+#ifdef CONFIG_NET_IPv6
+      if ((dev->d_buf[0] & 0xf0) == 0x60)
+        {
+          NETDEV_RXIPV6(dev);
+          ipv6_input(dev);
+        }
+      else
+#endif
+        {
+          NETDEV_RXDROPPED(dev);
+          dev->d_len = 0;
+        }
+    }
+
+  /* If processing the frame resulted in data that should be sent out on
+   * the network, the field d_len will set to a value > 0.  The response
+   * re-uses the I/O buffer of the received frame.
+   */
+
+  if (dev->d_len > 0)
+    {
+      netdev_iob_xmit(dev, pendack);
+    }
+
+  netdev_iob_detach(dev);
+}
+
+/****************************************************************************
+ * Function: netdev_iob_txpoll
+ *
+ * Description:
+ *   The devif_poll() and devif_timer() callback:  Pass any outgoing frame
+ *   to the driver and provide a new I/O buffer for the next frame.
+ *
+ ****************************************************************************/
+
+static int netdev_iob_txpoll(FAR struct net_driver_s *dev)
+{
+  if (dev->d_len > 0)
+    {
+      netdev_iob_llout(dev);
+
+      /* Terminate the poll if the driver cannot accept more frames or if
+       * there is no I/O buffer for the next frame.
+       */
+
+      if (netdev_iob_send(dev) < 0 || !netdev_iob_prepare(dev))
+        {
+          return 1;
+        }
+    }
+
+  return 0;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_dopoll
+ *
+ * Description:
+ *   Common logic of netdev_iob_poll() and netdev_iob_timer().
+ *
+ ****************************************************************************/
+
+static int netdev_iob_dopoll(FAR struct net_driver_s *dev,
+                             netdev_poll_t poll)
+{
+  int ret;
+
+  DEBUGASSERT(dev != NULL && dev->d_transmit != NULL);
+
+  net_lock();
+  netdev_lock(dev);
+
+  if (!netdev_iob_prepare(dev))
+    {
+      ret = -ENOMEM;
+      goto errout_with_lock;
+    }
+
+  ret = poll(dev, netdev_iob_txpoll);
+  netdev_iob_detach(dev);
+
+errout_with_lock:
+  netdev_unlock(dev);
+  net_unlock();
+  return ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_iob_input
+ *
+ * Description:
+ *   Process a batch of received frames.  Each frame is held in an I/O
+ *   buffer chain;  normally a single I/O buffer with the frame beginning at
+ *   io_data[0].  The network takes ownership of all of the I/O buffers:
+ *   Each is either freed or re-used for a response that is passed to the
+ *   driver's d_transmit() method.  Pure TCP ACKs generated for the same
+ *   connection within the batch are coalesced.
+ *
+ * Parameters:
+ *   dev   - The device that received the frames
+ *   pkts  - An array of npkts received frames
+ *   npkts - The number of frames in the array
+ *
+ * Returned Value:
+ *   The number of frames processed.
+ *
+ ****************************************************************************/
+
+int netdev_iob_input(FAR struct net_driver_s *dev, FAR struct iob_s **pkts,
+                     unsigned int npkts)
+{
+  FAR struct iob_s *pendack = NULL;
+  unsigned int i;
+
+  DEBUGASSERT(dev != NULL && dev->d_transmit != NULL &&
+              (pkts != NULL || npkts == 0));
+
+  /* Lock the network once for the entire batch */
+
+  net_lock();
+  netdev_lock(dev);
+  NETDEV_RXBATCH(dev, npkts);
+
+  for (i = 0; i < npkts; i++)
+    {
+      netdev_iob_rxframe(dev, pkts[i], &pendack);
+    }
+
+  /* Send the last pure ACK retained by netdev_iob_xmit() */
+
+  if (pendack != NULL)
+    {
+      (void)netdev_iob_transmit(dev, pendack);
+    }
+
+  netdev_unlock(dev);
+  net_unlock();
+  return (int)npkts;
+}
+
+/****************************************************************************
+ * Function: netdev_iob_poll
+ *
+ * Description:
+ *   Poll the network for outgoing frames as with devif_poll().  Each frame
+ *   is passed to the driver's d_transmit() method.
+ *
+ * Parameters:
+ *   dev - The device to poll
+ *
+ * Returned Value:
+ *   The value returned by devif_poll() or -ENOMEM if no I/O buffer is
+ *   available.
+ *
+ ****************************************************************************/
+
+int netdev_iob_poll(FAR struct net_driver_s *dev)
+{
+  return netdev_iob_dopoll(dev, devif_poll);
+}
+
+/****************************************************************************
+ * Function: netdev_iob_timer
+ *
+ * Description:
+ *   Perform the periodic network timer processing as with devif_timer().
+ *   Each outgoing frame is passed to the driver's d_transmit() method.
+ *
+ * Parameters:
+ *   dev - The device to poll
+ *
+ * Returned Value:
+ *   The value returned by devif_timer() or -ENOMEM if no I/O buffer is
+ *   available.
+ *
+ ****************************************************************************/
+
+int netdev_iob_timer(FAR struct net_driver_s *dev)
+{
+  return netdev_iob_dopoll(dev, devif_timer);
+}
+
+#endif /* CONFIG_NET && CONFIG_NETDEV_IOB */
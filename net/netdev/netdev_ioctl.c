@@ -453,6 +453,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
           if (dev)
             {
               ioctl_setipv4addr(&dev->d_netmask, &req->ifr_addr);
+              net_routecache_flush();
               ret = OK;
             }
         }
@@ -553,6 +554,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
             {
               FAR struct lifreq *lreq = (FAR struct lifreq *)req;
               ioctl_setipv6addr(dev->d_ipv6netmask, &lreq->lifr_addr);
+              net_routecache_flush();
               ret = OK;
             }
         }
@@ -664,6 +666,7 @@ static int netdev_ifrioctl(FAR struct socket *psock, int cmd,
 #ifdef CONFIG_NET_IPv6
               memset(&dev->d_ipv6addr, 0, sizeof(net_ipv6addr_t));
 #endif
+              net_routecache_flush();
               ret = OK;
             }
         }
@@ -861,22 +864,9 @@ static int netdev_arpioctl(FAR struct socket *psock, int cmd,
               FAR struct sockaddr_in *addr =
                 (FAR struct sockaddr_in *)&req->arp_pa;
 
-              /* Find the existing ARP table entry for this protocol address. */
-
-              FAR struct arp_entry *entry = arp_find(addr->sin_addr.s_addr);
-              if (entry != NULL)
-                {
-                  /* The ARP table is fixed size; an entry is deleted
-                   * by nullifying its protocol address.
-                   */
+              /* Remove the ARP table entry for this protocol address. */
 
-                  entry->at_ipaddr = 0;
-                  ret = OK;
-                }
-              else
-                {
-                  ret = -ENOENT;
-                }
+              ret = arp_delete(addr->sin_addr.s_addr);
             }
           else
             {
@@ -1190,6 +1180,10 @@ void netdev_ifup(FAR struct net_driver_s *dev)
             }
         }
     }
+
+  /* Routing decisions depend on the address and state of the device */
+
+  net_routecache_flush();
 }
 
 void netdev_ifdown(FAR struct net_driver_s *dev)
@@ -1216,6 +1210,10 @@ void netdev_ifdown(FAR struct net_driver_s *dev)
 
       (void)devif_dev_event(dev, NULL, NETDEV_DOWN);
     }
+
+  /* Routing decisions depend on the address and state of the device */
+
+  net_routecache_flush();
 }
 
 #endif /* CONFIG_NET && CONFIG_NSOCKET_DESCRIPTORS */
@@ -50,6 +50,7 @@
 
 #include <net/if.h>
 #include <net/ethernet.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 
@@ -266,6 +267,12 @@ int netdev_register(FAR struct net_driver_s *dev, enum net_lltype_e lltype)
       dev->d_conncb = NULL;
       dev->d_devcb = NULL;
 
+#ifdef CONFIG_NET_FINE_LOCKS
+      /* Initialize the lock that serializes calls into the driver */
+
+      net_rmutex_init(&dev->d_lock);
+#endif
+
       /* Get the next available device number and assign a device name to
        * the interface
        */
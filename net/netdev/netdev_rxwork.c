@@ -0,0 +1,156 @@
+/****************************************************************************
+ * net/netdev/netdev_rxwork.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NETDEV_RXWORK)
+
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_RXWORK_HPWORK)
+#  define RXWORK HPWORK
+#elif defined(CONFIG_NETDEV_RXWORK_LPWORK)
+#  define RXWORK LPWORK
+#else
+#  error No work queue selected for CONFIG_NETDEV_RXWORK
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_rxwork
+ *
+ * Description:
+ *   The receive worker:  Collect up to CONFIG_NETDEV_RXBUDGET received
+ *   frames from the driver, process them as one batch, and then poll for
+ *   outgoing frames.  If the budget was exhausted, more frames may be
+ *   pending and the worker is requeued.
+ *
+ * Parameters:
+ *   arg - The network device
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static void netdev_rxwork(FAR void *arg)
+{
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
+  FAR struct iob_s *pkts[CONFIG_NETDEV_RXBUDGET];
+  int npkts;
+
+  /* Collecting the frames only involves the driver.  The network is locked
+   * when the frames are processed.
+   */
+
+  netdev_lock(dev);
+  npkts = dev->d_rxpoll(dev, pkts, CONFIG_NETDEV_RXBUDGET);
+  netdev_unlock(dev);
+
+  if (npkts > 0)
+    {
+      (void)netdev_iob_input(dev, pkts, npkts);
+
+      /* Poll once for the entire batch so that data queued by applications
+       * woken up by the batch is sent.
+       */
+
+      (void)netdev_iob_poll(dev);
+    }
+
+  /* If the budget was exhausted, there may be more frames.  Requeue
+   * instead of looping so that other work is not starved.  Otherwise, the
+   * driver has re-enabled its receive interrupt.
+   */
+
+  if (npkts >= CONFIG_NETDEV_RXBUDGET)
+    {
+      NETDEV_RXBUDGET(dev);
+      (void)work_queue(RXWORK, &dev->d_rxwork, netdev_rxwork, dev, 0);
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: netdev_rxschedule
+ *
+ * Description:
+ *   Schedule deferred, batched receive processing for a device that uses
+ *   the I/O buffer driver interface.  This is normally called from the
+ *   receive interrupt handler with the receive interrupt disabled.
+ *
+ * Parameters:
+ *   dev - The device with received frames pending
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+int netdev_rxschedule(FAR struct net_driver_s *dev)
+{
+  DEBUGASSERT(dev != NULL && dev->d_rxpoll != NULL);
+
+  /* Nothing to do if the worker is already pending */
+
+  if (!work_available(&dev->d_rxwork))
+    {
+      return OK;
+    }
+
+  return work_queue(RXWORK, &dev->d_rxwork, netdev_rxwork, dev, 0);
+}
+
+#endif /* CONFIG_NET && CONFIG_NETDEV_RXWORK */
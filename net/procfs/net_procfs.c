@@ -64,6 +64,26 @@
 #if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
     !defined(CONFIG_FS_PROCFS_EXCLUDE_NET)
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The files in the net directory that precede the network devices */
+
+#ifdef CONFIG_NET_STATISTICS
+#  define NETPROCFS_NSTATFILES 1
+#else
+#  define NETPROCFS_NSTATFILES 0
+#endif
+
+#ifdef CONFIG_IOB_STATISTICS
+#  define NETPROCFS_NIOBFILES  1
+#else
+#  define NETPROCFS_NIOBFILES  0
+#endif
+
+#define NETPROCFS_NFILES       (NETPROCFS_NSTATFILES + NETPROCFS_NIOBFILES)
+
 /****************************************************************************
  * Private Function Prototypes
  ****************************************************************************/
@@ -125,6 +145,7 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 {
   FAR struct netprocfs_file_s *priv;
   FAR struct net_driver_s *dev;
+  uint8_t entry;
 
   finfo("Open '%s'\n", relpath);
 
@@ -148,11 +169,20 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 #ifdef CONFIG_NET_STATISTICS
   if (strcmp(relpath, "net/stat") == 0)
     {
-      /* A NULL network device reference is a clue that we are processing
-       * the network statistics file.
-       */
+      dev   = NULL;
+      entry = NETPROCFS_NETSTATS;
+    }
+  else
+#endif
+  /* "net/iob" is an acceptable value for the relpath only if I/O buffer
+   * statistics are enabled.
+   */
 
-      dev = NULL;
+#ifdef CONFIG_IOB_STATISTICS
+  if (strcmp(relpath, "net/iob") == 0)
+    {
+      dev   = NULL;
+      entry = NETPROCFS_IOBSTATS;
     }
   else
 #endif
@@ -180,6 +210,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
           ferr("ERROR: relpath is '%s'\n", relpath);
           return -ENOENT;
         }
+
+      entry = NETPROCFS_DEVSTATS;
     }
 
   /* Allocate the open file structure */
@@ -193,7 +225,8 @@ static int netprocfs_open(FAR struct file *filep, FAR const char *relpath,
 
   /* Initialize the open-file structure */
 
-  priv->dev = dev;
+  priv->dev   = dev;
+  priv->entry = entry;
 
   /* Save the open file structure as the open-specific state in
    * filep->f_priv.
@@ -241,17 +274,22 @@ static ssize_t netprocfs_read(FAR struct file *filep, FAR char *buffer,
   DEBUGASSERT(priv);
 
 #ifdef CONFIG_NET_STATISTICS
-  /* A NULL device structure reference is the key that we are showing the
-   * network statistics.
-   */
-
-  if (priv->dev == NULL)
+  if (priv->entry == NETPROCFS_NETSTATS)
     {
       /* Show the network layer statistics */
 
       nreturned = netprocfs_read_netstats(priv, buffer, buflen);
     }
   else
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  if (priv->entry == NETPROCFS_IOBSTATS)
+    {
+      /* Show the I/O buffer statistics */
+
+      nreturned = netprocfs_read_iobstats(priv, buffer, buflen);
+    }
+  else
 #endif
    {
       /* Otherwise, we are showing device-specific statistics */
@@ -358,11 +396,7 @@ static int netprocfs_opendir(FAR const char *relpath,
   /* Initialze base structure components */
 
   level1->base.level    = 1;
-#ifdef CONFIG_NET_STATISTICS
-  level1->base.nentries = ndevs + 1;
-#else
-  level1->base.nentries = ndevs;
-#endif
+  level1->base.nentries = ndevs + NETPROCFS_NFILES;
   level1->base.index    = 0;
 
   dir->u.procfs = (FAR void *) level1;
@@ -432,18 +466,21 @@ static int netprocfs_readdir(FAR struct fs_dirent_s *dir)
       dir->fd_dir.d_type = DTYPE_FILE;
       strncpy(dir->fd_dir.d_name, "stat", NAME_MAX + 1);
     }
-  else
 #endif
+#ifdef CONFIG_IOB_STATISTICS
+  else if (index == NETPROCFS_NSTATFILES)
     {
-      int devndx = index;
-
-#ifdef CONFIG_NET_STATISTICS
-      /* Subtract one to account for index == 0 which is used for network
-       * status.
-       */
+      /* Copy the I/O buffer statistics directory entry */
 
-      devndx--;
+      dir->fd_dir.d_type = DTYPE_FILE;
+      strncpy(dir->fd_dir.d_name, "iob", NAME_MAX + 1);
+    }
 #endif
+  else
+    {
+      /* Subtract the entries that precede the network devices */
+
+      int devndx = index - NETPROCFS_NFILES;
 
       /* Find the device corresponding to this device index */
 
@@ -505,6 +542,15 @@ static int netprocfs_stat(FAR const char *relpath, FAR struct stat *buf)
       buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
     }
   else
+#endif
+#ifdef CONFIG_IOB_STATISTICS
+  /* Check for I/O buffer statistics "net/iob" */
+
+  if (strcmp(relpath, "net/iob") == 0)
+    {
+      buf->st_mode = S_IFREG | S_IROTH | S_IRGRP | S_IRUSR;
+    }
+  else
 #endif
     {
       FAR struct net_driver_s *dev;
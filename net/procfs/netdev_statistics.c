@@ -70,6 +70,10 @@ static int netprocfs_rxpackets(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics_header(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile);
 static int netprocfs_errors(FAR struct netprocfs_file_s *netfile);
+#ifdef CONFIG_NETDEV_IOB
+static int netprocfs_batch_header(FAR struct netprocfs_file_s *netfile);
+static int netprocfs_batch(FAR struct netprocfs_file_s *netfile);
+#endif
 #endif /* CONFIG_NETDEV_STATISTICS */
 
 /****************************************************************************
@@ -89,6 +93,10 @@ static const linegen_t g_linegen[] =
   netprocfs_rxpackets,
   netprocfs_txstatistics_header,
   netprocfs_txstatistics,
+#ifdef CONFIG_NETDEV_IOB
+  netprocfs_batch_header,
+  netprocfs_batch,
+#endif
   netprocfs_errors
 #endif /* CONFIG_NETDEV_STATISTICS */
 };
@@ -421,6 +429,44 @@ static int netprocfs_txstatistics(FAR struct netprocfs_file_s *netfile)
 }
 #endif /* CONFIG_NETDEV_STATISTICS */
 
+/****************************************************************************
+ * Name: netprocfs_batch_header
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_IOB)
+static int netprocfs_batch_header(FAR struct netprocfs_file_s *netfile)
+{
+  DEBUGASSERT(netfile != NULL);
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\tBATCH: %-8s %-8s %-8s %-8s\n",
+                  "Batches", "MaxBatch", "Budget", "AckCoal");
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_IOB */
+
+/****************************************************************************
+ * Name: netprocfs_batch
+ ****************************************************************************/
+
+#if defined(CONFIG_NETDEV_STATISTICS) && defined(CONFIG_NETDEV_IOB)
+static int netprocfs_batch(FAR struct netprocfs_file_s *netfile)
+{
+  FAR struct netdev_statistics_s *stats;
+  FAR struct net_driver_s *dev;
+
+  DEBUGASSERT(netfile != NULL && netfile->dev != NULL);
+  dev = netfile->dev;
+  stats = &dev->d_statistics;
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "\t       %08lx %08lx %08lx %08lx\n",
+                  (unsigned long)stats->rx_batches,
+                  (unsigned long)stats->rx_maxbatch,
+                  (unsigned long)stats->rx_budget,
+                  (unsigned long)stats->tx_ackcoal);
+}
+#endif /* CONFIG_NETDEV_STATISTICS && CONFIG_NETDEV_IOB */
+
 /****************************************************************************
  * Name: netprocfs_errors
  ****************************************************************************/
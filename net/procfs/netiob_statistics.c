@@ -0,0 +1,164 @@
+/****************************************************************************
+ * net/procfs/netiob_statistics.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdio.h>
+#include <string.h>
+#include <debug.h>
+
+#include <nuttx/net/iob.h>
+
+#include "procfs/procfs.h"
+
+#if !defined(CONFIG_DISABLE_MOUNTPOINT) && defined(CONFIG_FS_PROCFS) && \
+    !defined(CONFIG_FS_PROCFS_EXCLUDE_NET) && defined(CONFIG_IOB_STATISTICS)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+/* Line generating functions */
+
+static int     netprocfs_iobheader(FAR struct netprocfs_file_s *netfile);
+static int     netprocfs_iobpool(FAR struct netprocfs_file_s *netfile);
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* Line generating functions:  The header followed by one line for each
+ * I/O buffer size class.
+ */
+
+static const linegen_t g_iob_linegen[] =
+{
+  netprocfs_iobheader,
+  netprocfs_iobpool
+
+#ifdef CONFIG_IOB_LARGE
+  , netprocfs_iobpool
+#endif
+};
+
+#define NIOBSTAT_LINES (sizeof(g_iob_linegen) / sizeof(linegen_t))
+
+/* The names of the size classes */
+
+static const char *g_iob_poolname[IOB_NPOOLS] =
+{
+  "small"
+#ifdef CONFIG_IOB_LARGE
+  , "large"
+#endif
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_iobheader
+ ****************************************************************************/
+
+static int netprocfs_iobheader(FAR struct netprocfs_file_s *netfile)
+{
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-5s %5s %5s %5s %5s %9s %9s %9s\n",
+                  "Pool", "Size", "Bufs", "Free", "Min", "Alloc", "Fail",
+                  "Throttle");
+}
+
+/****************************************************************************
+ * Name: netprocfs_iobpool
+ ****************************************************************************/
+
+static int netprocfs_iobpool(FAR struct netprocfs_file_s *netfile)
+{
+  struct iob_stats_s stats;
+  int pool;
+
+  /* Line zero is the header; the following lines are the size classes */
+
+  pool = netfile->lineno - 1;
+  if (iob_statistics(pool, &stats) < 0)
+    {
+      return 0;
+    }
+
+  return snprintf(netfile->line, NET_LINELEN,
+                  "%-5s %5u %5u %5u %5u %9lu %9lu %9lu\n",
+                  g_iob_poolname[pool], stats.is_bufsize, stats.is_nbuffers,
+                  stats.is_nfree, stats.is_minfree,
+                  (unsigned long)stats.is_nalloc,
+                  (unsigned long)stats.is_nfail,
+                  (unsigned long)stats.is_nthrottled);
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: netprocfs_read_iobstats
+ *
+ * Description:
+ *   Read and format I/O buffer statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which I/O buffer status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+ssize_t netprocfs_read_iobstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen)
+{
+  return netprocfs_read_linegen(priv, buffer, buflen, g_iob_linegen,
+                                NIOBSTAT_LINES);
+}
+
+#endif /* !CONFIG_DISABLE_MOUNTPOINT && CONFIG_FS_PROCFS &&
+        * !CONFIG_FS_PROCFS_EXCLUDE_NET && CONFIG_IOB_STATISTICS */
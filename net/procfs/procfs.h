@@ -56,6 +56,12 @@
 
 #define NET_LINELEN 64
 
+/* The kinds of files in the net directory */
+
+#define NETPROCFS_DEVSTATS 0         /* Statistics of one network device */
+#define NETPROCFS_NETSTATS 1         /* Network layer statistics, "stat" */
+#define NETPROCFS_IOBSTATS 2         /* I/O buffer statistics, "iob" */
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -67,6 +73,7 @@ struct netprocfs_file_s
 {
   struct procfs_file_s base;         /* Base open file structure */
   FAR struct net_driver_s *dev;      /* Current network device */
+  uint8_t entry;                     /* Kind of file, see NETPROCFS_* */
   uint8_t lineno;                    /* Line number */
   uint8_t linesize;                  /* Number of valid characters in line[] */
   uint8_t offset;                    /* Offset to first valid character in line[] */
@@ -148,6 +155,29 @@ ssize_t netprocfs_read_netstats(FAR struct netprocfs_file_s *priv,
                                 FAR char *buffer, size_t buflen);
 #endif
 
+/****************************************************************************
+ * Name: netprocfs_read_iobstats
+ *
+ * Description:
+ *   Read and format I/O buffer statistics.
+ *
+ * Input Parameters:
+ *   priv - A reference to the network procfs file structure
+ *   buffer - The user-provided buffer into which I/O buffer status will be
+ *            returned.
+ *   bulen  - The size in bytes of the user provided buffer.
+ *
+ * Returned Value:
+ *   Zero (OK) is returned on success; a negated errno value is returned
+ *   on failure.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_IOB_STATISTICS
+ssize_t netprocfs_read_iobstats(FAR struct netprocfs_file_s *priv,
+                                FAR char *buffer, size_t buflen);
+#endif
+
 /****************************************************************************
  * Name: netprocfs_read_devstats
  *
@@ -74,6 +74,17 @@
 int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 {
   FAR struct net_route_s *route;
+  int plen;
+  int ret;
+
+  /* Only contiguous netmasks can be used for longest prefix matching */
+
+  plen = net_lpm_prefixlen(&netmask, sizeof(in_addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR:  Netmask is not contiguous\n");
+      return plen;
+    }
 
   /* Allocate a route entry */
 
@@ -86,7 +97,7 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   /* Format the new route table entry */
 
-  net_ipv4addr_copy(route->target, target);
+  net_ipv4addr_copy(route->target, target & netmask);
   net_ipv4addr_copy(route->netmask, netmask);
   net_ipv4addr_copy(route->router, router);
 
@@ -94,9 +105,23 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 
   net_lock();
 
-  /* Then add the new entry to the table */
+  /* Then add the new entry to the table and to its index.  Cached routing
+   * decisions may no longer be the longest match.  If there is already a
+   * route for the same network, the new route is still added to the table
+   * but the index keeps the older one:  As before, the route that was
+   * added first is used.
+   */
+
+  ret = net_lpm_insert(&g_routetree, &route->target, plen, route);
+  if (ret < 0 && ret != -EEXIST)
+    {
+      net_unlock();
+      net_freeroute(route);
+      return ret;
+    }
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
+  net_routecache_flush();
   net_unlock();
   return OK;
 }
@@ -106,6 +131,18 @@ int net_addroute(in_addr_t target, in_addr_t netmask, in_addr_t router)
 int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6addr_t router)
 {
   FAR struct net_route_ipv6_s *route;
+  int plen;
+  int ret;
+  int i;
+
+  /* Only contiguous netmasks can be used for longest prefix matching */
+
+  plen = net_lpm_prefixlen(netmask, sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      nerr("ERROR:  Netmask is not contiguous\n");
+      return plen;
+    }
 
   /* Allocate a route entry */
 
@@ -118,7 +155,11 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6add
 
   /* Format the new route table entry */
 
-  net_ipv6addr_copy(route->target, target);
+  for (i = 0; i < 8; i++)
+    {
+      route->target[i] = target[i] & netmask[i];
+    }
+
   net_ipv6addr_copy(route->netmask, netmask);
   net_ipv6addr_copy(route->router, router);
 
@@ -126,9 +167,23 @@ int net_addroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask, net_ipv6add
 
   net_lock();
 
-  /* Then add the new entry to the table */
+  /* Then add the new entry to the table and to its index.  Cached routing
+   * decisions may no longer be the longest match.  If there is already a
+   * route for the same network, the new route is still added to the table
+   * but the index keeps the older one:  As before, the route that was
+   * added first is used.
+   */
+
+  ret = net_lpm_insert(&g_routetree_ipv6, route->target, plen, route);
+  if (ret < 0 && ret != -EEXIST)
+    {
+      net_unlock();
+      net_freeroute_ipv6(route);
+      return ret;
+    }
 
   sq_addlast((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes_ipv6);
+  net_routecache_flush();
   net_unlock();
   return OK;
 }
@@ -64,6 +64,16 @@ sq_queue_t g_routes;
 sq_queue_t g_routes_ipv6;
 #endif
 
+/* These are the longest-prefix-match indices of the routing tables */
+
+#ifdef CONFIG_NET_IPv4
+struct net_lpmtree_s g_routetree;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct net_lpmtree_s g_routetree_ipv6;
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -88,6 +98,16 @@ static struct net_route_s g_preallocroutes[CONFIG_NET_MAXROUTES];
 static struct net_route_ipv6_s g_preallocroutes_ipv6[CONFIG_NET_MAXROUTES];
 #endif
 
+/* These are the nodes of the longest-prefix-match trees */
+
+#ifdef CONFIG_NET_IPv4
+static struct net_lpmnode_s g_routenodes[NET_LPM_NNODES];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct net_lpmnode_s g_routenodes_ipv6[NET_LPM_NNODES];
+#endif
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -126,6 +146,8 @@ void net_initroute(void)
       sq_addlast((FAR sq_entry_t *)&g_preallocroutes[i],
                  (FAR sq_queue_t *)&g_freeroutes);
     }
+
+  net_lpm_initialize(&g_routetree, g_routenodes, NET_LPM_NNODES, 32);
 #endif
 
 #ifdef CONFIG_NET_IPv6
@@ -139,6 +161,9 @@ void net_initroute(void)
       sq_addlast((FAR sq_entry_t *)&g_preallocroutes_ipv6[i],
                  (FAR sq_queue_t *)&g_freeroutes_ipv6);
     }
+
+  net_lpm_initialize(&g_routetree_ipv6, g_routenodes_ipv6, NET_LPM_NNODES,
+                     128);
 #endif
 }
 
@@ -40,9 +40,10 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
-#include <string.h>
+#include <queue.h>
 #include <errno.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "route/route.h"
@@ -50,174 +51,133 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
 /****************************************************************************
- * Public Types
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-struct route_match_s
-{
-  FAR struct net_route_s *prev;     /* Predecessor in the list */
-  in_addr_t               target;   /* The target IP address to match */
-  in_addr_t               netmask;  /* The network mask to match */
-};
-#endif
-
-#ifdef CONFIG_NET_IPv6
-struct route_match_ipv6_s
-{
-  FAR struct net_route_ipv6_s *prev;     /* Predecessor in the list */
-  net_ipv6addr_t               target;   /* The target IP address to match */
-  net_ipv6addr_t               netmask;  /* The network mask to match */
-};
-#endif
-
-/****************************************************************************
- * Private Functions
+ * Public Functions
  ****************************************************************************/
 
 /****************************************************************************
- * Function: net_match
+ * Function: net_delroute
  *
  * Description:
- *   Return 1 if the route is available
+ *   Remove an existing route from the routing table
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   target   - The destination IP address on the destination network
+ *   netmask  - The mask defining the destination sub-net
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   OK on success; Negated errno on failure.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int net_match(FAR struct net_route_s *route, FAR void *arg)
+int net_delroute(in_addr_t target, in_addr_t netmask)
 {
-  FAR struct route_match_s *match = (FAR struct route_match_s *)arg;
-
-  /* To match, the masked target address must be the same, and the masks
-   * must be the same.
-   */
+  FAR struct net_route_s *route;
+  FAR struct net_route_s *next;
+  in_addr_t prefix;
+  int plen;
 
-  if (net_ipv4addr_maskcmp(route->target, match->target, match->netmask) &&
-      net_ipv4addr_cmp(route->netmask, match->netmask))
+  plen = net_lpm_prefixlen(&netmask, sizeof(in_addr_t));
+  if (plen < 0)
     {
-      /* They match.. Remove the entry from the routing table */
-
-      if (match->prev)
-        {
-          (void)sq_remafter((FAR sq_entry_t *)match->prev,
-                            (FAR sq_queue_t *)&g_routes);
-        }
-      else
-        {
-          (void)sq_remfirst((FAR sq_queue_t *)&g_routes);
-        }
+      return -ENOENT;
+    }
 
-      /* And free the routing table entry by adding it to the free list */
+  prefix = target & netmask;
 
-      net_freeroute(route);
+  /* Remove the entry from the index and from the routing table */
 
-      /* Return a non-zero value to terminate the traversal */
+  net_lock();
+  route = (FAR struct net_route_s *)
+    net_lpm_remove(&g_routetree, &prefix, plen);
 
-      return 1;
+  if (route == NULL)
+    {
+      net_unlock();
+      return -ENOENT;
     }
 
-  /* Next time we are here, this will be the previous entry */
+  sq_rem((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes);
 
-  match->prev = route;
-  return 0;
-}
-#endif
-
-#ifdef CONFIG_NET_IPv6
-static int net_match_ipv6(FAR struct net_route_ipv6_s *route, FAR void *arg)
-{
-  FAR struct route_match_ipv6_s *match = (FAR struct route_match_ipv6_s *)arg;
+  /* If there is another route for the same network, index the oldest one */
 
-  /* To match, the masked target address must be the same, and the masks
-   * must be the same.
-   */
-
-  if (net_ipv6addr_maskcmp(route->target, match->target, match->netmask) &&
-      net_ipv6addr_cmp(route->netmask, match->netmask))
+  for (next = (FAR struct net_route_s *)g_routes.head;
+       next != NULL;
+       next = next->flink)
     {
-      /* They match.. Remove the entry from the routing table */
-
-      if (match->prev)
+      if (net_ipv4addr_cmp(next->target, prefix) &&
+          net_ipv4addr_cmp(next->netmask, netmask))
         {
-          (void)sq_remafter((FAR sq_entry_t *)match->prev,
-                            (FAR sq_queue_t *)&g_routes_ipv6);
+          (void)net_lpm_insert(&g_routetree, &next->target, plen, next);
+          break;
         }
-      else
-        {
-          (void)sq_remfirst((FAR sq_queue_t *)&g_routes_ipv6);
-        }
-
-      /* And free the routing table entry by adding it to the free list */
-
-      net_freeroute_ipv6(route);
-
-      /* Return a non-zero value to terminate the traversal */
-
-      return 1;
     }
 
-  /* Next time we are here, this will be the previous entry */
+  net_routecache_flush();
+  net_unlock();
+
+  /* And free the routing table entry by adding it to the free list */
 
-  match->prev = route;
-  return 0;
+  net_freeroute(route);
+  return OK;
 }
 #endif
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Function: net_delroute
- *
- * Description:
- *   Remove an existing route from the routing table
- *
- * Parameters:
- *
- * Returned Value:
- *   OK on success; Negated errno on failure.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-int net_delroute(in_addr_t target, in_addr_t netmask)
+#ifdef CONFIG_NET_IPv6
+int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
 {
-  struct route_match_s match;
+  FAR struct net_route_ipv6_s *route;
+  FAR struct net_route_ipv6_s *next;
+  net_ipv6addr_t prefix;
+  int plen;
+  int i;
+
+  plen = net_lpm_prefixlen(netmask, sizeof(net_ipv6addr_t));
+  if (plen < 0)
+    {
+      return -ENOENT;
+    }
 
-  /* Set up the comparison structure */
+  for (i = 0; i < 8; i++)
+    {
+      prefix[i] = target[i] & netmask[i];
+    }
 
-  match.prev = NULL;
-  net_ipv4addr_copy(match.target, target);
-  net_ipv4addr_copy(match.netmask, netmask);
+  /* Remove the entry from the index and from the routing table */
 
-  /* Then remove the entry from the routing table */
+  net_lock();
+  route = (FAR struct net_route_ipv6_s *)
+    net_lpm_remove(&g_routetree_ipv6, prefix, plen);
 
-  return net_foreachroute(net_match, &match) ? OK : -ENOENT;
-}
-#endif
+  if (route == NULL)
+    {
+      net_unlock();
+      return -ENOENT;
+    }
 
-#ifdef CONFIG_NET_IPv6
-int net_delroute_ipv6(net_ipv6addr_t target, net_ipv6addr_t netmask)
-{
-  struct route_match_ipv6_s match;
+  sq_rem((FAR sq_entry_t *)route, (FAR sq_queue_t *)&g_routes_ipv6);
+
+  /* If there is another route for the same network, index the oldest one */
 
-  /* Set up the comparison structure */
+  for (next = (FAR struct net_route_ipv6_s *)g_routes_ipv6.head;
+       next != NULL;
+       next = next->flink)
+    {
+      if (net_ipv6addr_cmp(next->target, prefix) &&
+          net_ipv6addr_cmp(next->netmask, netmask))
+        {
+          (void)net_lpm_insert(&g_routetree_ipv6, next->target, plen, next);
+          break;
+        }
+    }
 
-  match.prev = NULL;
-  net_ipv6addr_copy(match.target, target);
-  net_ipv6addr_copy(match.netmask, netmask);
+  net_routecache_flush();
+  net_unlock();
 
-  /* Then remove the entry from the routing table */
+  /* And free the routing table entry by adding it to the free list */
 
-  return net_foreachroute_ipv6(net_match_ipv6, &match) ? OK : -ENOENT;
+  net_freeroute_ipv6(route);
+  return OK;
 }
 #endif
 
@@ -61,9 +61,13 @@
  *   Traverse the route table
  *
  * Parameters:
+ *   handler - Called for each route.  The traversal stops when it returns
+ *             a non-zero value.
+ *   arg     - An argument passed to the handler
  *
  * Returned Value:
- *   0 if in use; 1 if avaialble and the new entry was added
+ *   The value returned by the last call to the handler, zero if the table
+ *   is empty
  *
  ****************************************************************************/
 
@@ -78,9 +82,13 @@ int net_foreachroute(route_handler_t handler, FAR void *arg)
 
   net_lock();
 
-  /* Visit each entry in the routing table */
+  /* Visit each entry in the routing table until the handler returns a
+   * non-zero value.
+   */
 
-  for (route = (FAR struct net_route_s *)g_routes.head; route; route = next)
+  for (route = (FAR struct net_route_s *)g_routes.head;
+       route != NULL && ret == 0;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the hanlder may delete this entry.
@@ -108,9 +116,13 @@ int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg)
 
   net_lock();
 
-  /* Visit each entry in the routing table */
+  /* Visit each entry in the routing table until the handler returns a
+   * non-zero value.
+   */
 
-  for (route = (FAR struct net_route_s *)g_routes_ipv6.head; route; route = next)
+  for (route = (FAR struct net_route_ipv6_s *)g_routes_ipv6.head;
+       route != NULL && ret == 0;
+       route = next)
     {
       /* Get the next entry in the to visit.  We do this BEFORE calling the
        * handler because the hanlder may delete this entry.
@@ -0,0 +1,478 @@
+/****************************************************************************
+ * net/route/net_lpm.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <errno.h>
+#include <assert.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Return bit n of a key, counting from the most significant bit */
+
+#define LPM_BIT(key,n) (((key)[(n) >> 3] >> (7 - ((n) & 7))) & 1)
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: lpm_matchlen
+ *
+ * Description:
+ *   Return the number of leading bits that are the same in two keys, up to
+ *   a maximum of maxbits.
+ *
+ ****************************************************************************/
+
+static int lpm_matchlen(FAR const uint8_t *key1, FAR const uint8_t *key2,
+                        int maxbits)
+{
+  uint8_t diff;
+  int nbits = 0;
+  int i;
+
+  for (i = 0; nbits < maxbits; i++, nbits += 8)
+    {
+      diff = key1[i] ^ key2[i];
+      if (diff != 0)
+        {
+          while ((diff & 0x80) == 0)
+            {
+              diff <<= 1;
+              nbits++;
+            }
+
+          break;
+        }
+    }
+
+  return nbits < maxbits ? nbits : maxbits;
+}
+
+/****************************************************************************
+ * Function: lpm_allocnode
+ *
+ * Description:
+ *   Allocate a node and initialize it with the first plen bits of key.
+ *
+ ****************************************************************************/
+
+static FAR struct net_lpmnode_s *
+lpm_allocnode(FAR struct net_lpmtree_s *tree, FAR const uint8_t *key,
+              int plen)
+{
+  FAR struct net_lpmnode_s *node;
+  int nbytes = (plen + 7) >> 3;
+
+  node = tree->free;
+  if (node != NULL)
+    {
+      tree->free = node->child[0];
+
+      memset(node, 0, sizeof(struct net_lpmnode_s));
+      memcpy(node->key, key, nbytes);
+      if ((plen & 7) != 0)
+        {
+          node->key[nbytes - 1] &= (uint8_t)(0xff << (8 - (plen & 7)));
+        }
+
+      node->plen = (uint8_t)plen;
+    }
+
+  return node;
+}
+
+/****************************************************************************
+ * Function: lpm_freenode
+ ****************************************************************************/
+
+static void lpm_freenode(FAR struct net_lpmtree_s *tree,
+                         FAR struct net_lpmnode_s *node)
+{
+  node->child[0] = tree->free;
+  tree->free     = node;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_lpm_initialize
+ *
+ * Description:
+ *   Initialize an empty longest-prefix-match tree.
+ *
+ * Parameters:
+ *   tree    - The tree to initialize
+ *   nodes   - Storage for the nodes of the tree
+ *   nnodes  - The number of nodes in the storage
+ *   maxbits - The size of the addresses in bits (32 or 128)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_lpm_initialize(FAR struct net_lpmtree_s *tree,
+                        FAR struct net_lpmnode_s *nodes, int nnodes,
+                        int maxbits)
+{
+  int i;
+
+  DEBUGASSERT(maxbits <= 8 * NET_LPM_KEYSIZE);
+
+  tree->root    = NULL;
+  tree->free    = NULL;
+  tree->maxbits = (uint8_t)maxbits;
+
+  for (i = 0; i < nnodes; i++)
+    {
+      lpm_freenode(tree, &nodes[i]);
+    }
+}
+
+/****************************************************************************
+ * Function: net_lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask in network order.
+ *
+ * Parameters:
+ *   mask   - The netmask
+ *   nbytes - The size of the netmask in bytes
+ *
+ * Returned Value:
+ *   The prefix length in bits, or -EINVAL if the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+int net_lpm_prefixlen(FAR const void *mask, int nbytes)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)mask;
+  uint8_t byte;
+  int plen = 0;
+  int i;
+
+  for (i = 0; i < nbytes && ptr[i] == 0xff; i++)
+    {
+      plen += 8;
+    }
+
+  if (i < nbytes)
+    {
+      /* The remainder must be a run of ones followed by zeroes */
+
+      for (byte = ptr[i++]; (byte & 0x80) != 0; byte <<= 1)
+        {
+          plen++;
+        }
+
+      if (byte != 0)
+        {
+          return -EINVAL;
+        }
+
+      for (; i < nbytes; i++)
+        {
+          if (ptr[i] != 0)
+            {
+              return -EINVAL;
+            }
+        }
+    }
+
+  return plen;
+}
+
+/****************************************************************************
+ * Function: net_lpm_insert
+ *
+ * Description:
+ *   Add a route to the tree.
+ *
+ * Parameters:
+ *   tree  - The tree
+ *   key   - The destination network in network order
+ *   plen  - The prefix length in bits
+ *   route - The route to return from net_lpm_lookup()
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route for the same
+ *   prefix; -ENOMEM if no node is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_lpm_insert(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                   int plen, FAR void *route)
+{
+  FAR const uint8_t *bytes = (FAR const uint8_t *)key;
+  FAR struct net_lpmnode_s **pnode;
+  FAR struct net_lpmnode_s *node;
+  FAR struct net_lpmnode_s *newnode;
+  FAR struct net_lpmnode_s *glue;
+  int common = 0;
+
+  DEBUGASSERT(plen >= 0 && plen <= tree->maxbits && route != NULL);
+
+  /* Descend while the prefix of the node is a prefix of the new one */
+
+  for (pnode = &tree->root; (node = *pnode) != NULL; )
+    {
+      common = lpm_matchlen(node->key, bytes,
+                            node->plen < plen ? node->plen : plen);
+      if (common < node->plen)
+        {
+          break;
+        }
+
+      if (node->plen == plen)
+        {
+          /* The prefix is already present, perhaps as a glue node */
+
+          if (node->route != NULL)
+            {
+              return -EEXIST;
+            }
+
+          node->route = route;
+          return OK;
+        }
+
+      pnode = &node->child[LPM_BIT(bytes, node->plen)];
+    }
+
+  newnode = lpm_allocnode(tree, bytes, plen);
+  if (newnode == NULL)
+    {
+      return -ENOMEM;
+    }
+
+  newnode->route = route;
+
+  if (node == NULL)
+    {
+      /* Add a new leaf */
+
+      *pnode = newnode;
+    }
+  else if (common == plen)
+    {
+      /* The new prefix is a prefix of the node:  Insert it above the node */
+
+      newnode->child[LPM_BIT(node->key, plen)] = node;
+      *pnode = newnode;
+    }
+  else
+    {
+      /* The prefixes branch at bit 'common':  Insert a glue node there */
+
+      glue = lpm_allocnode(tree, bytes, common);
+      if (glue == NULL)
+        {
+          lpm_freenode(tree, newnode);
+          return -ENOMEM;
+        }
+
+      glue->child[LPM_BIT(bytes, common)]     = newnode;
+      glue->child[LPM_BIT(node->key, common)] = node;
+      *pnode = glue;
+    }
+
+  return OK;
+}
+
+/****************************************************************************
+ * Function: net_lpm_remove
+ *
+ * Description:
+ *   Remove the route with exactly this prefix from the tree.
+ *
+ * Parameters:
+ *   tree  - The tree
+ *   key   - The destination network in network order
+ *   plen  - The prefix length in bits
+ *
+ * Returned Value:
+ *   The removed route, or NULL if there is no route for the prefix.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_remove(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                         int plen)
+{
+  FAR const uint8_t *bytes = (FAR const uint8_t *)key;
+  FAR struct net_lpmnode_s **pparent = NULL;
+  FAR struct net_lpmnode_s **pnode;
+  FAR struct net_lpmnode_s *parent = NULL;
+  FAR struct net_lpmnode_s *node;
+  FAR struct net_lpmnode_s *child;
+  FAR void *route;
+
+  /* Find the node with exactly this prefix */
+
+  for (pnode = &tree->root; (node = *pnode) != NULL; )
+    {
+      if (node->plen > plen ||
+          lpm_matchlen(node->key, bytes, node->plen) < node->plen)
+        {
+          return NULL;
+        }
+
+      if (node->plen == plen)
+        {
+          break;
+        }
+
+      pparent = pnode;
+      parent  = node;
+      pnode   = &node->child[LPM_BIT(bytes, node->plen)];
+    }
+
+  if (node == NULL || node->route == NULL)
+    {
+      return NULL;
+    }
+
+  route       = node->route;
+  node->route = NULL;
+
+  /* A node with two children remains as a glue node.  Otherwise, replace
+   * it with its only child (if any).
+   */
+
+  if (node->child[0] != NULL && node->child[1] != NULL)
+    {
+      return route;
+    }
+
+  child  = node->child[0] != NULL ? node->child[0] : node->child[1];
+  *pnode = child;
+  lpm_freenode(tree, node);
+
+  /* If a leaf was removed and its parent is a glue node, the parent now has
+   * only one child and is no longer needed.
+   */
+
+  if (child == NULL && parent != NULL && parent->route == NULL)
+    {
+      child    = parent->child[0] != NULL ? parent->child[0] :
+                                            parent->child[1];
+      *pparent = child;
+      lpm_freenode(tree, parent);
+    }
+
+  return route;
+}
+
+/****************************************************************************
+ * Function: net_lpm_lookup
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches an address.  The
+ *   cost is proportional to the depth of the tree, not to the number of
+ *   routes.
+ *
+ * Parameters:
+ *   tree   - The tree
+ *   key    - The address to look up in network order
+ *   filter - If non-NULL, only routes for which this returns true are
+ *            considered.
+ *   arg    - An argument passed to the filter
+ *
+ * Returned Value:
+ *   The matching route, or NULL if no route matches.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_lookup(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                         lpm_filter_t filter, FAR void *arg)
+{
+  FAR const uint8_t *bytes = (FAR const uint8_t *)key;
+  FAR struct net_lpmnode_s *node;
+  FAR void *best = NULL;
+
+  /* The prefixes get longer on the way down, so the last matching route is
+   * the longest match.
+   */
+
+  for (node = tree->root; node != NULL; )
+    {
+      if (lpm_matchlen(node->key, bytes, node->plen) < node->plen)
+        {
+          break;
+        }
+
+      if (node->route != NULL &&
+          (filter == NULL || filter(node->route, arg)))
+        {
+          best = node->route;
+        }
+
+      if (node->plen >= tree->maxbits)
+        {
+          break;
+        }
+
+      node = node->child[LPM_BIT(bytes, node->plen)];
+    }
+
+  return best;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE */
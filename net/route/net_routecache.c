@@ -0,0 +1,245 @@
+/****************************************************************************
+ * net/route/net_routecache.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+
+#include <nuttx/net/net.h>
+#include <nuttx/net/ip.h>
+
+#include "route/route.h"
+
+#if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE) && \
+    CONFIG_NET_ROUTE_CACHE_SIZE > 0
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+/* One cached routing decision */
+
+#ifdef CONFIG_NET_IPv4
+struct route_cache_ipv4_s
+{
+  FAR struct net_driver_s *dev; /* Device constraint of the lookup or NULL */
+  in_addr_t target;             /* The destination address */
+  in_addr_t router;             /* The router for the destination */
+  bool valid;                   /* True if this entry is in use */
+};
+#endif
+
+#ifdef CONFIG_NET_IPv6
+struct route_cache_ipv6_s
+{
+  FAR struct net_driver_s *dev; /* Device constraint of the lookup or NULL */
+  net_ipv6addr_t target;        /* The destination address */
+  net_ipv6addr_t router;        /* The router for the destination */
+  bool valid;                   /* True if this entry is in use */
+};
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+static struct route_cache_ipv4_s g_routecache[CONFIG_NET_ROUTE_CACHE_SIZE];
+#endif
+
+#ifdef CONFIG_NET_IPv6
+static struct route_cache_ipv6_s
+  g_routecache_ipv6[CONFIG_NET_ROUTE_CACHE_SIZE];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: routecache_hash
+ *
+ * Description:
+ *   Fold an address into an index into the cache.
+ *
+ ****************************************************************************/
+
+static unsigned int routecache_hash(FAR const void *addr, int nbytes)
+{
+  FAR const uint8_t *ptr = (FAR const uint8_t *)addr;
+  unsigned int hash = 0;
+  int i;
+
+  for (i = 0; i < nbytes; i++)
+    {
+      hash = (hash << 3) ^ (hash >> 5) ^ ptr[i];
+    }
+
+  return hash % CONFIG_NET_ROUTE_CACHE_SIZE;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: net_routecache_flush
+ *
+ * Description:
+ *   Invalidate the route cache.  Called whenever the routing table is
+ *   modified and whenever the address, netmask or state of a network
+ *   device changes.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_routecache_flush(void)
+{
+  net_lock();
+#ifdef CONFIG_NET_IPv4
+  memset(g_routecache, 0, sizeof(g_routecache));
+#endif
+#ifdef CONFIG_NET_IPv6
+  memset(g_routecache_ipv6, 0, sizeof(g_routecache_ipv6));
+#endif
+  net_unlock();
+}
+
+/****************************************************************************
+ * Function: net_routecache_ipv4_lookup and net_routecache_ipv4_add
+ *
+ * Description:
+ *   Look up or remember the router for a destination address.  The cache
+ *   is direct-mapped on the destination address.  dev is NULL for lookups
+ *   that are not constrained to a device.
+ *
+ * Parameters:
+ *   dev    - The device the router must be accessible from, or NULL
+ *   target - The destination address
+ *   router - The router address (returned on lookup)
+ *
+ * Returned Value:
+ *   net_routecache_ipv4_lookup() returns true on a cache hit.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv4
+bool net_routecache_ipv4_lookup(FAR struct net_driver_s *dev,
+                                in_addr_t target, FAR in_addr_t *router)
+{
+  FAR struct route_cache_ipv4_s *entry;
+
+  entry = &g_routecache[routecache_hash(&target, sizeof(in_addr_t))];
+  if (entry->valid && entry->dev == dev &&
+      net_ipv4addr_cmp(entry->target, target))
+    {
+      net_ipv4addr_copy(*router, entry->router);
+      return true;
+    }
+
+  return false;
+}
+
+void net_routecache_ipv4_add(FAR struct net_driver_s *dev,
+                             in_addr_t target, in_addr_t router)
+{
+  FAR struct route_cache_ipv4_s *entry;
+
+  entry = &g_routecache[routecache_hash(&target, sizeof(in_addr_t))];
+  entry->dev   = dev;
+  net_ipv4addr_copy(entry->target, target);
+  net_ipv4addr_copy(entry->router, router);
+  entry->valid = true;
+}
+#endif /* CONFIG_NET_IPv4 */
+
+/****************************************************************************
+ * Function: net_routecache_ipv6_lookup and net_routecache_ipv6_add
+ *
+ * Description:
+ *   The IPv6 equivalents of net_routecache_ipv4_lookup() and
+ *   net_routecache_ipv4_add().
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_IPv6
+bool net_routecache_ipv6_lookup(FAR struct net_driver_s *dev,
+                                FAR const net_ipv6addr_t target,
+                                FAR net_ipv6addr_t router)
+{
+  FAR struct route_cache_ipv6_s *entry;
+
+  entry = &g_routecache_ipv6[routecache_hash(target,
+                                             sizeof(net_ipv6addr_t))];
+  if (entry->valid && entry->dev == dev &&
+      net_ipv6addr_cmp(entry->target, target))
+    {
+      net_ipv6addr_copy(router, entry->router);
+      return true;
+    }
+
+  return false;
+}
+
+void net_routecache_ipv6_add(FAR struct net_driver_s *dev,
+                             FAR const net_ipv6addr_t target,
+                             FAR const net_ipv6addr_t router)
+{
+  FAR struct route_cache_ipv6_s *entry;
+
+  entry = &g_routecache_ipv6[routecache_hash(target,
+                                             sizeof(net_ipv6addr_t))];
+  entry->dev   = dev;
+  net_ipv6addr_copy(entry->target, target);
+  net_ipv6addr_copy(entry->router, router);
+  entry->valid = true;
+}
+#endif /* CONFIG_NET_IPv6 */
+
+#endif /* CONFIG_NET && CONFIG_NET_ROUTE && CONFIG_NET_ROUTE_CACHE_SIZE > 0 */
@@ -45,6 +45,7 @@
 
 #include <netinet/in.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/ip.h>
 
 #include "devif/devif.h"
@@ -52,104 +53,6 @@
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
-/****************************************************************************
- * Public Types
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-struct route_ipv4_match_s
-{
-  in_addr_t target;       /* Target IPv4 address on an external network to match */
-  in_addr_t router;       /* IPv4 address of the router on one of our networks */
-};
-#endif
-
-#ifdef CONFIG_NET_IPv6
-struct route_ipv6_match_s
-{
-  net_ipv6addr_t target;  /* Target IPv6 address on an external network to match */
-  net_ipv6addr_t router;  /* IPv6 address of the router on one of our networks */
-};
-#endif
-
-/****************************************************************************
- * Private Functions
- ****************************************************************************/
-
-/****************************************************************************
- * Function: net_ipv4_match
- *
- * Description:
- *   Return 1 if the IPv4 route is available
- *
- * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
- *
- * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-static int net_ipv4_match(FAR struct net_route_s *route, FAR void *arg)
-{
-  FAR struct route_ipv4_match_s *match = (FAR struct route_ipv4_match_s *)arg;
-
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
-   */
-
-  if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv4addr_copy(match->router, route->router);
-      return 1;
-    }
-
-  return 0;
-}
-#endif /* CONFIG_NET_IPv4 */
-
-/****************************************************************************
- * Function: net_ipv6_match
- *
- * Description:
- *   Return 1 if the IPv6 route is available
- *
- * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
- *
- * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
- *
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv6
-static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
-{
-  FAR struct route_ipv6_match_s *match = (FAR struct route_ipv6_match_s *)arg;
-
-  /* To match, the masked target addresses must be the same.  In the event
-   * of multiple matches, only the first is returned.  There is not (yet) any
-   * concept for the precedence of networks.
-   */
-
-  if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv6addr_copy(match->router, route->router);
-      return 1;
-    }
-
-  return 0;
-}
-#endif /* CONFIG_NET_IPv6 */
-
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -174,8 +77,8 @@ static int net_ipv6_match(FAR struct net_route_ipv6_s *route, FAR void *arg)
 #ifdef CONFIG_NET_IPv4
 int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 {
-  struct route_ipv4_match_s match;
-  int ret;
+  FAR struct net_route_s *route;
+  int ret = OK;
 
   /* Do not route the special broadcast IP address */
 
@@ -184,30 +87,37 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
       return -ENOENT;
     }
 
-  /* Set up the comparison structure */
+  net_lock();
 
-  memset(&match, 0, sizeof(struct route_ipv4_match_s));
-  net_ipv4addr_copy(match.target, target);
-
-  /* Find an router entry with the routing table that can forward to this
-   * address
+  /* Try the route cache first.  Otherwise, find the router entry with the
+   * longest prefix that can forward to this address.
    */
 
-  ret = net_foreachroute(net_ipv4_match, &match);
-  if (ret > 0)
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+  if (!net_routecache_ipv4_lookup(NULL, target, router))
+#endif
     {
-      /* We found a route.  Return the router address. */
+      route = (FAR struct net_route_s *)
+        net_lpm_lookup(&g_routetree, &target, NULL, NULL);
 
-      net_ipv4addr_copy(*router, match.router);
-      ret = OK;
-    }
-  else
-    {
-      /* There is no route for this address */
+      if (route != NULL)
+        {
+          /* We found a route.  Return the router address. */
 
-      ret = -ENOENT;
+          net_ipv4addr_copy(*router, route->router);
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+          net_routecache_ipv4_add(NULL, target, route->router);
+#endif
+        }
+      else
+        {
+          /* There is no route for this address */
+
+          ret = -ENOENT;
+        }
     }
 
+  net_unlock();
   return ret;
 }
 #endif /* CONFIG_NET_IPv4 */
@@ -232,8 +142,8 @@ int net_ipv4_router(in_addr_t target, FAR in_addr_t *router)
 #ifdef CONFIG_NET_IPv6
 int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
 {
-  struct route_ipv6_match_s match;
-  int ret;
+  FAR struct net_route_ipv6_s *route;
+  int ret = OK;
 
   /* Do not route the special broadcast IP address */
 
@@ -242,30 +152,37 @@ int net_ipv6_router(net_ipv6addr_t target, net_ipv6addr_t router)
       return -ENOENT;
     }
 
-  /* Set up the comparison structure */
+  net_lock();
 
-  memset(&match, 0, sizeof(struct route_ipv6_match_s));
-  net_ipv6addr_copy(match.target, target);
-
-  /* Find an router entry with the routing table that can forward to this
-   * address
+  /* Try the route cache first.  Otherwise, find the router entry with the
+   * longest prefix that can forward to this address.
    */
 
-  ret = net_foreachroute_ipv6(net_ipv6_match, &match);
-  if (ret > 0)
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+  if (!net_routecache_ipv6_lookup(NULL, target, router))
+#endif
     {
-      /* We found a route.  Return the router address. */
+      route = (FAR struct net_route_ipv6_s *)
+        net_lpm_lookup(&g_routetree_ipv6, target, NULL, NULL);
 
-      net_ipv6addr_copy(router, match.router);
-      ret = OK;
-    }
-  else
-    {
-      /* There is no route for this address */
+      if (route != NULL)
+        {
+          /* We found a route.  Return the router address. */
+
+          net_ipv6addr_copy(router, route->router);
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+          net_routecache_ipv6_add(NULL, target, route->router);
+#endif
+        }
+      else
+        {
+          /* There is no route for this address */
 
-      ret = -ENOENT;
+          ret = -ENOENT;
+        }
     }
 
+  net_unlock();
   return ret;
 }
 #endif /* CONFIG_NET_IPv6 */
@@ -40,9 +40,11 @@
 #include <nuttx/config.h>
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <errno.h>
 
+#include <nuttx/net/net.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
 
@@ -51,28 +53,6 @@
 
 #if defined(CONFIG_NET) && defined(CONFIG_NET_ROUTE)
 
-/****************************************************************************
- * Public Types
- ****************************************************************************/
-
-#ifdef CONFIG_NET_IPv4
-struct route_ipv4_devmatch_s
-{
-  FAR struct net_driver_s *dev; /* The route must use this device */
-  in_addr_t target;             /* Target IPv4 address on an external network to match */
-  in_addr_t router;             /* IPv6 address of the router on one of our networks */
-};
-#endif
-
-#ifdef CONFIG_NET_IPv6
-struct route_ipv6_devmatch_s
-{
-  FAR struct net_driver_s *dev; /* The route must use this device */
-  net_ipv6addr_t target;        /* Target IPv4 address on an external network to match */
-  net_ipv6addr_t router;        /* IPv6 address of the router on one of our networks */
-};
-#endif
-
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -81,40 +61,25 @@ struct route_ipv6_devmatch_s
  * Function: net_ipv4_devmatch
  *
  * Description:
- *   Return 1 if the IPv4 route is available on the device's network.
+ *   Route filter for net_lpm_lookup():  Accept the IPv4 route if its router
+ *   is on the device's network.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   route - The candidate route
+ *   arg   - The device (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   true if the router is accessible from the device.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv4
-static int net_ipv4_devmatch(FAR struct net_route_s *route, FAR void *arg)
+static bool net_ipv4_devmatch(FAR void *route, FAR void *arg)
 {
-  FAR struct route_ipv4_devmatch_s *match = (FAR struct route_ipv4_devmatch_s *)arg;
-  FAR struct net_driver_s *dev = match->dev;
-
-  /* To match, (1) the masked target addresses must be the same, and (2) the
-   * router address must like on the network provided by the device.
-   *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
-   */
-
-  if (net_ipv4addr_maskcmp(route->target, match->target, route->netmask) &&
-      net_ipv4addr_maskcmp(route->router, dev->d_ipaddr, dev->d_netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv4addr_copy(match->router, route->router);
-      return 1;
-    }
+  FAR struct net_route_s *entry = (FAR struct net_route_s *)route;
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
 
-  return 0;
+  return net_ipv4addr_maskcmp(entry->router, dev->d_ipaddr, dev->d_netmask);
 }
 #endif /* CONFIG_NET_IPv4 */
 
@@ -122,40 +87,26 @@ static int net_ipv4_devmatch(FAR struct net_route_s *route, FAR void *arg)
  * Function: net_ipv6_devmatch
  *
  * Description:
- *   Return 1 if the IPv6 route is available on the device's network.
+ *   Route filter for net_lpm_lookup():  Accept the IPv6 route if its router
+ *   is on the device's network.
  *
  * Parameters:
- *   route - The next route to examine
- *   arg   - The match values (cast to void*)
+ *   route - The candidate route
+ *   arg   - The device (cast to void*)
  *
  * Returned Value:
- *   0 if the entry is not a match; 1 if the entry matched and was cleared.
+ *   true if the router is accessible from the device.
  *
  ****************************************************************************/
 
 #ifdef CONFIG_NET_IPv6
-static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route, FAR void *arg)
+static bool net_ipv6_devmatch(FAR void *route, FAR void *arg)
 {
-  FAR struct route_ipv6_devmatch_s *match = (FAR struct route_ipv6_devmatch_s *)arg;
-  FAR struct net_driver_s *dev = match->dev;
-
-  /* To match, (1) the masked target addresses must be the same, and (2) the
-   * router address must like on the network provided by the device.
-   *
-   * In the event of multiple matches, only the first is returned.  There
-   * not (yet) any concept for the precedence of networks.
-   */
+  FAR struct net_route_ipv6_s *entry = (FAR struct net_route_ipv6_s *)route;
+  FAR struct net_driver_s *dev = (FAR struct net_driver_s *)arg;
 
-  if (net_ipv6addr_maskcmp(route->target, match->target, route->netmask) &&
-      net_ipv6addr_maskcmp(route->router, dev->d_ipv6addr, dev->d_ipv6netmask))
-    {
-      /* They match.. Copy the router address */
-
-      net_ipv6addr_copy(match->router, route->router);
-      return 1;
-    }
-
-  return 0;
+  return net_ipv6addr_maskcmp(entry->router, dev->d_ipv6addr,
+                              dev->d_ipv6netmask);
 }
 #endif /* CONFIG_NET_IPv6 */
 
@@ -188,34 +139,41 @@ static int net_ipv6_devmatch(FAR struct net_route_ipv6_s *route, FAR void *arg)
 void netdev_ipv4_router(FAR struct net_driver_s *dev, in_addr_t target,
                         FAR in_addr_t *router)
 {
-  struct route_ipv4_devmatch_s match;
-  int ret;
+  FAR struct net_route_s *route;
 
-  /* Set up the comparison structure */
+  net_lock();
 
-  memset(&match, 0, sizeof(struct route_ipv4_devmatch_s));
-  match.dev = dev;
-  net_ipv4addr_copy(match.target, target);
-
-  /* Find an router entry with the routing table that can forward to this
-   * address using this device.
+  /* Try the route cache first.  Otherwise, find the router entry with the
+   * longest prefix that can forward to this address using this device.
    */
 
-  ret = net_foreachroute(net_ipv4_devmatch, &match);
-  if (ret > 0)
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+  if (!net_routecache_ipv4_lookup(dev, target, router))
+#endif
     {
-      /* We found a route.  Return the router address. */
+      route = (FAR struct net_route_s *)
+        net_lpm_lookup(&g_routetree, &target, net_ipv4_devmatch, dev);
 
-      net_ipv4addr_copy(*router, match.target);
-    }
-  else
-    {
-      /* There isn't a matching route.. fallback and use the default router
-       * of the device.
-       */
+      if (route != NULL)
+        {
+          /* We found a route.  Return the router address. */
 
-      net_ipv4addr_copy(*router, dev->d_draddr);
+          net_ipv4addr_copy(*router, route->router);
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+          net_routecache_ipv4_add(dev, target, route->router);
+#endif
+        }
+      else
+        {
+          /* There isn't a matching route.. fallback and use the default
+           * router of the device.
+           */
+
+          net_ipv4addr_copy(*router, dev->d_draddr);
+        }
     }
+
+  net_unlock();
 }
 #endif
 
@@ -245,34 +203,41 @@ void netdev_ipv6_router(FAR struct net_driver_s *dev,
                         FAR const net_ipv6addr_t target,
                         FAR net_ipv6addr_t router)
 {
-  struct route_ipv6_devmatch_s match;
-  int ret;
+  FAR struct net_route_ipv6_s *route;
 
-  /* Set up the comparison structure */
+  net_lock();
 
-  memset(&match, 0, sizeof(struct route_ipv6_devmatch_s));
-  match.dev = dev;
-  net_ipv6addr_copy(match.target, target);
-
-  /* Find an router entry with the routing table that can forward to this
-   * address using this device.
+  /* Try the route cache first.  Otherwise, find the router entry with the
+   * longest prefix that can forward to this address using this device.
    */
 
-  ret = net_foreachroute_ipv6(net_ipv6_devmatch, &match);
-  if (ret > 0)
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+  if (!net_routecache_ipv6_lookup(dev, target, router))
+#endif
     {
-      /* We found a route.  Return the router address. */
+      route = (FAR struct net_route_ipv6_s *)
+        net_lpm_lookup(&g_routetree_ipv6, target, net_ipv6_devmatch, dev);
 
-      net_ipv6addr_copy(router, match.target);
-    }
-  else
-    {
-      /* There isn't a matching route.. fallback and use the default router
-       * of the device.
-       */
+      if (route != NULL)
+        {
+          /* We found a route.  Return the router address. */
 
-      net_ipv6addr_copy(router, dev->d_ipv6draddr);
+          net_ipv6addr_copy(router, route->router);
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+          net_routecache_ipv6_add(dev, target, route->router);
+#endif
+        }
+      else
+        {
+          /* There isn't a matching route.. fallback and use the default
+           * router of the device.
+           */
+
+          net_ipv6addr_copy(router, dev->d_ipv6draddr);
+        }
     }
+
+  net_unlock();
 }
 #endif
 
@@ -42,6 +42,8 @@
 
 #include <nuttx/config.h>
 
+#include <stdint.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <net/if.h>
@@ -59,6 +61,24 @@
 #  define CONFIG_NET_MAXROUTES 4
 #endif
 
+#ifndef CONFIG_NET_ROUTE_CACHE_SIZE
+#  define CONFIG_NET_ROUTE_CACHE_SIZE 0
+#endif
+
+/* The size of the longest key in the longest-prefix-match tree */
+
+#ifdef CONFIG_NET_IPv6
+#  define NET_LPM_KEYSIZE 16
+#else
+#  define NET_LPM_KEYSIZE 4
+#endif
+
+/* Each route needs at most one node for its own prefix plus one glue node
+ * where its prefix branches away from an existing one.
+ */
+
+#define NET_LPM_NNODES (2 * CONFIG_NET_MAXROUTES)
+
 /****************************************************************************
  * Public Types
  ****************************************************************************/
@@ -92,6 +112,34 @@ struct net_route_ipv6_s
 typedef int (*route_handler_ipv6_t)(FAR struct net_route_ipv6_s *route, FAR void *arg);
 #endif
 
+/* One node of a longest-prefix-match tree.  This is a binary trie with path
+ * compression:  Each node holds a complete prefix and only the nodes where
+ * prefixes branch are present, so the depth of the tree is bounded by the
+ * number of routes as well as by the address size.  A node with no route
+ * is a glue node that exists only because two prefixes branch there.
+ */
+
+struct net_lpmnode_s
+{
+  FAR struct net_lpmnode_s *child[2]; /* Longer prefixes: next bit 0 or 1 */
+  FAR void *route;                    /* Route with this prefix or NULL */
+  uint8_t plen;                       /* Prefix length in bits */
+  uint8_t key[NET_LPM_KEYSIZE];       /* Prefix, network order, masked */
+};
+
+/* A longest-prefix-match tree */
+
+struct net_lpmtree_s
+{
+  FAR struct net_lpmnode_s *root;     /* The shortest prefix */
+  FAR struct net_lpmnode_s *free;     /* Free nodes, linked via child[0] */
+  uint8_t maxbits;                    /* Address size in bits */
+};
+
+/* Type of the route filter function provided to net_lpm_lookup() */
+
+typedef bool (*lpm_filter_t)(FAR void *route, FAR void *arg);
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -113,6 +161,16 @@ EXTERN sq_queue_t g_routes;
 EXTERN sq_queue_t g_routes_ipv6;
 #endif
 
+/* These are the longest-prefix-match indices of the routing tables */
+
+#ifdef CONFIG_NET_IPv4
+EXTERN struct net_lpmtree_s g_routetree;
+#endif
+
+#ifdef CONFIG_NET_IPv6
+EXTERN struct net_lpmtree_s g_routetree_ipv6;
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -344,10 +402,192 @@ int net_foreachroute(route_handler_t handler, FAR void *arg);
 int net_foreachroute_ipv6(route_handler_ipv6_t handler, FAR void *arg);
 #endif
 
+/****************************************************************************
+ * Function: net_lpm_initialize
+ *
+ * Description:
+ *   Initialize an empty longest-prefix-match tree.
+ *
+ * Parameters:
+ *   tree    - The tree to initialize
+ *   nodes   - Storage for the nodes of the tree
+ *   nnodes  - The number of nodes in the storage
+ *   maxbits - The size of the addresses in bits (32 or 128)
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void net_lpm_initialize(FAR struct net_lpmtree_s *tree,
+                        FAR struct net_lpmnode_s *nodes, int nnodes,
+                        int maxbits);
+
+/****************************************************************************
+ * Function: net_lpm_prefixlen
+ *
+ * Description:
+ *   Return the prefix length of a netmask in network order.
+ *
+ * Parameters:
+ *   mask   - The netmask
+ *   nbytes - The size of the netmask in bytes
+ *
+ * Returned Value:
+ *   The prefix length in bits, or -EINVAL if the mask is not contiguous.
+ *
+ ****************************************************************************/
+
+int net_lpm_prefixlen(FAR const void *mask, int nbytes);
+
+/****************************************************************************
+ * Function: net_lpm_insert
+ *
+ * Description:
+ *   Add a route to the tree.
+ *
+ * Parameters:
+ *   tree  - The tree
+ *   key   - The destination network in network order
+ *   plen  - The prefix length in bits
+ *   route - The route to return from net_lpm_lookup()
+ *
+ * Returned Value:
+ *   OK on success; -EEXIST if there is already a route for the same
+ *   prefix; -ENOMEM if no node is available.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+int net_lpm_insert(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                   int plen, FAR void *route);
+
+/****************************************************************************
+ * Function: net_lpm_remove
+ *
+ * Description:
+ *   Remove the route with exactly this prefix from the tree.
+ *
+ * Parameters:
+ *   tree  - The tree
+ *   key   - The destination network in network order
+ *   plen  - The prefix length in bits
+ *
+ * Returned Value:
+ *   The removed route, or NULL if there is no route for the prefix.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_remove(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                         int plen);
+
+/****************************************************************************
+ * Function: net_lpm_lookup
+ *
+ * Description:
+ *   Find the route with the longest prefix that matches an address.  The
+ *   cost is proportional to the depth of the tree, not to the number of
+ *   routes.
+ *
+ * Parameters:
+ *   tree   - The tree
+ *   key    - The address to look up in network order
+ *   filter - If non-NULL, only routes for which this returns true are
+ *            considered.
+ *   arg    - An argument passed to the filter
+ *
+ * Returned Value:
+ *   The matching route, or NULL if no route matches.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+FAR void *net_lpm_lookup(FAR struct net_lpmtree_s *tree, FAR const void *key,
+                         lpm_filter_t filter, FAR void *arg);
+
+/****************************************************************************
+ * Function: net_routecache_flush
+ *
+ * Description:
+ *   Invalidate the route cache.  Called whenever the routing table is
+ *   modified and whenever the address, netmask or state of a network
+ *   device changes.
+ *
+ * Parameters:
+ *   None
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_NET_ROUTE_CACHE_SIZE > 0
+void net_routecache_flush(void);
+#else
+#  define net_routecache_flush()
+#endif
+
+/****************************************************************************
+ * Function: net_routecache_ipv4_lookup and net_routecache_ipv4_add
+ *
+ * Description:
+ *   Look up or remember the router for a destination address.  The cache
+ *   is direct-mapped on the destination address.  dev is NULL for lookups
+ *   that are not constrained to a device.
+ *
+ * Parameters:
+ *   dev    - The device the router must be accessible from, or NULL
+ *   target - The destination address
+ *   router - The router address (returned on lookup)
+ *
+ * Returned Value:
+ *   net_routecache_ipv4_lookup() returns true on a cache hit.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv4) && CONFIG_NET_ROUTE_CACHE_SIZE > 0
+struct net_driver_s;
+bool net_routecache_ipv4_lookup(FAR struct net_driver_s *dev,
+                                in_addr_t target, FAR in_addr_t *router);
+void net_routecache_ipv4_add(FAR struct net_driver_s *dev,
+                             in_addr_t target, in_addr_t router);
+#endif
+
+/****************************************************************************
+ * Function: net_routecache_ipv6_lookup and net_routecache_ipv6_add
+ *
+ * Description:
+ *   The IPv6 equivalents of net_routecache_ipv4_lookup() and
+ *   net_routecache_ipv4_add().
+ *
+ ****************************************************************************/
+
+#if defined(CONFIG_NET_IPv6) && CONFIG_NET_ROUTE_CACHE_SIZE > 0
+struct net_driver_s;
+bool net_routecache_ipv6_lookup(FAR struct net_driver_s *dev,
+                                FAR const net_ipv6addr_t target,
+                                FAR net_ipv6addr_t router);
+void net_routecache_ipv6_add(FAR struct net_driver_s *dev,
+                             FAR const net_ipv6addr_t target,
+                             FAR const net_ipv6addr_t router);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
 #endif
 
+#else /* CONFIG_NET_ROUTE */
+#  define net_routecache_flush()
 #endif /* CONFIG_NET_ROUTE */
 #endif /* __NET_ROUTE_ROUTE_H */
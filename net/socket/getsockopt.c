@@ -43,9 +43,12 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
 #include <errno.h>
 
 #include "socket/socket.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -98,6 +101,38 @@ int psock_getsockopt(FAR struct socket *psock, int level, int option,
 {
   int errcode;
 
+#ifdef CONFIG_NET_TCP
+  /* Options at the IPPROTO_TCP level are handled by the TCP layer */
+
+  if (level == IPPROTO_TCP)
+    {
+      int ret = tcp_getsockopt(psock, option, value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  /* Options at the IPPROTO_UDP level are handled by the UDP layer */
+
+  if (level == IPPROTO_UDP)
+    {
+      int ret = udp_getsockopt(psock, option, value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_GETVALID(option) || !value || !value_len)
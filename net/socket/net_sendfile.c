@@ -53,13 +53,16 @@
 #include <string.h>
 #include <unistd.h>
 #include <errno.h>
+#include <assert.h>
 #include <debug.h>
 
 #include <arch/irq.h>
 #include <nuttx/clock.h>
 #include <nuttx/semaphore.h>
 #include <nuttx/fs/fs.h>
+#include <nuttx/fs/ioctl.h>
 #include <nuttx/net/net.h>
+#include <nuttx/net/iob.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/arp.h>
 #include <nuttx/net/tcp.h>
@@ -80,6 +83,12 @@
 #  define CONFIG_NET_TCP_SPLIT_SIZE 40
 #endif
 
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+#  if CONFIG_NET_SENDFILE_RAWINDOW + CONFIG_IOB_BUFSIZE > 65535
+#    error CONFIG_NET_SENDFILE_RAWINDOW is too large
+#  endif
+#endif
+
 #define TCPIPv4BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv4_HDRLEN])
 #define TCPIPv6BUF ((struct tcp_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev) + IPv6_HDRLEN])
 
@@ -106,6 +115,16 @@ struct sendfile_s
 #ifdef CONFIG_NET_SOCKOPTS
   systime_t          snd_time;    /* Last send time for determining timeout */
 #endif
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  FAR const uint8_t *snd_map;     /* File data at snd_foffset */
+#endif
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+  FAR struct iob_s  *snd_ra;      /* Read-ahead file data */
+  FAR struct iob_s  *snd_ratail;  /* Last I/O buffer in snd_ra */
+  uint32_t           snd_rastart; /* Offset of the first byte in snd_ra */
+  uint32_t           snd_raend;   /* Offset of the byte following snd_ra */
+  bool               snd_rawake;  /* The sending thread has been signalled */
+#endif
 };
 
 /****************************************************************************
@@ -152,6 +171,36 @@ static inline int sendfile_timeout(FAR struct sendfile_s *pstate)
 }
 #endif /* CONFIG_NET_SOCKOPTS */
 
+/****************************************************************************
+ * Function: sendfile_rawakeup
+ *
+ * Description:
+ *   Wake up the thread waiting in net_sendfile() so that it reads more of
+ *   the file ahead, unless it has already been signalled and has not yet
+ *   run.
+ *
+ * Parameters:
+ *   pstate - send state structure
+ *
+ * Returned Value:
+ *   None
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+static void sendfile_rawakeup(FAR struct sendfile_s *pstate)
+{
+  if (!pstate->snd_rawake)
+    {
+      pstate->snd_rawake = true;
+      sem_post(&pstate->snd_sem);
+    }
+}
+#endif
+
 static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
                               FAR void *pvpriv, uint16_t flags)
 {
@@ -176,7 +225,7 @@ static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
       if (IFF_IS_IPv6(dev->d_flags))
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET6);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET6);
           tcp = TCPIPv6BUF;
         }
 #endif /* CONFIG_NET_IPv6 */
@@ -186,7 +235,7 @@ static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
       else
 #endif
         {
-          DEBUGASSERT(pstate->snd_sock == PF_INET);
+          DEBUGASSERT(pstate->snd_sock->s_domain == PF_INET);
           tcp = TCPIPv4BUF;
         }
 #endif /* CONFIG_NET_IPv4 */
@@ -201,6 +250,19 @@ static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
       ninfo("ACK: acked=%d sent=%d flen=%d\n",
             pstate->snd_acked, pstate->snd_sent, pstate->snd_flen);
 
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+      /* Release the read-ahead buffers holding data that has been ACKed */
+
+      if (pstate->snd_ra != NULL && pstate->snd_acked > pstate->snd_rastart &&
+          pstate->snd_acked <= pstate->snd_raend)
+        {
+          pstate->snd_ra      = iob_trimhead(pstate->snd_ra,
+                                             pstate->snd_acked -
+                                             pstate->snd_rastart);
+          pstate->snd_rastart = pstate->snd_acked;
+        }
+#endif
+
       dev->d_sndlen = 0;
 
       flags &= ~TCP_ACKDATA;
@@ -228,9 +290,33 @@ static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
       pstate->snd_sent = -ENOTCONN;
     }
 
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+  /* Wake up the waiting thread when the transfer has completed or failed,
+   * or when less than half of the read-ahead window is left so that the
+   * thread can read more before the poll callback runs dry.
+   */
+
+  if (pstate->snd_sent < 0 || pstate->snd_acked >= pstate->snd_flen)
+    {
+      sendfile_rawakeup(pstate);
+    }
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  else if (pstate->snd_map != NULL)
+    {
+      /* The file data is in memory.  Nothing is read ahead. */
+    }
+#endif
+  else if (pstate->snd_raend < pstate->snd_flen &&
+           pstate->snd_raend - pstate->snd_acked <
+           CONFIG_NET_SENDFILE_RAWINDOW / 2)
+    {
+      sendfile_rawakeup(pstate);
+    }
+#else
   /* Wake up the waiting thread */
 
   sem_post(&pstate->snd_sem);
+#endif
 
   return flags;
 }
@@ -253,6 +339,12 @@ static uint16_t ack_interrupt(FAR struct net_driver_s *dev, FAR void *pvconn,
  *   NOTE 3: If CONFIG_NET_ARP_SEND then we can be assured that the IP
  *   address mapping is already in the ARP table.
  *
+ *   NOTE 4: If CONFIG_NET_ARP_PENDING is non-zero, then a packet to an
+ *   unresolved address is held and sent once the address is resolved.  It
+ *   must be counted as sent; sending the same data again would duplicate
+ *   it.  If the packet is dropped after all, the data is retransmitted
+ *   when the retransmission timer expires.
+ *
  * Parameters:
  *   conn  - The TCP connection structure
  *
@@ -272,7 +364,8 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
   if (conn->domain == PF_INET)
 #endif
     {
-#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND)
+#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND) && \
+    CONFIG_NET_ARP_PENDING == 0
       return (arp_find(conn->u.ipv4.raddr) != NULL);
 #else
       return true;
@@ -295,9 +388,97 @@ static inline bool sendfile_addrcheck(FAR struct tcp_conn_s *conn)
 }
 
 #else /* CONFIG_NET_ETHERNET */
-#  sendfile_addrcheck(r) (true)
+#  define sendfile_addrcheck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Function: sendfile_copyout
+ *
+ * Description:
+ *   Copy the file data for the next segment into the outgoing packet.
+ *
+ * Parameters:
+ *   pstate - send state structure
+ *   dest   - The location to copy the data to
+ *   sndlen - The maximum number of bytes to copy
+ *
+ * Returned Value:
+ *   The number of bytes copied on success; zero if the data has not yet
+ *   been read ahead; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+static int sendfile_copyout(FAR struct sendfile_s *pstate,
+                            FAR uint8_t *dest, uint32_t sndlen)
+{
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+  uint32_t avail;
+#else
+  int ret;
+#endif
+
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  /* If the file data is directly addressable, then just copy it */
+
+  if (pstate->snd_map != NULL)
+    {
+      memcpy(dest, &pstate->snd_map[pstate->snd_sent], sndlen);
+      return sndlen;
+    }
+#endif
+
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+  /* Otherwise, take what is available from the read-ahead buffers.  After
+   * a retransmission, snd_sent may be anywhere between snd_rastart and
+   * snd_raend.
+   */
+
+  avail = pstate->snd_raend - pstate->snd_sent;
+  if (avail == 0)
+    {
+      return 0;
+    }
+
+  if (sndlen > avail)
+    {
+      sndlen = avail;
+    }
+
+  return iob_copyout(dest, pstate->snd_ra, sndlen,
+                     pstate->snd_sent - pstate->snd_rastart);
+#else
+  /* Otherwise, read the data from the file */
+
+  ret = file_seek(pstate->snd_file,
+                  pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+  if (ret < 0)
+    {
+      int errcode = get_errno();
+      nerr("ERROR: Failed to lseek: %d\n", errcode);
+      return -errcode;
+    }
+
+  ret = file_read(pstate->snd_file, dest, sndlen);
+  if (ret < 0)
+    {
+      int errcode = get_errno();
+      nerr("ERROR: Failed to read from input file: %d\n", errcode);
+      return -errcode;
+    }
+  else if (ret == 0)
+    {
+      /* The file was truncated */
+
+      return -EIO;
+    }
+
+  return ret;
+#endif
+}
+
 /****************************************************************************
  * Function: sendfile_interrupt
  *
@@ -382,25 +563,25 @@ static uint16_t sendfile_interrupt(FAR struct net_driver_s *dev, FAR void *pvcon
            * happen until the polling cycle completes).
            */
 
-          ret = file_seek(pstate->snd_file,
-                          pstate->snd_foffset + pstate->snd_sent, SEEK_SET);
+          ret = sendfile_copyout(pstate, dev->d_appdata, sndlen);
           if (ret < 0)
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to lseek: %d\n", errcode);
-              pstate->snd_sent = -errcode;
+              pstate->snd_sent = ret;
               goto end_wait;
             }
-
-          ret = file_read(pstate->snd_file, dev->d_appdata, sndlen);
-          if (ret < 0)
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+          else if (ret == 0)
             {
-              int errcode = get_errno();
-              nerr("ERROR: Failed to read from input file: %d\n", errcode);
-              pstate->snd_sent = -errcode;
-              goto end_wait;
+              /* The sending thread has not yet read this far.  Wake it up
+               * (once) and wait for the next poll.
+               */
+
+              sendfile_rawakeup(pstate);
+              goto wait;
             }
+#endif
 
+          sndlen        = ret;
           dev->d_sndlen = sndlen;
 
           /* Set the sequence number for this packet.  NOTE:  The network updates
@@ -530,6 +711,167 @@ static inline void sendfile_txnotify(FAR struct socket *psock,
 #endif /* CONFIG_NET_IPv6 */
 }
 
+/****************************************************************************
+ * Function: sendfile_map
+ *
+ * Description:
+ *   Get the address of the file data if the file system supports the
+ *   FIOC_MMAP ioctl command and clip the transfer to the size of the file.
+ *
+ * Parameters:
+ *   filep  - The input file
+ *   offset - The file offset of the first byte to send
+ *   count  - The number of bytes to send.  Updated on return.
+ *
+ * Returned Value:
+ *   The address of the file data at offset or NULL if the file data is not
+ *   directly addressable.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_MMAP
+static FAR const uint8_t *sendfile_map(FAR struct file *filep, off_t offset,
+                                       FAR size_t *count)
+{
+  FAR void *addr;
+  off_t pos;
+  off_t size;
+  int ret;
+
+  ret = file_ioctl(filep, FIOC_MMAP, (unsigned long)((uintptr_t)&addr));
+  if (ret < 0)
+    {
+      return NULL;
+    }
+
+  /* Nothing prevents us from reading past the end of the file data, so get
+   * the size of the file (without changing the file position).
+   */
+
+  pos  = file_seek(filep, 0, SEEK_CUR);
+  size = file_seek(filep, 0, SEEK_END);
+  if (pos < 0 || size < 0 || file_seek(filep, pos, SEEK_SET) < 0)
+    {
+      return NULL;
+    }
+
+  if (offset >= size)
+    {
+      *count = 0;
+    }
+  else if (*count > size - offset)
+    {
+      *count = size - offset;
+    }
+
+  return (FAR const uint8_t *)addr + offset;
+}
+#endif /* CONFIG_NET_SENDFILE_MMAP */
+
+/****************************************************************************
+ * Function: sendfile_readahead
+ *
+ * Description:
+ *   Read the input file into the read-ahead buffers until the read-ahead
+ *   window is full.  The network is unlocked while the file is read.
+ *
+ * Parameters:
+ *   pstate - send state structure
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+static int sendfile_readahead(FAR struct sendfile_s *pstate)
+{
+  FAR struct iob_s *iob;
+  ssize_t nread;
+  size_t len;
+  off_t pos;
+  int errcode;
+
+  while (pstate->snd_sent >= 0 && pstate->snd_raend < pstate->snd_flen &&
+         pstate->snd_raend - pstate->snd_acked <
+         CONFIG_NET_SENDFILE_RAWINDOW)
+    {
+      len = pstate->snd_flen - pstate->snd_raend;
+      if (len > CONFIG_IOB_BUFSIZE)
+        {
+          len = CONFIG_IOB_BUFSIZE;
+        }
+
+      /* Read the next block without holding the network lock.  The poll
+       * callback may run meanwhile; it does not see this I/O buffer until
+       * it is added to the chain below.
+       */
+
+      net_unlock();
+
+      nread = -ENOMEM;
+      iob   = iob_alloc(false);
+      if (iob != NULL)
+        {
+          pos = file_seek(pstate->snd_file,
+                          pstate->snd_foffset + pstate->snd_raend, SEEK_SET);
+          if (pos >= 0)
+            {
+              nread = file_read(pstate->snd_file, iob->io_data, len);
+            }
+
+          if (pos < 0 || nread < 0)
+            {
+              errcode = get_errno();
+              nread   = -errcode;
+            }
+          else if (nread == 0)
+            {
+              /* The file was truncated */
+
+              nread = -EIO;
+            }
+        }
+
+      net_lock();
+
+      if (nread < 0)
+        {
+          nerr("ERROR: Failed to read from input file: %d\n", (int)nread);
+          if (iob != NULL)
+            {
+              iob_free(iob);
+            }
+
+          return (int)nread;
+        }
+
+      /* Add the new data to the end of the read-ahead chain */
+
+      iob->io_len    = nread;
+      iob->io_pktlen = nread;
+
+      if (pstate->snd_ra == NULL)
+        {
+          pstate->snd_ra = iob;
+        }
+      else
+        {
+          pstate->snd_ratail->io_flink = iob;
+          pstate->snd_ra->io_pktlen   += nread;
+        }
+
+      pstate->snd_ratail = iob;
+      pstate->snd_raend += nread;
+    }
+
+  return OK;
+}
+#endif /* CONFIG_NET_SENDFILE_READAHEAD */
+
 /****************************************************************************
  * Public Functions
  ****************************************************************************/
@@ -604,7 +946,14 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   FAR struct socket *psock = sockfd_socket(outfd);
   FAR struct tcp_conn_s *conn;
   struct sendfile_s state;
-  int errcode;
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  FAR const uint8_t *map;
+#endif
+  int errcode = 0;
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR) || \
+    defined(CONFIG_NET_SENDFILE_READAHEAD)
+  int ret;
+#endif
 
   /* Verify that the sockfd corresponds to valid, allocated socket */
 
@@ -667,6 +1016,12 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
 
   psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
 
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  /* Check if the file data can be accessed directly in memory */
+
+  map = sendfile_map(infile, offset ? *offset : 0, &count);
+#endif
+
   /* Initialize the state structure.  This is done with interrupts
    * disabled because we don't want anything to happen until we
    * are ready.
@@ -686,6 +1041,9 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
   state.snd_foffset = offset ? *offset : 0; /* Input file offset */
   state.snd_flen    = count;                /* Number of bytes to send */
   state.snd_file    = infile;               /* File to read from */
+#ifdef CONFIG_NET_SENDFILE_MMAP
+  state.snd_map     = map;                  /* File data in memory */
+#endif
 
   /* Allocate resources to receive a callback */
 
@@ -733,6 +1091,26 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
 
   do
     {
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+      /* Refill the read-ahead window (unless the file data is in memory).
+       * The callbacks may signal this thread again from now on.
+       */
+
+      state.snd_rawake = false;
+
+#ifdef CONFIG_NET_SENDFILE_MMAP
+      if (state.snd_map == NULL)
+#endif
+        {
+          ret = sendfile_readahead(&state);
+          if (ret < 0)
+            {
+              state.snd_sent = ret;
+              break;
+            }
+        }
+#endif
+
       state.snd_datacb->flags = TCP_POLL;
       state.snd_datacb->priv  = (FAR void *)&state;
       state.snd_datacb->event = sendfile_interrupt;
@@ -750,6 +1128,15 @@ ssize_t net_sendfile(int outfd, struct file *infile, off_t *offset,
 
   tcp_callback_free(conn, state.snd_ackcb);
 
+#ifdef CONFIG_NET_SENDFILE_READAHEAD
+  /* Free any unacknowledged read-ahead data */
+
+  if (state.snd_ra != NULL)
+    {
+      iob_free_chain(state.snd_ra);
+    }
+#endif
+
 errout_datacb:
   tcp_callback_free(conn, state.snd_datacb);
 
@@ -355,7 +355,8 @@ static inline void recvfrom_newudpdata(FAR struct net_driver_s *dev,
  *   None
  *
  * Assumptions:
- *   The network is locked.
+ *   The connection lock is not held by the caller;  it is taken here.  The
+ *   network may or may not be locked.
  *
  ****************************************************************************/
 
@@ -370,6 +371,7 @@ static inline void recvfrom_tcpreadahead(struct recvfrom_s *pstate)
    * buffer.
    */
 
+  tcp_conn_lock(conn);
   while ((iob = iob_peek_queue(&conn->readahead)) != NULL &&
           pstate->rf_buflen > 0)
     {
@@ -418,6 +420,8 @@ static inline void recvfrom_tcpreadahead(struct recvfrom_s *pstate)
           (void)iob_trimhead_queue(&conn->readahead, recvlen);
         }
     }
+
+  tcp_conn_unlock(conn);
 }
 #endif /* CONFIG_NET_UDP || CONFIG_NET_TCP */
 
@@ -478,7 +482,7 @@ static inline void recvfrom_udpreadahead(struct recvfrom_s *pstate)
       if (pstate->rf_buflen > 0)
         {
           recvlen = iob_copyout(pstate->rf_buffer, iob, pstate->rf_buflen,
-                                src_addr_size + sizeof(uint8_t));
+                                UDP_RA_HDRLEN(src_addr_size));
 
           ninfo("Received %d bytes (of %d)\n", recvlen, iob->io_pktlen);
 
@@ -1636,6 +1640,35 @@ static ssize_t tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
   struct recvfrom_s state;
   int               ret;
 
+#if defined(CONFIG_NET_FINE_LOCKS) && defined(CONFIG_NET_TCP_READAHEAD)
+  /* Copy the data already buffered in the read-ahead buffers to the caller
+   * before locking the network so that a receive that is satisfied from
+   * the read-ahead buffers does not wait for unrelated network activity.
+   * Data that arrives before the network is locked is picked up below.
+   */
+
+  recvfrom_init(psock, buf, len, from, fromlen, &state);
+  recvfrom_tcpreadahead(&state);
+
+  /* Return without locking the network if the read-ahead data satisfies
+   * the receive:  The user buffer is full, the socket is non-blocking, or
+   * we would not wait for more data anyway.
+   */
+
+#if CONFIG_NET_TCP_RECVDELAY == 0
+  if (state.rf_recvlen > 0)
+#else
+  if (state.rf_recvlen > 0 &&
+      (state.rf_buflen == 0 || _SS_ISNONBLOCK(psock->s_flags)))
+#endif
+    {
+      ret = state.rf_recvlen;
+      recvfrom_uninit(&state);
+      return (ssize_t)ret;
+    }
+
+  net_lock();
+#else
   /* Initialize the state structure.  This is done with interrupts
    * disabled because we don't want anything to happen until we
    * are ready.
@@ -1643,6 +1676,7 @@ static ssize_t tcp_recvfrom(FAR struct socket *psock, FAR void *buf, size_t len,
 
   net_lock();
   recvfrom_init(psock, buf, len, from, fromlen, &state);
+#endif
 
   /* Handle any any TCP data already buffered in a read-ahead buffer.  NOTE
    * that there may be read-ahead data to be retrieved even after the
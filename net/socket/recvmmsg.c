@@ -0,0 +1,704 @@
+/****************************************************************************
+ * net/socket/recvmmsg.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <netinet/udp.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <time.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "devif/devif.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* UDP datagrams are copied directly out of the read-ahead queue */
+
+#if defined(CONFIG_NET_UDP) && defined(CONFIG_NET_UDP_READAHEAD)
+#  define HAVE_UDP_RECVMMSG 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMMSG
+struct recvmmsg_s
+{
+  FAR struct devif_callback_s *rm_cb;  /* Reference to callback instance */
+  sem_t rm_sem;                        /* Wakes up the receiving thread */
+  int rm_result;                       /* Error reported by the callback */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: recvmmsg_expired
+ *
+ * Description:
+ *   Return true if the absolute time has passed.
+ *
+ ****************************************************************************/
+
+static bool recvmmsg_expired(FAR const struct timespec *abstime)
+{
+  struct timespec now;
+
+  (void)clock_gettime(CLOCK_REALTIME, &now);
+  return now.tv_sec > abstime->tv_sec ||
+         (now.tv_sec == abstime->tv_sec && now.tv_nsec >= abstime->tv_nsec);
+}
+
+/****************************************************************************
+ * Function: recvmmsg_grocmsg
+ *
+ * Description:
+ *   Report the segment size of coalesced datagrams in a UDP_GRO control
+ *   message, if there is room for it.
+ *
+ ****************************************************************************/
+
+#if defined(HAVE_UDP_RECVMMSG) && defined(CONFIG_NET_UDP_GRO)
+static void recvmmsg_grocmsg(FAR struct msghdr *msg, uint16_t segsize)
+{
+  FAR struct cmsghdr *cmsg;
+  int value = segsize;
+
+  if (msg->msg_control == NULL ||
+      msg->msg_controllen < CMSG_SPACE(sizeof(int)))
+    {
+      msg->msg_controllen = 0;
+      msg->msg_flags     |= MSG_CTRUNC;
+      return;
+    }
+
+  cmsg             = (FAR struct cmsghdr *)msg->msg_control;
+  cmsg->cmsg_len   = CMSG_LEN(sizeof(int));
+  cmsg->cmsg_level = IPPROTO_UDP;
+  cmsg->cmsg_type  = UDP_GRO;
+  memcpy(CMSG_DATA(cmsg), &value, sizeof(int));
+
+  msg->msg_controllen = CMSG_SPACE(sizeof(int));
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmmsg_udpcopy
+ *
+ * Description:
+ *   Copy one datagram from a read-ahead I/O buffer chain into the buffers
+ *   of a message.  See net/udp/udp.h for the layout of the chain.
+ *
+ * Returned Value:
+ *   The number of payload bytes copied.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMMSG
+static unsigned int recvmmsg_udpcopy(FAR struct iob_s *iob,
+                                     FAR struct msghdr *msg)
+{
+  unsigned int offset;
+  unsigned int total;
+  uint8_t src_addr_size;
+#ifdef CONFIG_NET_UDP_GRO
+  uint16_t segsize;
+#endif
+  int ret;
+  int i;
+
+  msg->msg_flags = 0;
+
+  if (iob_copyout(&src_addr_size, iob, sizeof(uint8_t), 0) !=
+      sizeof(uint8_t))
+    {
+      msg->msg_controllen = 0;
+      return 0;
+    }
+
+#ifdef CONFIG_NET_UDP_GRO
+  if (iob_copyout((FAR uint8_t *)&segsize, iob, sizeof(uint16_t),
+                  sizeof(uint8_t) + src_addr_size) == sizeof(uint16_t) &&
+      segsize > 0)
+    {
+      recvmmsg_grocmsg(msg, segsize);
+    }
+  else
+#endif
+    {
+      msg->msg_controllen = 0;
+    }
+
+  if (msg->msg_name != NULL)
+    {
+      socklen_t len = msg->msg_namelen;
+
+      if ((socklen_t)src_addr_size < len)
+        {
+          len = src_addr_size;
+        }
+
+      (void)iob_copyout((FAR uint8_t *)msg->msg_name, iob, len,
+                        sizeof(uint8_t));
+      msg->msg_namelen = src_addr_size;
+    }
+
+  /* Scatter the payload into the I/O vector */
+
+  offset = UDP_RA_HDRLEN(src_addr_size);
+  total  = 0;
+
+  for (i = 0; i < msg->msg_iovlen && offset < iob->io_pktlen; i++)
+    {
+      ret = iob_copyout((FAR uint8_t *)msg->msg_iov[i].iov_base, iob,
+                        msg->msg_iov[i].iov_len, offset);
+      if (ret <= 0)
+        {
+          break;
+        }
+
+      offset += ret;
+      total  += ret;
+    }
+
+  if (offset < iob->io_pktlen)
+    {
+      msg->msg_flags |= MSG_TRUNC;
+    }
+
+  return total;
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmmsg_udp_event
+ *
+ * Description:
+ *   Wake up the receiving thread when a datagram arrives.  The UDP_NEWDATA
+ *   flag is left set so that udp_callback() adds the datagram to the
+ *   read-ahead queue.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMMSG
+static uint16_t recvmmsg_udp_event(FAR struct net_driver_s *dev,
+                                   FAR void *pvconn, FAR void *pvpriv,
+                                   uint16_t flags)
+{
+  FAR struct recvmmsg_s *pstate = (FAR struct recvmmsg_s *)pvpriv;
+
+  if (pstate != NULL && (flags & (UDP_NEWDATA | NETDEV_DOWN)) != 0)
+    {
+      if ((flags & NETDEV_DOWN) != 0)
+        {
+          pstate->rm_result = -ENOTCONN;
+        }
+
+      /* Don't allow any further callbacks */
+
+      pstate->rm_cb->flags = 0;
+      pstate->rm_cb->priv  = NULL;
+      pstate->rm_cb->event = NULL;
+
+      sem_post(&pstate->rm_sem);
+    }
+
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmmsg_udpwait
+ *
+ * Description:
+ *   Wait until a datagram has been added to the read-ahead queue.
+ *
+ * Returned Value:
+ *   OK when a datagram may be available; a negated errno value on failure.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMMSG
+static int recvmmsg_udpwait(FAR struct udp_conn_s *conn,
+                            FAR const struct timespec *abstime)
+{
+  FAR struct net_driver_s *dev;
+  struct recvmmsg_s state;
+  int ret;
+
+  dev = udp_find_laddr_device(conn);
+
+  state.rm_cb = udp_callback_alloc(dev, conn);
+  if (state.rm_cb == NULL)
+    {
+      return -EBUSY;
+    }
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)sem_init(&state.rm_sem, 0, 0);
+  (void)sem_setprotocol(&state.rm_sem, SEM_PRIO_NONE);
+  state.rm_result = OK;
+
+  state.rm_cb->flags = (UDP_NEWDATA | NETDEV_DOWN);
+  state.rm_cb->priv  = (FAR void *)&state;
+  state.rm_cb->event = recvmmsg_udp_event;
+
+  if (abstime != NULL)
+    {
+      ret = net_timedwait(&state.rm_sem, abstime);
+    }
+  else
+    {
+      ret = net_lockedwait(&state.rm_sem);
+    }
+
+  if (ret < 0)
+    {
+      ret = -get_errno();
+      if (ret == -ETIMEDOUT)
+        {
+          ret = -EAGAIN;
+        }
+    }
+  else
+    {
+      ret = state.rm_result;
+    }
+
+  udp_callback_free(dev, conn, state.rm_cb);
+  sem_destroy(&state.rm_sem);
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Function: udp_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of UDP datagrams.  All datagrams that are in the
+ *   read-ahead queue are copied out while the network is locked once,
+ *   without setting up a callback for each of them.
+ *
+ * Returned Value:
+ *   The number of messages received; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_RECVMMSG
+static int udp_recvmmsg(FAR struct socket *psock,
+                        FAR struct mmsghdr *msgvec, unsigned int vlen,
+                        int flags, FAR const struct timespec *abstime)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct iob_s *iob;
+  unsigned int count = 0;
+  bool nonblock;
+  int ret;
+
+  nonblock = _SS_ISNONBLOCK(psock->s_flags) || (flags & MSG_DONTWAIT) != 0;
+
+  net_lock();
+
+  /* Setup the UDP remote connection */
+
+  ret = udp_connect(conn, NULL);
+  if (ret < 0)
+    {
+      goto errout_with_lock;
+    }
+
+  while (count < vlen)
+    {
+      /* Drain the datagrams that are already buffered */
+
+      while (count < vlen &&
+             (iob = iob_remove_queue(&conn->readahead)) != NULL)
+        {
+          msgvec[count].msg_len =
+            recvmmsg_udpcopy(iob, &msgvec[count].msg_hdr);
+
+          (void)iob_free_chain(iob);
+          count++;
+        }
+
+      if (count >= vlen || nonblock ||
+          (count > 0 && (flags & MSG_WAITFORONE) != 0) ||
+          (count > 0 && abstime != NULL && recvmmsg_expired(abstime)))
+        {
+          break;
+        }
+
+      /* Wait for more */
+
+      ret = recvmmsg_udpwait(conn, abstime);
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  if (count > 0)
+    {
+      ret = count;
+    }
+  else if (ret >= 0)
+    {
+      ret = -EAGAIN;
+    }
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Function: recvmmsg_one
+ *
+ * Description:
+ *   Receive one message with psock_recvfrom().  A message with more than
+ *   one I/O vector is received into a temporary buffer.
+ *
+ * Returned Value:
+ *   The number of bytes received; -1 on failure with errno set.
+ *
+ ****************************************************************************/
+
+static ssize_t recvmmsg_one(FAR struct socket *psock,
+                            FAR struct msghdr *msg, int flags)
+{
+  FAR struct sockaddr *from;
+  FAR socklen_t *fromlen;
+  FAR uint8_t *buffer;
+  size_t buflen;
+  ssize_t ret;
+  uint8_t dummy;
+  int i;
+
+  from    = (FAR struct sockaddr *)msg->msg_name;
+  fromlen = from != NULL ? &msg->msg_namelen : NULL;
+
+  msg->msg_flags      = 0;
+  msg->msg_controllen = 0;
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_recvfrom(psock, msg->msg_iov[0].iov_base,
+                            msg->msg_iov[0].iov_len, flags, from, fromlen);
+    }
+  else if (msg->msg_iovlen <= 0)
+    {
+      return psock_recvfrom(psock, &dummy, 0, flags, from, fromlen);
+    }
+
+  for (i = 0, buflen = 0; i < msg->msg_iovlen; i++)
+    {
+      buflen += msg->msg_iov[i].iov_len;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(buflen > 0 ? buflen : 1);
+  if (buffer == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  ret = psock_recvfrom(psock, buffer, buflen, flags, from, fromlen);
+  if (ret > 0)
+    {
+      size_t offset = 0;
+
+      for (i = 0; i < msg->msg_iovlen && offset < (size_t)ret; i++)
+        {
+          size_t ncopy = msg->msg_iov[i].iov_len;
+
+          if (ncopy > (size_t)ret - offset)
+            {
+              ncopy = (size_t)ret - offset;
+            }
+
+          memcpy(msg->msg_iov[i].iov_base, &buffer[offset], ncopy);
+          offset += ncopy;
+        }
+    }
+
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Function: generic_recvmmsg
+ *
+ * Description:
+ *   Receive a batch of messages with one psock_recvfrom() call per
+ *   message.  This is used for all sockets other than UDP sockets with
+ *   read-ahead buffering.
+ *
+ * Returned Value:
+ *   The number of messages received; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+static int generic_recvmmsg(FAR struct socket *psock,
+                            FAR struct mmsghdr *msgvec, unsigned int vlen,
+                            int flags, FAR const struct timespec *abstime)
+{
+  unsigned int count;
+  uint8_t saved;
+  ssize_t nbytes;
+  int ret = OK;
+
+  /* psock_recvfrom() does not honor MSG_DONTWAIT for all socket types, so
+   * the socket is made non-blocking instead.
+   */
+
+  saved = psock->s_flags & _SF_NONBLOCK;
+  if ((flags & MSG_DONTWAIT) != 0)
+    {
+      psock->s_flags |= _SF_NONBLOCK;
+    }
+
+  for (count = 0; count < vlen; count++)
+    {
+      nbytes = recvmmsg_one(psock, &msgvec[count].msg_hdr, flags);
+      if (nbytes < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      msgvec[count].msg_len = nbytes;
+
+      if (abstime != NULL && recvmmsg_expired(abstime))
+        {
+          count++;
+          break;
+        }
+
+      /* Don't wait for the following messages if MSG_WAITFORONE */
+
+      if ((flags & MSG_WAITFORONE) != 0)
+        {
+          psock->s_flags |= _SF_NONBLOCK;
+        }
+    }
+
+  psock->s_flags = (psock->s_flags & ~_SF_NONBLOCK) | saved;
+  return count > 0 ? (int)count : ret;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_recvmmsg
+ *
+ * Description:
+ *   Receive up to vlen messages from a socket in one call.  For UDP sockets
+ *   with read-ahead buffering, all datagrams already buffered are copied
+ *   out with the network locked once (unless MSG_PEEK is set).
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags (MSG_DONTWAIT and MSG_WAITFORONE are honored)
+ *   timeout  Time to wait for messages (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received and msg_len of
+ *   each is set to the number of bytes received.  On error, -1 is
+ *   returned and errno is set appropriately (see psock_recvfrom()).
+ *
+ ****************************************************************************/
+
+int psock_recvmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags,
+                   FAR struct timespec *timeout)
+{
+  FAR const struct timespec *abstime = NULL;
+  struct timespec deadline;
+  int ret;
+
+  /* Treat as a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+  /* Convert the relative timeout to the absolute time used by
+   * net_timedwait().
+   */
+
+  if (timeout != NULL)
+    {
+      (void)clock_gettime(CLOCK_REALTIME, &deadline);
+
+      deadline.tv_sec  += timeout->tv_sec;
+      deadline.tv_nsec += timeout->tv_nsec;
+      if (deadline.tv_nsec >= NSEC_PER_SEC)
+        {
+          deadline.tv_sec++;
+          deadline.tv_nsec -= NSEC_PER_SEC;
+        }
+
+      abstime = &deadline;
+    }
+
+#ifdef HAVE_UDP_RECVMMSG
+  /* The UDP fast path removes the datagrams from the read-ahead queue, so
+   * MSG_PEEK is left to the generic path.
+   */
+
+  if (psock->s_type == SOCK_DGRAM && psock->s_domain != PF_LOCAL &&
+      (flags & MSG_PEEK) == 0)
+    {
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_RECV);
+      ret = udp_recvmmsg(psock, msgvec, vlen, flags, abstime);
+      psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+    }
+  else
+#endif
+    {
+      ret = generic_recvmmsg(psock, msgvec, vlen, flags, abstime);
+    }
+
+  if (ret < 0)
+    {
+      goto errout;
+    }
+
+  leave_cancellation_point();
+  return ret;
+
+errout:
+  set_errno(-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+/****************************************************************************
+ * Function: recvmmsg
+ *
+ * Description:
+ *   Receive up to vlen messages from a socket in one call.  See
+ *   psock_recvmmsg().
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Receive flags
+ *   timeout  Time to wait for messages (may be NULL)
+ *
+ * Returned Value:
+ *   On success, returns the number of messages received.  On error, -1 is
+ *   returned and errno is set appropriately (see recvfrom()).
+ *
+ ****************************************************************************/
+
+int recvmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags, FAR struct timespec *timeout)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* recvmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* Then let psock_recvmmsg() do all of the work */
+
+  ret = psock_recvmmsg(psock, msgvec, vlen, flags, timeout);
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
@@ -0,0 +1,774 @@
+/****************************************************************************
+ * net/socket/sendmmsg.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#ifdef CONFIG_NET
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <semaphore.h>
+#include <errno.h>
+#include <debug.h>
+
+#include <nuttx/kmalloc.h>
+#include <nuttx/semaphore.h>
+#include <nuttx/cancelpt.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+#include <nuttx/net/udp.h>
+
+#include "netdev/netdev.h"
+#include "devif/devif.h"
+#include "arp/arp.h"
+#include "icmpv6/icmpv6.h"
+#include "udp/udp.h"
+#include "socket/socket.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* UDP datagrams are sent in batches from a single device callback */
+
+#ifdef CONFIG_NET_UDP
+#  define HAVE_UDP_SENDMMSG 1
+#endif
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_SENDMMSG
+/* The address of a UDP peer */
+
+union sendmmsg_addr_u
+{
+  struct sockaddr     addr;
+#ifdef CONFIG_NET_IPv4
+  struct sockaddr_in  addr4;
+#endif
+#ifdef CONFIG_NET_IPv6
+  struct sockaddr_in6 addr6;
+#endif
+};
+
+/* The state of one batch of datagrams */
+
+struct sendmmsg_s
+{
+  FAR struct socket *sm_sock;          /* The sending socket */
+  FAR struct devif_callback_s *sm_cb;  /* Reference to callback instance */
+  FAR struct mmsghdr *sm_msgvec;       /* The messages to send */
+  FAR const struct sockaddr *sm_peer;  /* Peer of a connected socket */
+  sem_t sm_sem;                        /* Wakes up the sending thread */
+  unsigned int sm_next;                /* Index of the next message */
+  unsigned int sm_end;                 /* Index after the batch */
+  int sm_result;                       /* Error reported by the callback */
+};
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: sendmmsg_one
+ *
+ * Description:
+ *   Send one message with psock_sendto().  A message with more than one
+ *   I/O vector is gathered into a temporary buffer first.
+ *
+ * Returned Value:
+ *   The number of bytes sent; -1 on failure with errno set.
+ *
+ ****************************************************************************/
+
+static ssize_t sendmmsg_one(FAR struct socket *psock,
+                            FAR const struct msghdr *msg, int flags)
+{
+  FAR const struct sockaddr *to;
+  FAR uint8_t *buffer;
+  size_t buflen;
+  size_t offset;
+  ssize_t ret;
+  uint8_t dummy = 0;
+  int i;
+
+  to = (FAR const struct sockaddr *)msg->msg_name;
+
+  if (msg->msg_iovlen == 1)
+    {
+      return psock_sendto(psock, msg->msg_iov[0].iov_base,
+                          msg->msg_iov[0].iov_len, flags, to,
+                          msg->msg_namelen);
+    }
+  else if (msg->msg_iovlen <= 0)
+    {
+      return psock_sendto(psock, &dummy, 0, flags, to, msg->msg_namelen);
+    }
+
+  for (i = 0, buflen = 0; i < msg->msg_iovlen; i++)
+    {
+      buflen += msg->msg_iov[i].iov_len;
+    }
+
+  buffer = (FAR uint8_t *)kmm_malloc(buflen > 0 ? buflen : 1);
+  if (buffer == NULL)
+    {
+      set_errno(ENOMEM);
+      return ERROR;
+    }
+
+  for (i = 0, offset = 0; i < msg->msg_iovlen; i++)
+    {
+      memcpy(&buffer[offset], msg->msg_iov[i].iov_base,
+             msg->msg_iov[i].iov_len);
+      offset += msg->msg_iov[i].iov_len;
+    }
+
+  ret = psock_sendto(psock, buffer, buflen, flags, to, msg->msg_namelen);
+  kmm_free(buffer);
+  return ret;
+}
+
+/****************************************************************************
+ * Function: sendmmsg_udpaddr
+ *
+ * Description:
+ *   Get the destination of a UDP message.  A message without an address
+ *   goes to the peer of a connected socket.
+ *
+ * Returned Value:
+ *   The destination address; NULL if the address is not valid for the
+ *   socket.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_SENDMMSG
+static FAR const struct sockaddr *
+sendmmsg_udpaddr(FAR struct socket *psock, FAR const struct msghdr *msg,
+                 FAR const struct sockaddr *peer)
+{
+  FAR const struct sockaddr *to;
+
+  to = (FAR const struct sockaddr *)msg->msg_name;
+  if (to == NULL || msg->msg_namelen == 0)
+    {
+      return peer;
+    }
+
+#ifdef CONFIG_NET_IPv4
+  if (psock->s_domain == PF_INET)
+    {
+      if (to->sa_family == AF_INET &&
+          msg->msg_namelen >= sizeof(struct sockaddr_in))
+        {
+          return to;
+        }
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET6)
+    {
+      if (to->sa_family == AF_INET6 &&
+          msg->msg_namelen >= sizeof(struct sockaddr_in6))
+        {
+          return to;
+        }
+    }
+#endif
+
+  return NULL;
+}
+#endif
+
+/****************************************************************************
+ * Function: sendmmsg_udpresolve
+ *
+ * Description:
+ *   Make sure that the link layer addresses of the destinations of the
+ *   messages in the ARP or Neighbor table.  This may block, so it is done
+ *   before the network is locked.
+ *
+ * Returned Value:
+ *   The number of messages, starting at 'start', whose destination could
+ *   be resolved.
+ *
+ ****************************************************************************/
+
+#if defined(HAVE_UDP_SENDMMSG) && \
+    (defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR))
+static unsigned int sendmmsg_udpresolve(FAR struct socket *psock,
+                                        FAR struct mmsghdr *msgvec,
+                                        unsigned int start,
+                                        unsigned int vlen,
+                                        FAR const struct sockaddr *peer)
+{
+  FAR const struct sockaddr *to;
+  unsigned int i;
+  int ret;
+
+  for (i = start; i < vlen; i++)
+    {
+      to = sendmmsg_udpaddr(psock, &msgvec[i].msg_hdr, peer);
+      if (to == NULL)
+        {
+          break;
+        }
+
+      ret = OK;
+
+#ifdef CONFIG_NET_ARP_SEND
+      if (psock->s_domain == PF_INET)
+        {
+          ret = arp_send(((FAR const struct sockaddr_in *)to)->
+                         sin_addr.s_addr);
+        }
+#endif
+
+#ifdef CONFIG_NET_ICMPv6_NEIGHBOR
+      if (psock->s_domain == PF_INET6)
+        {
+          ret = icmpv6_neighbor(((FAR const struct sockaddr_in6 *)to)->
+                                sin6_addr.s6_addr16);
+        }
+#endif
+
+      if (ret < 0)
+        {
+          break;
+        }
+    }
+
+  return i - start;
+}
+#endif
+
+/****************************************************************************
+ * Function: sendmmsg_udp_event
+ *
+ * Description:
+ *   Send the next datagram of the batch each time the device is polled.
+ *   The connection is marked so that devif_poll() polls it again at once
+ *   while the driver accepts more packets, so the whole batch may go out
+ *   in a single poll cycle.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_SENDMMSG
+static uint16_t sendmmsg_udp_event(FAR struct net_driver_s *dev,
+                                   FAR void *pvconn, FAR void *pvpriv,
+                                   uint16_t flags)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)pvconn;
+  FAR struct sendmmsg_s *pstate = (FAR struct sendmmsg_s *)pvpriv;
+  FAR struct msghdr *msg;
+  FAR uint8_t *dest;
+  size_t len;
+  int i;
+
+  if (pstate == NULL)
+    {
+      return flags;
+    }
+
+  if ((flags & NETDEV_DOWN) != 0)
+    {
+      nwarn("WARNING: Network is down\n");
+      pstate->sm_result = -ENETUNREACH;
+      goto end_wait;
+    }
+
+  /* Wait for the next poll if the outgoing packet is not available */
+
+  if (dev->d_sndlen > 0 || (flags & UDP_NEWDATA) != 0)
+    {
+      return flags;
+    }
+
+  /* Set the destination of this datagram and gather its data into the
+   * outgoing packet.
+   */
+
+  msg = &pstate->sm_msgvec[pstate->sm_next].msg_hdr;
+  (void)udp_connect(conn, sendmmsg_udpaddr(pstate->sm_sock, msg,
+                                           pstate->sm_peer));
+
+#if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
+  if (conn->domain == PF_INET)
+    {
+      udp_ipv4_select(dev);
+    }
+  else
+    {
+      udp_ipv6_select(dev);
+    }
+#endif
+
+  dest = dev->d_appdata;
+  for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+    {
+      memcpy(&dest[len], msg->msg_iov[i].iov_base, msg->msg_iov[i].iov_len);
+      len += msg->msg_iov[i].iov_len;
+    }
+
+  dev->d_sndlen = len;
+  pstate->sm_msgvec[pstate->sm_next].msg_len = len;
+
+  if (++pstate->sm_next < pstate->sm_end)
+    {
+      /* More to go */
+
+      conn->txmore = true;
+      return flags;
+    }
+
+end_wait:
+  conn->txmore = false;
+
+  /* Don't allow any further callbacks */
+
+  pstate->sm_cb->flags = 0;
+  pstate->sm_cb->priv  = NULL;
+  pstate->sm_cb->event = NULL;
+
+  sem_post(&pstate->sm_sem);
+  return flags;
+}
+#endif
+
+/****************************************************************************
+ * Function: sendmmsg_udpbatch
+ *
+ * Description:
+ *   Send a batch of UDP datagrams, starting with message 'start', that
+ *   all leave through the same network device.  A message that cannot be
+ *   part of a batch ends it.
+ *
+ * Returned Value:
+ *   The number of messages sent, zero if message 'start' cannot be sent in
+ *   a batch, or a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_SENDMMSG
+static int sendmmsg_udpbatch(FAR struct socket *psock,
+                             FAR struct mmsghdr *msgvec, unsigned int start,
+                             unsigned int vlen,
+                             FAR const struct sockaddr *peer)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR struct net_driver_s *dev = NULL;
+  FAR const struct sockaddr *to;
+  FAR struct msghdr *msg;
+  struct sendmmsg_s state;
+  unsigned int end;
+  uint16_t hdrlen;
+  size_t len;
+  int ret;
+  int i;
+
+#if defined(CONFIG_NET_ARP_SEND) || defined(CONFIG_NET_ICMPv6_NEIGHBOR)
+  /* Only messages whose destination has been resolved can be batched */
+
+  vlen = start + sendmmsg_udpresolve(psock, msgvec, start, vlen, peer);
+#endif
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (psock->s_domain == PF_INET)
+#endif
+    {
+      hdrlen = IPv4_HDRLEN + UDP_HDRLEN;
+    }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      hdrlen = IPv6_HDRLEN + UDP_HDRLEN;
+    }
+#endif
+
+  net_lock();
+
+  /* Find the messages that go out through the same device as the first
+   * one and that fit in one packet each.  Messages that must be segmented
+   * (UDP_SEGMENT) are sent on their own.
+   */
+
+  for (end = start; end < vlen; end++)
+    {
+      msg = &msgvec[end].msg_hdr;
+      to  = sendmmsg_udpaddr(psock, msg, peer);
+      if (to == NULL || msg->msg_iovlen <= 0)
+        {
+          break;
+        }
+
+      for (i = 0, len = 0; i < msg->msg_iovlen; i++)
+        {
+          len += msg->msg_iov[i].iov_len;
+        }
+
+      if (udp_connect(conn, to) < 0)
+        {
+          break;
+        }
+
+      if (dev == NULL)
+        {
+          dev = udp_find_raddr_device(conn);
+          if (dev == NULL)
+            {
+              break;
+            }
+        }
+      else if (udp_find_raddr_device(conn) != dev)
+        {
+          break;
+        }
+
+      if (len == 0 || len > UDP_MSS(dev, hdrlen)
+#ifdef CONFIG_NET_UDP_SEGMENT
+          || (conn->gso_size > 0 && len > conn->gso_size)
+#endif
+         )
+        {
+          break;
+        }
+    }
+
+  if (end == start)
+    {
+      ret = 0;
+      goto errout_with_lock;
+    }
+
+  /* Set up the callback in the connection */
+
+  state.sm_cb = udp_callback_alloc(dev, conn);
+  if (state.sm_cb == NULL)
+    {
+      ret = -EBUSY;
+      goto errout_with_lock;
+    }
+
+  /* This semaphore is used for signaling and, hence, should not have
+   * priority inheritance enabled.
+   */
+
+  (void)sem_init(&state.sm_sem, 0, 0);
+  (void)sem_setprotocol(&state.sm_sem, SEM_PRIO_NONE);
+
+  state.sm_sock    = psock;
+  state.sm_msgvec  = msgvec;
+  state.sm_peer    = peer;
+  state.sm_next    = start;
+  state.sm_end     = end;
+  state.sm_result  = OK;
+
+  state.sm_cb->flags = (UDP_POLL | NETDEV_DOWN);
+  state.sm_cb->priv  = (FAR void *)&state;
+  state.sm_cb->event = sendmmsg_udp_event;
+
+  /* Notify the device driver of the availability of TX data */
+
+  netdev_txnotify_dev(dev);
+
+  /* Wait for the batch to be sent.  net_lockedwait() also returns if a
+   * signal is received.
+   */
+
+  (void)net_lockedwait(&state.sm_sem);
+
+  udp_callback_free(dev, conn, state.sm_cb);
+  conn->txmore = false;
+  sem_destroy(&state.sm_sem);
+
+  /* Report the datagrams that were sent, if any */
+
+  ret = state.sm_next - start;
+  if (ret == 0)
+    {
+      ret = state.sm_result < 0 ? state.sm_result : -EINTR;
+    }
+
+errout_with_lock:
+  net_unlock();
+  return ret;
+}
+#endif
+
+/****************************************************************************
+ * Function: udp_sendmmsg
+ *
+ * Description:
+ *   Send a batch of messages on a UDP socket.  Consecutive datagrams that
+ *   leave through the same device are sent from one device callback;
+ *   other messages are sent one at a time with psock_sendto().
+ *
+ * Returned Value:
+ *   The number of messages sent; a negated errno value on failure.
+ *
+ ****************************************************************************/
+
+#ifdef HAVE_UDP_SENDMMSG
+static int udp_sendmmsg(FAR struct socket *psock,
+                        FAR struct mmsghdr *msgvec, unsigned int vlen,
+                        int flags)
+{
+  FAR struct udp_conn_s *conn = (FAR struct udp_conn_s *)psock->s_conn;
+  FAR const struct sockaddr *peer = NULL;
+  union sendmmsg_addr_u peeraddr;
+  unsigned int count = 0;
+  ssize_t nbytes;
+  int ret = OK;
+
+  /* Messages without an address go to the peer of a connected socket */
+
+  if (_SS_ISCONNECTED(psock->s_flags))
+    {
+      memset(&peeraddr, 0, sizeof(peeraddr));
+
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+      if (conn->domain == PF_INET)
+#endif
+        {
+          peeraddr.addr4.sin_family = AF_INET;
+          peeraddr.addr4.sin_port   = conn->rport;
+          net_ipv4addr_copy(peeraddr.addr4.sin_addr.s_addr,
+                            conn->u.ipv4.raddr);
+        }
+#endif
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+      else
+#endif
+        {
+          peeraddr.addr6.sin6_family = AF_INET6;
+          peeraddr.addr6.sin6_port   = conn->rport;
+          net_ipv6addr_copy(peeraddr.addr6.sin6_addr.s6_addr16,
+                            conn->u.ipv6.raddr);
+        }
+#endif
+
+      peer = &peeraddr.addr;
+    }
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_SEND);
+
+  while (count < vlen)
+    {
+      ret = sendmmsg_udpbatch(psock, msgvec, count, vlen, peer);
+      if (ret > 0)
+        {
+          count += ret;
+          continue;
+        }
+      else if (ret < 0)
+        {
+          break;
+        }
+
+      /* This message cannot be batched.  Send it on its own. */
+
+      nbytes = sendmmsg_one(psock, &msgvec[count].msg_hdr, flags);
+      if (nbytes < 0)
+        {
+          ret = -get_errno();
+          break;
+        }
+
+      msgvec[count++].msg_len = nbytes;
+    }
+
+  psock->s_flags = _SS_SETSTATE(psock->s_flags, _SF_IDLE);
+  return count > 0 ? (int)count : ret;
+}
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: psock_sendmmsg
+ *
+ * Description:
+ *   Send up to vlen messages on a socket in one call.  On UDP sockets,
+ *   consecutive datagrams are sent from one device callback, so that they
+ *   may all go out in a single device poll.
+ *
+ * Parameters:
+ *   psock    A pointer to a NuttX-specific, internal socket structure
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent and msg_len of each is
+ *   set to the number of bytes sent.  If the first message cannot be sent,
+ *   -1 is returned and errno is set appropriately (see psock_sendto()).
+ *
+ ****************************************************************************/
+
+int psock_sendmmsg(FAR struct socket *psock, FAR struct mmsghdr *msgvec,
+                   unsigned int vlen, int flags)
+{
+  unsigned int count;
+  ssize_t nbytes;
+  int ret = OK;
+
+  /* Treat as a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Verify that the sockfd corresponds to valid, allocated socket */
+
+  if (psock == NULL || psock->s_crefs <= 0)
+    {
+      ret = -EBADF;
+      goto errout;
+    }
+
+  if (msgvec == NULL && vlen > 0)
+    {
+      ret = -EINVAL;
+      goto errout;
+    }
+
+#ifdef HAVE_UDP_SENDMMSG
+  if (psock->s_type == SOCK_DGRAM && psock->s_domain != PF_LOCAL)
+    {
+      ret = udp_sendmmsg(psock, msgvec, vlen, flags);
+      if (ret < 0)
+        {
+          goto errout;
+        }
+
+      leave_cancellation_point();
+      return ret;
+    }
+#endif
+
+  /* Stop at the first message that cannot be sent.  The error is reported
+   * only if no message was sent.
+   */
+
+  for (count = 0; count < vlen; count++)
+    {
+      nbytes = sendmmsg_one(psock, &msgvec[count].msg_hdr, flags);
+      if (nbytes < 0)
+        {
+          if (count == 0)
+            {
+              leave_cancellation_point();
+              return ERROR;
+            }
+
+          break;
+        }
+
+      msgvec[count].msg_len = nbytes;
+    }
+
+  leave_cancellation_point();
+  return count;
+
+errout:
+  set_errno(-ret);
+  leave_cancellation_point();
+  return ERROR;
+}
+
+/****************************************************************************
+ * Function: sendmmsg
+ *
+ * Description:
+ *   Send up to vlen messages on a socket in one call.  See
+ *   psock_sendmmsg().
+ *
+ * Parameters:
+ *   sockfd   Socket descriptor of socket
+ *   msgvec   Array of message headers
+ *   vlen     Number of entries in msgvec
+ *   flags    Send flags
+ *
+ * Returned Value:
+ *   On success, returns the number of messages sent.  On error, -1 is
+ *   returned and errno is set appropriately (see sendto()).
+ *
+ ****************************************************************************/
+
+int sendmmsg(int sockfd, FAR struct mmsghdr *msgvec, unsigned int vlen,
+             int flags)
+{
+  FAR struct socket *psock;
+  int ret;
+
+  /* sendmmsg() is a cancellation point */
+
+  (void)enter_cancellation_point();
+
+  /* Get the underlying socket structure */
+
+  psock = sockfd_socket(sockfd);
+
+  /* And let psock_sendmmsg do all of the work */
+
+  ret = psock_sendmmsg(psock, msgvec, vlen, flags);
+  leave_cancellation_point();
+  return ret;
+}
+
+#endif /* CONFIG_NET */
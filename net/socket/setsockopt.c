@@ -44,12 +44,15 @@
 #include <sys/types.h>
 #include <sys/socket.h>
 #include <sys/time.h>
+#include <netinet/in.h>
 #include <errno.h>
 #include <arch/irq.h>
 
 #include <nuttx/net/net.h>
 
 #include "socket/socket.h"
+#include "tcp/tcp.h"
+#include "udp/udp.h"
 #include "utils/utils.h"
 
 /****************************************************************************
@@ -107,6 +110,38 @@ int psock_setsockopt(FAR struct socket *psock, int level, int option,
 {
   int errcode;
 
+#ifdef CONFIG_NET_TCP
+  /* Options at the IPPROTO_TCP level are handled by the TCP layer */
+
+  if (level == IPPROTO_TCP)
+    {
+      int ret = tcp_setsockopt(psock, option, value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
+#ifdef CONFIG_NET_UDP
+  /* Options at the IPPROTO_UDP level are handled by the UDP layer */
+
+  if (level == IPPROTO_UDP)
+    {
+      int ret = udp_setsockopt(psock, option, value, value_len);
+      if (ret < 0)
+        {
+          errcode = -ret;
+          goto errout;
+        }
+
+      return OK;
+    }
+#endif
+
   /* Verify that the socket option if valid (but might not be supported ) */
 
   if (!_SO_SETVALID(option) || !value)
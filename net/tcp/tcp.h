@@ -45,6 +45,8 @@
 #include <sys/types.h>
 #include <queue.h>
 
+#include <nuttx/clock.h>
+#include <nuttx/net/net.h>
 #include <nuttx/net/iob.h>
 #include <nuttx/net/ip.h>
 
@@ -101,6 +103,18 @@
     devif_conn_callback_free(g_netdevices, cb, NULL)
 #endif
 
+/* Take and release the lock of a connection.  Without
+ * CONFIG_NET_FINE_LOCKS, that is the network lock.
+ */
+
+#if defined(CONFIG_NET_FINE_LOCKS) && defined(CONFIG_NET_TCP_READAHEAD)
+#  define tcp_conn_lock(conn)   net_rmutex_lock(&(conn)->lock)
+#  define tcp_conn_unlock(conn) net_rmutex_unlock(&(conn)->lock)
+#else
+#  define tcp_conn_lock(conn)   net_lock()
+#  define tcp_conn_unlock(conn) net_unlock()
+#endif
+
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
 /* TCP write buffer access macros */
 
@@ -123,6 +137,47 @@
 #endif
 #endif
 
+/* Sequence number comparisons that are immune to wrap-around */
+
+#define TCP_SEQ_LT(a,b)   ((int32_t)((a) - (b)) < 0)
+#define TCP_SEQ_GT(a,b)   ((int32_t)((a) - (b)) > 0)
+#define TCP_SEQ_LTE(a,b)  ((int32_t)((a) - (b)) <= 0)
+#define TCP_SEQ_GTE(a,b)  ((int32_t)((a) - (b)) >= 0)
+
+/* Values of the optflags field of struct tcp_conn_s.  These record which
+ * TCP options were negotiated when the connection was established.
+ */
+
+#define TCP_OPTF_WSCALE   (1 << 0) /* Window scaling in use (RFC 7323) */
+#define TCP_OPTF_SACK     (1 << 1) /* SACK permitted (RFC 2018) */
+
+#if defined(CONFIG_NET_TCP_NAGLE) || defined(CONFIG_NET_TCP_DELAYED_ACK)
+/* Values of the txflags field of struct tcp_conn_s */
+
+#  define HAVE_TCP_TXFLAGS 1
+#  define TCP_TXF_NODELAY  (1 << 0) /* TCP_NODELAY: Nagle algorithm off */
+#  define TCP_TXF_CORK     (1 << 1) /* TCP_CORK: Hold back partial segments */
+#  define TCP_TXF_DELACK   (1 << 2) /* The ACK of received data is delayed */
+#endif
+
+#ifdef CONFIG_NET_TCP_CC
+/* Values of the ccflags field of struct tcp_conn_s */
+
+#  define TCP_CCF_RECOVERY (1 << 0) /* In fast recovery */
+#  define TCP_CCF_RTO      (1 << 1) /* Retransmission timeout, no new ACK */
+
+/* Number of duplicate ACKs that trigger a fast retransmit */
+
+#  define TCP_CC_DUPTHRESH 3
+
+/* The usable send window is the smaller of the congestion window and the
+ * window advertised by the peer.
+ */
+
+#  define TCP_CC_SNDWND(c) \
+     ((c)->cwnd < (c)->winsize ? (c)->cwnd : (c)->winsize)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -141,9 +196,50 @@ struct devif_callback_s;  /* Forward reference */
 struct tcp_backlog_s;     /* Forward reference */
 struct tcp_hdr_s;         /* Forward reference */
 
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion control algorithm.  Slow start, fast retransmit, and fast
+ * recovery are common to all algorithms and are implemented in
+ * tcp_cc.c.  An algorithm provides only the congestion avoidance phase and
+ * the reaction to a loss:
+ *
+ *   init       - Initialize algorithm state when the connection is
+ *                established (optional)
+ *   congavoid  - Open the congestion window in response to the ACK of
+ *                'acked' new bytes while cwnd >= ssthresh
+ *   ssthresh   - A loss was detected.  Return the new slow start
+ *                threshold.
+ */
+
+struct tcp_conn_s;        /* Forward reference */
+
+struct tcp_cc_ops_s
+{
+  CODE void     (*init)(FAR struct tcp_conn_s *conn);
+  CODE void     (*congavoid)(FAR struct tcp_conn_s *conn, uint32_t acked);
+  CODE uint32_t (*ssthresh)(FAR struct tcp_conn_s *conn);
+};
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+/* One range of data that was received beyond a hole in the sequence space.
+ * The ranges held by a connection never overlap.
+ */
+
+struct tcp_ofoseg_s
+{
+  uint32_t left;          /* Sequence number of the first byte */
+  uint32_t right;         /* Sequence number following the last byte */
+  FAR struct iob_s *iob;  /* The data */
+};
+#endif
+
 struct tcp_conn_s
 {
   dq_entry_t node;        /* Implements a doubly linked list */
+#ifdef CONFIG_NET_TCP_CONNHASH
+  FAR struct tcp_conn_s *hnext; /* Next in the active connection hash chain */
+  FAR struct tcp_conn_s *pnext; /* Next in the local port hash chain */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint8_t  rcvseq[4];     /* The sequence number that we expect to
                            * receive next */
@@ -165,7 +261,17 @@ struct tcp_conn_s
   uint16_t rport;         /* The remoteTCP port, in network byte order */
   uint16_t mss;           /* Current maximum segment size for the
                            * connection */
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  uint32_t winsize;       /* Current window size of the connection */
+  uint8_t  snd_wscale;    /* Shift count applied to the peer's window */
+  uint8_t  rcv_wscale;    /* Shift count applied to our window */
+#else
   uint16_t winsize;       /* Current window size of the connection */
+#endif
+  uint8_t  optflags;      /* Negotiated TCP options.  See TCP_OPTF_* */
+#ifdef HAVE_TCP_TXFLAGS
+  uint8_t  txflags;       /* Nagle and delayed ACK state.  See TCP_TXF_* */
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   uint32_t unacked;       /* Number bytes sent but not yet ACKed */
 #else
@@ -189,6 +295,14 @@ struct tcp_conn_s
    */
 
   struct iob_queue_s readahead;   /* Read-ahead buffering */
+
+#ifdef CONFIG_NET_FINE_LOCKS
+  /* The connection lock.  This protects only the read-ahead buffers so
+   * far;  all other connection state is protected by the network lock.
+   */
+
+  struct net_rmutex_s lock;
+#endif
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -210,6 +324,59 @@ struct tcp_conn_s
                            * segment (next greater sndseq) */
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Congestion control
+   *
+   *   cc       - The congestion control algorithm in use
+   *   cwnd     - The congestion window (bytes)
+   *   ssthresh - The slow start threshold (bytes)
+   *   lastack  - The highest acknowledgement number received
+   *   recover  - The highest sequence number sent when fast recovery
+   *              was last entered (RFC 6582)
+   *   dupacks  - The number of consecutive duplicate ACKs received
+   *   ccflags  - See TCP_CCF_* definitions
+   */
+
+  FAR const struct tcp_cc_ops_s *cc;
+  uint32_t   cwnd;        /* Congestion window */
+  uint32_t   ssthresh;    /* Slow start threshold */
+  uint32_t   lastack;     /* Highest ACK number received */
+  uint32_t   recover;     /* NewReno recovery point */
+  uint8_t    dupacks;     /* Number of duplicate ACKs received */
+  uint8_t    ccflags;     /* Congestion control flags */
+
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  /* CUBIC state (RFC 8312)
+   *
+   *   wmax     - The congestion window just before the last reduction
+   *   west     - The estimate of the window of a standard TCP flow
+   *   kmsec    - The time to grow back to wmax (msec)
+   *   epoch    - Start time of the current congestion avoidance epoch
+   */
+
+  uint32_t   wmax;        /* Window before the last reduction */
+  uint32_t   west;        /* Standard TCP window estimate */
+  uint32_t   kmsec;       /* Time period to reach wmax (msec) */
+  systime_t  epoch;       /* Start of the congestion avoidance epoch */
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Selective acknowledgement
+   *
+   *   ofosegs  - Out-of-order data, in ascending sequence number order
+   *   nofosegs - The number of valid entries in ofosegs[]
+   *   sacklast - The sequence number of the most recently received
+   *              out-of-order data.  Its range is reported first.
+   *   sackhigh - The highest sequence number SACKed by the peer
+   */
+
+  struct tcp_ofoseg_s ofosegs[CONFIG_NET_TCP_NOFOSEGS];
+  uint8_t    nofosegs;    /* Number of out-of-order ranges */
+  uint32_t   sacklast;    /* Most recent out-of-order data */
+  uint32_t   sackhigh;    /* Highest sequence number SACKed by the peer */
+#endif
+
 #ifdef CONFIG_NET_TCPBACKLOG
   /* Listen backlog support
    *
@@ -291,6 +458,9 @@ struct tcp_wrbuffer_s
   uint16_t   wb_sent;      /* Number of bytes sent from the I/O buffer chain */
   uint8_t    wb_nrtx;      /* The number of retransmissions for the last
                             * segment sent */
+#ifdef CONFIG_NET_TCP_SACK
+  uint8_t    wb_sacked;    /* True: Selectively acknowledged by the peer */
+#endif
   struct iob_s *wb_iob;    /* Head of the I/O buffer chain */
 };
 #endif
@@ -338,6 +508,15 @@ extern "C"
 EXTERN struct net_driver_s *g_netdevices;
 #endif
 
+#ifdef CONFIG_NET_TCP_CC
+/* Congestion avoidance algorithms */
+
+EXTERN const struct tcp_cc_ops_s g_tcp_newreno;
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+EXTERN const struct tcp_cc_ops_s g_tcp_cubic;
+#endif
+#endif
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -857,6 +1036,224 @@ void tcp_appsend(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 void tcp_rexmit(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
                 uint16_t result);
 
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide whether the ACK of newly received, in-order data may be delayed.
+ *   At most one ACK is delayed per connection (RFC 1122, section 4.2.3.2):
+ *   If an ACK is already being delayed, then the ACK must be sent now.
+ *   Otherwise, the ACK is marked as delayed and the delayed ACK timer is
+ *   started.  The delayed ACK is sent when the device next polls the
+ *   connection after the timer expires, unless it is sent with some other
+ *   segment before that.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   true if the ACK is delayed; false if the ACK must be sent now.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+bool tcp_delack(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   entered the ESTABLISHED state:  Set the initial congestion window
+ *   (RFC 3390) and an arbitrarily high slow start threshold.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.  conn->mss and conn->isn are valid.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_init(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state on receipt of an ACK in the
+ *   ESTABLISHED state.  New data ACKed opens the congestion window (slow
+ *   start or congestion avoidance) or, in fast recovery, deflates it.
+ *   Duplicate ACKs are counted and the third one enters fast recovery.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment qualifies as a duplicate ACK:  It carries
+ *            no data and does not update the window
+ *
+ * Return:
+ *   True if the oldest unacknowledged segment must be retransmitted now
+ *   (fast retransmit or a partial ACK during fast recovery).
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack);
+#endif
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofo_insert
+ *
+ * Description:
+ *   Retain data that was received beyond a hole in the sequence space.
+ *   Only the parts that are not already held are copied into new I/O
+ *   buffer chains.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - The received data
+ *   buflen - The number of bytes of data
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_ofo_insert(FAR struct tcp_conn_s *conn, uint32_t seqno,
+                    FAR const uint8_t *buffer, uint16_t buflen);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofo_drain
+ *
+ * Description:
+ *   Move out-of-order data that has become contiguous with conn->rcvseq to
+ *   the read-ahead buffers and advance conn->rcvseq past it.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   The number of bytes moved to the read-ahead buffers.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+uint32_t tcp_ofo_drain(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_ofo_free
+ *
+ * Description:
+ *   Discard all out-of-order data held by a connection.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_ofo_free(FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_build
+ *
+ * Description:
+ *   Build the SACK option describing the out-of-order data held by the
+ *   connection.  The range containing the most recently received data is
+ *   reported first (RFC 2018, section 4).
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   opt  - The location of the option in the outgoing TCP header
+ *
+ * Return:
+ *   The length of the option in bytes, a multiple of four.  Zero if there
+ *   is no out-of-order data.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+unsigned int tcp_sack_build(FAR struct tcp_conn_s *conn, FAR uint8_t *opt);
+#endif
+
+/****************************************************************************
+ * Name: tcp_sack_update
+ *
+ * Description:
+ *   Update the SACK scoreboard from the SACK option of an incoming ACK:
+ *   Mark the unacknowledged write buffers that the peer has received.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   tcp  - The TCP header of the incoming segment, with its options
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+void tcp_sack_update(FAR struct tcp_conn_s *conn,
+                     FAR struct tcp_hdr_s *tcp);
+#endif
+
 /****************************************************************************
  * Name: tcp_ipv4_input
  *
@@ -1175,6 +1572,77 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
 int psock_tcp_cansend(FAR struct socket *psock);
 
+/****************************************************************************
+ * Function: tcp_send_txnotify
+ *
+ * Description:
+ *   Notify the appropriate device driver that we are have data ready to
+ *   be send (TCP)
+ *
+ * Parameters:
+ *   psock - Socket state structure
+ *   conn  - The TCP connection structure
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WRITE_BUFFERS
+void tcp_send_txnotify(FAR struct socket *psock,
+                       FAR struct tcp_conn_s *conn);
+#endif
+
+/****************************************************************************
+ * Function: tcp_setsockopt
+ *
+ * Description:
+ *   tcp_setsockopt() sets the TCP protocol option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument.  This
+ *   implements setsockopt() for the IPPROTO_TCP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_setsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int tcp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Function: tcp_getsockopt
+ *
+ * Description:
+ *   tcp_getsockopt() retrieves the value of the TCP protocol option
+ *   specified by the 'option' argument.  This implements getsockopt() for
+ *   the IPPROTO_TCP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_getsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int tcp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
 /****************************************************************************
  * Function: tcp_wrbuffer_initialize
  *
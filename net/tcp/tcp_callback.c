@@ -238,11 +238,11 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
   int ret;
 
   /* Try to allocate on I/O buffer to start the chain without waiting (and
-   * throttling as necessary).  If we would have to wait, then drop the
-   * packet.
+   * throttling as necessary), preferably one that holds the whole segment.
+   * If we would have to wait, then drop the packet.
    */
 
-  iob = iob_tryalloc(true);
+  iob = iob_tryalloc_sized(buflen, true);
   if (iob == NULL)
     {
       nerr("ERROR: Failed to create new I/O buffer chain\n");
@@ -267,7 +267,10 @@ uint16_t tcp_datahandler(FAR struct tcp_conn_s *conn, FAR uint8_t *buffer,
    * without waiting).
    */
 
+  tcp_conn_lock(conn);
   ret = iob_tryadd_queue(iob, &conn->readahead);
+  tcp_conn_unlock(conn);
+
   if (ret < 0)
     {
       nerr("ERROR: Failed to queue the I/O buffer chain: %d\n", ret);
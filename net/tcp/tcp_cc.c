@@ -0,0 +1,360 @@
+/****************************************************************************
+ * net/tcp/tcp_cc.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/tcp.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* Initial window (RFC 3390): min(4*MSS, max(2*MSS, 4380 bytes)) */
+
+#define TCP_CC_IW(mss) \
+  ((mss) > 1095 ? ((mss) > 2190 ? 2 * (mss) : 4380) : 4 * (mss))
+
+/* The congestion window need never exceed the largest window that the peer
+ * could advertise.
+ */
+
+#define TCP_CC_MAXWND     ((uint32_t)UINT16_MAX << TCP_WS_MAXSHIFT)
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void     newreno_congavoid(FAR struct tcp_conn_s *conn,
+                                  uint32_t acked);
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_newreno =
+{
+  NULL,                 /* init */
+  newreno_congavoid,    /* congavoid */
+  newreno_ssthresh      /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: newreno_congavoid
+ *
+ * Description:
+ *   Congestion avoidance (RFC 5681, section 3.1):  Increase the congestion
+ *   window by about one segment per round trip time.
+ *
+ ****************************************************************************/
+
+static void newreno_congavoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  uint32_t incr;
+
+  incr = ((uint32_t)conn->mss * conn->mss) / conn->cwnd;
+  conn->cwnd += incr > 0 ? incr : 1;
+}
+
+/****************************************************************************
+ * Name: newreno_ssthresh
+ *
+ * Description:
+ *   Return the slow start threshold after a loss (RFC 5681, equation 4):
+ *   Half of the amount of data in flight, but at least two segments.
+ *
+ ****************************************************************************/
+
+static uint32_t newreno_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t ssthresh = conn->unacked >> 1;
+  uint32_t minthresh = 2 * (uint32_t)conn->mss;
+
+  return ssthresh > minthresh ? ssthresh : minthresh;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_cc_init
+ *
+ * Description:
+ *   Initialize the congestion control state of a connection that has just
+ *   entered the ESTABLISHED state:  Set the initial congestion window
+ *   (RFC 3390) and an arbitrarily high slow start threshold.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.  conn->mss and conn->isn are valid.
+ *
+ ****************************************************************************/
+
+void tcp_cc_init(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_TCP_CC_CUBIC
+  conn->cc       = &g_tcp_cubic;
+#else
+  conn->cc       = &g_tcp_newreno;
+#endif
+  conn->cwnd     = TCP_CC_IW((uint32_t)conn->mss);
+  conn->ssthresh = TCP_CC_MAXWND;
+
+  /* The ISN is the first sequence number that may be ACKed.  recover is
+   * initialized so that a loss of the very first segment can still enter
+   * fast recovery (RFC 6582, section 3.2, step 1).
+   */
+
+  conn->lastack  = conn->isn;
+  conn->recover  = conn->isn - 1;
+  conn->dupacks  = 0;
+  conn->ccflags  = 0;
+#ifdef CONFIG_NET_TCP_SACK
+  conn->sackhigh = conn->isn;
+#endif
+
+  if (conn->cc->init != NULL)
+    {
+      conn->cc->init(conn);
+    }
+
+  ninfo("cwnd=%u ssthresh=%u\n", conn->cwnd, conn->ssthresh);
+}
+
+/****************************************************************************
+ * Name: tcp_cc_ack
+ *
+ * Description:
+ *   Update the congestion control state on receipt of an ACK in the
+ *   ESTABLISHED state.  New data ACKed opens the congestion window (slow
+ *   start or congestion avoidance) or, in fast recovery, deflates it.
+ *   Duplicate ACKs are counted and the third one enters fast recovery.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   ackno  - The acknowledgement number of the incoming segment
+ *   dupack - True if the segment qualifies as a duplicate ACK:  It carries
+ *            no data and does not update the window
+ *
+ * Return:
+ *   True if the oldest unacknowledged segment must be retransmitted now
+ *   (fast retransmit or a partial ACK during fast recovery).
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+bool tcp_cc_ack(FAR struct tcp_conn_s *conn, uint32_t ackno, bool dupack)
+{
+  uint32_t mss = conn->mss;
+  uint32_t acked;
+
+  if (TCP_SEQ_GT(ackno, conn->lastack))
+    {
+      /* New data has been acknowledged */
+
+      acked          = ackno - conn->lastack;
+      conn->lastack  = ackno;
+      conn->dupacks  = 0;
+      conn->ccflags &= ~TCP_CCF_RTO;
+
+      if ((conn->ccflags & TCP_CCF_RECOVERY) != 0)
+        {
+          if (TCP_SEQ_GTE(ackno, conn->recover))
+            {
+              uint32_t flight;
+
+              /* A full acknowledgement ends fast recovery.  Deflate the
+               * window to min(ssthresh, max(FlightSize, SMSS) + SMSS)
+               * (RFC 6582, section 3.2, step 3).
+               */
+
+              flight      = conn->unacked > mss ? conn->unacked : mss;
+              conn->cwnd  = flight + mss < conn->ssthresh ?
+                            flight + mss : conn->ssthresh;
+              conn->ccflags &= ~TCP_CCF_RECOVERY;
+
+              ninfo("Exit recovery: cwnd=%u\n", conn->cwnd);
+              return false;
+            }
+
+          /* A partial acknowledgement:  The segment after the one ACKed
+           * was lost too.  Retransmit it, deflate the window by the amount
+           * of new data ACKed, and add back one segment if at least one
+           * segment was ACKed (RFC 6582, section 3.2, step 5).
+           */
+
+          conn->cwnd = conn->cwnd > acked ? conn->cwnd - acked : 0;
+          if (acked >= mss || conn->cwnd < mss)
+            {
+              conn->cwnd += mss;
+            }
+
+          ninfo("Partial ACK: cwnd=%u\n", conn->cwnd);
+          return true;
+        }
+
+      if (conn->cwnd < conn->ssthresh)
+        {
+          /* Slow start (RFC 5681, section 3.1):  Grow by at most one
+           * segment per ACK.
+           */
+
+          conn->cwnd += acked < mss ? acked : mss;
+        }
+      else
+        {
+          conn->cc->congavoid(conn, acked);
+        }
+
+      if (conn->cwnd > TCP_CC_MAXWND)
+        {
+          conn->cwnd = TCP_CC_MAXWND;
+        }
+
+      return false;
+    }
+
+  if (!dupack || ackno != conn->lastack)
+    {
+      return false;
+    }
+
+  /* A duplicate ACK */
+
+  if (conn->dupacks < UINT8_MAX)
+    {
+      conn->dupacks++;
+    }
+
+  if ((conn->ccflags & TCP_CCF_RECOVERY) != 0)
+    {
+      /* Each further duplicate ACK signals that a segment has left the
+       * network.  Inflate the window (RFC 6582, section 3.2, step 4).
+       */
+
+      if (conn->cwnd < TCP_CC_MAXWND)
+        {
+          conn->cwnd += mss;
+        }
+
+      return false;
+    }
+
+  if (conn->dupacks == TCP_CC_DUPTHRESH &&
+      TCP_SEQ_GT(ackno, conn->recover))
+    {
+      /* Fast retransmit (RFC 6582, section 3.2, step 2).  Only enter fast
+       * recovery if the ACK covers more than recover;  otherwise these
+       * duplicate ACKs belong to a loss that has already been reacted to.
+       */
+
+      conn->ssthresh = conn->cc->ssthresh(conn);
+      conn->recover  = conn->sndseq_max;
+      conn->cwnd     = conn->ssthresh + TCP_CC_DUPTHRESH * mss;
+      conn->ccflags |= TCP_CCF_RECOVERY;
+
+      ninfo("Fast retransmit: ssthresh=%u cwnd=%u recover=%u\n",
+            conn->ssthresh, conn->cwnd, conn->recover);
+      return true;
+    }
+
+  return false;
+}
+
+/****************************************************************************
+ * Name: tcp_cc_timeout
+ *
+ * Description:
+ *   Collapse the congestion window after a retransmission timeout.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_cc_timeout(FAR struct tcp_conn_s *conn)
+{
+  /* The slow start threshold is reduced only on the first timeout.  It is
+   * held constant while the same data is retransmitted again (RFC 5681,
+   * section 3.1).
+   */
+
+  if ((conn->ccflags & TCP_CCF_RTO) == 0)
+    {
+      conn->ssthresh = conn->cc->ssthresh(conn);
+    }
+
+  /* Restart in slow start with the loss window of one segment */
+
+  conn->cwnd     = conn->mss;
+  conn->recover  = conn->sndseq_max;
+  conn->dupacks  = 0;
+  conn->ccflags  = TCP_CCF_RTO;
+
+  ninfo("Timeout: ssthresh=%u cwnd=%u\n", conn->ssthresh, conn->cwnd);
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC */
@@ -69,6 +69,28 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+#  if (CONFIG_NET_TCP_CONNHASH_SIZE & (CONFIG_NET_TCP_CONNHASH_SIZE - 1)) != 0
+#    error CONFIG_NET_TCP_CONNHASH_SIZE must be a power of two
+#  endif
+
+#  define TCP_HASH_MASK (CONFIG_NET_TCP_CONNHASH_SIZE - 1)
+#else
+#  define tcp_setlport(conn,portno) do { (conn)->lport = (portno); } while (0)
+#endif
+
+/* Take and release the table lock that protects the list of free
+ * connections.  Without CONFIG_NET_FINE_LOCKS, that is the network lock.
+ */
+
+#ifdef CONFIG_NET_FINE_LOCKS
+#  define tcp_tablelock()   net_rmutex_lock(&g_tcp_tablelock)
+#  define tcp_tableunlock() net_rmutex_unlock(&g_tcp_tablelock)
+#else
+#  define tcp_tablelock()   net_lock()
+#  define tcp_tableunlock() net_unlock()
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -85,14 +107,217 @@ static dq_queue_t g_free_tcp_connections;
 
 static dq_queue_t g_active_tcp_connections;
 
+#ifdef CONFIG_NET_FINE_LOCKS
+/* The table lock.  The list of active connections and the hash tables are
+ * still protected by the network lock.
+ */
+
+static struct net_rmutex_s g_tcp_tablelock;
+#endif
+
 /* Last port used by a TCP connection connection. */
 
 static uint16_t g_last_tcp_port;
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+/* Active connections hashed on the remote IP address and the local and
+ * remote port numbers.
+ */
+
+static FAR struct tcp_conn_s *g_tcp_active_hash[CONFIG_NET_TCP_CONNHASH_SIZE];
+
+/* All connections with a local port number hashed on that port number */
+
+static FAR struct tcp_conn_s *g_tcp_port_hash[CONFIG_NET_TCP_CONNHASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_porthash and tcp_activehash
+ *
+ * Description:
+ *   Return the index of the hash bucket for a local port number or for the
+ *   remote IP address and the local and remote port numbers of an active
+ *   connection.  Port numbers are in network byte order.  The remote IP
+ *   address is first folded into 32-bits.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CONNHASH
+static inline unsigned int tcp_porthash(uint16_t portno)
+{
+  return (portno ^ (portno >> 8)) & TCP_HASH_MASK;
+}
+
+static inline unsigned int tcp_activehash(uint32_t raddr, uint16_t lport,
+                                          uint16_t rport)
+{
+  uint32_t hash = raddr ^ ((uint32_t)lport << 16) ^ rport;
+
+  hash ^= hash >> 16;
+  hash ^= hash >> 8;
+  return hash & TCP_HASH_MASK;
+}
+
+#ifdef CONFIG_NET_IPv6
+static inline uint32_t tcp_ipv6_fold(FAR const uint16_t *ipaddr)
+{
+  uint32_t fold = 0;
+  int i;
+
+  for (i = 0; i < 8; i += 2)
+    {
+      fold ^= ((uint32_t)ipaddr[i] << 16) | ipaddr[i + 1];
+    }
+
+  return fold;
+}
+#endif
+
+/****************************************************************************
+ * Name: tcp_connhash
+ *
+ * Description:
+ *   Return the index of the active connection hash bucket for an existing
+ *   connection.
+ *
+ ****************************************************************************/
+
+static unsigned int tcp_connhash(FAR struct tcp_conn_s *conn)
+{
+#ifdef CONFIG_NET_IPv4
+#ifdef CONFIG_NET_IPv6
+  if (conn->domain == PF_INET)
+#endif
+    {
+      return tcp_activehash(conn->u.ipv4.raddr, conn->lport, conn->rport);
+    }
+#endif /* CONFIG_NET_IPv4 */
+
+#ifdef CONFIG_NET_IPv6
+#ifdef CONFIG_NET_IPv4
+  else
+#endif
+    {
+      return tcp_activehash(tcp_ipv6_fold(conn->u.ipv6.raddr), conn->lport,
+                            conn->rport);
+    }
+#endif /* CONFIG_NET_IPv6 */
+}
+
+/****************************************************************************
+ * Name: tcp_hash_add and tcp_hash_remove
+ *
+ * Description:
+ *   Add a connection to or remove a connection from the active connection
+ *   hash table.  The local and remote port numbers and the remote IP
+ *   address must not be changed while the connection is in the table.
+ *   Connections are appended to the bucket so that, just like in the list
+ *   of active connections, the oldest connection is found first.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_hash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_active_hash[tcp_connhash(conn)];
+
+  while (*link != NULL)
+    {
+      link = &(*link)->hnext;
+    }
+
+  conn->hnext = NULL;
+  *link       = conn;
+}
+
+static void tcp_hash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_active_hash[tcp_connhash(conn)];
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link = conn->hnext;
+          break;
+        }
+
+      link = &(*link)->hnext;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_porthash_add and tcp_porthash_remove
+ *
+ * Description:
+ *   Add a connection to or remove a connection from the local port hash
+ *   table.  Every connection with a non-zero local port number is in this
+ *   table.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_porthash_add(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_port_hash[tcp_porthash(conn->lport)];
+
+  conn->pnext = *link;
+  *link       = conn;
+}
+
+static void tcp_porthash_remove(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_conn_s **link = &g_tcp_port_hash[tcp_porthash(conn->lport)];
+
+  while (*link != NULL)
+    {
+      if (*link == conn)
+        {
+          *link = conn->pnext;
+          break;
+        }
+
+      link = &(*link)->pnext;
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_setlport
+ *
+ * Description:
+ *   Assign a local port number (network byte order) to a connection and
+ *   keep the local port hash table up to date.  A port number of zero
+ *   unbinds the connection.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+static void tcp_setlport(FAR struct tcp_conn_s *conn, uint16_t portno)
+{
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
+    }
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      tcp_porthash_add(conn);
+    }
+}
+#endif /* CONFIG_NET_TCP_CONNHASH */
+
 /****************************************************************************
  * Name: tcp_ipv4_listener
  *
@@ -110,13 +335,23 @@ static inline FAR struct tcp_conn_s *tcp_ipv4_listener(in_addr_t ipaddr,
                                                        uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_CONNHASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -161,13 +396,23 @@ static inline FAR struct tcp_conn_s *
 tcp_ipv6_listener(const net_ipv6addr_t ipaddr, uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_CONNHASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -236,13 +481,23 @@ static FAR struct tcp_conn_s *
 static FAR struct tcp_conn_s *tcp_listener(uint16_t portno)
 {
   FAR struct tcp_conn_s *conn;
+#ifndef CONFIG_NET_TCP_CONNHASH
   int i;
+#endif
 
   /* Check if this port number is in use by any active UIP TCP connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  for (conn = g_tcp_port_hash[tcp_porthash(portno)];
+       conn != NULL;
+       conn = conn->pnext)
+#else
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_TCP_CONNHASH
       conn = &g_tcp_connections[i];
+#endif
 
       /* Check if this connection is open and the local port assignment
        * matches the requested port number.
@@ -368,12 +623,18 @@ static inline FAR struct tcp_conn_s *
   in_addr_t destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = net_ip4addr_conv32(ip->srcipaddr);
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = net_ip4addr_conv32(ip->destipaddr);
 #endif
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  conn = g_tcp_active_hash[tcp_activehash(srcipaddr, tcp->destport,
+                                          tcp->srcport)];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -413,7 +674,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -443,12 +708,18 @@ static inline FAR struct tcp_conn_s *
   net_ipv6addr_t *destipaddr;
 #endif
 
-  conn       = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
   srcipaddr  = (net_ipv6addr_t *)ip->srcipaddr;
 #ifdef CONFIG_NETDEV_MULTINIC
   destipaddr = (net_ipv6addr_t *)ip->destipaddr;
 #endif
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  conn = g_tcp_active_hash[tcp_activehash(tcp_ipv6_fold(ip->srcipaddr),
+                                          tcp->destport, tcp->srcport)];
+#else
+  conn = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+#endif
+
   while (conn)
     {
       /* Find an open connection matching the TCP input. The following
@@ -488,7 +759,11 @@ static inline FAR struct tcp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct tcp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -539,7 +814,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv4addr_copy(conn->u.ipv4.laddr, addr->sin_addr.s_addr);
 #endif
@@ -557,7 +832,7 @@ static inline int tcp_ipv4_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
 #ifdef CONFIG_NETDEV_MULTINIC
       net_ipv4addr_copy(conn->u.ipv4.laddr, INADDR_ANY);
 #endif
@@ -619,7 +894,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
   /* Save the local address in the connection structure (network byte order). */
 
-  conn->lport = htons(port);
+  tcp_setlport(conn, htons(port));
 #ifdef CONFIG_NETDEV_MULTINIC
   net_ipv6addr_copy(conn->u.ipv6.laddr, addr->sin6_addr.in6_u.u6_addr16);
 #endif
@@ -637,7 +912,7 @@ static inline int tcp_ipv6_bind(FAR struct tcp_conn_s *conn,
 
       /* Back out the local address setting */
 
-      conn->lport = 0;
+      tcp_setlport(conn, 0);
 #ifdef CONFIG_NETDEV_MULTINIC
       net_ipv6addr_copy(conn->u.ipv6.laddr, g_ipv6_allzeroaddr);
 #endif
@@ -671,6 +946,10 @@ void tcp_initialize(void)
   dq_init(&g_free_tcp_connections);
   dq_init(&g_active_tcp_connections);
 
+#ifdef CONFIG_NET_FINE_LOCKS
+  net_rmutex_init(&g_tcp_tablelock);
+#endif
+
   /* Now initialize each connection structure */
 
   for (i = 0; i < CONFIG_NET_TCP_CONNS; i++)
@@ -700,29 +979,32 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
   FAR struct tcp_conn_s *conn;
 
   /* Because this routine is called from both interrupt level and
-   * and from user level, we have not option but to disable interrupts
-   * while accessing g_free_tcp_connections[];
+   * and from user level, we have not option but to lock the connection
+   * table while accessing g_free_tcp_connections[];
    */
 
-  net_lock();
+  tcp_tablelock();
 
   /* Return the entry from the head of the free list */
 
   conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+  tcp_tableunlock();
 
 #ifndef CONFIG_NET_SOLINGER
   /* Is the free list empty? */
 
   if (!conn)
     {
+      FAR struct tcp_conn_s *tmp;
+
       /* As a fall-back, check for connection structures which can be stalled.
        *
        * Search the active connection list for the oldest connection
-       * that is about to be closed anyway.
+       * that is about to be closed anyway.  That requires the network lock.
        */
 
-      FAR struct tcp_conn_s *tmp =
-        (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
+      net_lock();
+      tmp = (FAR struct tcp_conn_s *)g_active_tcp_connections.head;
 
       while (tmp)
         {
@@ -776,15 +1058,19 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
 
           tcp_free(conn);
 
-          /* Now there is guaranteed to be one free connection.  Get it! */
+          /* Now there is one free connection, unless another thread took
+           * it without the network lock.  Get it!
+           */
 
+          tcp_tablelock();
           conn = (FAR struct tcp_conn_s *)dq_remfirst(&g_free_tcp_connections);
+          tcp_tableunlock();
         }
+
+      net_unlock();
     }
 #endif
 
-  net_unlock();
-
   /* Mark the connection allocated */
 
   if (conn)
@@ -793,6 +1079,9 @@ FAR struct tcp_conn_s *tcp_alloc(uint8_t domain)
       conn->tcpstateflags = TCP_ALLOCATED;
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
       conn->domain        = domain;
+#endif
+#if defined(CONFIG_NET_FINE_LOCKS) && defined(CONFIG_NET_TCP_READAHEAD)
+      net_rmutex_init(&conn->lock);
 #endif
     }
 
@@ -843,12 +1132,32 @@ void tcp_free(FAR struct tcp_conn_s *conn)
       /* Remove the connection from the active list */
 
       dq_rem(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      tcp_hash_remove(conn);
+#endif
     }
 
+#ifdef CONFIG_NET_TCP_CONNHASH
+  /* Remove the connection from the local port hash table */
+
+  if (conn->lport != 0)
+    {
+      tcp_porthash_remove(conn);
+    }
+#endif
+
 #ifdef CONFIG_NET_TCP_READAHEAD
   /* Release any read-ahead buffers attached to the connection */
 
+  tcp_conn_lock(conn);
   iob_free_queue(&conn->readahead);
+  tcp_conn_unlock(conn);
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Release any out-of-order data held by the connection */
+
+  tcp_ofo_free(conn);
 #endif
 
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -886,7 +1195,11 @@ void tcp_free(FAR struct tcp_conn_s *conn)
   /* Mark the connection available and put it into the free list */
 
   conn->tcpstateflags = TCP_CLOSED;
+
+  tcp_tablelock();
   dq_addlast(&conn->node, &g_free_tcp_connections);
+  tcp_tableunlock();
+
   net_unlock();
 }
 
@@ -1076,10 +1389,10 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
       conn->sa            = 0;
       conn->sv            = 4;
       conn->nrtx          = 0;
-      conn->lport         = tcp->destport;
       conn->rport         = tcp->srcport;
       conn->tcpstateflags = TCP_SYN_RCVD;
 
+      tcp_setlport(conn, tcp->destport);
       tcp_initsequence(conn->sndseq);
       conn->unacked       = 1;
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
@@ -1111,6 +1424,9 @@ FAR struct tcp_conn_s *tcp_alloc_accept(FAR struct net_driver_s *dev,
        */
 
       dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+      tcp_hash_add(conn);
+#endif
     }
 
   return conn;
@@ -1333,6 +1649,7 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
    */
 
   conn->tcpstateflags = TCP_SYN_SENT;
+  tcp_setlport(conn, htons((uint16_t)port));
   tcp_initsequence(conn->sndseq);
 
   conn->unacked    = 1;    /* TCP length of the SYN is one. */
@@ -1341,7 +1658,11 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   conn->rto        = TCP_RTO;
   conn->sa         = 0;
   conn->sv         = 16;   /* Initial value of the RTT variance. */
-  conn->lport      = htons((uint16_t)port);
+  conn->optflags   = 0;
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  conn->snd_wscale = 0;
+  conn->rcv_wscale = 0;
+#endif
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
   conn->expired    = 0;
   conn->isn        = 0;
@@ -1365,6 +1686,9 @@ int tcp_connect(FAR struct tcp_conn_s *conn, FAR const struct sockaddr *addr)
   /* And, finally, put the connection structure into the active list. */
 
   dq_addlast(&conn->node, &g_active_tcp_connections);
+#ifdef CONFIG_NET_TCP_CONNHASH
+  tcp_hash_add(conn);
+#endif
   ret = OK;
 
 errout_with_lock:
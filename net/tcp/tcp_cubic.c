@@ -0,0 +1,268 @@
+/****************************************************************************
+ * net/tcp/tcp_cubic.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_CC_CUBIC)
+
+#include <stdint.h>
+
+#include <nuttx/clock.h>
+
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* CUBIC uses the multiplicative decrease factor beta = 0.7 and the scaling
+ * constant C = 0.4 (RFC 8312, section 5).  Integer arithmetic is used
+ * throughout:  Windows are in bytes and times in milliseconds.
+ */
+
+#define CUBIC_BETA_NUM    7     /* beta = 7 / 10 */
+#define CUBIC_BETA_DEN    10
+
+/* Fast convergence scales wmax by (1 + beta) / 2 = 17 / 20 */
+
+#define CUBIC_FC_NUM      17
+#define CUBIC_FC_DEN      20
+
+/* alpha = 3 * (1 - beta) / (1 + beta) ~ 0.529 is the additive increase of
+ * the standard TCP window estimate (RFC 8312, section 4.2).
+ */
+
+#define CUBIC_ALPHA_NUM   529
+#define CUBIC_ALPHA_DEN   1000
+
+/* Limit the time offset used in the cubic function so that the cube does
+ * not overflow 64-bit arithmetic.
+ */
+
+#define CUBIC_MAXMSEC     100000
+
+/****************************************************************************
+ * Private Function Prototypes
+ ****************************************************************************/
+
+static void     cubic_init(FAR struct tcp_conn_s *conn);
+static void     cubic_congavoid(FAR struct tcp_conn_s *conn, uint32_t acked);
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn);
+
+/****************************************************************************
+ * Public Data
+ ****************************************************************************/
+
+const struct tcp_cc_ops_s g_tcp_cubic =
+{
+  cubic_init,           /* init */
+  cubic_congavoid,      /* congavoid */
+  cubic_ssthresh        /* ssthresh */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: cubic_root
+ *
+ * Description:
+ *   Return the integer cube root of a 64-bit value.
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_root(uint64_t x)
+{
+  uint64_t y = 0;
+  uint64_t b;
+  int s;
+
+  for (s = 63; s >= 0; s -= 3)
+    {
+      y <<= 1;
+      b = 3 * y * (y + 1) + 1;
+      if ((x >> s) >= b)
+        {
+          x -= b << s;
+          y++;
+        }
+    }
+
+  return (uint32_t)y;
+}
+
+/****************************************************************************
+ * Name: cubic_init
+ *
+ * Description:
+ *   Reset the CUBIC state of a new connection.
+ *
+ ****************************************************************************/
+
+static void cubic_init(FAR struct tcp_conn_s *conn)
+{
+  conn->wmax  = 0;
+  conn->west  = 0;
+  conn->kmsec = 0;
+  conn->epoch = 0;
+}
+
+/****************************************************************************
+ * Name: cubic_congavoid
+ *
+ * Description:
+ *   Congestion avoidance (RFC 8312, section 4):  Grow the window towards
+ *   W_cubic(t) = C * (t - K)^3 + W_max, but never slower than a standard
+ *   TCP flow would.
+ *
+ ****************************************************************************/
+
+static void cubic_congavoid(FAR struct tcp_conn_s *conn, uint32_t acked)
+{
+  systime_t now = clock_systimer();
+  uint32_t mss = conn->mss;
+  uint32_t cwnd = conn->cwnd;
+  int64_t target;
+  int64_t delta;
+  int64_t t;
+
+  if (conn->epoch == 0)
+    {
+      /* First ACK of a new congestion avoidance epoch.  K is the time that
+       * it takes to grow from cwnd back to wmax:
+       *
+       *   K = cbrt((W_max - cwnd) / C) seconds (with windows in segments)
+       */
+
+      conn->epoch = now != 0 ? now : 1;
+      if (cwnd < conn->wmax)
+        {
+          conn->kmsec =
+            cubic_root((uint64_t)(conn->wmax - cwnd) * 2500000000ull / mss);
+        }
+      else
+        {
+          conn->kmsec = 0;
+          conn->wmax  = cwnd;
+        }
+
+      conn->west = cwnd;
+    }
+
+  /* W_cubic(t) in bytes.  The cube is in msec^3 and C = 0.4 per sec^3. */
+
+  t     = TICK2MSEC((int64_t)(now - conn->epoch));
+  delta = t - (int64_t)conn->kmsec;
+  if (delta > CUBIC_MAXMSEC)
+    {
+      delta = CUBIC_MAXMSEC;
+    }
+  else if (delta < -CUBIC_MAXMSEC)
+    {
+      delta = -CUBIC_MAXMSEC;
+    }
+
+  target = (int64_t)conn->wmax +
+           ((delta * delta * delta) / 1000) * 4 * mss / 10000000;
+
+  /* The TCP-friendly window estimate grows by alpha segments per RTT */
+
+  conn->west += (uint32_t)(((uint64_t)acked * mss * CUBIC_ALPHA_NUM) /
+                           ((uint64_t)cwnd * CUBIC_ALPHA_DEN));
+  if (target < (int64_t)conn->west)
+    {
+      target = conn->west;
+    }
+
+  /* Never more than 1.5 * cwnd in one RTT (RFC 8312, section 4.1) */
+
+  if (target > (int64_t)cwnd + (cwnd >> 1))
+    {
+      target = (int64_t)cwnd + (cwnd >> 1);
+    }
+
+  if (target > (int64_t)cwnd)
+    {
+      conn->cwnd += (uint32_t)(((uint64_t)(target - cwnd) * mss) / cwnd);
+    }
+  else
+    {
+      /* Plateau around wmax:  Grow very slowly */
+
+      conn->cwnd += ((mss * mss) / cwnd) / 100;
+    }
+}
+
+/****************************************************************************
+ * Name: cubic_ssthresh
+ *
+ * Description:
+ *   A loss was detected:  Remember the window at which the loss occurred
+ *   and reduce by beta (RFC 8312, sections 4.5 and 4.6).
+ *
+ ****************************************************************************/
+
+static uint32_t cubic_ssthresh(FAR struct tcp_conn_s *conn)
+{
+  uint32_t minthresh = 2 * (uint32_t)conn->mss;
+  uint32_t ssthresh;
+
+  /* With fast convergence, a flow that sees a loss before it regained the
+   * previous wmax releases bandwidth for new flows.
+   */
+
+  if (conn->cwnd < conn->wmax)
+    {
+      conn->wmax = (uint32_t)(((uint64_t)conn->cwnd * CUBIC_FC_NUM) /
+                              CUBIC_FC_DEN);
+    }
+  else
+    {
+      conn->wmax = conn->cwnd;
+    }
+
+  conn->epoch = 0;
+
+  ssthresh = (uint32_t)(((uint64_t)conn->cwnd * CUBIC_BETA_NUM) /
+                        CUBIC_BETA_DEN);
+  return ssthresh > minthresh ? ssthresh : minthresh;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_CC_CUBIC */
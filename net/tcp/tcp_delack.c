@@ -0,0 +1,161 @@
+/****************************************************************************
+ * net/tcp/tcp_delack.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_DELAYED_ACK)
+
+#include <stdbool.h>
+#include <debug.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/wqueue.h>
+#include <nuttx/net/net.h>
+#include <nuttx/net/netdev.h>
+
+#include "netdev/netdev.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#if defined(CONFIG_SCHED_LPWORK)
+#  define DELACKWORK LPWORK
+#elif defined(CONFIG_SCHED_HPWORK)
+#  define DELACKWORK HPWORK
+#else
+#  error No work queue for CONFIG_NET_TCP_DELAYED_ACK
+#endif
+
+#define DELACK_DELAY MSEC2TICK(CONFIG_NET_TCP_DELACK_MSEC)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* One timer serves all connections:  It is started when the first ACK is
+ * delayed and every connection with a delayed ACK is served when it
+ * expires.
+ */
+
+static struct work_s g_delack_work;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack_txnotify
+ *
+ * Description:
+ *   netdev_foreach() callback:  Ask the device to poll for TX data.
+ *   tcp_poll() sends the delayed ACKs of the connections on the device.
+ *
+ ****************************************************************************/
+
+static int tcp_delack_txnotify(FAR struct net_driver_s *dev, FAR void *arg)
+{
+  netdev_txnotify_dev(dev);
+  return 0;
+}
+
+/****************************************************************************
+ * Name: tcp_delack_work
+ *
+ * Description:
+ *   The delayed ACK timer has expired.
+ *
+ ****************************************************************************/
+
+static void tcp_delack_work(FAR void *arg)
+{
+  net_lock();
+  (void)netdev_foreach(tcp_delack_txnotify, NULL);
+  net_unlock();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_delack
+ *
+ * Description:
+ *   Decide whether the ACK of newly received, in-order data may be delayed.
+ *   At most one ACK is delayed per connection (RFC 1122, section 4.2.3.2):
+ *   If an ACK is already being delayed, then the ACK must be sent now.
+ *   Otherwise, the ACK is marked as delayed and the delayed ACK timer is
+ *   started.  The delayed ACK is sent when the device next polls the
+ *   connection after the timer expires, unless it is sent with some other
+ *   segment before that.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   true if the ACK is delayed; false if the ACK must be sent now.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+bool tcp_delack(FAR struct tcp_conn_s *conn)
+{
+  if ((conn->txflags & TCP_TXF_DELACK) != 0)
+    {
+      /* This is the second segment:  ACK both of them now */
+
+      return false;
+    }
+
+  conn->txflags |= TCP_TXF_DELACK;
+
+  if (work_available(&g_delack_work))
+    {
+      (void)work_queue(DELACKWORK, &g_delack_work, tcp_delack_work, NULL,
+                       DELACK_DELAY);
+    }
+
+  return true;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_DELAYED_ACK */
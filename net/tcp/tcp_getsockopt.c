@@ -0,0 +1,128 @@
+/****************************************************************************
+ * net/tcp/tcp_getsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_SOCKOPTS)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <errno.h>
+
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_getsockopt
+ *
+ * Description:
+ *   tcp_getsockopt() retrieves the value of the TCP protocol option
+ *   specified by the 'option' argument.  This implements getsockopt() for
+ *   the IPPROTO_TCP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_getsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+int tcp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+#ifdef CONFIG_NET_TCP_NAGLE
+  FAR struct tcp_conn_s *conn;
+#endif
+
+  /* Only Internet stream sockets have a TCP connection structure */
+
+  if ((psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+      psock->s_type != SOCK_STREAM || psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  /* Both options report an integer boolean value */
+
+  if (value == NULL || value_len == NULL || *value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+#endif
+
+  switch (option)
+    {
+      case TCP_NODELAY:  /* Disable the Nagle algorithm */
+#ifdef CONFIG_NET_TCP_NAGLE
+        *(FAR int *)value = ((conn->txflags & TCP_TXF_NODELAY) != 0);
+#else
+        /* Small segments are never held back */
+
+        *(FAR int *)value = 1;
+#endif
+        break;
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK:     /* Hold back partial segments */
+        *(FAR int *)value = ((conn->txflags & TCP_TXF_CORK) != 0);
+        break;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+  *value_len = sizeof(int);
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_SOCKOPTS */
@@ -47,6 +47,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_TCP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -64,6 +65,135 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: tcp_parse_option
+ *
+ * Description:
+ *   Parse the TCP options of an incoming SYN or SYNACK segment:  The TCP
+ *   MSS option and, if enabled, the window scale and SACK permitted
+ *   options.
+ *
+ * Parameters:
+ *   dev    - The device driver structure containing the received packet.
+ *   conn   - The TCP connection structure holding connection information
+ *   tcp    - A pointer to the TCP header in the packet
+ *   iplen  - Length of the IP header
+ *   hdrlen - Offset of the TCP options in the packet buffer
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the interrupt level or with interrupts disabled.
+ *
+ ****************************************************************************/
+
+static void tcp_parse_option(FAR struct net_driver_s *dev,
+                             FAR struct tcp_conn_s *conn,
+                             FAR struct tcp_hdr_s *tcp,
+                             unsigned int iplen, unsigned int hdrlen)
+{
+  uint16_t tmp16;
+  uint8_t  opt;
+  int      i;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* Window scaling is used only if the peer's SYN carries the option */
+
+  conn->optflags  &= ~TCP_OPTF_WSCALE;
+  conn->snd_wscale = 0;
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+  conn->optflags  &= ~TCP_OPTF_SACK;
+#endif
+
+  if ((tcp->tcpoffset & 0xf0) > 0x50)
+    {
+      for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
+        {
+          opt = dev->d_buf[hdrlen + i];
+          if (opt == TCP_OPT_END)
+            {
+              /* End of options. */
+
+              break;
+            }
+          else if (opt == TCP_OPT_NOOP)
+            {
+              /* NOP option. */
+
+              ++i;
+            }
+          else if (opt == TCP_OPT_MSS &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
+            {
+              uint16_t tcp_mss = TCP_MSS(dev, iplen);
+
+              /* An MSS option with the right option length. */
+
+              tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
+                       (uint16_t)dev->d_buf[hdrlen + 3 + i];
+              conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
+
+              i += TCP_OPT_MSS_LEN;
+            }
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+          else if (opt == TCP_OPT_WS &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_WS_LEN)
+            {
+              /* A window scale option with the right option length.  A
+               * shift count larger than 14 must be treated as 14
+               * (RFC 7323, section 2.3).
+               */
+
+              opt = dev->d_buf[hdrlen + 2 + i];
+              conn->snd_wscale = opt > TCP_WS_MAXSHIFT ?
+                                 TCP_WS_MAXSHIFT : opt;
+              conn->optflags  |= TCP_OPTF_WSCALE;
+
+              i += TCP_OPT_WS_LEN;
+            }
+#endif
+#ifdef CONFIG_NET_TCP_SACK
+          else if (opt == TCP_OPT_SACK_PERM &&
+                   dev->d_buf[hdrlen + 1 + i] == TCP_OPT_SACK_PERM_LEN)
+            {
+              /* The peer is able to receive SACK options */
+
+              conn->optflags |= TCP_OPTF_SACK;
+              i += TCP_OPT_SACK_PERM_LEN;
+            }
+#endif
+          else
+            {
+              /* All other options have a length field, so that we easily
+               * can skip past them.
+               */
+
+              if (dev->d_buf[hdrlen + 1 + i] == 0)
+                {
+                  /* If the length field is zero, the options are malformed
+                   * and we don't process them further.
+                   */
+
+                  break;
+                }
+
+              i += dev->d_buf[hdrlen + 1 + i];
+            }
+        }
+    }
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* If the peer does not scale, then neither do we */
+
+  if ((conn->optflags & TCP_OPTF_WSCALE) == 0)
+    {
+      conn->rcv_wscale = 0;
+    }
+#endif
+}
+
 /****************************************************************************
  * Name: tcp_input
  *
@@ -89,12 +219,14 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
   FAR struct tcp_conn_s *conn = NULL;
   unsigned int tcpiplen;
   unsigned int hdrlen;
+  uint32_t wnd;
   uint16_t tmp16;
   uint16_t flags;
   uint16_t result;
-  uint8_t  opt;
   int      len;
-  int      i;
+#ifdef CONFIG_NET_TCP_CC
+  bool     wndupdate;
+#endif
 
 #ifdef CONFIG_NET_STATISTICS
   /* Bump up the count of TCP packets received */
@@ -214,56 +346,7 @@ static void tcp_input(FAR struct net_driver_s *dev, unsigned int iplen)
 
           /* Parse the TCP MSS option, if present. */
 
-          if ((tcp->tcpoffset & 0xf0) > 0x50)
-            {
-              for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                {
-                  opt = dev->d_buf[hdrlen + i];
-                  if (opt == TCP_OPT_END)
-                    {
-                      /* End of options. */
-
-                      break;
-                    }
-                  else if (opt == TCP_OPT_NOOP)
-                    {
-                      /* NOP option. */
-
-                      ++i;
-                    }
-                  else if (opt == TCP_OPT_MSS &&
-                          dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                    {
-                      uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                      /* An MSS option with the right option length. */
-
-                      tmp16 = ((uint16_t)dev->d_buf[hdrlen + 2 + i] << 8) |
-                               (uint16_t)dev->d_buf[hdrlen + 3 + i];
-                      conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                      /* And we are done processing options. */
-
-                      break;
-                    }
-                  else
-                    {
-                      /* All other options have a length field, so that we easily
-                       * can skip past them.
-                       */
-
-                      if (dev->d_buf[hdrlen + 1 + i] == 0)
-                        {
-                          /* If the length field is zero, the options are malformed
-                           * and we don't process them further.
-                           */
-
-                          break;
-                        }
-                      i += dev->d_buf[hdrlen + 1 + i];
-                    }
-                }
-            }
+          tcp_parse_option(dev, conn, tcp, iplen, hdrlen);
 
           /* Our response will be a SYNACK. */
 
@@ -293,9 +376,22 @@ reset:
 
 found:
 
-  /* Update the connection's window size */
+  /* Update the connection's window size.  The window field of a SYN
+   * segment is never scaled (RFC 7323).
+   */
+
+  wnd = ((uint32_t)tcp->wnd[0] << 8) + (uint32_t)tcp->wnd[1];
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  if ((tcp->flags & TCP_SYN) == 0)
+    {
+      wnd <<= conn->snd_wscale;
+    }
+#endif
 
-  conn->winsize = ((uint16_t)tcp->wnd[0] << 8) + (uint16_t)tcp->wnd[1];
+#ifdef CONFIG_NET_TCP_CC
+  wndupdate     = (wnd != conn->winsize);
+#endif
+  conn->winsize = wnd;
 
   flags = 0;
 
@@ -327,6 +423,26 @@ found:
 
   dev->d_len -= (len + iplen);
 
+#ifdef CONFIG_NET_TCP_SACK
+  /* Update the SACK scoreboard before the options are overwritten below */
+
+  if ((conn->optflags & TCP_OPTF_SACK) != 0 &&
+      (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+      (tcp->flags & TCP_ACK) != 0 && len > TCP_HDRLEN)
+    {
+      tcp_sack_update(conn, tcp);
+    }
+#endif
+
+  /* If the segment carries TCP options, then move the data so that it
+   * begins at d_appdata, just after a TCP header without options.
+   */
+
+  if (len > TCP_HDRLEN && dev->d_len > 0)
+    {
+      memmove(dev->d_appdata, (FAR uint8_t *)tcp + len, dev->d_len);
+    }
+
   /* First, check if the sequence number of the incoming packet is
    * what we're expecting next. If not, we send out an ACK with the
    * correct numbers in, unless we are in the SYN_RCVD state and
@@ -342,6 +458,25 @@ found:
       if ((dev->d_len > 0 || ((tcp->flags & (TCP_SYN | TCP_FIN)) != 0)) &&
           memcmp(tcp->seqno, conn->rcvseq, 4) != 0)
         {
+#ifdef CONFIG_NET_TCP_SACK
+          uint32_t seqno  = tcp_getsequence(tcp->seqno);
+          uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+
+          /* Retain data that arrives beyond a hole in the sequence space
+           * (but within our receive window) so that the peer does not
+           * have to send it again.  The ACK reports it with SACK blocks.
+           */
+
+          if ((conn->optflags & TCP_OPTF_SACK) != 0 &&
+              (conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+              (tcp->flags & (TCP_SYN | TCP_FIN | TCP_URG)) == 0 &&
+              dev->d_len > 0 && TCP_SEQ_GT(seqno, rcvseq) &&
+              seqno - rcvseq < (uint32_t)NET_DEV_RCVWNDO(dev))
+            {
+              tcp_ofo_insert(conn, seqno, dev->d_appdata, dev->d_len);
+            }
+#endif
+
           tcp_send(dev, conn, TCP_ACK, tcpiplen);
           return;
         }
@@ -443,6 +578,26 @@ found:
        conn->timer = conn->rto;
     }
 
+#ifdef CONFIG_NET_TCP_CC
+  /* Let congestion control see every ACK received in the ESTABLISHED
+   * state.  A segment that carries no data, does not update the window, and
+   * ACKs nothing new while data is outstanding is a duplicate ACK.  If a
+   * segment must be retransmitted now, that is requested from the write
+   * buffer logic with TCP_REXMIT.
+   */
+
+  if ((conn->tcpstateflags & TCP_STATE_MASK) == TCP_ESTABLISHED &&
+      (tcp->flags & (TCP_ACK | TCP_SYN | TCP_FIN)) == TCP_ACK)
+    {
+      bool dupack = (dev->d_len == 0 && !wndupdate && conn->unacked > 0);
+
+      if (tcp_cc_ack(conn, tcp_getsequence(tcp->ackno), dupack))
+        {
+          flags |= TCP_REXMIT;
+        }
+    }
+#endif
+
   /* Do different things depending on in what state the connection is. */
 
   switch (conn->tcpstateflags & TCP_STATE_MASK)
@@ -469,6 +624,9 @@ found:
             tcp_setsequence(conn->sndseq, conn->isn);
             conn->sent          = 0;
             conn->sndseq_max    = 0;
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
 #endif
             conn->unacked       = 0;
             flags               = TCP_CONNECTED;
@@ -507,57 +665,7 @@ found:
           {
             /* Parse the TCP MSS option, if present. */
 
-            if ((tcp->tcpoffset & 0xf0) > 0x50)
-              {
-                for (i = 0; i < ((tcp->tcpoffset >> 4) - 5) << 2 ; )
-                  {
-                    opt = dev->d_buf[hdrlen + i];
-                    if (opt == TCP_OPT_END)
-                      {
-                        /* End of options. */
-
-                        break;
-                      }
-                    else if (opt == TCP_OPT_NOOP)
-                      {
-                        /* NOP option. */
-
-                        ++i;
-                      }
-                    else if (opt == TCP_OPT_MSS &&
-                              dev->d_buf[hdrlen + 1 + i] == TCP_OPT_MSS_LEN)
-                      {
-                        uint16_t tcp_mss = TCP_MSS(dev, iplen);
-
-                        /* An MSS option with the right option length. */
-
-                        tmp16 =
-                          (dev->d_buf[hdrlen + 2 + i] << 8) |
-                          dev->d_buf[hdrlen + 3 + i];
-                        conn->mss = tmp16 > tcp_mss ? tcp_mss : tmp16;
-
-                        /* And we are done processing options. */
-
-                        break;
-                      }
-                    else
-                      {
-                        /* All other options have a length field, so that we
-                         * easily can skip past them.
-                         */
-
-                        if (dev->d_buf[hdrlen + 1 + i] == 0)
-                          {
-                            /* If the length field is zero, the options are
-                             * malformed and we don't process them further.
-                             */
-
-                            break;
-                          }
-                        i += dev->d_buf[hdrlen + 1 + i];
-                      }
-                  }
-              }
+            tcp_parse_option(dev, conn, tcp, iplen, hdrlen);
 
             conn->tcpstateflags = TCP_ESTABLISHED;
             memcpy(conn->rcvseq, tcp->seqno, 4);
@@ -568,6 +676,9 @@ found:
 #ifdef CONFIG_NET_TCP_WRITE_BUFFERS
             conn->isn           = tcp_getsequence(tcp->ackno);
             tcp_setsequence(conn->sndseq, conn->isn);
+#endif
+#ifdef CONFIG_NET_TCP_CC
+            tcp_cc_init(conn);
 #endif
             dev->d_len          = 0;
             dev->d_sndlen       = 0;
@@ -728,9 +839,44 @@ found:
 
             if ((result & TCP_SNDACK) != 0)
               {
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                bool delack = (len > 0 && dev->d_sndlen == 0);
+#endif
+
                 /* Update the sequence number using the saved length */
 
                 net_incr32(conn->rcvseq, len);
+
+#ifdef CONFIG_NET_TCP_SACK
+                /* This data may have filled a hole.  Pass on the out-of-
+                 * order data that follows it.
+                 */
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                if (tcp_ofo_drain(conn) > 0)
+                  {
+                    /* The peer is waiting for this ACK to recover from
+                     * the loss.  Don't delay it.
+                     */
+
+                    delack = false;
+                  }
+#else
+                (void)tcp_ofo_drain(conn);
+#endif
+#endif
+
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+                /* If no data is being sent in response, then the ACK of
+                 * new data may be delayed in the hope of sending it with
+                 * data or of ACKing two segments at once.
+                 */
+
+                if (delack && tcp_delack(conn))
+                  {
+                    result &= ~TCP_SNDACK;
+                  }
+#endif
               }
 
             /* Send the response, ACKing the data or not, as appropriate */
@@ -0,0 +1,565 @@
+/****************************************************************************
+ * net/tcp/tcp_sack.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_TCP_SACK)
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <string.h>
+#include <queue.h>
+#include <debug.h>
+
+#include <nuttx/net/netconfig.h>
+#include <nuttx/net/iob.h>
+#include <nuttx/net/tcp.h>
+
+#include "iob/iob.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Private Types
+ ****************************************************************************/
+
+struct tcp_sackblk_s
+{
+  uint32_t left;              /* First sequence number of the block */
+  uint32_t right;             /* Sequence number following the block */
+};
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofo_remove
+ *
+ * Description:
+ *   Remove entry 'ndx' from the out-of-order table.  The I/O buffer chain is
+ *   not freed.
+ *
+ ****************************************************************************/
+
+static void tcp_ofo_remove(FAR struct tcp_conn_s *conn, int ndx)
+{
+  conn->nofosegs--;
+  memmove(&conn->ofosegs[ndx], &conn->ofosegs[ndx + 1],
+          (conn->nofosegs - ndx) * sizeof(struct tcp_ofoseg_s));
+}
+
+/****************************************************************************
+ * Name: tcp_ofo_add
+ *
+ * Description:
+ *   Copy a range of data that does not overlap any held range into a new
+ *   I/O buffer chain and insert it in the table at index 'ndx'.  If the
+ *   table is full, the range with the highest sequence number is given up
+ *   unless that would be the new one.
+ *
+ * Return:
+ *   True on success; false if the data could not be retained.
+ *
+ ****************************************************************************/
+
+static bool tcp_ofo_add(FAR struct tcp_conn_s *conn, int ndx,
+                        uint32_t seqno, FAR const uint8_t *buffer,
+                        uint16_t buflen)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  FAR struct iob_s *iob;
+  int ret;
+
+  if (conn->nofosegs >= CONFIG_NET_TCP_NOFOSEGS)
+    {
+      if (ndx >= conn->nofosegs)
+        {
+          return false;
+        }
+
+      seg = &conn->ofosegs[conn->nofosegs - 1];
+      ninfo("Dropping out-of-order data %u-%u\n", seg->left, seg->right);
+
+      iob_free_chain(seg->iob);
+      conn->nofosegs--;
+    }
+
+  /* Allocate the I/O buffer chain without waiting (and throttled) so that
+   * out-of-order data cannot starve the rest of the network.
+   */
+
+  iob = iob_tryalloc(true);
+  if (iob == NULL)
+    {
+      return false;
+    }
+
+  ret = iob_trycopyin(iob, buffer, buflen, 0, true);
+  if (ret < 0)
+    {
+      iob_free_chain(iob);
+      return false;
+    }
+
+  memmove(&conn->ofosegs[ndx + 1], &conn->ofosegs[ndx],
+          (conn->nofosegs - ndx) * sizeof(struct tcp_ofoseg_s));
+
+  seg        = &conn->ofosegs[ndx];
+  seg->left  = seqno;
+  seg->right = seqno + buflen;
+  seg->iob   = iob;
+
+  conn->nofosegs++;
+  return true;
+}
+
+/****************************************************************************
+ * Name: tcp_ofo_coalesce
+ *
+ * Description:
+ *   Concatenate adjacent ranges so that they occupy a single table entry.
+ *
+ ****************************************************************************/
+
+static void tcp_ofo_coalesce(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  int i = 0;
+
+  while (i + 1 < conn->nofosegs)
+    {
+      seg = &conn->ofosegs[i];
+      if (seg[0].right == seg[1].left &&
+          (uint32_t)seg[0].iob->io_pktlen + seg[1].iob->io_pktlen <=
+          UINT16_MAX)
+        {
+          iob_concat(seg[0].iob, seg[1].iob);
+          seg[0].right = seg[1].right;
+          tcp_ofo_remove(conn, i + 1);
+        }
+      else
+        {
+          i++;
+        }
+    }
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: tcp_ofo_insert
+ *
+ * Description:
+ *   Retain data that was received beyond a hole in the sequence space.
+ *   Only the parts that are not already held are copied into new I/O
+ *   buffer chains.
+ *
+ * Parameters:
+ *   conn   - The TCP connection structure holding connection information
+ *   seqno  - The sequence number of the first byte of data
+ *   buffer - The received data
+ *   buflen - The number of bytes of data
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_ofo_insert(FAR struct tcp_conn_s *conn, uint32_t seqno,
+                    FAR const uint8_t *buffer, uint16_t buflen)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  uint32_t end = seqno + buflen;
+  uint32_t gapend;
+  int i = 0;
+
+  ninfo("Out-of-order data %u-%u\n", seqno, end);
+  conn->sacklast = seqno;
+
+  while (TCP_SEQ_LT(seqno, end))
+    {
+      /* Skip the ranges that lie entirely below seqno */
+
+      while (i < conn->nofosegs &&
+             TCP_SEQ_LTE(conn->ofosegs[i].right, seqno))
+        {
+          i++;
+        }
+
+      seg = &conn->ofosegs[i];
+      if (i < conn->nofosegs && TCP_SEQ_LTE(seg->left, seqno))
+        {
+          /* seqno lies within a held range.  Skip past that range. */
+
+          gapend = TCP_SEQ_LT(seg->right, end) ? seg->right : end;
+        }
+      else
+        {
+          /* seqno starts a gap that extends to the next held range (or to
+           * the end of the new data).
+           */
+
+          gapend = end;
+          if (i < conn->nofosegs && TCP_SEQ_LT(seg->left, end))
+            {
+              gapend = seg->left;
+            }
+
+          if (!tcp_ofo_add(conn, i, seqno, buffer, gapend - seqno))
+            {
+              break;
+            }
+
+          i++;
+        }
+
+      buffer += gapend - seqno;
+      seqno   = gapend;
+    }
+
+  tcp_ofo_coalesce(conn);
+}
+
+/****************************************************************************
+ * Name: tcp_ofo_drain
+ *
+ * Description:
+ *   Move out-of-order data that has become contiguous with conn->rcvseq to
+ *   the read-ahead buffers and advance conn->rcvseq past it.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   The number of bytes moved to the read-ahead buffers.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+uint32_t tcp_ofo_drain(FAR struct tcp_conn_s *conn)
+{
+  FAR struct tcp_ofoseg_s *seg;
+  FAR struct iob_s *iob;
+  uint32_t rcvseq = tcp_getsequence(conn->rcvseq);
+  uint32_t total = 0;
+  int ret;
+
+  while (conn->nofosegs > 0)
+    {
+      seg = &conn->ofosegs[0];
+      if (TCP_SEQ_GT(seg->left, rcvseq))
+        {
+          /* There is still a hole */
+
+          break;
+        }
+
+      iob = seg->iob;
+      if (TCP_SEQ_LTE(seg->right, rcvseq))
+        {
+          /* This data has already been received in sequence */
+
+          tcp_ofo_remove(conn, 0);
+          iob_free_chain(iob);
+          continue;
+        }
+
+      /* Trim any data that has already been received in sequence */
+
+      if (seg->left != rcvseq)
+        {
+          iob = iob_trimhead(iob, rcvseq - seg->left);
+          seg->iob  = iob;
+          seg->left = rcvseq;
+        }
+
+      tcp_conn_lock(conn);
+      ret = iob_tryadd_queue(iob, &conn->readahead);
+      tcp_conn_unlock(conn);
+
+      if (ret < 0)
+        {
+          /* Keep the data and try again when the next segment arrives */
+
+          nerr("ERROR: Failed to queue out-of-order data\n");
+          break;
+        }
+
+      total  += seg->right - rcvseq;
+      rcvseq  = seg->right;
+      tcp_ofo_remove(conn, 0);
+    }
+
+  if (total > 0)
+    {
+      ninfo("Delivered %u bytes of out-of-order data\n", total);
+      tcp_setsequence(conn->rcvseq, rcvseq);
+    }
+
+  return total;
+}
+
+/****************************************************************************
+ * Name: tcp_ofo_free
+ *
+ * Description:
+ *   Discard all out-of-order data held by a connection.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_ofo_free(FAR struct tcp_conn_s *conn)
+{
+  while (conn->nofosegs > 0)
+    {
+      conn->nofosegs--;
+      iob_free_chain(conn->ofosegs[conn->nofosegs].iob);
+    }
+}
+
+/****************************************************************************
+ * Name: tcp_sack_build
+ *
+ * Description:
+ *   Build the SACK option describing the out-of-order data held by the
+ *   connection.  The range containing the most recently received data is
+ *   reported first (RFC 2018, section 4).
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   opt  - The location of the option in the outgoing TCP header
+ *
+ * Return:
+ *   The length of the option in bytes, a multiple of four.  Zero if there
+ *   is no out-of-order data.
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+unsigned int tcp_sack_build(FAR struct tcp_conn_s *conn, FAR uint8_t *opt)
+{
+  struct tcp_sackblk_s blocks[CONFIG_NET_TCP_NOFOSEGS];
+  FAR uint8_t *ptr;
+  int nblocks = 0;
+  int first = 0;
+  int nsent;
+  int i;
+
+  if (conn->nofosegs == 0)
+    {
+      return 0;
+    }
+
+  /* Ranges that were not coalesced because of the I/O buffer chain size
+   * limit are still reported as a single block.
+   */
+
+  for (i = 0; i < conn->nofosegs; i++)
+    {
+      if (nblocks > 0 &&
+          blocks[nblocks - 1].right == conn->ofosegs[i].left)
+        {
+          blocks[nblocks - 1].right = conn->ofosegs[i].right;
+        }
+      else
+        {
+          blocks[nblocks].left  = conn->ofosegs[i].left;
+          blocks[nblocks].right = conn->ofosegs[i].right;
+          nblocks++;
+        }
+
+      if (TCP_SEQ_GTE(conn->sacklast, conn->ofosegs[i].left) &&
+          TCP_SEQ_LT(conn->sacklast, conn->ofosegs[i].right))
+        {
+          first = nblocks - 1;
+        }
+    }
+
+  nsent = nblocks < TCP_SACK_MAXBLOCKS ? nblocks : TCP_SACK_MAXBLOCKS;
+
+  /* Two NOPs keep the blocks 32-bit aligned */
+
+  opt[0] = TCP_OPT_NOOP;
+  opt[1] = TCP_OPT_NOOP;
+  opt[2] = TCP_OPT_SACK;
+  opt[3] = 2 + 8 * nsent;
+  ptr    = &opt[4];
+
+  for (i = 0; i < nsent; i++)
+    {
+      FAR struct tcp_sackblk_s *blk;
+
+      /* The first block, then the others in ascending order */
+
+      if (i == 0)
+        {
+          blk = &blocks[first];
+        }
+      else
+        {
+          blk = &blocks[i <= first ? i - 1 : i];
+        }
+
+      tcp_setsequence(ptr, blk->left);
+      tcp_setsequence(ptr + 4, blk->right);
+      ptr += 8;
+    }
+
+  return 4 + 8 * nsent;
+}
+
+/****************************************************************************
+ * Name: tcp_sack_update
+ *
+ * Description:
+ *   Update the SACK scoreboard from the SACK option of an incoming ACK:
+ *   Mark the unacknowledged write buffers that the peer has received.
+ *
+ * Parameters:
+ *   conn - The TCP connection structure holding connection information
+ *   tcp  - The TCP header of the incoming segment, with its options
+ *
+ * Return:
+ *   None
+ *
+ * Assumptions:
+ *   Called with the network locked.
+ *
+ ****************************************************************************/
+
+void tcp_sack_update(FAR struct tcp_conn_s *conn, FAR struct tcp_hdr_s *tcp)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR uint8_t *opt = (FAR uint8_t *)tcp + TCP_HDRLEN;
+  uint32_t ackno = tcp_getsequence(tcp->ackno);
+  uint32_t left;
+  uint32_t right;
+  uint32_t start;
+  int optlen = ((tcp->tcpoffset >> 4) << 2) - TCP_HDRLEN;
+  int i = 0;
+  int j;
+
+  while (i < optlen)
+    {
+      if (opt[i] == TCP_OPT_END)
+        {
+          break;
+        }
+      else if (opt[i] == TCP_OPT_NOOP)
+        {
+          i++;
+          continue;
+        }
+      else if (i + 1 >= optlen || opt[i + 1] < 2)
+        {
+          /* Malformed options */
+
+          break;
+        }
+      else if (opt[i] != TCP_OPT_SACK || i + opt[i + 1] > optlen)
+        {
+          i += opt[i + 1];
+          continue;
+        }
+
+      /* Walk the SACK blocks */
+
+      for (j = i + 2; j + 8 <= i + opt[i + 1]; j += 8)
+        {
+          left  = tcp_getsequence(&opt[j]);
+          right = tcp_getsequence(&opt[j + 4]);
+
+          /* Ignore blocks that are stale or invalid (RFC 2018, section 5) */
+
+          if (TCP_SEQ_LTE(right, ackno) || TCP_SEQ_GTE(left, right))
+            {
+              continue;
+            }
+
+          if (TCP_SEQ_GT(right, conn->sackhigh))
+            {
+              conn->sackhigh = right;
+            }
+
+          /* Mark every write buffer whose unacknowledged data lies entirely
+           * within the block.
+           */
+
+          for (entry = sq_peek(&conn->unacked_q); entry;
+               entry = sq_next(entry))
+            {
+              wrb   = (FAR struct tcp_wrbuffer_s *)entry;
+              start = WRB_SEQNO(wrb);
+              if (TCP_SEQ_LT(start, ackno))
+                {
+                  start = ackno;
+                }
+
+              if (TCP_SEQ_GTE(start, left) &&
+                  TCP_SEQ_LTE(WRB_SEQNO(wrb) + WRB_PKTLEN(wrb), right))
+                {
+                  ninfo("SACK: wrb=%p seqno=%u\n", wrb, WRB_SEQNO(wrb));
+                  wrb->wb_sacked = true;
+                }
+            }
+        }
+
+      break;
+    }
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_TCP_SACK */
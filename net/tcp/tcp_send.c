@@ -238,6 +238,36 @@ static inline void tcp_ipv6_sendcomplete(FAR struct net_driver_s *dev,
 }
 #endif /* CONFIG_NET_IPv6 */
 
+/****************************************************************************
+ * Name: tcp_rcvwscale
+ *
+ * Description:
+ *   Return the smallest window shift count that lets the receive window of
+ *   the network device be advertised in the 16-bit TCP window field.
+ *
+ * Parameters:
+ *   dev  - The device driver structure to use in the send operation
+ *
+ * Return:
+ *   The shift count to offer in the window scale option.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+static uint8_t tcp_rcvwscale(FAR struct net_driver_s *dev)
+{
+  uint32_t rcvwnd = NET_DEV_RCVWNDO(dev);
+  uint8_t shift = 0;
+
+  while ((rcvwnd >> shift) > UINT16_MAX && shift < TCP_WS_MAXSHIFT)
+    {
+      shift++;
+    }
+
+  return shift;
+}
+#endif
+
 /****************************************************************************
  * Name: tcp_sendcomplete
  *
@@ -337,6 +367,12 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
   memcpy(tcp->ackno, conn->rcvseq, 4);
   memcpy(tcp->seqno, conn->sndseq, 4);
 
+#ifdef CONFIG_NET_TCP_DELAYED_ACK
+  /* This segment acknowledges all data received so far */
+
+  conn->txflags &= ~TCP_TXF_DELACK;
+#endif
+
   tcp->srcport  = conn->lport;
   tcp->destport = conn->rport;
 
@@ -353,8 +389,24 @@ static void tcp_sendcommon(FAR struct net_driver_s *dev,
     }
   else
     {
-      tcp->wnd[0] = ((NET_DEV_RCVWNDO(dev)) >> 8);
-      tcp->wnd[1] = ((NET_DEV_RCVWNDO(dev)) & 0xff);
+      uint32_t rcvwnd = NET_DEV_RCVWNDO(dev);
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+      /* The window field of a SYN segment is never scaled (RFC 7323) */
+
+      if ((tcp->flags & TCP_SYN) == 0)
+        {
+          rcvwnd >>= conn->rcv_wscale;
+        }
+#endif
+
+      if (rcvwnd > UINT16_MAX)
+        {
+          rcvwnd = UINT16_MAX;
+        }
+
+      tcp->wnd[0] = (rcvwnd >> 8);
+      tcp->wnd[1] = (rcvwnd & 0xff);
     }
 
   /* Finish the IP portion of the message and calculate checksums */
@@ -395,6 +447,27 @@ void tcp_send(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->flags     = flags;
   dev->d_len     = len;
   tcp->tcpoffset = (TCP_HDRLEN / 4) << 4;
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* A pure ACK reports any out-of-order data that we hold (RFC 2018).  The
+   * option would displace the payload of a segment that carries data.
+   */
+
+  if (flags == TCP_ACK && (conn->optflags & TCP_OPTF_SACK) != 0 &&
+      conn->nofosegs > 0)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN;
+      unsigned int optlen;
+
+      if (len == optdata - &dev->d_buf[NET_LL_HDRLEN(dev)])
+        {
+          optlen         = tcp_sack_build(conn, optdata);
+          dev->d_len    += optlen;
+          tcp->tcpoffset = ((TCP_HDRLEN + optlen) / 4) << 4;
+        }
+    }
+#endif
+
   tcp_sendcommon(dev, conn, tcp);
 }
 
@@ -537,6 +610,7 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
 {
   struct tcp_hdr_s *tcp;
   uint16_t tcp_mss;
+  uint16_t optlen;
 
   /* Get values that vary with the underlying IP domain */
 
@@ -582,7 +656,45 @@ void tcp_ack(FAR struct net_driver_s *dev, FAR struct tcp_conn_s *conn,
   tcp->optdata[1] = TCP_OPT_MSS_LEN;
   tcp->optdata[2] = tcp_mss >> 8;
   tcp->optdata[3] = tcp_mss & 0xff;
-  tcp->tcpoffset  = ((TCP_HDRLEN + TCP_OPT_MSS_LEN) / 4) << 4;
+  optlen          = TCP_OPT_MSS_LEN;
+
+#ifdef CONFIG_NET_TCP_WINDOW_SCALE
+  /* We offer window scaling in our SYN.  We answer with the option in our
+   * SYNACK only if the peer offered window scaling in its SYN.
+   */
+
+  if ((ack & TCP_ACK) == 0 || (conn->optflags & TCP_OPTF_WSCALE) != 0)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      conn->rcv_wscale = tcp_rcvwscale(dev);
+
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_WS;
+      optdata[2]  = TCP_OPT_WS_LEN;
+      optdata[3]  = conn->rcv_wscale;
+      optlen     += TCP_OPT_WS_LEN + 1;
+      dev->d_len += TCP_OPT_WS_LEN + 1;
+    }
+#endif
+
+#ifdef CONFIG_NET_TCP_SACK
+  /* Likewise for selective acknowledgements */
+
+  if ((ack & TCP_ACK) == 0 || (conn->optflags & TCP_OPTF_SACK) != 0)
+    {
+      FAR uint8_t *optdata = (FAR uint8_t *)tcp + TCP_HDRLEN + optlen;
+
+      optdata[0]  = TCP_OPT_NOOP;
+      optdata[1]  = TCP_OPT_NOOP;
+      optdata[2]  = TCP_OPT_SACK_PERM;
+      optdata[3]  = TCP_OPT_SACK_PERM_LEN;
+      optlen     += TCP_OPT_SACK_PERM_LEN + 2;
+      dev->d_len += TCP_OPT_SACK_PERM_LEN + 2;
+    }
+#endif
+
+  tcp->tcpoffset  = ((TCP_HDRLEN + optlen) / 4) << 4;
 
   /* Complete the common portions of the TCP message */
 
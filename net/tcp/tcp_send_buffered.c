@@ -266,6 +266,12 @@ static inline void send_ipselect(FAR struct net_driver_s *dev,
  *   NOTE 3: If CONFIG_NET_ARP_SEND then we can be assured that the IP
  *   address mapping is already in the ARP table.
  *
+ *   NOTE 4: If CONFIG_NET_ARP_PENDING is non-zero, then a packet to an
+ *   unresolved address is held and sent once the address is resolved.  It
+ *   must be counted as sent; sending the same data again would duplicate
+ *   it.  If the packet is dropped after all, the data is retransmitted
+ *   when the retransmission timer expires.
+ *
  * Parameters:
  *   conn  - The TCP connection structure
  *
@@ -285,7 +291,8 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
   if (conn->domain == PF_INET)
 #endif
     {
-#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND)
+#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND) && \
+    CONFIG_NET_ARP_PENDING == 0
       return (arp_find(conn->u.ipv4.raddr) != NULL);
 #else
       return true;
@@ -311,6 +318,255 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
 #  define psock_send_addrchck(r) (true)
 #endif /* CONFIG_NET_ETHERNET */
 
+/****************************************************************************
+ * Function: psock_sack_rexmit
+ *
+ * Description:
+ *   Handle a retransmission request on a connection that uses selective
+ *   acknowledgements.
+ *
+ *   On a fast retransmission (TCP_REXMIT with TCP_ACKDATA), only the
+ *   un-ACKed write buffers that lie below the highest SACKed sequence
+ *   number and that were not SACKed themselves are moved back to the
+ *   write_q; these are the holes that the peer is missing.
+ *
+ *   A retransmission timeout (TCP_REXMIT alone) discards the SACK
+ *   information since the peer may have discarded the out-of-order data
+ *   (RFC 2018, section 8).
+ *
+ * Parameters:
+ *   conn     The connection structure associated with the socket
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   True if the retransmission was handled;  false if all un-ACKed data
+ *   must be retransmitted.
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_SACK
+static bool psock_sack_rexmit(FAR struct tcp_conn_s *conn, uint16_t flags)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  FAR sq_entry_t *entry;
+  FAR sq_entry_t *next;
+  bool handled = false;
+
+  if ((conn->optflags & TCP_OPTF_SACK) == 0)
+    {
+      return false;
+    }
+
+  if ((flags & TCP_ACKDATA) == 0)
+    {
+      for (entry = sq_peek(&conn->unacked_q); entry; entry = sq_next(entry))
+        {
+          ((FAR struct tcp_wrbuffer_s *)entry)->wb_sacked = false;
+        }
+
+      conn->sackhigh = conn->lastack;
+      return false;
+    }
+
+  for (entry = sq_peek(&conn->unacked_q); entry; entry = next)
+    {
+      next = sq_next(entry);
+      wrb  = (FAR struct tcp_wrbuffer_s *)entry;
+
+      /* Nothing is known about data beyond the highest SACKed data */
+
+      if (!TCP_SEQ_LT(WRB_SEQNO(wrb), conn->sackhigh))
+        {
+          break;
+        }
+
+      if (wrb->wb_sacked)
+        {
+          continue;
+        }
+
+      /* Resend this write buffer */
+
+      sq_rem(entry, &conn->unacked_q);
+      handled = true;
+
+      if (conn->unacked > WRB_SENT(wrb))
+        {
+          conn->unacked -= WRB_SENT(wrb);
+        }
+      else
+        {
+          conn->unacked = 0;
+        }
+
+      if (conn->sent > WRB_SENT(wrb))
+        {
+          conn->sent -= WRB_SENT(wrb);
+        }
+      else
+        {
+          conn->sent = 0;
+        }
+
+      WRB_SENT(wrb) = 0;
+
+      if (++WRB_NRTX(wrb) >= TCP_MAXRTX)
+        {
+          nwarn("WARNING: Expiring wrb=%p nrtx=%u\n", wrb, WRB_NRTX(wrb));
+
+          tcp_wrbuffer_release(wrb);
+          conn->expired++;
+        }
+      else
+        {
+          ninfo("SACK REXMIT: Moving wrb=%p seqno=%u\n",
+                wrb, WRB_SEQNO(wrb));
+          psock_insert_segment(wrb, &conn->write_q);
+        }
+    }
+
+  return handled;
+}
+#endif
+
+/****************************************************************************
+ * Function: psock_fast_rexmit
+ *
+ * Description:
+ *   Handle a fast retransmission or a NewReno partial ACK that was
+ *   requested by congestion control (TCP_REXMIT with TCP_ACKDATA).  Only
+ *   the first un-ACKed segment is resent.  The write buffer stays where it
+ *   is, so the rest of the data in flight is not sent again and the count
+ *   of un-ACKed bytes, that congestion control uses as the flight size,
+ *   is left unchanged.
+ *
+ *   A retransmission timeout (TCP_REXMIT alone) is not handled here; all
+ *   un-ACKed data is resent in that case.
+ *
+ * Parameters:
+ *   dev      The structure of the network driver that caused the interrupt
+ *   conn     The connection structure associated with the socket
+ *   flags    Set of events describing why the callback was invoked
+ *
+ * Returned Value:
+ *   True if the retransmission was handled;  false if all un-ACKed data
+ *   must be retransmitted.
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_CC
+static bool psock_fast_rexmit(FAR struct net_driver_s *dev,
+                              FAR struct tcp_conn_s *conn, uint16_t flags)
+{
+  FAR struct tcp_wrbuffer_s *wrb;
+  size_t sndlen;
+
+  if ((flags & TCP_ACKDATA) == 0)
+    {
+      return false;
+    }
+
+  /* The lowest un-ACKed sequence number is at the head of the unacked_q
+   * or, if nothing there has been sent completely, in the partially sent
+   * write buffer at the head of the write_q.
+   */
+
+  wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->unacked_q);
+  if (wrb == NULL)
+    {
+      wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
+      if (wrb == NULL || WRB_SENT(wrb) == 0)
+        {
+          /* Nothing is outstanding.  Ignore the request. */
+
+          return true;
+        }
+    }
+
+  /* Wait for the next poll if the outgoing packet is not available */
+
+  if (dev->d_sndlen > 0 || !psock_send_addrchck(conn))
+    {
+      return true;
+    }
+
+  sndlen = WRB_SENT(wrb);
+  if (sndlen > conn->mss)
+    {
+      sndlen = conn->mss;
+    }
+
+  WRB_NRTX(wrb)++;
+  ninfo("FAST REXMIT: wrb=%p seqno=%u sndlen=%u nrtx=%u\n",
+        wrb, WRB_SEQNO(wrb), sndlen, WRB_NRTX(wrb));
+
+  /* Resend the first segment of the write buffer.  Since the data is
+   * already counted in unacked, sent and sndseq_max, none of them change.
+   */
+
+  tcp_setsequence(conn->sndseq, WRB_SEQNO(wrb));
+
+#ifdef NEED_IPDOMAIN_SUPPORT
+  send_ipselect(dev, conn);
+#endif
+
+  devif_iob_send(dev, WRB_IOB(wrb), sndlen, 0);
+  return true;
+}
+#endif
+
+/****************************************************************************
+ * Function: psock_send_hold
+ *
+ * Description:
+ *   Decide whether a partial segment at the head of the write queue should
+ *   be held back instead of being sent now.  With TCP_CORK, partial
+ *   segments are always held back.  Otherwise, the Nagle algorithm (RFC
+ *   896, RFC 1122 section 4.2.3.4) holds them back while there is
+ *   unacknowledged data, unless TCP_NODELAY is set.  More data is meanwhile
+ *   appended to the write buffer by psock_tcp_send().
+ *
+ * Parameters:
+ *   conn  - The TCP connection structure
+ *   wrb   - The write buffer at the head of the write queue
+ *
+ * Returned Value:
+ *   true if the data in the write buffer should not be sent now.
+ *
+ * Assumptions:
+ *   Running at the interrupt level
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_TCP_NAGLE
+static inline bool psock_send_hold(FAR struct tcp_conn_s *conn,
+                                   FAR struct tcp_wrbuffer_s *wrb)
+{
+  /* Retransmissions, full-sized segments and data with more data queued
+   * behind it are never held back.
+   */
+
+  if (WRB_NRTX(wrb) > 0 || WRB_PKTLEN(wrb) - WRB_SENT(wrb) >= conn->mss ||
+      sq_next(&wrb->wb_node) != NULL)
+    {
+      return false;
+    }
+
+  if ((conn->txflags & TCP_TXF_CORK) != 0)
+    {
+      return true;
+    }
+
+  return (conn->txflags & TCP_TXF_NODELAY) == 0 && conn->unacked > 0;
+}
+#endif
+
 /****************************************************************************
  * Function: psock_send_interrupt
  *
@@ -496,6 +752,18 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
           ninfo("ACK: wrb=%p seqno=%u pktlen=%u sent=%u\n",
                 wrb, WRB_SEQNO(wrb), WRB_PKTLEN(wrb), WRB_SENT(wrb));
         }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* A partial segment may have been held back waiting for this ACK.
+       * Have the device poll for it now rather than on its next timer
+       * poll.
+       */
+
+      if (conn->unacked == 0 && !sq_empty(&conn->write_q))
+        {
+          tcp_send_txnotify(psock, conn);
+        }
+#endif
     }
 
   /* Check for a loss of connection */
@@ -517,9 +785,21 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
       return flags;
     }
 
-   /* Check if we are being asked to retransmit data */
+  /* Check if we are being asked to retransmit data.  This may accompany
+   * an ACK when congestion control requests a fast retransmission.  With
+   * SACK, only the holes reported by the peer may need to be resent;
+   * without it, only the first un-ACKed segment is.  After a timeout,
+   * all un-ACKed data is resent.
+   */
 
-   else if ((flags & TCP_REXMIT) != 0)
+  if ((flags & TCP_REXMIT) != 0
+#ifdef CONFIG_NET_TCP_SACK
+      && !psock_sack_rexmit(conn, flags)
+#endif
+#ifdef CONFIG_NET_TCP_CC
+      && !psock_fast_rexmit(dev, conn, flags)
+#endif
+     )
     {
       FAR struct tcp_wrbuffer_s *wrb;
       FAR sq_entry_t *entry;
@@ -708,6 +988,15 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
           wrb = (FAR struct tcp_wrbuffer_s *)sq_peek(&conn->write_q);
           DEBUGASSERT(wrb);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+          if ((flags & TCP_REXMIT) == 0 && psock_send_hold(conn, wrb))
+            {
+              ninfo("SEND: Holding wrb=%p pktlen=%u unacked=%u\n",
+                    wrb, WRB_PKTLEN(wrb), conn->unacked);
+              return flags;
+            }
+#endif
+
           /* Get the amount of data that we can send in the next packet.
            * We will send either the remaining data in the buffer I/O
            * buffer chain, or as much as will fit given the MSS and current
@@ -720,10 +1009,28 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
               sndlen = conn->mss;
             }
 
+#ifdef CONFIG_NET_TCP_CC
+          /* Do not put more data in flight than the congestion window and
+           * the peer's receive window allow.
+           */
+
+          if (conn->unacked >= TCP_CC_SNDWND(conn))
+            {
+              ninfo("SEND: window full unacked=%u cwnd=%u winsize=%u\n",
+                    conn->unacked, conn->cwnd, conn->winsize);
+              return flags;
+            }
+
+          if (sndlen > TCP_CC_SNDWND(conn) - conn->unacked)
+            {
+              sndlen = TCP_CC_SNDWND(conn) - conn->unacked;
+            }
+#else
           if (sndlen > conn->winsize)
             {
               sndlen = conn->winsize;
             }
+#endif
 
           ninfo("SEND: wrb=%p pktlen=%u sent=%u sndlen=%u\n",
                 wrb, WRB_PKTLEN(wrb), WRB_SENT(wrb), sndlen);
@@ -828,7 +1135,11 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
 }
 
 /****************************************************************************
- * Function: send_txnotify
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_send_txnotify
  *
  * Description:
  *   Notify the appropriate device driver that we are have data ready to
@@ -843,8 +1154,8 @@ static uint16_t psock_send_interrupt(FAR struct net_driver_s *dev,
  *
  ****************************************************************************/
 
-static inline void send_txnotify(FAR struct socket *psock,
-                                 FAR struct tcp_conn_s *conn)
+void tcp_send_txnotify(FAR struct socket *psock,
+                       FAR struct tcp_conn_s *conn)
 {
 #ifdef CONFIG_NET_IPv4
 #ifdef CONFIG_NET_IPv6
@@ -882,10 +1193,6 @@ static inline void send_txnotify(FAR struct socket *psock,
 #endif /* CONFIG_NET_IPv6 */
 }
 
-/****************************************************************************
- * Public Functions
- ****************************************************************************/
-
 /****************************************************************************
  * Function: psock_tcp_send
  *
@@ -1019,6 +1326,25 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
        */
 
       net_lock();
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      /* If nothing has been sent from the last write buffer yet, then
+       * small writes are appended to it so that they are sent together.
+       * The callback is already in place in that case.
+       */
+
+      wrb = (FAR struct tcp_wrbuffer_s *)conn->write_q.tail;
+      if (wrb != NULL && WRB_SEQNO(wrb) == (unsigned)-1 &&
+          WRB_PKTLEN(wrb) + len <= conn->mss)
+        {
+          result = iob_copyin(WRB_IOB(wrb), (FAR uint8_t *)buf, len,
+                              WRB_PKTLEN(wrb), false);
+
+          ninfo("Appended to WRB=%p pktlen=%u\n", wrb, WRB_PKTLEN(wrb));
+          goto notify;
+        }
+#endif
+
       wrb = tcp_wrbuffer_alloc();
       if (!wrb)
         {
@@ -1058,7 +1384,32 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
 
       WRB_SEQNO(wrb) = (unsigned)-1;
       WRB_NRTX(wrb)  = 0;
+
+#ifdef CONFIG_NET_FINE_LOCKS
+      /* The write buffer is not visible to the network until it is added to
+       * the write queue below.  Copy the user data without the network
+       * lock so that the copy (and any wait for I/O buffers) does not hold
+       * up other network activity.
+       */
+
+      net_unlock();
+      result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
+      net_lock();
+
+      /* The connection may have been lost while the network was unlocked.
+       * psock_lost_connection() disables the callback in that case.
+       */
+
+      if (!_SS_ISCONNECTED(psock->s_flags) || psock->s_sndcb == NULL ||
+          psock->s_sndcb->event == NULL)
+        {
+          nerr("ERROR: Connection lost\n");
+          errcode = ENOTCONN;
+          goto errout_with_wrb;
+        }
+#else
       result = WRB_COPYIN(wrb, (FAR uint8_t *)buf, len);
+#endif
 
       /* Dump I/O buffer chain */
 
@@ -1073,9 +1424,12 @@ ssize_t psock_tcp_send(FAR struct socket *psock, FAR const void *buf,
             wrb, WRB_PKTLEN(wrb),
             conn->write_q.head, conn->write_q.tail);
 
+#ifdef CONFIG_NET_TCP_NAGLE
+notify:
+#endif
       /* Notify the device driver of the availability of TX data */
 
-      send_txnotify(psock, conn);
+      tcp_send_txnotify(psock, conn);
       net_unlock();
     }
 
@@ -217,6 +217,12 @@ static inline void tcpsend_ipselect(FAR struct net_driver_s *dev,
  *   NOTE 3: If CONFIG_NET_ARP_SEND then we can be assured that the IP
  *   address mapping is already in the ARP table.
  *
+ *   NOTE 4: If CONFIG_NET_ARP_PENDING is non-zero, then a packet to an
+ *   unresolved address is held and sent once the address is resolved.  It
+ *   must be counted as sent; sending the same data again would duplicate
+ *   it.  If the packet is dropped after all, the data is retransmitted
+ *   when the retransmission timer expires.
+ *
  * Parameters:
  *   conn  - The TCP connection structure
  *
@@ -236,7 +242,8 @@ static inline bool psock_send_addrchck(FAR struct tcp_conn_s *conn)
   if (conn->domain == PF_INET)
 #endif
     {
-#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND)
+#if !defined(CONFIG_NET_ARP_IPIN) && !defined(CONFIG_NET_ARP_SEND) && \
+    CONFIG_NET_ARP_PENDING == 0
       return (arp_find(conn->u.ipv4.raddr) != NULL);
 #else
       return true;
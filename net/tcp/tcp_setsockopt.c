@@ -0,0 +1,155 @@
+/****************************************************************************
+ * net/tcp/tcp_setsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_TCP) && \
+    defined(CONFIG_NET_SOCKOPTS)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/tcp.h>
+#include <stdbool.h>
+#include <queue.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "socket/socket.h"
+#include "tcp/tcp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: tcp_setsockopt
+ *
+ * Description:
+ *   tcp_setsockopt() sets the TCP protocol option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument.  This
+ *   implements setsockopt() for the IPPROTO_TCP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_setsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+int tcp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+#ifdef CONFIG_NET_TCP_NAGLE
+  FAR struct tcp_conn_s *conn;
+  uint8_t txflag;
+  bool push;
+#endif
+
+  /* Only Internet stream sockets have a TCP connection structure */
+
+  if ((psock->s_domain != PF_INET && psock->s_domain != PF_INET6) ||
+      psock->s_type != SOCK_STREAM || psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  /* Both options take a pointer to an integer boolean value */
+
+  if (value == NULL || value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+  switch (option)
+    {
+      case TCP_NODELAY:  /* Disable the Nagle algorithm */
+#ifdef CONFIG_NET_TCP_NAGLE
+        txflag = TCP_TXF_NODELAY;
+        push   = (*(FAR const int *)value != 0);
+        break;
+#else
+        /* Small segments are never held back */
+
+        return OK;
+#endif
+
+#ifdef CONFIG_NET_TCP_NAGLE
+      case TCP_CORK:     /* Hold back partial segments */
+        txflag = TCP_TXF_CORK;
+        push   = (*(FAR const int *)value == 0);
+        break;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+#ifdef CONFIG_NET_TCP_NAGLE
+  conn = (FAR struct tcp_conn_s *)psock->s_conn;
+
+  net_lock();
+  if (*(FAR const int *)value != 0)
+    {
+      conn->txflags |= txflag;
+    }
+  else
+    {
+      conn->txflags &= ~txflag;
+    }
+
+  /* Setting TCP_NODELAY or clearing TCP_CORK releases any partial segment
+   * that is being held back.
+   */
+
+  if (push && !sq_empty(&conn->write_q))
+    {
+      tcp_send_txnotify(psock, conn);
+    }
+
+  net_unlock();
+  return OK;
+#endif
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_TCP && CONFIG_NET_SOCKOPTS */
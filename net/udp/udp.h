@@ -43,6 +43,7 @@
 #include <nuttx/config.h>
 
 #include <sys/types.h>
+#include <stdbool.h>
 #include <queue.h>
 
 #include <nuttx/net/ip.h>
@@ -70,6 +71,25 @@
 #define udp_callback_free(dev, conn,cb) \
   devif_conn_callback_free(dev, cb, &conn->list)
 
+/* Each datagram in the read-ahead queue is an I/O buffer chain holding the
+ * size of the source address (one byte), the source address, the segment
+ * size of coalesced datagrams (two bytes, host order, CONFIG_NET_UDP_GRO
+ * only, zero if nothing was coalesced) and then the payload.
+ */
+
+#ifdef CONFIG_NET_UDP_GRO
+#  define UDP_RA_SEGSIZELEN 2
+#else
+#  define UDP_RA_SEGSIZELEN 0
+#endif
+
+#define UDP_RA_HDRLEN(addrsize) \
+  (sizeof(uint8_t) + (addrsize) + UDP_RA_SEGSIZELEN)
+
+/* The maximum number of datagrams coalesced into one chain */
+
+#define UDP_GRO_MAXSEGS 64
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -82,6 +102,9 @@ struct udp_hdr_s;         /* Forward reference */
 struct udp_conn_s
 {
   dq_entry_t node;        /* Supports a doubly linked list */
+#ifdef CONFIG_NET_UDP_CONNHASH
+  FAR struct udp_conn_s *hnext; /* Next in the local port hash chain */
+#endif
   union ip_binding_u u;   /* IP address binding */
   uint16_t lport;         /* Bound local port number (network byte order) */
   uint16_t rport;         /* Remote port number (network byte order) */
@@ -99,6 +122,14 @@ struct udp_conn_s
   struct iob_queue_s readahead;   /* Read-ahead buffering */
 #endif
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t gso_size;      /* UDP_SEGMENT payload size (0: disabled) */
+#endif
+  bool     txmore;        /* More datagrams are ready to be sent */
+#ifdef CONFIG_NET_UDP_GRO
+  bool     gro;           /* UDP_GRO: Coalesce received datagrams */
+#endif
+
   /* Defines the list of UDP callbacks */
 
   FAR struct devif_callback_s *list;
@@ -505,6 +536,56 @@ int udp_pollsetup(FAR struct socket *psock, FAR struct pollfd *fds);
 int udp_pollteardown(FAR struct socket *psock, FAR struct pollfd *fds);
 #endif
 
+/****************************************************************************
+ * Function: udp_setsockopt
+ *
+ * Description:
+ *   udp_setsockopt() sets the UDP protocol option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument.  This
+ *   implements setsockopt() for the IPPROTO_UDP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_setsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int udp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len);
+#endif
+
+/****************************************************************************
+ * Function: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value of the UDP protocol option
+ *   specified by the 'option' argument.  This implements getsockopt() for
+ *   the IPPROTO_UDP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_getsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_SOCKOPTS
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len);
+#endif
+
 #undef EXTERN
 #ifdef __cplusplus
 }
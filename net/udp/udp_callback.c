@@ -41,6 +41,7 @@
 #if defined(CONFIG_NET) && defined(CONFIG_NET_UDP)
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <string.h>
 #include <debug.h>
 
@@ -67,6 +68,106 @@
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Function: udp_gro_merge
+ *
+ * Description:
+ *   Try to append a received datagram to the last datagram in the
+ *   read-ahead queue.  This is possible if both are from the same source,
+ *   all datagrams in the chain have the same size, and the new datagram is
+ *   no larger than that.
+ *
+ * Returned Value:
+ *   True if the datagram was coalesced.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_GRO
+static bool udp_gro_merge(FAR struct udp_conn_s *conn,
+                          FAR const void *src_addr, uint8_t src_addr_size,
+                          FAR const uint8_t *buffer, uint16_t buflen)
+{
+  struct sockaddr_storage addr;
+  FAR struct iob_s *iob;
+  unsigned int datalen;
+  unsigned int oldlen;
+  uint16_t segsize;
+  uint8_t addrsize;
+  int ret;
+
+  if (conn->readahead.qh_tail == NULL || buflen == 0)
+    {
+      return false;
+    }
+
+  iob = conn->readahead.qh_tail->qe_head;
+
+  /* Is the last datagram from the same source? */
+
+  if (iob_copyout(&addrsize, iob, sizeof(uint8_t), 0) != sizeof(uint8_t) ||
+      addrsize != src_addr_size || addrsize > sizeof(addr) ||
+      iob_copyout((FAR uint8_t *)&addr, iob, addrsize, sizeof(uint8_t)) !=
+      addrsize || memcmp(&addr, src_addr, addrsize) != 0)
+    {
+      return false;
+    }
+
+  if (iob_copyout((FAR uint8_t *)&segsize, iob, sizeof(uint16_t),
+                  sizeof(uint8_t) + addrsize) != sizeof(uint16_t))
+    {
+      return false;
+    }
+
+  /* All datagrams but the last one must have the segment size.  If
+   * nothing was coalesced yet, the first datagram sets the segment size.
+   */
+
+  oldlen  = iob->io_pktlen;
+  datalen = oldlen - UDP_RA_HDRLEN(addrsize);
+
+  if (segsize == 0)
+    {
+      if (buflen > datalen)
+        {
+          return false;
+        }
+
+      segsize = datalen;
+    }
+  else if (buflen > segsize || (datalen % segsize) != 0 ||
+           datalen / segsize >= UDP_GRO_MAXSEGS)
+    {
+      return false;
+    }
+
+  if (oldlen + buflen > UINT16_MAX)
+    {
+      return false;
+    }
+
+  /* Append the payload.  Remove any partial copy on failure. */
+
+  ret = iob_trycopyin(iob, buffer, buflen, oldlen, true);
+  if (ret < 0)
+    {
+      if (iob->io_pktlen > oldlen)
+        {
+          (void)iob_trimtail(iob, iob->io_pktlen - oldlen);
+        }
+
+      return false;
+    }
+
+  /* Record the segment size (this overwrites data already in the chain
+   * and cannot fail).
+   */
+
+  (void)iob_trycopyin(iob, (FAR const uint8_t *)&segsize, sizeof(uint16_t),
+                      sizeof(uint8_t) + addrsize, true);
+  return true;
+}
+#endif
+
 /****************************************************************************
  * Function: udp_datahandler
  *
@@ -90,17 +191,9 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 #endif
   FAR void  *src_addr;
   uint8_t src_addr_size;
-
-  /* Allocate on I/O buffer to start the chain (throttling as necessary).
-   * We will not wait for an I/O buffer to become available in this context.
-   */
-
-  iob = iob_tryalloc(true);
-  if (iob == NULL)
-    {
-      nerr("ERROR: Failed to create new I/O buffer chain\n");
-      return 0;
-    }
+#ifdef CONFIG_NET_UDP_GRO
+  uint16_t segsize;
+#endif
 
 #ifdef CONFIG_NET_IPv6
 #ifdef CONFIG_NET_IPv4
@@ -110,6 +203,7 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       FAR struct udp_hdr_s *udp   = UDPIPv6BUF;
       FAR struct ipv6_hdr_s *ipv6 = IPv6BUF;
 
+      memset(&src_addr6, 0, sizeof(src_addr6));
       src_addr6.sin6_family = AF_INET6;
       src_addr6.sin6_port   = udp->srcport;
 
@@ -138,6 +232,7 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
 
           /* Encode the IPv4 address as an IPv-mapped IPv6 address */
 
+          memset(&src_addr6, 0, sizeof(src_addr6));
           src_addr6.sin6_family = AF_INET6;
           src_addr6.sin6_port = udp->srcport;
 
@@ -153,6 +248,7 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
           FAR struct udp_hdr_s *udp   = UDPIPv4BUF;
           FAR struct ipv4_hdr_s *ipv4 = IPv4BUF;
 
+          memset(&src_addr4, 0, sizeof(src_addr4));
           src_addr4.sin_family = AF_INET;
           src_addr4.sin_port   = udp->srcport;
 
@@ -165,6 +261,29 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
     }
 #endif /* CONFIG_NET_IPv4 */
 
+#ifdef CONFIG_NET_UDP_GRO
+  /* Try to coalesce the datagram with the last one from the same source */
+
+  if (conn->gro &&
+      udp_gro_merge(conn, src_addr, src_addr_size, buffer, buflen))
+    {
+      ninfo("Coalesced %d bytes\n", buflen);
+      return buflen;
+    }
+#endif
+
+  /* Allocate on I/O buffer to start the chain (throttling as necessary),
+   * preferably one that holds the whole record.  We will not wait for an
+   * I/O buffer to become available in this context.
+   */
+
+  iob = iob_tryalloc_sized(UDP_RA_HDRLEN(src_addr_size) + buflen, true);
+  if (iob == NULL)
+    {
+      nerr("ERROR: Failed to create new I/O buffer chain\n");
+      return 0;
+    }
+
   /* Copy the src address info into the I/O buffer chain.  We will not wait
    * for an I/O buffer to become available in this context.  It there is
    * any failure to allocated, the entire I/O buffer chain will be discarded.
@@ -196,12 +315,26 @@ static uint16_t udp_datahandler(FAR struct net_driver_s *dev, FAR struct udp_con
       return 0;
     }
 
+#ifdef CONFIG_NET_UDP_GRO
+  /* Nothing is coalesced yet */
+
+  segsize = 0;
+  ret = iob_trycopyin(iob, (FAR const uint8_t *)&segsize, sizeof(uint16_t),
+                      src_addr_size + sizeof(uint8_t), true);
+  if (ret < 0)
+    {
+      nerr("ERROR: Failed to add data to the I/O buffer chain: %d\n", ret);
+      (void)iob_free_chain(iob);
+      return 0;
+    }
+#endif
+
   if (buflen > 0)
     {
       /* Copy the new appdata into the I/O buffer chain */
 
-      ret = iob_trycopyin(iob, buffer, buflen,
-                          src_addr_size + sizeof(uint8_t), true);
+      ret = iob_trycopyin(iob, buffer, buflen, UDP_RA_HDRLEN(src_addr_size),
+                          true);
       if (ret < 0)
         {
           /* On a failure, iob_trycopyin return a negated error value but
@@ -72,6 +72,17 @@
 #define IPv4BUF ((struct ipv4_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 #define IPv6BUF ((struct ipv6_hdr_s *)&dev->d_buf[NET_LL_HDRLEN(dev)])
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+#  if (CONFIG_NET_UDP_CONNHASH_SIZE & (CONFIG_NET_UDP_CONNHASH_SIZE - 1)) != 0
+#    error CONFIG_NET_UDP_CONNHASH_SIZE must be a power of two
+#  endif
+
+#  define UDP_HASH_MASK (CONFIG_NET_UDP_CONNHASH_SIZE - 1)
+#  define udp_porthash(portno) (((portno) ^ ((portno) >> 8)) & UDP_HASH_MASK)
+#else
+#  define udp_setlport(conn,portno) do { (conn)->lport = (portno); } while (0)
+#endif
+
 /****************************************************************************
  * Private Data
  ****************************************************************************/
@@ -93,6 +104,12 @@ static dq_queue_t g_active_udp_connections;
 
 static uint16_t g_last_udp_port;
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+/* Bound UDP connections hashed on the local port number */
+
+static FAR struct udp_conn_s *g_udp_port_hash[CONFIG_NET_UDP_CONNHASH_SIZE];
+#endif
+
 /****************************************************************************
  * Private Functions
  ****************************************************************************/
@@ -121,6 +138,60 @@ static inline void _udp_semtake(FAR sem_t *sem)
 
 #define _udp_semgive(sem) sem_post(sem)
 
+/****************************************************************************
+ * Name: udp_setlport
+ *
+ * Description:
+ *   Assign a local port number (network byte order) to a connection and
+ *   keep the local port hash table up to date.  A port number of zero
+ *   unbinds the connection.  Connections are appended to the bucket so
+ *   that, just like in the list of allocated connections, the oldest
+ *   connection is found first.
+ *
+ * Assumptions:
+ *   The network is locked.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_NET_UDP_CONNHASH
+static void udp_setlport(FAR struct udp_conn_s *conn, uint16_t portno)
+{
+  FAR struct udp_conn_s **link;
+
+  /* Remove the connection from the bucket of its current port number */
+
+  if (conn->lport != 0)
+    {
+      for (link = &g_udp_port_hash[udp_porthash(conn->lport)];
+           *link != NULL;
+           link = &(*link)->hnext)
+        {
+          if (*link == conn)
+            {
+              *link = conn->hnext;
+              break;
+            }
+        }
+    }
+
+  /* And add it to the end of the bucket of its new port number */
+
+  conn->lport = portno;
+
+  if (portno != 0)
+    {
+      for (link = &g_udp_port_hash[udp_porthash(portno)];
+           *link != NULL;
+           link = &(*link)->hnext)
+        {
+        }
+
+      conn->hnext = NULL;
+      *link       = conn;
+    }
+}
+#endif /* CONFIG_NET_UDP_CONNHASH */
+
 /****************************************************************************
  * Name: udp_find_conn()
  *
@@ -139,13 +210,23 @@ static FAR struct udp_conn_s *udp_find_conn(uint16_t portno)
 #endif
 {
   FAR struct udp_conn_s *conn;
+#ifndef CONFIG_NET_UDP_CONNHASH
   int i;
+#endif
 
   /* Now search each connection structure. */
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+  for (conn = g_udp_port_hash[udp_porthash(portno)];
+       conn != NULL;
+       conn = conn->hnext)
+#else
   for (i = 0; i < CONFIG_NET_UDP_CONNS; i++)
+#endif
     {
+#ifndef CONFIG_NET_UDP_CONNHASH
       conn = &g_udp_connections[i];
+#endif
 
 #ifdef CONFIG_NETDEV_MULTINIC
       /* If the port local port number assigned to the connections matches
@@ -280,7 +361,12 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv4_hdr_s *ip = IPv4BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+  conn = g_udp_port_hash[udp_porthash(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -322,7 +408,11 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -348,7 +438,12 @@ static inline FAR struct udp_conn_s *
   FAR struct ipv6_hdr_s *ip = IPv6BUF;
   FAR struct udp_conn_s *conn;
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+  conn = g_udp_port_hash[udp_porthash(udp->destport)];
+#else
   conn = (FAR struct udp_conn_s *)g_active_udp_connections.head;
+#endif
+
   while (conn)
     {
       /* If the local UDP port is non-zero, the connection is considered
@@ -390,7 +485,11 @@ static inline FAR struct udp_conn_s *
 
       /* Look at the next active connection */
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+      conn = conn->hnext;
+#else
       conn = (FAR struct udp_conn_s *)conn->node.flink;
+#endif
     }
 
   return conn;
@@ -458,6 +557,13 @@ FAR struct udp_conn_s *udp_alloc(uint8_t domain)
       conn->domain = domain;
 #endif
       conn->lport  = 0;
+#ifdef CONFIG_NET_UDP_SEGMENT
+      conn->gso_size = 0;
+#endif
+      conn->txmore   = false;
+#ifdef CONFIG_NET_UDP_GRO
+      conn->gro      = false;
+#endif
 
       /* Enqueue the connection into the active list */
 
@@ -485,8 +591,20 @@ void udp_free(FAR struct udp_conn_s *conn)
 
   DEBUGASSERT(conn->crefs == 0);
 
+#ifdef CONFIG_NET_UDP_CONNHASH
+  /* Remove the connection from the hash table before taking the free list
+   * semaphore:  The hash table is protected by the network lock.
+   */
+
+  net_lock();
+  udp_setlport(conn, 0);
+  net_unlock();
+
+  _udp_semtake(&g_free_sem);
+#else
   _udp_semtake(&g_free_sem);
   conn->lport = 0;
+#endif
 
   /* Remove the connection from the active list */
 
@@ -625,6 +743,10 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
     }
 #endif /* CONFIG_NET_IPv6 */
 
+  /* Interrupts must be disabled while access the UDP connection list */
+
+  net_lock();
+
   /* Is the user requesting to bind to any port? */
 
   if (portno == 0)
@@ -632,18 +754,14 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
       /* Yes.. Select any unused local port number */
 
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
 #else
-      conn->lport = htons(udp_select_port());
+      udp_setlport(conn, htons(udp_select_port()));
 #endif
-      ret         = OK;
+      ret = OK;
     }
   else
     {
-      /* Interrupts must be disabled while access the UDP connection list */
-
-      net_lock();
-
       /* Is any other UDP connection already bound to this address and port? */
 
 #ifdef CONFIG_NETDEV_MULTINIC
@@ -654,13 +772,12 @@ int udp_bind(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
         {
           /* No.. then bind the socket to the port */
 
-          conn->lport = portno;
-          ret         = OK;
+          udp_setlport(conn, portno);
+          ret = OK;
         }
-
-      net_unlock();
     }
 
+  net_unlock();
   return ret;
 }
 
@@ -701,11 +818,13 @@ int udp_connect(FAR struct udp_conn_s *conn, FAR const struct sockaddr *addr)
        * connection structure.
        */
 
+      net_lock();
 #ifdef CONFIG_NETDEV_MULTINIC
-      conn->lport = htons(udp_select_port(conn->domain, &conn->u));
+      udp_setlport(conn, htons(udp_select_port(conn->domain, &conn->u)));
 #else
-      conn->lport = htons(udp_select_port());
+      udp_setlport(conn, htons(udp_select_port()));
 #endif
+      net_unlock();
     }
 
   /* Is there a remote port (rport)? */
@@ -0,0 +1,123 @@
+/****************************************************************************
+ * net/udp/udp_getsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_UDP) && \
+    defined(CONFIG_NET_SOCKOPTS)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: udp_getsockopt
+ *
+ * Description:
+ *   udp_getsockopt() retrieves the value of the UDP protocol option
+ *   specified by the 'option' argument.  This implements getsockopt() for
+ *   the IPPROTO_UDP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to get
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_getsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+int udp_getsockopt(FAR struct socket *psock, int option,
+                   FAR void *value, FAR socklen_t *value_len)
+{
+#if defined(CONFIG_NET_UDP_SEGMENT) || defined(CONFIG_NET_UDP_GRO)
+  FAR struct udp_conn_s *conn;
+#endif
+
+  if (psock->s_type != SOCK_DGRAM || psock->s_domain == PF_LOCAL ||
+      psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  /* Both options report an integer value */
+
+  if (value == NULL || value_len == NULL || *value_len < sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+#if defined(CONFIG_NET_UDP_SEGMENT) || defined(CONFIG_NET_UDP_GRO)
+  conn = (FAR struct udp_conn_s *)psock->s_conn;
+#endif
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_SEGMENT
+      case UDP_SEGMENT:  /* Segment size of sends */
+        *(FAR int *)value = conn->gso_size;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO:      /* Coalesce received datagrams */
+        *(FAR int *)value = conn->gro;
+        break;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+  *value_len = sizeof(int);
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_SOCKOPTS */
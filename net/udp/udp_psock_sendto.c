@@ -105,6 +105,10 @@ struct sendto_s
   FAR struct devif_callback_s *st_cb; /* Reference to callback instance */
   sem_t st_sem;                       /* Semaphore signals sendto completion */
   uint16_t st_buflen;                 /* Length of send buffer (error if <0) */
+#ifdef CONFIG_NET_UDP_SEGMENT
+  uint16_t st_segsize;                /* Datagram payload size (0: all) */
+  uint16_t st_sent;                   /* Bytes sent in previous datagrams */
+#endif
   const char *st_buffer;              /* Pointer to send buffer */
   int st_sndlen;                      /* Result of the send (length sent or negated errno) */
 };
@@ -284,12 +288,48 @@ static uint16_t sendto_interrupt(FAR struct net_driver_s *dev, FAR void *conn,
           sendto_ipselect(dev, pstate);
 #endif
 
-          /* Copy the user data into d_appdata and send it */
+#ifdef CONFIG_NET_UDP_SEGMENT
+          if (pstate->st_segsize > 0)
+            {
+              FAR struct udp_conn_s *udpconn = (FAR struct udp_conn_s *)conn;
+              uint16_t sndlen;
+
+              /* Send the next segment of the buffer as one datagram */
+
+              sndlen = pstate->st_buflen - pstate->st_sent;
+              if (sndlen > pstate->st_segsize)
+                {
+                  sndlen = pstate->st_segsize;
+                }
+
+              devif_send(dev, &pstate->st_buffer[pstate->st_sent], sndlen);
+              pstate->st_sent += sndlen;
+
+              if (pstate->st_sent < pstate->st_buflen)
+                {
+                  /* More to go.  Have devif_poll() poll this connection
+                   * again as long as the driver accepts more packets.
+                   */
+
+                  udpconn->txmore = true;
+                  return flags;
+                }
+            }
+          else
+#endif
+            {
+              /* Copy the user data into d_appdata and send it */
+
+              devif_send(dev, pstate->st_buffer, pstate->st_buflen);
+            }
 
-          devif_send(dev, pstate->st_buffer, pstate->st_buflen);
           pstate->st_sndlen = pstate->st_buflen;
         }
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+      ((FAR struct udp_conn_s *)conn)->txmore = false;
+#endif
+
       /* Don't allow any further call backs. */
 
       pstate->st_cb->flags   = 0;
@@ -442,6 +482,35 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       goto errout_with_lock;
    }
 
+#ifdef CONFIG_NET_UDP_SEGMENT
+  /* With UDP_SEGMENT, a large buffer is sent as a train of datagrams of
+   * the segment size.
+   */
+
+  if (conn->gso_size > 0 && len > conn->gso_size)
+    {
+      uint16_t hdrlen;
+
+      /* Assume the larger IP header if both IPv4 and IPv6 are enabled */
+
+#ifdef CONFIG_NET_IPv6
+      hdrlen = IPv6_HDRLEN + UDP_HDRLEN;
+#else
+      hdrlen = IPv4_HDRLEN + UDP_HDRLEN;
+#endif
+
+      if (len > UINT16_MAX || conn->gso_size > UDP_MSS(dev, hdrlen))
+        {
+          nerr("ERROR: Bad segmentation: len=%u segment=%u\n",
+               (unsigned int)len, conn->gso_size);
+          ret = -EMSGSIZE;
+          goto errout_with_lock;
+        }
+
+      state.st_segsize = conn->gso_size;
+    }
+#endif
+
   /* Set up the callback in the connection */
 
   state.st_cb = udp_callback_alloc(dev, conn);
@@ -466,6 +535,9 @@ ssize_t psock_udp_sendto(FAR struct socket *psock, FAR const void *buf,
       /* Make sure that no further interrupts are processed */
 
       udp_callback_free(dev, conn, state.st_cb);
+#ifdef CONFIG_NET_UDP_SEGMENT
+      conn->txmore = false;
+#endif
     }
 
   /* The result of the sendto operation is the number of bytes transferred */
@@ -0,0 +1,130 @@
+/****************************************************************************
+ * net/udp/udp_setsockopt.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+#if defined(CONFIG_NET) && defined(CONFIG_NET_UDP) && \
+    defined(CONFIG_NET_SOCKOPTS)
+
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <netinet/udp.h>
+#include <stdint.h>
+#include <errno.h>
+
+#include <nuttx/net/net.h>
+
+#include "udp/udp.h"
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Function: udp_setsockopt
+ *
+ * Description:
+ *   udp_setsockopt() sets the UDP protocol option specified by the 'option'
+ *   argument to the value pointed to by the 'value' argument.  This
+ *   implements setsockopt() for the IPPROTO_UDP level.
+ *
+ * Parameters:
+ *   psock     Socket structure of the socket to query
+ *   option    Identifies the option to set
+ *   value     Points to the argument value
+ *   value_len The length of the argument value
+ *
+ * Returned Value:
+ *   Zero (OK) on success; a negated errno value on failure.  See
+ *   psock_setsockopt() for the list of possible error values.
+ *
+ ****************************************************************************/
+
+int udp_setsockopt(FAR struct socket *psock, int option,
+                   FAR const void *value, socklen_t value_len)
+{
+#if defined(CONFIG_NET_UDP_SEGMENT) || defined(CONFIG_NET_UDP_GRO)
+  FAR struct udp_conn_s *conn;
+  int optval;
+#endif
+
+  if (psock->s_type != SOCK_DGRAM || psock->s_domain == PF_LOCAL ||
+      psock->s_conn == NULL)
+    {
+      return -ENOPROTOOPT;
+    }
+
+  /* Both options take a pointer to an integer value */
+
+  if (value == NULL || value_len != sizeof(int))
+    {
+      return -EINVAL;
+    }
+
+#if defined(CONFIG_NET_UDP_SEGMENT) || defined(CONFIG_NET_UDP_GRO)
+  conn   = (FAR struct udp_conn_s *)psock->s_conn;
+  optval = *(FAR const int *)value;
+#endif
+
+  switch (option)
+    {
+#ifdef CONFIG_NET_UDP_SEGMENT
+      case UDP_SEGMENT:  /* Segment size of sends */
+        if (optval < 0 || optval > UINT16_MAX)
+          {
+            return -EINVAL;
+          }
+
+        conn->gso_size = (uint16_t)optval;
+        break;
+#endif
+
+#ifdef CONFIG_NET_UDP_GRO
+      case UDP_GRO:      /* Coalesce received datagrams */
+        conn->gro = (optval != 0);
+        break;
+#endif
+
+      default:
+        return -ENOPROTOOPT;
+    }
+
+  return OK;
+}
+
+#endif /* CONFIG_NET && CONFIG_NET_UDP && CONFIG_NET_SOCKOPTS */
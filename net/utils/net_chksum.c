@@ -41,8 +41,12 @@
 #ifdef CONFIG_NET
 
 #include <stdint.h>
+#include <stdbool.h>
 #include <debug.h>
 
+#include <arpa/inet.h>
+
+#include <nuttx/arch.h>
 #include <nuttx/net/netconfig.h>
 #include <nuttx/net/netdev.h>
 #include <nuttx/net/ip.h>
@@ -65,45 +69,139 @@
 
 /****************************************************************************
  * Name: chksum
+ *
+ * Description:
+ *   Add the one's complement sum of the len bytes at data to sum.  Both
+ *   sum and the returned value are in host byte order.
+ *
+ *   The one's complement sum does not depend on the byte order in which it
+ *   is computed (RFC 1071):  Summing the 16-bit words in host byte order
+ *   just gives the byte swapped result on a little-endian machine.  So the
+ *   data is summed a 32-bit word at a time into a 64-bit accumulator and
+ *   the carries are folded back only once at the end.
+ *
+ *   If CONFIG_NET_ARCH_CHKSUM is defined, then the architecture-specific
+ *   up_chksum() is used instead.
+ *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
+#ifdef CONFIG_NET_ARCH_CHKSUM
+#  define chksum(s,d,l) up_chksum(s,d,l)
+#else
 static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
 {
-  FAR const uint8_t *dataptr;
-  FAR const uint8_t *last_byte;
-  uint16_t t;
+#ifdef CONFIG_HAVE_LONG_LONG
+  uint64_t acc = 0;
+#else
+  uint32_t acc = 0;
+#endif
+  uint16_t result;
+  bool odd;
 
-  dataptr = data;
-  last_byte = data + len - 1;
+  /* If the buffer begins at an odd address, then the first byte is the
+   * second byte of a 16-bit word.  The sum of the remainder is then byte
+   * swapped.
+   */
 
-  while (dataptr < last_byte)
+  odd = ((uintptr_t)data & 1) != 0;
+  if (odd && len > 0)
     {
-      /* At least two more bytes */
+#ifdef CONFIG_ENDIAN_BIG
+      acc   = *data;
+#else
+      acc   = (uint16_t)*data << 8;
+#endif
+      data++;
+      len--;
+    }
 
-      t = ((uint16_t)dataptr[0] << 8) + dataptr[1];
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+#ifdef CONFIG_HAVE_LONG_LONG
+  /* Align to a 32-bit boundary */
 
-      dataptr += 2;
+  if (((uintptr_t)data & 2) != 0 && len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
     }
 
-  if (dataptr == last_byte)
+  /* Sum 16 bytes per iteration.  The accumulator cannot overflow:  Fewer
+   * than 2^14 32-bit words are added.
+   */
+
+  while (len >= 16)
     {
-      t = (dataptr[0] << 8) + 0;
-      sum += t;
-      if (sum < t)
-        {
-          sum++; /* carry */
-        }
+      FAR const uint32_t *ptr = (FAR const uint32_t *)data;
+
+      acc  += (uint64_t)ptr[0] + ptr[1] + ptr[2] + ptr[3];
+      data += 16;
+      len  -= 16;
+    }
+
+  while (len >= 4)
+    {
+      acc  += *(FAR const uint32_t *)data;
+      data += 4;
+      len  -= 4;
+    }
+#else
+  /* Sum 8 bytes per iteration.  The accumulator cannot overflow:  Fewer
+   * than 2^15 16-bit words are added.
+   */
+
+  while (len >= 8)
+    {
+      FAR const uint16_t *ptr = (FAR const uint16_t *)data;
+
+      acc  += (uint32_t)ptr[0] + ptr[1] + ptr[2] + ptr[3];
+      data += 8;
+      len  -= 8;
     }
+#endif
 
-  /* Return sum in host byte order. */
+  while (len >= 2)
+    {
+      acc  += *(FAR const uint16_t *)data;
+      data += 2;
+      len  -= 2;
+    }
 
-  return sum;
+  /* A trailing byte is the first byte of a 16-bit word */
+
+  if (len > 0)
+    {
+#ifdef CONFIG_ENDIAN_BIG
+      acc  += (uint16_t)*data << 8;
+#else
+      acc  += *data;
+#endif
+    }
+
+  /* Fold the carries back into 16 bits */
+
+#ifdef CONFIG_HAVE_LONG_LONG
+  acc = (acc & 0xffffffff) + (acc >> 32);
+  acc = (acc & 0xffffffff) + (acc >> 32);
+#endif
+  acc = (acc & 0xffff) + (acc >> 16);
+  acc = (acc & 0xffff) + (acc >> 16);
+
+  result = (uint16_t)acc;
+  if (odd)
+    {
+      result = (result << 8) | (result >> 8);
+    }
+
+  /* Convert the sum to host byte order and add the initial sum */
+
+  result = ntohs(result);
+  result += sum;
+  if (result < sum)
+    {
+      result++; /* carry */
+    }
+
+  return result;
 }
 #endif /* CONFIG_NET_ARCH_CHKSUM */
 
@@ -111,7 +209,7 @@ static uint16_t chksum(uint16_t sum, FAR const uint8_t *data, uint16_t len)
  * Name: ipv4_upperlayer_chksum
  ****************************************************************************/
 
-#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NET_IPv4)
+#ifdef CONFIG_NET_IPv4
 static uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev,
                                        uint8_t proto)
 {
@@ -147,13 +245,13 @@ static uint16_t ipv4_upperlayer_chksum(FAR struct net_driver_s *dev,
   sum = chksum(sum, &dev->d_buf[IPv4_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif
 
 /****************************************************************************
  * Name: ipv6_upperlayer_chksum
  ****************************************************************************/
 
-#if !defined(CONFIG_NET_ARCH_CHKSUM) && defined(CONFIG_NET_IPv6)
+#ifdef CONFIG_NET_IPv6
 static uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
                                        uint8_t proto)
 {
@@ -190,7 +288,7 @@ static uint16_t ipv6_upperlayer_chksum(FAR struct net_driver_s *dev,
   sum = chksum(sum, &dev->d_buf[IPv6_HDRLEN + NET_LL_HDRLEN(dev)], upperlen);
   return (sum == 0) ? 0xffff : htons(sum);
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif
 
 /****************************************************************************
  * Name: net_carry32
@@ -270,9 +368,6 @@ void net_incr32(FAR uint8_t *op32, uint16_t op16)
  *
  *   See RFC1071.
  *
- *   If CONFIG_NET_ARCH_CHKSUM is defined, then this function must be
- *   provided by architecture-specific logic.
- *
  * Input Parameters:
  *
  *   buf - A pointer to the buffer over which the checksum is to be computed.
@@ -284,12 +379,59 @@ void net_incr32(FAR uint8_t *op32, uint16_t op16)
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 uint16_t net_chksum(FAR uint16_t *data, uint16_t len)
 {
   return htons(chksum(0, (uint8_t *)data, len));
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+
+/****************************************************************************
+ * Name: net_chksum_adjust and net_chksum_adjust32
+ *
+ * Description:
+ *   Update an Internet checksum after a 16-bit or 32-bit field of the
+ *   checksummed data was rewritten, without summing all of the data again.
+ *   This uses equation 3 of RFC 1624:
+ *
+ *     HC' = ~(~HC + ~m + m')
+ *
+ *   The checksum and the field values may be in either byte order as long
+ *   as it is the same for all of them.  Normally all are just loaded from
+ *   the packet (i.e., are in network byte order).  The fields must be
+ *   16-bit aligned within the checksummed data.
+ *
+ * Input Parameters:
+ *   chksum - The checksum before the field was rewritten
+ *   oldval - The previous value of the field
+ *   newval - The new value of the field
+ *
+ * Returned Value:
+ *   The updated checksum.
+ *
+ ****************************************************************************/
+
+uint16_t net_chksum_adjust(uint16_t chksum, uint16_t oldval,
+                           uint16_t newval)
+{
+  uint32_t sum;
+
+  sum = (uint32_t)(uint16_t)~chksum + (uint16_t)~oldval + newval;
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return (uint16_t)~sum;
+}
+
+uint16_t net_chksum_adjust32(uint16_t chksum, uint32_t oldval,
+                             uint32_t newval)
+{
+  uint32_t sum;
+
+  sum = (uint32_t)(uint16_t)~chksum +
+        (uint16_t)~(oldval >> 16) + (uint16_t)~oldval +
+        (newval >> 16) + (newval & 0xffff);
+  sum = (sum & 0xffff) + (sum >> 16);
+  sum = (sum & 0xffff) + (sum >> 16);
+  return (uint16_t)~sum;
+}
 
 /****************************************************************************
  * Name: ipv4_chksum
@@ -300,15 +442,12 @@ uint16_t net_chksum(FAR uint16_t *data, uint16_t len)
  *   The IPv4 header checksum is the Internet checksum of the 20 bytes of
  *   the IPv4 header.
  *
- *   If CONFIG_NET_ARCH_CHKSUM is defined, then this function must be
- *   provided by architecture-specific logic.
- *
  * Returned Value:
  *   The IPv4 header checksum of the IPv4 header in the d_buf buffer.
  *
  ****************************************************************************/
 
-#if defined(CONFIG_NET_IPv4) && !defined(CONFIG_NET_ARCH_CHKSUM)
+#ifdef CONFIG_NET_IPv4
 uint16_t ipv4_chksum(FAR struct net_driver_s *dev)
 {
   uint16_t sum;
@@ -316,7 +455,7 @@ uint16_t ipv4_chksum(FAR struct net_driver_s *dev)
   sum = chksum(0, &dev->d_buf[NET_LL_HDRLEN(dev)], IPv4_HDRLEN);
   return (sum == 0) ? 0xffff : htons(sum);
 }
-#endif /* CONFIG_NET_ARCH_CHKSUM */
+#endif
 
 /****************************************************************************
  * Name: tcp_chksum, tcp_ipv4_chksum, and tcp_ipv6_chksum
@@ -337,7 +476,6 @@ uint16_t ipv4_chksum(FAR struct net_driver_s *dev)
  *
  ****************************************************************************/
 
-#ifndef CONFIG_NET_ARCH_CHKSUM
 #ifdef CONFIG_NET_IPv4
 uint16_t tcp_ipv4_chksum(FAR struct net_driver_s *dev)
 {
@@ -351,7 +489,6 @@ uint16_t tcp_ipv6_chksum(FAR struct net_driver_s *dev)
   return ipv6_upperlayer_chksum(dev, IP_PROTO_TCP);
 }
 #endif /* CONFIG_NET_IPv6 */
-#endif /* !CONFIG_NET_ARCH_CHKSUM */
 
 #if defined(CONFIG_NET_IPv4) && defined(CONFIG_NET_IPv6)
 uint16_t tcp_chksum(FAR struct net_driver_s *dev)
@@ -61,9 +61,10 @@
  * Private Data
  ****************************************************************************/
 
-static sem_t        g_netlock;
-static pid_t        g_holder  = NO_HOLDER;
-static unsigned int g_count   = 0;
+static struct net_rmutex_s g_netlock =
+{
+  SEM_INITIALIZER(1), NO_HOLDER, 0
+};
 
 /****************************************************************************
  * Private Functions
@@ -77,9 +78,9 @@ static unsigned int g_count   = 0;
  *
  ****************************************************************************/
 
-static void _net_takesem(void)
+static void _net_takesem(FAR sem_t *sem)
 {
-  while (sem_wait(&g_netlock) != 0)
+  while (sem_wait(sem) != 0)
     {
       /* The only case that an error should occur here is if the wait was
        * awakened by a signal.
@@ -103,72 +104,113 @@ static void _net_takesem(void)
 
 void net_lockinitialize(void)
 {
-  sem_init(&g_netlock, 0, 1);
+  net_rmutex_init(&g_netlock);
 }
 
 /****************************************************************************
- * Function: net_lock
+ * Function: net_rmutex_init
  *
  * Description:
- *   Take the lock
+ *   Initialize a re-entrant mutex
  *
  ****************************************************************************/
 
-void net_lock(void)
+void net_rmutex_init(FAR struct net_rmutex_s *rmutex)
+{
+  sem_init(&rmutex->sem, 0, 1);
+  rmutex->holder = NO_HOLDER;
+  rmutex->count  = 0;
+}
+
+/****************************************************************************
+ * Function: net_rmutex_lock
+ *
+ * Description:
+ *   Take a re-entrant mutex, waiting if it is held by another thread.
+ *
+ ****************************************************************************/
+
+void net_rmutex_lock(FAR struct net_rmutex_s *rmutex)
 {
   pid_t me = getpid();
 
   /* Does this thread already hold the semaphore? */
 
-  if (g_holder == me)
+  if (rmutex->holder == me)
     {
       /* Yes.. just increment the reference count */
 
-      g_count++;
+      rmutex->count++;
     }
   else
     {
       /* No.. take the semaphore (perhaps waiting) */
 
-      _net_takesem();
+      _net_takesem(&rmutex->sem);
 
       /* Now this thread holds the semaphore */
 
-      g_holder = me;
-      g_count  = 1;
+      rmutex->holder = me;
+      rmutex->count  = 1;
     }
 }
 
 /****************************************************************************
- * Function: net_unlock
+ * Function: net_rmutex_unlock
  *
  * Description:
- *   Release the lock.
+ *   Release a re-entrant mutex taken by net_rmutex_lock().
  *
  ****************************************************************************/
 
-void net_unlock(void)
+void net_rmutex_unlock(FAR struct net_rmutex_s *rmutex)
 {
-  DEBUGASSERT(g_holder == getpid() && g_count > 0);
+  DEBUGASSERT(rmutex->holder == getpid() && rmutex->count > 0);
 
   /* If the count would go to zero, then release the semaphore */
 
-  if (g_count == 1)
+  if (rmutex->count == 1)
     {
       /* We no longer hold the semaphore */
 
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      rmutex->holder = NO_HOLDER;
+      rmutex->count  = 0;
+      sem_post(&rmutex->sem);
     }
   else
     {
       /* We still hold the semaphore. Just decrement the count */
 
-      g_count--;
+      rmutex->count--;
     }
 }
 
+/****************************************************************************
+ * Function: net_lock
+ *
+ * Description:
+ *   Take the lock
+ *
+ ****************************************************************************/
+
+void net_lock(void)
+{
+  net_rmutex_lock(&g_netlock);
+}
+
+/****************************************************************************
+ * Function: net_unlock
+ *
+ * Description:
+ *   Release the lock.
+ *
+ ****************************************************************************/
+
+void net_unlock(void)
+{
+  net_rmutex_unlock(&g_netlock);
+}
+
 /****************************************************************************
  * Function: net_timedwait
  *
@@ -196,14 +238,14 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
   flags = enter_critical_section(); /* No interrupts */
   sched_lock();      /* No context switches */
-  if (g_holder == me)
+  if (g_netlock.holder == me)
     {
       /* Release the network lock, remembering my count */
 
-      count    = g_count;
-      g_holder = NO_HOLDER;
-      g_count  = 0;
-      sem_post(&g_netlock);
+      count            = g_netlock.count;
+      g_netlock.holder = NO_HOLDER;
+      g_netlock.count  = 0;
+      sem_post(&g_netlock.sem);
 
       /* Now take the semaphore, waiting if so requested. */
 
@@ -222,9 +264,9 @@ int net_timedwait(sem_t *sem, FAR const struct timespec *abstime)
 
       /* Recover the network lock at the proper count */
 
-      _net_takesem();
-      g_holder = me;
-      g_count  = count;
+      _net_takesem(&g_netlock.sem);
+      g_netlock.holder = me;
+      g_netlock.count  = count;
     }
   else
     {
@@ -525,7 +525,7 @@ void os_start(void)
 #else
       tasklist = TLIST_HEAD(TSTATE_TASK_RUNNING);
 #endif
-      dq_addfirst((FAR dq_entry_t *)&g_idletcb[cpu], tasklist);
+      sched_addfirstprioritized(&g_idletcb[cpu].cmn, tasklist);
 
       /* Initialize the processor-specific portion of the TCB */
 
@@ -42,6 +42,7 @@
 #include <sys/types.h>
 
 #include <nuttx/init.h>
+#include <nuttx/irqlock.h>
 #include <nuttx/spinlock.h>
 #include <nuttx/sched_note.h>
 #include <arch/irq.h>
@@ -283,6 +284,12 @@ try_again:
                    * no longer blocked by the critical section).
                    */
 
+#ifdef CONFIG_SMP_LOCK_DEBUG
+                  /* The critical section is the outermost lock */
+
+                  DEBUGASSERT(irqlock_held(cpu) == 0);
+#endif
+
                   if (!irq_waitlock(cpu))
                     {
                       /* We are in a deadlock condition due to a pending
@@ -340,6 +347,14 @@ try_again:
               cpu = this_cpu();
               DEBUGASSERT((g_cpu_irqset & (1 << cpu)) == 0);
 
+#ifdef CONFIG_SMP_LOCK_DEBUG
+              /* The critical section is the outermost lock:  It may not be
+               * entered while this CPU holds any subsystem lock.
+               */
+
+              DEBUGASSERT(irqlock_held(cpu) == 0);
+#endif
+
               if (!irq_waitlock(cpu))
                 {
                   /* We are in a deadlock condition due to a pending pause
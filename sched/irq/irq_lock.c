@@ -0,0 +1,257 @@
+/****************************************************************************
+ * sched/irq/irq_lock.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+#include <debug.h>
+
+#include <nuttx/arch.h>
+#include <nuttx/irqlock.h>
+
+#include "sched/sched.h"
+#include "irq/irq.h"
+
+#ifdef CONFIG_SMP_FINE_LOCKS
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_LOCK_DEBUG
+/* The levels of the subsystem locks held by each CPU */
+
+static uint32_t g_irqlock_held[CONFIG_SMP_NCPUS];
+#endif
+
+#ifdef CONFIG_SMP_LOCK_STATS
+/* The list of registered locks.  Protected by the critical section. */
+
+static FAR struct irqlock_s *g_irqlock_list;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: irqlock_enter
+ *
+ * Description:
+ *   Disable interrupts on the local CPU and take a subsystem lock.  Unlike
+ *   enter_critical_section(), this serializes only with the other users of
+ *   the same subsystem lock.
+ *
+ * Input Parameters:
+ *   lock - The subsystem lock to take.
+ *
+ * Returned Value:
+ *   The interrupt state that must be passed to irqlock_leave().
+ *
+ ****************************************************************************/
+
+irqstate_t irqlock_enter(FAR struct irqlock_s *lock)
+{
+  irqstate_t flags;
+  int cpu;
+
+  DEBUGASSERT(lock != NULL);
+
+  flags = up_irq_save();
+  cpu   = this_cpu();
+
+  /* Do we already hold the lock on this CPU? */
+
+  if (lock->cpu == cpu)
+    {
+      /* Yes.. just count the nested acquisition */
+
+      DEBUGASSERT(lock->count > 0 && lock->count < UINT16_MAX);
+      lock->count++;
+      return flags;
+    }
+
+#ifdef CONFIG_SMP_LOCK_DEBUG
+  /* Lock ordering validation:  All other subsystem locks held by this CPU
+   * must have a lower level.
+   */
+
+  DEBUGASSERT(lock->level > 0 && lock->level < IRQLOCK_NLEVELS);
+  if ((g_irqlock_held[cpu] >> lock->level) != 0)
+    {
+      _alert("ERROR: CPU%d takes lock level %d while holding %08lx\n",
+             cpu, lock->level, (unsigned long)g_irqlock_held[cpu]);
+      PANIC();
+    }
+#endif
+
+#ifdef CONFIG_SMP_LOCK_STATS
+  if (up_testset(&lock->lock) == SP_LOCKED)
+    {
+      uint32_t nspins = 0;
+
+      do
+        {
+          SP_DSB();
+          nspins++;
+        }
+      while (up_testset(&lock->lock) == SP_LOCKED);
+
+      /* The counters are only updated while holding the lock */
+
+      lock->ncontended++;
+      lock->nspins += nspins;
+    }
+
+  lock->nacquired++;
+#else
+  while (up_testset(&lock->lock) == SP_LOCKED)
+    {
+      SP_DSB();
+    }
+#endif
+
+  SP_DMB();
+
+  lock->cpu   = cpu;
+  lock->count = 1;
+
+#ifdef CONFIG_SMP_LOCK_DEBUG
+  g_irqlock_held[cpu] |= (uint32_t)1 << lock->level;
+#endif
+
+  return flags;
+}
+
+/****************************************************************************
+ * Name: irqlock_leave
+ *
+ * Description:
+ *   Release a subsystem lock taken by irqlock_enter() and restore the
+ *   interrupt state.
+ *
+ * Input Parameters:
+ *   lock  - The subsystem lock to release.
+ *   flags - The value returned by the matching irqlock_enter().
+ *
+ * Returned Value:
+ *   None
+ *
+ ****************************************************************************/
+
+void irqlock_leave(FAR struct irqlock_s *lock, irqstate_t flags)
+{
+  DEBUGASSERT(lock != NULL && lock->cpu == this_cpu() && lock->count > 0);
+
+  if (--lock->count == 0)
+    {
+#ifdef CONFIG_SMP_LOCK_DEBUG
+      g_irqlock_held[lock->cpu] &= ~((uint32_t)1 << lock->level);
+#endif
+      lock->cpu = (uint8_t)-1;
+
+      SP_DMB();
+      lock->lock = SP_UNLOCKED;
+      SP_DSB();
+    }
+
+  up_irq_restore(flags);
+}
+
+/****************************************************************************
+ * Name: irqlock_held
+ *
+ * Description:
+ *   Return a bit set of the levels of the subsystem locks held by a CPU.
+ *   Used for lock ordering validation.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_LOCK_DEBUG
+uint32_t irqlock_held(int cpu)
+{
+  return g_irqlock_held[cpu];
+}
+#endif
+
+/****************************************************************************
+ * Name: irqlock_register
+ *
+ * Description:
+ *   Add a subsystem lock to the list of locks whose contention counters are
+ *   shown at /proc/locks.  Locks are never unregistered.
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_SMP_LOCK_STATS
+void irqlock_register(FAR struct irqlock_s *lock)
+{
+  irqstate_t flags;
+
+  flags          = enter_critical_section();
+  lock->flink    = g_irqlock_list;
+  g_irqlock_list = lock;
+  leave_critical_section(flags);
+}
+
+/****************************************************************************
+ * Name: irqlock_foreach
+ *
+ * Description:
+ *   Call 'handler' for each registered subsystem lock.
+ *
+ ****************************************************************************/
+
+void irqlock_foreach(irqlock_handler_t handler, FAR void *arg)
+{
+  FAR struct irqlock_s *lock;
+
+  /* Locks are only ever added at the head of the list, so the list may be
+   * traversed without holding the critical section.
+   */
+
+  for (lock = g_irqlock_list; lock != NULL; lock = lock->flink)
+    {
+      handler(lock, arg);
+    }
+}
+#endif /* CONFIG_SMP_LOCK_STATS */
+#endif /* CONFIG_SMP_FINE_LOCKS */
@@ -45,6 +45,8 @@
 #include <errno.h>
 #include <debug.h>
 
+#include <nuttx/semaphore.h>
+
 #include "pthread/pthread.h"
 
 /****************************************************************************
@@ -112,6 +114,21 @@ int pthread_mutex_lock(FAR pthread_mutex_t *mutex)
     {
       ret = EINVAL;
     }
+
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an uncontended mutex without locking the scheduler.  Only this
+   * thread can set mutex->pid to its own pid, so that test is stable.
+   */
+
+  else if (mutex->pid != mypid && sem_fastwait((FAR sem_t *)&mutex->sem))
+    {
+      mutex->pid    = mypid;
+#ifdef CONFIG_MUTEX_TYPES
+      mutex->nlocks = 1;
+#endif
+    }
+#endif
+
   else
     {
       /* Make sure the semaphore is stable while we make the following
@@ -102,6 +102,14 @@
 #  define TLIST_BLOCKED(s)       __TLIST_HEAD(s)
 #endif
 
+/* The number of 32-bit words in the priority bitmap of a ready-to-run list
+ * index.
+ */
+
+#ifdef CONFIG_SCHED_READYMAP
+#  define READYMAP_NWORDS        ((SCHED_PRIORITY_MAX + 32) >> 5)
+#endif
+
 /****************************************************************************
  * Public Type Definitions
  ****************************************************************************/
@@ -136,6 +144,20 @@ struct tasklist_s
   uint8_t attr;                   /* List attribute flags */
 };
 
+#ifdef CONFIG_SCHED_READYMAP
+/* This structure indexes a prioritized ready-to-run list.  The list is the
+ * concatenation of one FIFO of TCBs for each priority present in the list.
+ * A bit is set in 'bitmap' for each such priority and 'tail' points to the
+ * last TCB of the FIFO for that priority.
+ */
+
+struct readymap_s
+{
+  uint32_t bitmap[READYMAP_NWORDS];               /* Priorities present */
+  FAR struct tcb_s *tail[SCHED_PRIORITY_MAX + 1]; /* Last TCB at priority */
+};
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -376,6 +398,20 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 bool sched_mergepending(void);
 void sched_addblocked(FAR struct tcb_s *btcb, tstate_t task_state);
 void sched_removeblocked(FAR struct tcb_s *btcb);
+
+#ifdef CONFIG_SCHED_READYMAP
+FAR struct readymap_s *sched_readymap(FAR dq_queue_t *list);
+bool sched_readymap_add(FAR struct readymap_s *map, FAR struct tcb_s *tcb,
+                        FAR dq_queue_t *list);
+void sched_readymap_reset(FAR struct readymap_s *map);
+void sched_removeprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+void sched_addfirstprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list);
+#else
+#  define sched_removeprioritized(tcb,list) \
+     dq_rem((FAR dq_entry_t *)(tcb), (list))
+#  define sched_addfirstprioritized(tcb,list) \
+     dq_addfirst((FAR dq_entry_t *)(tcb), (list))
+#endif
 int  sched_setpriority(FAR struct tcb_s *tcb, int sched_priority);
 
 /* Priority inheritance support */
@@ -421,6 +457,13 @@ void sched_sporadic_lowpriority(FAR struct tcb_s *tcb);
 #ifdef CONFIG_SMP
 int  sched_cpu_select(cpu_set_t affinity);
 int  sched_cpu_pause(FAR struct tcb_s *tcb);
+#ifdef CONFIG_SMP_CPUQUEUES
+int  sched_cpu_queue(FAR struct tcb_s *tcb);
+FAR struct tcb_s *sched_cpu_steal(int cpu, uint8_t minprio);
+#if defined(CONFIG_SMP_BALANCE_INTERVAL) && CONFIG_SMP_BALANCE_INTERVAL > 0
+void sched_cpu_balance(void);
+#endif
+#endif
 #  define sched_islocked(tcb) spin_islocked(&g_cpu_schedlock)
 #else
 #  define sched_cpu_select(a) (0)
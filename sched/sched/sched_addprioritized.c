@@ -80,6 +80,9 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 {
   FAR struct tcb_s *next;
   FAR struct tcb_s *prev;
+#ifdef CONFIG_SCHED_READYMAP
+  FAR struct readymap_s *map;
+#endif
   uint8_t sched_priority = tcb->sched_priority;
   bool ret = false;
 
@@ -87,6 +90,18 @@ bool sched_addprioritized(FAR struct tcb_s *tcb, DSEG dq_queue_t *list)
 
   ASSERT(sched_priority >= SCHED_PRIORITY_MIN);
 
+#ifdef CONFIG_SCHED_READYMAP
+  /* The ready-to-run lists are indexed so that the location to insert the
+   * new TCB can be found without searching the list.
+   */
+
+  map = sched_readymap(list);
+  if (map != NULL)
+    {
+      return sched_readymap_add(map, tcb, list);
+    }
+#endif
+
   /* Search the list to find the location to insert the new Tcb.
    * Each is list is maintained in ascending sched_priority order.
    */
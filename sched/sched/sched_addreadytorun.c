@@ -169,6 +169,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   FAR dq_queue_t *tasklist;
   bool switched;
   bool doswitch;
+  bool paused;
   int task_state;
   int cpu;
   int me;
@@ -214,6 +215,15 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
       cpu = btcb->cpu;
     }
 
+#ifdef CONFIG_SMP_CPUQUEUES
+  /* Otherwise, it will wait in the run queue of some CPU */
+
+  else
+    {
+      task_state = TSTATE_TASK_ASSIGNED;
+      cpu = sched_cpu_queue(btcb);
+    }
+#else
   /* Otherwise, it will be ready-to-run, but not not yet running */
 
   else
@@ -221,6 +231,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
       task_state = TSTATE_TASK_READYTORUN;
       cpu = 0;  /* CPU does not matter */
     }
+#endif
 
   /* If the selected state is TSTATE_TASK_RUNNING, then we would like to
    * start running the task.  Be we cannot do that if pre-emption is
@@ -237,7 +248,8 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
   me = this_cpu();
   if ((spin_islocked(&g_cpu_schedlock) || irq_cpu_locked(me)) &&
-      task_state != TSTATE_TASK_ASSIGNED)
+      (task_state != TSTATE_TASK_ASSIGNED ||
+       (btcb->flags & TCB_FLAG_CPU_LOCKED) == 0))
     {
       /* Add the new ready-to-run task to the g_pendingtasks task list for
        * now.
@@ -265,12 +277,19 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
   else /* (task_state == TSTATE_TASK_ASSIGNED || task_state == TSTATE_TASK_RUNNING) */
     {
       /* If we are modifying some assigned task list other than our own, we
-       * will need to stop that CPU.
+       * will need to stop that CPU.  That is not necessary if the task
+       * just waits in the run queue of that CPU.
        */
 
-      if (cpu != me)
+      paused = false;
+      if (cpu != me
+#ifdef CONFIG_SMP_CPUQUEUES
+          && task_state == TSTATE_TASK_RUNNING
+#endif
+         )
         {
           DEBUGVERIFY(up_cpu_pause(cpu));
+          paused = true;
         }
 
       /* Add the task to the list corresponding to the selected state
@@ -367,6 +386,14 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
           DEBUGASSERT(btcb->flink != NULL);
           next = (FAR struct tcb_s *)btcb->flink;
 
+#ifdef CONFIG_SMP_CPUQUEUES
+          /* With per-CPU run queues, the preempted task just waits in the
+           * run queue of this CPU where its cache is still warm.
+           */
+
+          DEBUGASSERT(next->cpu == cpu);
+          next->task_state = TSTATE_TASK_ASSIGNED;
+#else
           if ((next->flags & TCB_FLAG_CPU_LOCKED) != 0)
             {
               DEBUGASSERT(next->cpu == cpu);
@@ -376,7 +403,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
             {
               /* Remove the task from the assigned task list */
 
-              dq_rem((FAR dq_entry_t *)next, tasklist);
+              sched_removeprioritized(next, tasklist);
 
               /* Add the task to the g_readytorun or to the g_pendingtasks
                * list.  NOTE: That the above operations may cause the
@@ -397,6 +424,7 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
               (void)sched_addprioritized(next, tasklist);
             }
+#endif
 
           doswitch = true;
         }
@@ -421,7 +449,11 @@ bool sched_addreadytorun(FAR struct tcb_s *btcb)
 
       if (cpu != me)
         {
-          DEBUGVERIFY(up_cpu_resume(cpu));
+          if (paused)
+            {
+              DEBUGVERIFY(up_cpu_resume(cpu));
+            }
+
           doswitch = false;
         }
     }
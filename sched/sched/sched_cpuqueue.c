@@ -0,0 +1,266 @@
+/****************************************************************************
+ * sched/sched/sched_cpuqueue.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <assert.h>
+
+#include <nuttx/irq.h>
+#include <nuttx/arch.h>
+#include <nuttx/sched.h>
+#include <nuttx/spinlock.h>
+
+#include "irq/irq.h"
+#include "sched/sched.h"
+
+#if defined(CONFIG_SMP) && defined(CONFIG_SMP_CPUQUEUES)
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+#if CONFIG_SMP_BALANCE_INTERVAL > 0
+/* The number of ticks since the run queues were last balanced */
+
+static unsigned int g_balance_ticks;
+#endif
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name:  sched_cpu_queue
+ *
+ * Description:
+ *   Select the CPU on whose run queue a ready-to-run task should wait.  The
+ *   task will not preempt any running task and is not locked to a CPU.
+ *
+ *   The best CPU is the one on which the task will be the next to run, i.e.
+ *   where the task would be ahead of all other waiting tasks.  Among such
+ *   CPUs, the CPU that the task last ran on is preferred since its cache
+ *   may still hold the task's working set.  Otherwise, the CPU with the
+ *   lowest priority waiting task is selected.
+ *
+ * Inputs:
+ *   tcb - The TCB of the task to be queued.
+ *
+ * Return Value:
+ *   Index of the selected CPU
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+int sched_cpu_queue(FAR struct tcb_s *tcb)
+{
+  FAR struct tcb_s *next;
+  uint8_t minprio = UINT8_MAX;
+  uint8_t prio;
+  int cpu = -1;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      /* Is the task permitted to run on this CPU? */
+
+      if ((tcb->affinity & (1 << i)) != 0)
+        {
+          /* Get the priority of the first task waiting behind the running
+           * task (perhaps the IDLE task).  All priorities lower than the
+           * priority of the new task are equally good.
+           */
+
+          next = (FAR struct tcb_s *)g_assignedtasks[i].head->flink;
+          prio = next != NULL ? next->sched_priority : 0;
+
+          if (prio < tcb->sched_priority)
+            {
+              prio = 0;
+            }
+
+          if (cpu < 0 || prio < minprio ||
+              (prio == minprio && i == tcb->cpu))
+            {
+              minprio = prio;
+              cpu     = i;
+            }
+        }
+    }
+
+  DEBUGASSERT(cpu >= 0);
+  return cpu;
+}
+
+/****************************************************************************
+ * Name:  sched_cpu_steal
+ *
+ * Description:
+ *   Find the highest priority task waiting in the run queue of some other
+ *   CPU that may run on 'cpu'.  Only tasks with a priority strictly
+ *   greater than 'minprio' are considered so that a CPU prefers the tasks
+ *   in its own run queue when the priorities are the same.
+ *
+ * Inputs:
+ *   cpu     - The CPU that will run the task.
+ *   minprio - The priority that the task must exceed.
+ *
+ * Return Value:
+ *   The TCB of the task to be migrated to 'cpu' or NULL if there is no
+ *   such task.  The task is not removed from its run queue.
+ *
+ * Assumptions:
+ *   Called from within a critical section.
+ *
+ ****************************************************************************/
+
+FAR struct tcb_s *sched_cpu_steal(int cpu, uint8_t minprio)
+{
+  FAR struct tcb_s *stolen = NULL;
+  FAR struct tcb_s *tcb;
+  int i;
+
+  for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+    {
+      if (i == cpu)
+        {
+          continue;
+        }
+
+      /* Each run queue is in priority order and the running task is at the
+       * head.  The first eligible waiting task is the best in this queue.
+       */
+
+      for (tcb  = (FAR struct tcb_s *)g_assignedtasks[i].head->flink;
+           tcb != NULL && tcb->sched_priority > minprio;
+           tcb  = tcb->flink)
+        {
+          if ((tcb->flags & TCB_FLAG_CPU_LOCKED) == 0 &&
+              (tcb->affinity & (1 << cpu)) != 0)
+            {
+              stolen  = tcb;
+              minprio = tcb->sched_priority;
+              break;
+            }
+        }
+    }
+
+  return stolen;
+}
+
+/****************************************************************************
+ * Name:  sched_cpu_balance
+ *
+ * Description:
+ *   Called periodically from the timer interrupt.  Migrate the highest
+ *   priority waiting tasks to the CPUs that are running their IDLE task.
+ *   The migration is done with up_reprioritize_rtr() which removes the
+ *   task from its run queue and lets sched_addreadytorun() start it on
+ *   the idle CPU.  The CPU that owns the run queue is paused meanwhile so
+ *   that it cannot select its next task from that queue concurrently.
+ *
+ * Inputs:
+ *   None
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+#if CONFIG_SMP_BALANCE_INTERVAL > 0
+void sched_cpu_balance(void)
+{
+  FAR struct tcb_s *tcb;
+  irqstate_t flags;
+  int cpu;
+  int me;
+  int i;
+
+  if (++g_balance_ticks < CONFIG_SMP_BALANCE_INTERVAL)
+    {
+      return;
+    }
+
+  g_balance_ticks = 0;
+
+  flags = enter_critical_section();
+
+  /* Tasks cannot be migrated while pre-emption is disabled */
+
+  me = this_cpu();
+  if (!spin_islocked(&g_cpu_schedlock) && !irq_cpu_locked(me))
+    {
+      for (i = 0; i < CONFIG_SMP_NCPUS; i++)
+        {
+          /* Is this CPU running its IDLE task?  The IDLE task is always
+           * the last task in the assigned task list.
+           */
+
+          if (g_assignedtasks[i].head->flink == NULL)
+            {
+              tcb = sched_cpu_steal(i, 0);
+              if (tcb != NULL)
+                {
+                  /* Pause the CPU whose run queue holds the task */
+
+                  cpu = tcb->cpu;
+                  if (cpu != me)
+                    {
+                      DEBUGVERIFY(up_cpu_pause(cpu));
+                    }
+
+                  up_reprioritize_rtr(tcb, tcb->sched_priority);
+
+                  if (cpu != me)
+                    {
+                      DEBUGVERIFY(up_cpu_resume(cpu));
+                    }
+                }
+            }
+        }
+    }
+
+  leave_critical_section(flags);
+}
+#endif
+
+#endif /* CONFIG_SMP && CONFIG_SMP_CPUQUEUES */
@@ -110,9 +110,10 @@ int sched_cpu_select(cpu_set_t affinity)
               DEBUGASSERT(rtcb->sched_priority == 0);
               return i;
             }
-          else if (rtcb->sched_priority < minprio)
+          else if (cpu == IMPOSSIBLE_CPU || rtcb->sched_priority < minprio)
             {
               DEBUGASSERT(rtcb->sched_priority > 0);
+              minprio = rtcb->sched_priority;
               cpu = i;
             }
         }
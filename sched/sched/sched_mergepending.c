@@ -84,7 +84,41 @@
  *
  ****************************************************************************/
 
-#ifndef CONFIG_SMP
+#if !defined(CONFIG_SMP) && defined(CONFIG_SCHED_READYMAP)
+bool sched_mergepending(void)
+{
+  FAR struct tcb_s *ptcb;
+  FAR struct tcb_s *rtcb;
+
+  /* Remember the task at the head of the ready-to-run list */
+
+  rtcb = this_task();
+
+  /* Move every TCB in the g_pendingtasks list to the ready-to-run list.
+   * The ready-to-run list is indexed so each TCB is added in constant time.
+   */
+
+  while ((ptcb = (FAR struct tcb_s *)
+          dq_remfirst((FAR dq_queue_t *)&g_pendingtasks)) != NULL)
+    {
+      ptcb->task_state = TSTATE_TASK_READYTORUN;
+      (void)sched_addprioritized(ptcb, (FAR dq_queue_t *)&g_readytorun);
+    }
+
+  /* Check if the head of the ready-to-run list has changed */
+
+  ptcb = this_task();
+  if (ptcb != rtcb)
+    {
+      rtcb->task_state = TSTATE_TASK_READYTORUN;
+      ptcb->task_state = TSTATE_TASK_RUNNING;
+      return true;
+    }
+
+  return false;
+}
+
+#elif !defined(CONFIG_SMP)
 bool sched_mergepending(void)
 {
   FAR struct tcb_s *ptcb;
@@ -277,6 +311,26 @@ bool sched_mergepending(void)
           rtcb = current_task(cpu);
         }
 
+#ifdef CONFIG_SMP_CPUQUEUES
+      /* No more pending tasks can be made running.  Move any remaining
+       * tasks in the pending task list to the run queues of the CPUs.
+       */
+
+      while ((tcb = (FAR struct tcb_s *)
+              dq_remfirst((FAR dq_queue_t *)&g_pendingtasks)) != NULL)
+        {
+          ret |= sched_addreadytorun(tcb);
+
+          /* Stop if that caused the scheduler to become locked.  The
+           * remaining tasks then stay in the pending task list.
+           */
+
+          if (spin_islocked(&g_cpu_schedlock) || irq_cpu_locked(me))
+            {
+              break;
+            }
+        }
+#else
       /* No more pending tasks can be made running.  Move any remaining
        * tasks in the pending task list to the ready-to-run task list.
        */
@@ -284,6 +338,7 @@ bool sched_mergepending(void)
       sched_mergeprioritized((FAR dq_queue_t *)&g_pendingtasks,
                              (FAR dq_queue_t *)&g_readytorun,
                              TSTATE_TASK_READYTORUN);
+#endif
     }
 
   return ret;
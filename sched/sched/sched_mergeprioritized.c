@@ -82,6 +82,9 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
   FAR struct tcb_s *tcb1;
   FAR struct tcb_s *tcb2;
   FAR struct tcb_s *tmp;
+#ifdef CONFIG_SCHED_READYMAP
+  FAR struct readymap_s *map;
+#endif
 
   DEBUGASSERT(list1 != NULL && list2 != NULL);
 
@@ -92,6 +95,18 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
 
   dq_move(list1, &clone);
 
+#ifdef CONFIG_SCHED_READYMAP
+  /* If list1 is indexed, then its index must be reset now that it is
+   * empty.
+   */
+
+  map = sched_readymap(list1);
+  if (map != NULL)
+    {
+      sched_readymap_reset(map);
+    }
+#endif
+
   /* Get the TCB at the head of list1 */
 
   tcb1 = (FAR struct tcb_s *)dq_peek(&clone);
@@ -114,6 +129,23 @@ void sched_mergeprioritized(FAR dq_queue_t *list1, FAR dq_queue_t *list2,
       tmp->task_state = task_state;
     }
 
+#ifdef CONFIG_SCHED_READYMAP
+  /* If list2 is indexed, then each TCB can be added to it in constant time
+   * using the index.  The result is the same as the merge below.
+   */
+
+  map = sched_readymap(list2);
+  if (map != NULL)
+    {
+      while ((tmp = (FAR struct tcb_s *)dq_remfirst(&clone)) != NULL)
+        {
+          (void)sched_readymap_add(map, tmp, list2);
+        }
+
+      return;
+    }
+#endif
+
   /* Get the head of list2 */
 
   tcb2 = (FAR struct tcb_s *)dq_peek(list2);
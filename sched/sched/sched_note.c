@@ -582,6 +582,33 @@ void sched_note_spinabort(FAR struct tcb_s *tcb, FAR volatile void *spinlock)
 }
 #endif
 
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+void sched_note_spinstats(FAR struct tcb_s *tcb, FAR volatile void *spinlock,
+                          uint32_t nspins, uint32_t holdtime)
+{
+  struct note_spinstats_s note;
+
+  /* Format the note */
+
+  note_common(tcb, &note.nss_cmn, sizeof(struct note_spinstats_s),
+              NOTE_SPINLOCK_STATS);
+
+  note.nss_spinlock    = (FAR void *)spinlock;
+  note.nss_spins[0]    = (uint8_t)( nspins          & 0xff);
+  note.nss_spins[1]    = (uint8_t)((nspins >> 8)    & 0xff);
+  note.nss_spins[2]    = (uint8_t)((nspins >> 16)   & 0xff);
+  note.nss_spins[3]    = (uint8_t)((nspins >> 24)   & 0xff);
+  note.nss_holdtime[0] = (uint8_t)( holdtime        & 0xff);
+  note.nss_holdtime[1] = (uint8_t)((holdtime >> 8)  & 0xff);
+  note.nss_holdtime[2] = (uint8_t)((holdtime >> 16) & 0xff);
+  note.nss_holdtime[3] = (uint8_t)((holdtime >> 24) & 0xff);
+
+  /* Add the note to circular buffer */
+
+  note_add((FAR const uint8_t *)&note, sizeof(struct note_spinstats_s));
+}
+#endif
+
 /****************************************************************************
  * Name: sched_note_get
  *
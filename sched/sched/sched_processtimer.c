@@ -222,4 +222,10 @@ void sched_process_timer(void)
    */
 
   sched_process_scheduler();
+
+#if defined(CONFIG_SMP_CPUQUEUES) && CONFIG_SMP_BALANCE_INTERVAL > 0
+  /* Periodically migrate waiting tasks to idle CPUs */
+
+  sched_cpu_balance();
+#endif
 }
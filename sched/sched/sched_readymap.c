@@ -0,0 +1,274 @@
+/****************************************************************************
+ * sched/sched/sched_readymap.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <string.h>
+#include <queue.h>
+#include <assert.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SCHED_READYMAP
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+#define READYMAP_WORD(p)   ((p) >> 5)
+#define READYMAP_BIT(p)    ((uint32_t)1 << ((p) & 31))
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The index of the g_readytorun list */
+
+static struct readymap_s g_readymap;
+
+#ifdef CONFIG_SMP
+/* The indices of the g_assignedtasks[] lists */
+
+static struct readymap_s g_assignedmap[CONFIG_SMP_NCPUS];
+#endif
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_readymap_next
+ *
+ * Description:
+ *   Return the lowest priority that is present in the list and that is
+ *   greater than or equal to 'prio' (or -1 if there is no such priority).
+ *   The new TCB at priority 'prio' belongs just after the last TCB with
+ *   that priority.
+ *
+ ****************************************************************************/
+
+static int sched_readymap_next(FAR struct readymap_s *map, int prio)
+{
+  int ndx = READYMAP_WORD(prio);
+  uint32_t bits;
+
+  bits = map->bitmap[ndx] & ((uint32_t)-1 << (prio & 31));
+  while (bits == 0)
+    {
+      if (++ndx >= READYMAP_NWORDS)
+        {
+          return -1;
+        }
+
+      bits = map->bitmap[ndx];
+    }
+
+  return (ndx << 5) + ffs((int)bits) - 1;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: sched_readymap
+ *
+ * Description:
+ *   Return the index of a task list or NULL if the list is not indexed.
+ *   Only the ready-to-run lists are indexed.
+ *
+ ****************************************************************************/
+
+FAR struct readymap_s *sched_readymap(FAR dq_queue_t *list)
+{
+  if (list == (FAR dq_queue_t *)&g_readytorun)
+    {
+      return &g_readymap;
+    }
+
+#ifdef CONFIG_SMP
+  if (list >= (FAR dq_queue_t *)&g_assignedtasks[0] &&
+      list <  (FAR dq_queue_t *)&g_assignedtasks[CONFIG_SMP_NCPUS])
+    {
+      return &g_assignedmap[list - (FAR dq_queue_t *)&g_assignedtasks[0]];
+    }
+#endif
+
+  return NULL;
+}
+
+/****************************************************************************
+ * Name: sched_readymap_add
+ *
+ * Description:
+ *   Add a TCB to an indexed, prioritized list in constant time.  The TCB is
+ *   added after all TCBs of the same or higher priority.
+ *
+ * Return Value:
+ *   true if the head of the list has changed.
+ *
+ * Assumptions:
+ *   Same as for sched_addprioritized().
+ *
+ ****************************************************************************/
+
+bool sched_readymap_add(FAR struct readymap_s *map, FAR struct tcb_s *tcb,
+                        FAR dq_queue_t *list)
+{
+  int prio = tcb->sched_priority;
+  int next;
+
+  next = sched_readymap_next(map, prio);
+  if (next < 0)
+    {
+      /* There are no TCBs of the same or higher priority */
+
+      dq_addfirst((FAR dq_entry_t *)tcb, list);
+    }
+  else
+    {
+      dq_addafter((FAR dq_entry_t *)map->tail[next],
+                  (FAR dq_entry_t *)tcb, list);
+    }
+
+  /* The new TCB is now the last TCB at its priority */
+
+  map->tail[prio] = tcb;
+  map->bitmap[READYMAP_WORD(prio)] |= READYMAP_BIT(prio);
+
+  return next < 0;
+}
+
+/****************************************************************************
+ * Name: sched_readymap_reset
+ *
+ * Description:
+ *   Reset the index of a list that has been emptied.
+ *
+ ****************************************************************************/
+
+void sched_readymap_reset(FAR struct readymap_s *map)
+{
+  memset(map->bitmap, 0, sizeof(map->bitmap));
+}
+
+/****************************************************************************
+ * Name: sched_removeprioritized
+ *
+ * Description:
+ *   Remove a TCB from a task list, maintaining the index of the list if the
+ *   list is indexed.  The list need not be prioritized.
+ *
+ * Assumptions:
+ * - The caller has established a critical section.
+ * - The priority of the TCB has not changed since it was added to the
+ *   list.
+ *
+ ****************************************************************************/
+
+void sched_removeprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  FAR struct readymap_s *map = sched_readymap(list);
+
+  if (map != NULL)
+    {
+      int prio = tcb->sched_priority;
+
+      DEBUGASSERT((map->bitmap[READYMAP_WORD(prio)] &
+                   READYMAP_BIT(prio)) != 0);
+
+      /* If this is the last TCB at its priority, then the previous TCB
+       * becomes the last TCB at the priority... if there is one.
+       */
+
+      if (map->tail[prio] == tcb)
+        {
+          FAR struct tcb_s *prev = tcb->blink;
+
+          if (prev != NULL && prev->sched_priority == prio)
+            {
+              map->tail[prio] = prev;
+            }
+          else
+            {
+              map->bitmap[READYMAP_WORD(prio)] &= ~READYMAP_BIT(prio);
+            }
+        }
+    }
+
+  dq_rem((FAR dq_entry_t *)tcb, list);
+}
+
+/****************************************************************************
+ * Name: sched_addfirstprioritized
+ *
+ * Description:
+ *   Add a TCB to the head of a prioritized task list, ahead of any TCBs of
+ *   the same priority.  The TCB must have the highest priority in the list.
+ *
+ * Assumptions:
+ *   The caller has established a critical section.
+ *
+ ****************************************************************************/
+
+void sched_addfirstprioritized(FAR struct tcb_s *tcb, FAR dq_queue_t *list)
+{
+  FAR struct readymap_s *map = sched_readymap(list);
+
+  if (map != NULL)
+    {
+      int prio = tcb->sched_priority;
+
+      DEBUGASSERT(prio >= SCHED_PRIORITY_MAX ||
+                  sched_readymap_next(map, prio + 1) < 0);
+
+      if ((map->bitmap[READYMAP_WORD(prio)] & READYMAP_BIT(prio)) == 0)
+        {
+          map->tail[prio] = tcb;
+          map->bitmap[READYMAP_WORD(prio)] |= READYMAP_BIT(prio);
+        }
+    }
+
+  dq_addfirst((FAR dq_entry_t *)tcb, list);
+}
+
+#endif /* CONFIG_SCHED_READYMAP */
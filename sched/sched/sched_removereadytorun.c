@@ -100,7 +100,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
    * is always the g_readytorun list.
    */
 
-  dq_rem((FAR dq_entry_t *)rtcb, (FAR dq_queue_t *)&g_readytorun);
+  sched_removeprioritized(rtcb, (FAR dq_queue_t *)&g_readytorun);
 
   /* Since the TCB is not in any list, it is now invalid */
 
@@ -166,6 +166,10 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
     {
       FAR struct tcb_s *nxttcb;
       FAR struct tcb_s *rtrtcb = NULL;
+#ifdef CONFIG_SMP_CPUQUEUES
+      FAR struct tcb_s *stltcb = NULL;
+      uint8_t minprio;
+#endif
       int me;
 
       /* There must always be at least one task in the list (the IDLE task)
@@ -191,7 +195,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * or the g_assignedtasks[cpu] list.
        */
 
-      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+      sched_removeprioritized(rtcb, tasklist);
 
       /* Which task will go at the head of the list?  It will be either the
        * next tcb in the assigned task list (nxttcb) or a TCB in the
@@ -212,7 +216,49 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
           for (rtrtcb = (FAR struct tcb_s *)g_readytorun.head;
                rtrtcb != NULL && !CPU_ISSET(cpu, &rtrtcb->affinity);
                rtrtcb = (FAR struct tcb_s *)rtrtcb->flink);
+
+#ifdef CONFIG_SMP_CPUQUEUES
+          /* Steal a task from the run queue of another CPU if it has a
+           * higher priority than either candidate.
+           */
+
+          minprio = nxttcb->sched_priority;
+          if (rtrtcb != NULL && rtrtcb->sched_priority > minprio)
+            {
+              minprio = rtrtcb->sched_priority;
+            }
+
+          stltcb = sched_cpu_steal(cpu, minprio);
+          if (stltcb != NULL)
+            {
+              rtrtcb = NULL;
+            }
+#endif
         }
+#ifdef CONFIG_SMP_CPUQUEUES
+      else
+        {
+          /* Pre-emption is disabled.  Tasks in the run queue that are not
+           * locked to this CPU must not be started now.  Move them to the
+           * g_pendingtasks list where they will wait until pre-emption is
+           * re-enabled.  This leaves a task locked to this CPU (probably
+           * the IDLE task) at the head of the run queue.
+           */
+
+          while ((nxttcb->flags & TCB_FLAG_CPU_LOCKED) == 0)
+            {
+              FAR struct tcb_s *tmptcb = nxttcb;
+
+              nxttcb = (FAR struct tcb_s *)nxttcb->flink;
+              DEBUGASSERT(nxttcb != NULL);
+
+              sched_removeprioritized(tmptcb, tasklist);
+              tmptcb->task_state = TSTATE_TASK_PENDING;
+              (void)sched_addprioritized(tmptcb,
+                                         (FAR dq_queue_t *)&g_pendingtasks);
+            }
+        }
+#endif
 
       /* Did we find a task in the g_readytorun list?  Which task should
        * we use?  We decide strictly by the priority of the two tasks:
@@ -230,17 +276,34 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
            * list and add to the head of the g_assignedtasks[cpu] list.
            */
 
-          tmptcb = (FAR struct tcb_s *)
-            dq_remfirst((FAR dq_queue_t *)&g_readytorun);
-
+          tmptcb = (FAR struct tcb_s *)g_readytorun.head;
           DEBUGASSERT(tmptcb == rtrtcb);
 
-          dq_addfirst((FAR dq_entry_t *)tmptcb, tasklist);
+          sched_removeprioritized(tmptcb, (FAR dq_queue_t *)&g_readytorun);
+          sched_addfirstprioritized(tmptcb, tasklist);
 
           tmptcb->cpu = cpu;
           nxttcb = tmptcb;
         }
 
+#ifdef CONFIG_SMP_CPUQUEUES
+      /* Or did we find a higher priority task in the run queue of another
+       * CPU?  Remove it from that run queue and add it to the head of this
+       * one.  It is not running so the other CPU need not be paused.
+       */
+
+      if (stltcb != NULL)
+        {
+          sched_removeprioritized(stltcb,
+                                  TLIST_HEAD(stltcb->task_state,
+                                             stltcb->cpu));
+          sched_addfirstprioritized(stltcb, tasklist);
+
+          stltcb->cpu = cpu;
+          nxttcb = stltcb;
+        }
+#endif
+
       /* Will pre-emption be disabled after the switch?  If the lockcount is
        * greater than zero, then this task/this CPU holds the scheduler lock.
        */
@@ -324,7 +387,7 @@ bool sched_removereadytorun(FAR struct tcb_s *rtcb)
        * g_assignedtasks[cpu] list.
        */
 
-      dq_rem((FAR dq_entry_t *)rtcb, tasklist);
+      sched_removeprioritized(rtcb, tasklist);
     }
 
   /* Since the TCB is no longer in any list, it is now invalid */
@@ -164,9 +164,27 @@ static inline void sched_running_setpriority(FAR struct tcb_s *tcb,
 
   else
     {
+#ifdef CONFIG_SCHED_READYMAP
+      /* The index of the ready-to-run list must follow the change in
+       * priority.  The task remains at the head of its list.
+       */
+
+      FAR dq_queue_t *tasklist;
+
+#ifdef CONFIG_SMP
+      tasklist = TLIST_HEAD(tcb->task_state, tcb->cpu);
+#else
+      tasklist = TLIST_HEAD(tcb->task_state);
+#endif
+
+      sched_removeprioritized(tcb, tasklist);
+      tcb->sched_priority = (uint8_t)sched_priority;
+      (void)sched_addprioritized(tcb, tasklist);
+#else
       /* Change the task priority */
 
       tcb->sched_priority = (uint8_t)sched_priority;
+#endif
     }
 }
 
@@ -289,7 +307,7 @@ static inline void sched_blocked_setpriority(FAR struct tcb_s *tcb,
     {
       /* Remove the TCB from the prioritized task list */
 
-      dq_rem((FAR dq_entry_t *)tcb, tasklist);
+      sched_removeprioritized(tcb, tasklist);
 
       /* Change the task priority */
 
@@ -0,0 +1,247 @@
+/****************************************************************************
+ * sched/semaphore/mcslock.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/sched_note.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SPINLOCK_FAIR
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mcs_locked
+ *
+ * Description:
+ *   Common logic once an MCS lock has been taken.
+ *
+ ****************************************************************************/
+
+static inline void mcs_locked(FAR struct mcslock_s *lock, uint32_t nspins)
+{
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  lock->ml_spins = nspins;
+  lock->ml_start = SP_TIMESTAMP();
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), &lock->ml_tail);
+#endif
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: mcs_lock
+ *
+ * Description:
+ *   Join the queue of CPUs waiting for an MCS lock and wait to reach the
+ *   head of the queue.
+ *
+ *   Like spin_lock(), this does not disable interrupts.  The caller must do
+ *   that if the lock is also taken by interrupt handlers.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of this CPU.  It is usually on the caller's stack
+ *          and must remain valid until the matching mcs_unlock().
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void mcs_lock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *prev;
+  uint32_t nspins = 0;
+
+  DEBUGASSERT(lock != NULL && node != NULL);
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are waiting for a spinlock */
+
+  sched_note_spinlock(this_task(), &lock->ml_tail);
+#endif
+
+  node->mn_next   = NULL;
+  node->mn_locked = true;
+
+  /* Append our node to the queue */
+
+  prev = __atomic_exchange_n(&lock->ml_tail, node, __ATOMIC_ACQ_REL);
+  if (prev != NULL)
+    {
+      /* The lock is held.  Link behind the previous waiter and spin on our
+       * own node until it hands the lock over.
+       */
+
+      __atomic_store_n(&prev->mn_next, node, __ATOMIC_RELEASE);
+
+      while (__atomic_load_n(&node->mn_locked, __ATOMIC_ACQUIRE))
+        {
+          SP_DSB();
+          nspins++;
+        }
+    }
+
+  mcs_locked(lock, nspins);
+}
+
+/****************************************************************************
+ * Name: mcs_trylock
+ *
+ * Description:
+ *   Take the MCS lock only if no other CPU holds it or waits for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to lock.
+ *   node - The queue node of this CPU, as for mcs_lock().
+ *
+ * Returned Value:
+ *   True if the lock was taken; false if not.
+ *
+ ****************************************************************************/
+
+bool mcs_trylock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *tail = NULL;
+
+  DEBUGASSERT(lock != NULL && node != NULL);
+
+  node->mn_next   = NULL;
+  node->mn_locked = false;
+
+  if (!__atomic_compare_exchange_n(&lock->ml_tail, &tail, node, false,
+                                   __ATOMIC_ACQ_REL, __ATOMIC_RELAXED))
+    {
+      return false;
+    }
+
+  mcs_locked(lock, 0);
+  return true;
+}
+
+/****************************************************************************
+ * Name: mcs_unlock
+ *
+ * Description:
+ *   Release an MCS lock, passing it to the next CPU in the queue, if any.
+ *
+ * Input Parameters:
+ *   lock - A reference to the MCS lock object to unlock.
+ *   node - The same queue node that was passed to mcs_lock().
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void mcs_unlock(FAR struct mcslock_s *lock, FAR struct mcs_node_s *node)
+{
+  FAR struct mcs_node_s *next;
+
+  DEBUGASSERT(lock != NULL && node != NULL && mcs_islocked(lock));
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  /* Report the spins and the hold time of this acquisition */
+
+  sched_note_spinstats(this_task(), &lock->ml_tail, lock->ml_spins,
+                       SP_TIMESTAMP() - lock->ml_start);
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are unlocking the spinlock */
+
+  sched_note_spinunlock(this_task(), &lock->ml_tail);
+#endif
+
+  SP_DMB();
+
+  next = __atomic_load_n(&node->mn_next, __ATOMIC_ACQUIRE);
+  if (next == NULL)
+    {
+      FAR struct mcs_node_s *tail = node;
+
+      /* There is no known waiter.  If we are still the tail of the queue,
+       * then the lock becomes free.
+       */
+
+      if (__atomic_compare_exchange_n(&lock->ml_tail, &tail, NULL, false,
+                                      __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+        {
+          SP_DSB();
+          return;
+        }
+
+      /* Another CPU has joined the queue but has not linked its node
+       * behind ours yet.  Wait for it.
+       */
+
+      while ((next = __atomic_load_n(&node->mn_next, __ATOMIC_ACQUIRE))
+             == NULL)
+        {
+          SP_DSB();
+        }
+    }
+
+  /* Hand the lock over to the next waiter */
+
+  __atomic_store_n(&next->mn_locked, false, __ATOMIC_RELEASE);
+  SP_DSB();
+}
+
+#endif /* CONFIG_SPINLOCK_FAIR */
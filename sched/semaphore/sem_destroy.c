@@ -90,7 +90,7 @@ int sem_destroy (FAR sem_t *sem)
 
       if (sem->semcount >= 0)
         {
-          sem->semcount = 1;
+          sem_count_set(sem, 1);
         }
 
       /* Release holders of the semaphore */
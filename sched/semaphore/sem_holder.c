@@ -44,6 +44,7 @@
 #include <assert.h>
 #include <debug.h>
 #include <nuttx/arch.h>
+#include <nuttx/mm/pool.h>
 
 #include "sched/sched.h"
 #include "semaphore/semaphore.h"
@@ -75,7 +76,7 @@ typedef int (*holderhandler_t)(FAR struct semholder_s *pholder,
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
 static struct semholder_s g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS];
-static FAR struct semholder_s *g_freeholders;
+static struct mm_pool_s g_holderpool;
 #endif
 
 /****************************************************************************
@@ -92,14 +93,11 @@ static inline FAR struct semholder_s *sem_allocholder(sem_t *sem)
    */
 
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  pholder = g_freeholders;
+  pholder = (FAR struct semholder_s *)mm_poolalloc(&g_holderpool);
   if (pholder)
     {
-      /* Remove the holder from the free list an put it into the semaphore's
-       * holder list
-       */
+      /* Put the holder into the semaphore's holder list */
 
-      g_freeholders    = pholder->flink;
       pholder->flink   = sem->hhead;
       sem->hhead       = pholder;
 
@@ -207,10 +205,9 @@ static inline void sem_freeholder(sem_t *sem, FAR struct semholder_s *pholder)
           sem->hhead = pholder->flink;
         }
 
-      /* And put it in the free list */
+      /* And return it to the pool */
 
-      pholder->flink = g_freeholders;
-      g_freeholders  = pholder;
+      mm_poolfree(&g_holderpool, pholder);
     }
 #endif
 }
@@ -772,17 +769,13 @@ static inline void sem_restorebaseprio_task(FAR struct tcb_s *stcb,
 void sem_initholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  int i;
-
-  /* Put all of the pre-allocated holder structures into the free list */
-
-  g_freeholders = g_holderalloc;
-  for (i = 0; i < (CONFIG_SEM_PREALLOCHOLDERS-1); i++)
-    {
-      g_holderalloc[i].flink = &g_holderalloc[i+1];
-    }
+  /* Put all of the pre-allocated holder structures into the pool.  The
+   * pool cannot grow:  Holders are allocated from within the semaphore
+   * logic so the heap (which depends on semaphores) cannot be used.
+   */
 
-  g_holderalloc[CONFIG_SEM_PREALLOCHOLDERS-1].flink = NULL;
+  mm_poolinit(&g_holderpool, "semholder", sizeof(struct semholder_s),
+              g_holderalloc, CONFIG_SEM_PREALLOCHOLDERS, 0, 0, NULL, NULL);
 #endif
 }
 
@@ -1098,11 +1091,7 @@ void sem_enumholders(FAR sem_t *sem)
 int sem_nfreeholders(void)
 {
 #if CONFIG_SEM_PREALLOCHOLDERS > 0
-  FAR struct semholder_s *pholder;
-  int n;
-
-  for (pholder = g_freeholders, n = 0; pholder; pholder = pholder->flink) n++;
-  return n;
+  return g_holderpool.nfree;
 #else
   return 0;
 #endif
@@ -85,10 +85,22 @@ int sem_post(FAR sem_t *sem)
 {
   FAR struct tcb_s *stcb = NULL;
   irqstate_t flags;
+  int16_t count;
   int ret = ERROR;
 
   /* Make sure we were supplied with a valid semaphore. */
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Give the count without entering the critical section if no thread is
+   * waiting for it.
+   */
+
+  if (sem != NULL && sem_fastpost(sem))
+    {
+      return OK;
+    }
+#endif
+
   if (sem)
     {
       /* The following operations must be performed with interrupts
@@ -117,7 +129,7 @@ int sem_post(FAR sem_t *sem)
 
       ASSERT(sem->semcount < SEM_VALUE_MAX);
       sem_releaseholder(sem);
-      sem->semcount++;
+      count = sem_count_inc(sem) + 1;
 
 #ifdef CONFIG_PRIORITY_INHERITANCE
       /* Don't let any unblocked tasks run until we complete any priority
@@ -134,7 +146,7 @@ int sem_post(FAR sem_t *sem)
        * there must be some task waiting for the semaphore.
        */
 
-      if (sem->semcount <= 0)
+      if (count <= 0)
         {
           /* Check if there are any tasks in the waiting for semaphore
            * task list that are waiting for this semaphore. This is a
@@ -110,7 +110,7 @@ void sem_recover(FAR struct tcb_s *tcb)
        * place.
        */
 
-      sem->semcount++;
+      (void)sem_count_inc(sem);
 
       /* Clear the semaphore to assure that it is not reused.  But leave the
        * state as TSTATE_WAIT_SEM.  This is necessary because this is a
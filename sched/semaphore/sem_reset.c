@@ -112,7 +112,7 @@ int sem_reset(FAR sem_t *sem, int16_t count)
 
   if (sem->semcount >= 0)
     {
-      sem->semcount = count;
+      sem_count_set(sem, count);
     }
 
   /* Allow any pending context switches to occur now */
@@ -86,6 +86,15 @@ int sem_trywait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an available count without entering the critical section */
+
+  if (sem != NULL && sem_fastwait(sem))
+    {
+      return OK;
+    }
+#endif
+
   if (sem != NULL)
     {
       /* The following operations must be performed with interrupts disabled
@@ -96,11 +105,10 @@ int sem_trywait(FAR sem_t *sem)
 
       /* If the semaphore is available, give it to the requesting task */
 
-      if (sem->semcount > 0)
+      if (sem_count_trydec(sem))
         {
-          /* It is, let the task take the semaphore */
+          /* It is, the task has taken the semaphore */
 
-          sem->semcount--;
           rtcb->waitsem = NULL;
           ret = OK;
         }
@@ -87,6 +87,22 @@ int sem_wait(FAR sem_t *sem)
 
   DEBUGASSERT(sem != NULL && up_interrupt_context() == false);
 
+#ifdef CONFIG_SEM_FASTPATH
+  /* Take an available count without entering the critical section, unless
+   * there is a pending cancellation that this cancellation point must act
+   * upon.
+   */
+
+  if (sem != NULL &&
+#ifdef CONFIG_CANCELLATION_POINTS
+      (rtcb->flags & TCB_FLAG_CANCEL_PENDING) == 0 &&
+#endif
+      sem_fastwait(sem))
+    {
+      return OK;
+    }
+#endif
+
   /* The following operations must be performed with interrupts
    * disabled because sem_post() may be called from an interrupt
    * handler.
@@ -114,13 +130,12 @@ int sem_wait(FAR sem_t *sem)
 
   if (sem != NULL)
     {
-      /* Check if the lock is available */
+      /* Take a count and check if the lock was available */
 
-      if (sem->semcount > 0)
+      if (sem_count_dec(sem) > 0)
         {
-          /* It is, let the task take the semaphore. */
+          /* It was, let the task take the semaphore. */
 
-          sem->semcount--;
           sem_addholder(sem);
           rtcb->waitsem = NULL;
           ret = OK;
@@ -138,11 +153,9 @@ int sem_wait(FAR sem_t *sem)
 
           ASSERT(rtcb->waitsem == NULL);
 
-          /* Handle the POSIX semaphore (but don't set the owner yet) */
-
-          sem->semcount--;
-
-          /* Save the waited on semaphore in the TCB */
+          /* The semaphore count has already been decremented (but the
+           * owner is not set yet).  Save the waited on semaphore in the TCB.
+           */
 
           rtcb->waitsem = sem;
 
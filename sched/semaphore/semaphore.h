@@ -49,6 +49,8 @@
 #include <sched.h>
 #include <queue.h>
 
+#include <nuttx/semaphore.h>
+
 /****************************************************************************
  * Public Function Prototypes
  ****************************************************************************/
@@ -0,0 +1,199 @@
+/****************************************************************************
+ * sched/semaphore/ticketlock.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <sys/types.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <assert.h>
+
+#include <nuttx/clock.h>
+#include <nuttx/spinlock.h>
+#include <nuttx/sched_note.h>
+
+#include "sched/sched.h"
+
+#ifdef CONFIG_SPINLOCK_FAIR
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: ticket_lock
+ *
+ * Description:
+ *   Take a ticket and wait until it is served.  Unlike spin_lock(), the
+ *   waiting CPUs only read the lock while they wait and they get the lock
+ *   in the order in which they asked for it.
+ *
+ *   Like spin_lock(), this does not disable interrupts.  The caller must do
+ *   that if the lock is also taken by interrupt handlers.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   None.  When the function returns, the lock is held by this CPU.
+ *
+ ****************************************************************************/
+
+void ticket_lock(FAR struct ticketlock_s *lock)
+{
+  uint32_t ticket;
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  uint32_t nspins = 0;
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are waiting for a spinlock */
+
+  sched_note_spinlock(this_task(), &lock->tl_owner);
+#endif
+
+  /* Take the next ticket and wait for it to be served */
+
+  ticket = __atomic_fetch_add(&lock->tl_next, 1, __ATOMIC_RELAXED);
+
+  while (__atomic_load_n(&lock->tl_owner, __ATOMIC_ACQUIRE) != ticket)
+    {
+      SP_DSB();
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+      nspins++;
+#endif
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  lock->tl_spins = nspins;
+  lock->tl_start = SP_TIMESTAMP();
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), &lock->tl_owner);
+#endif
+
+  SP_DMB();
+}
+
+/****************************************************************************
+ * Name: ticket_trylock
+ *
+ * Description:
+ *   Take the ticket lock only if no other CPU holds it or waits for it.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to lock.
+ *
+ * Returned Value:
+ *   True if the lock was taken; false if not.
+ *
+ ****************************************************************************/
+
+bool ticket_trylock(FAR struct ticketlock_s *lock)
+{
+  uint32_t owner = __atomic_load_n(&lock->tl_owner, __ATOMIC_ACQUIRE);
+  uint32_t next  = owner;
+
+  /* The lock is free only if the next ticket is the one being served.  If
+   * so, take that ticket.
+   */
+
+  if (!__atomic_compare_exchange_n(&lock->tl_next, &next, owner + 1, false,
+                                   __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    {
+      return false;
+    }
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  lock->tl_spins = 0;
+  lock->tl_start = SP_TIMESTAMP();
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we have the spinlock */
+
+  sched_note_spinlocked(this_task(), &lock->tl_owner);
+#endif
+
+  SP_DMB();
+  return true;
+}
+
+/****************************************************************************
+ * Name: ticket_unlock
+ *
+ * Description:
+ *   Release a ticket lock, serving the next ticket.
+ *
+ * Input Parameters:
+ *   lock - A reference to the ticket lock object to unlock.
+ *
+ * Returned Value:
+ *   None.
+ *
+ ****************************************************************************/
+
+void ticket_unlock(FAR struct ticketlock_s *lock)
+{
+  DEBUGASSERT(ticket_islocked(lock));
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINSTATS
+  /* Report the spins and the hold time of this acquisition */
+
+  sched_note_spinstats(this_task(), &lock->tl_owner, lock->tl_spins,
+                       SP_TIMESTAMP() - lock->tl_start);
+#endif
+
+#ifdef CONFIG_SCHED_INSTRUMENTATION_SPINLOCKS
+  /* Notify that we are unlocking the spinlock */
+
+  sched_note_spinunlock(this_task(), &lock->tl_owner);
+#endif
+
+  /* Only the holder writes tl_owner, so no read-modify-write is needed */
+
+  SP_DMB();
+  __atomic_store_n(&lock->tl_owner, lock->tl_owner + 1, __ATOMIC_RELEASE);
+  SP_DSB();
+}
+
+#endif /* CONFIG_SPINLOCK_FAIR */
@@ -72,8 +72,10 @@
 
 int wd_cancel(WDOG_ID wdog)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
+#endif
   irqstate_t flags;
   int ret = -EINVAL;
 
@@ -81,7 +83,7 @@ int wd_cancel(WDOG_ID wdog)
    * cancellation is complete
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 
   /* Make sure that the watchdog is initialized (non-NULL) and is still
    * active.
@@ -89,6 +91,17 @@ int wd_cancel(WDOG_ID wdog)
 
   if (wdog != NULL && WDOG_ISACTIVE(wdog))
     {
+#ifdef CONFIG_WDOG_WHEEL
+      /* Remove the watchdog from the timing wheel.  Reassess the interval
+       * timer only if this may have been the next watchdog to expire.
+       */
+
+      if (wd_wheelremove(wdog))
+        {
+          sched_timer_reassess();
+        }
+
+#else
       /* Search the g_wdactivelist for the target FCB.  We can't use sq_rem
        * to do this because there are additional operations that need to be
        * done.
@@ -138,6 +151,7 @@ int wd_cancel(WDOG_ID wdog)
 
           sched_timer_reassess();
         }
+#endif
 
       /* Mark the watchdog inactive */
 
@@ -149,6 +163,6 @@ int wd_cancel(WDOG_ID wdog)
       ret = OK;
     }
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return ret;
 }
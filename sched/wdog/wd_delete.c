@@ -46,7 +46,7 @@
 #include <nuttx/irq.h>
 #include <nuttx/arch.h>
 #include <nuttx/wdog.h>
-#include <nuttx/kmalloc.h>
+#include <nuttx/mm/pool.h>
 
 #include "wdog/wdog.h"
 
@@ -95,38 +95,15 @@ int wd_delete(WDOG_ID wdog)
       wd_cancel(wdog);
     }
 
-  /* Did this watchdog come from the pool of pre-allocated timers?  Or, was
-   * it allocated from the heap?
-   */
-
-  if (WDOG_ISALLOCED(wdog))
-    {
-      /* It was allocated from the heap.  Use sched_kfree() to release the
-       * memory.  If the timer was released from an interrupt handler,
-       * sched_kfree() will defer the actual deallocation of the memory
-       * until a more appropriate time.
-       *
-       * We don't need interrupts disabled to do this.
-       */
-
-      leave_critical_section(flags);
-      sched_kfree(wdog);
-    }
+  leave_critical_section(flags);
 
-  /* This was a pre-allocated timer.  This function should not be called for
-   * statically allocated timers.
+  /* Return the timer to the watchdog pool.  This function should not be
+   * called for statically allocated timers.
    */
 
-  else if (!WDOG_ISSTATIC(wdog))
+  if (!WDOG_ISSTATIC(wdog))
     {
-      /* Put the timer back on the free list and increment the count of free
-       * timers, all with interrupts disabled.
-       */
-
-      sq_addlast((FAR sq_entry_t *)wdog, &g_wdfreelist);
-      g_wdnfree++;
-      DEBUGASSERT(g_wdnfree <= CONFIG_PREALLOC_WDOGS);
-      leave_critical_section(flags);
+      mm_poolfree(&g_wdpool, wdog);
     }
 
   /* Return success */
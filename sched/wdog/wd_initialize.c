@@ -47,35 +47,36 @@
  * Public Data
  ****************************************************************************/
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* g_wdpool is the pool of watchdogs available to the system for delayed
+ * function use.
  */
 
-sq_queue_t g_wdfreelist;
+struct mm_pool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 sq_queue_t g_wdactivelist;
+#endif
 
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
- */
+#ifdef WDOG_FINE_LOCK
+/* g_wdlock protects the active watchdogs */
 
-uint16_t g_wdnfree;
+struct irqlock_s g_wdlock = IRQLOCK_INITIALIZER("wdog", IRQLOCK_LEVEL_WDOG);
+#endif
 
 /****************************************************************************
  * Private Data
  ****************************************************************************/
 
-/* g_wdpool is a list of pre-allocated watchdogs. The number of watchdogs
+/* g_wdprealloc holds the pre-allocated watchdogs. The number of watchdogs
  * in the pool is a configuration item.
  */
 
-static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
+static struct wdog_s g_wdprealloc[CONFIG_PREALLOC_WDOGS];
 
 /****************************************************************************
  * Public Functions
@@ -102,24 +103,25 @@ static struct wdog_s g_wdpool[CONFIG_PREALLOC_WDOGS];
 
 void wd_initialize(void)
 {
-  FAR struct wdog_s *wdog = g_wdpool;
-  int i;
-
-  /* Initialize watchdog lists */
+#ifndef CONFIG_WDOG_WHEEL
+  /* Initialize the active watchdog list */
 
-  sq_init(&g_wdfreelist);
   sq_init(&g_wdactivelist);
+#endif
 
-  /* The g_wdfreelist must be loaded at initialization time to hold the
-   * configured number of watchdogs.
-   */
+#ifdef WDOG_FINE_LOCK
+  /* Make the watchdog lock visible at /proc/locks */
 
-  for (i = 0; i < CONFIG_PREALLOC_WDOGS; i++)
-    {
-      sq_addlast((FAR sq_entry_t *)wdog++, &g_wdfreelist);
-    }
+  irqlock_register(&g_wdlock);
+#endif
 
-  /* All watchdogs are free */
+  /* The watchdog pool must be loaded at initialization time to hold the
+   * configured number of watchdogs.  It will grow as needed from normal
+   * tasking context but interrupt handlers are limited to the pre-allocated
+   * watchdogs.
+   */
 
-  g_wdnfree = CONFIG_PREALLOC_WDOGS;
+  mm_poolinit(&g_wdpool, "wdog", sizeof(struct wdog_s), g_wdprealloc,
+              CONFIG_PREALLOC_WDOGS, CONFIG_WDOG_EXPAND,
+              CONFIG_WDOG_INTRESERVE, NULL, NULL);
 }
@@ -42,6 +42,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <stdarg.h>
+#include <string.h>
 #include <unistd.h>
 #include <sched.h>
 #include <assert.h>
@@ -90,6 +91,163 @@ typedef void (*wdentry4_t)(int argc, wdparm_t arg1, wdparm_t arg2,
  * Private Functions
  ****************************************************************************/
 
+/****************************************************************************
+ * Name: wd_execute
+ *
+ * Description:
+ *   Execute the function of a watchdog that has expired.
+ *
+ * Parameters:
+ *   wdog - The expired watchdog.  It must already have been removed from
+ *          the active watchdogs and marked inactive.
+ *
+ * Return Value:
+ *   None
+ *
+ ****************************************************************************/
+
+static inline void wd_execute(FAR struct wdog_s *wdog)
+{
+  /* Execute the watchdog function */
+
+  up_setpicbase(wdog->picbase);
+  switch (wdog->argc)
+    {
+      default:
+        DEBUGPANIC();
+        break;
+
+      case 0:
+        (*((wdentry0_t)(wdog->func)))(0);
+        break;
+
+#if CONFIG_MAX_WDOGPARMS > 0
+      case 1:
+        (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 1
+      case 2:
+        (*((wdentry2_t)(wdog->func)))(2,
+                        wdog->parm[0], wdog->parm[1]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 2
+      case 3:
+        (*((wdentry3_t)(wdog->func)))(3,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2]);
+        break;
+#endif
+#if CONFIG_MAX_WDOGPARMS > 3
+      case 4:
+        (*((wdentry4_t)(wdog->func)))(4,
+                        wdog->parm[0], wdog->parm[1],
+                        wdog->parm[2], wdog->parm[3]);
+        break;
+#endif
+    }
+}
+
+/****************************************************************************
+ * Name: wd_dispatch
+ *
+ * Description:
+ *   Execute the function of a watchdog that has expired, called with the
+ *   watchdog lock held.  If the watchdog timer queue has its own lock, that
+ *   lock is released while the function runs:  The function may well start
+ *   or cancel watchdogs itself and it may take other locks which must not
+ *   nest within the watchdog lock.  Watchdog functions still run in the
+ *   global critical section as they did before.
+ *
+ * Parameters:
+ *   wdog - The expired watchdog.  It must already have been removed from
+ *          the active watchdogs and marked inactive.
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *   Called from the timer interrupt handler with interrupts disabled.
+ *
+ ****************************************************************************/
+
+#ifdef WDOG_FINE_LOCK
+static void wd_dispatch(FAR struct wdog_s *wdog)
+{
+  struct wdog_s expired;
+  irqstate_t flags;
+
+  /* Another CPU may restart the watchdog as soon as the lock is released,
+   * so execute a copy of it.
+   */
+
+  memcpy(&expired, wdog, sizeof(struct wdog_s));
+
+  /* Interrupts are already disabled here and they stay disabled */
+
+  DEBUGASSERT(g_wdlock.count == 1);
+  wd_unlock(up_irq_save());
+
+  flags = enter_critical_section();
+  wd_execute(&expired);
+  leave_critical_section(flags);
+
+  (void)wd_lock();
+}
+#else
+#  define wd_dispatch(w) wd_execute(w)
+#endif
+
+#ifdef CONFIG_WDOG_WHEEL
+/****************************************************************************
+ * Name: wd_expiration
+ *
+ * Description:
+ *   Advance the timing wheel by up to 'ticks' ticks, executing the
+ *   watchdogs that expire as the wheel advances.
+ *
+ * Parameters:
+ *   ticks - The number of ticks that have elapsed
+ *
+ * Return Value:
+ *   None
+ *
+ * Assumptions:
+ *
+ ****************************************************************************/
+
+static inline void wd_expiration(unsigned int ticks)
+{
+  FAR struct wdog_s *expired;
+  FAR struct wdog_s *wdog;
+
+  while (ticks > 0)
+    {
+      /* Advance to the next tick with expired watchdogs */
+
+      ticks -= wd_wheeladvance(ticks, &expired);
+
+      /* Execute each of the expired watchdogs.  A watchdog function may
+       * restart its own watchdog or cancel the others in the list.
+       */
+
+      while ((wdog = expired) != NULL)
+        {
+          (void)wd_wheelremove(wdog);
+
+          /* Indicate that the watchdog is no longer active. */
+
+          WDOG_CLRACTIVE(wdog);
+
+          /* Execute the watchdog function */
+
+          wd_dispatch(wdog);
+        }
+    }
+}
+
+#else
 /****************************************************************************
  * Name: wd_expiration
  *
@@ -141,46 +299,11 @@ static inline void wd_expiration(void)
 
           /* Execute the watchdog function */
 
-          up_setpicbase(wdog->picbase);
-          switch (wdog->argc)
-            {
-              default:
-                DEBUGPANIC();
-                break;
-
-              case 0:
-                (*((wdentry0_t)(wdog->func)))(0);
-                break;
-
-#if CONFIG_MAX_WDOGPARMS > 0
-              case 1:
-                (*((wdentry1_t)(wdog->func)))(1, wdog->parm[0]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 1
-              case 2:
-                (*((wdentry2_t)(wdog->func)))(2,
-                                wdog->parm[0], wdog->parm[1]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 2
-              case 3:
-                (*((wdentry3_t)(wdog->func)))(3,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2]);
-                break;
-#endif
-#if CONFIG_MAX_WDOGPARMS > 3
-              case 4:
-                (*((wdentry4_t)(wdog->func)))(4,
-                                wdog->parm[0], wdog->parm[1],
-                                wdog->parm[2], wdog->parm[3]);
-                break;
-#endif
-            }
+          wd_dispatch(wdog);
         }
     }
 }
+#endif /* CONFIG_WDOG_WHEEL */
 
 /****************************************************************************
  * Public Functions
@@ -222,10 +345,12 @@ static inline void wd_expiration(void)
 int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 {
   va_list ap;
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *curr;
   FAR struct wdog_s *prev;
   FAR struct wdog_s *next;
   int32_t now;
+#endif
   irqstate_t flags;
   int i;
 
@@ -243,7 +368,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
    * the critical section is established.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
   if (WDOG_ISACTIVE(wdog))
     {
       wd_cancel(wdog);
@@ -289,6 +414,12 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   (void)sched_timer_cancel();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Add the watchdog to the timing wheel */
+
+  wd_wheeladd(wdog, (uint32_t)delay);
+
+#else
   /* Do the easy case first -- when the watchdog timer queue is empty. */
 
   if (g_wdactivelist.head == NULL)
@@ -374,9 +505,13 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
         }
     }
 
-  /* Put the lag into the watchdog structure and mark it as active. */
+  /* Put the lag into the watchdog structure */
 
   wdog->lag = delay;
+#endif /* CONFIG_WDOG_WHEEL */
+
+  /* Mark the watchdog as active. */
+
   WDOG_SETACTIVE(wdog);
 
 #ifdef CONFIG_SCHED_TICKLESS
@@ -388,7 +523,7 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
   sched_timer_resume();
 #endif
 
-  leave_critical_section(flags);
+  wd_unlock(flags);
   return OK;
 }
 
@@ -420,12 +555,14 @@ int wd_start(WDOG_ID wdog, int32_t delay, wdentry_t wdentry,  int argc, ...)
 #ifdef CONFIG_SCHED_TICKLESS
 unsigned int wd_timer(int ticks)
 {
+#ifndef CONFIG_WDOG_WHEEL
   FAR struct wdog_s *wdog;
+  int decr;
+#endif
 #ifdef CONFIG_SMP
   irqstate_t flags;
 #endif
   unsigned int ret;
-  int decr;
 
 #ifdef CONFIG_SMP
   /* We are in an interrupt handler as, as a consequence, interrupts are
@@ -437,9 +574,22 @@ unsigned int wd_timer(int ticks)
    * SMP case.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Process the watchdogs that expired in the elapsed interval */
+
+  if (ticks > 0)
+    {
+      wd_expiration(ticks);
+    }
+
+  /* Return the delay for the next watchdog to expire */
+
+  ret = wd_wheelnext();
+
+#else
   /* Check if there are any active watchdogs to process */
 
   while (g_wdactivelist.head != NULL && ticks > 0)
@@ -474,9 +624,10 @@ unsigned int wd_timer(int ticks)
 
   ret = g_wdactivelist.head ?
           ((FAR struct wdog_s *)g_wdactivelist.head)->lag : 0;
+#endif
 
 #ifdef CONFIG_SMP
-  leave_critical_section(flags);
+  wd_unlock(flags);
 #endif
 
   /* Return the delay for the next watchdog to expire */
@@ -499,9 +650,15 @@ void wd_timer(void)
    * SMP case.
    */
 
-  flags = enter_critical_section();
+  flags = wd_lock();
 #endif
 
+#ifdef CONFIG_WDOG_WHEEL
+  /* Advance the timing wheel by one tick */
+
+  wd_expiration(1);
+
+#else
   /* Check if there are any active watchdogs to process */
 
   if (g_wdactivelist.head)
@@ -514,9 +671,10 @@ void wd_timer(void)
 
       wd_expiration();
     }
+#endif
 
 #ifdef CONFIG_SMP
-  leave_critical_section(flags);
+  wd_unlock(flags);
 #endif
 }
 #endif /* CONFIG_SCHED_TICKLESS */
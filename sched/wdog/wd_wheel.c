@@ -0,0 +1,537 @@
+/****************************************************************************
+ * sched/wdog/wd_wheel.c
+ *
+ *   Copyright (C) 2017 Gregory Nutt. All rights reserved.
+ *   Author: Gregory Nutt <gnutt@nuttx.org>
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * 1. Redistributions of source code must retain the above copyright
+ *    notice, this list of conditions and the following disclaimer.
+ * 2. Redistributions in binary form must reproduce the above copyright
+ *    notice, this list of conditions and the following disclaimer in
+ *    the documentation and/or other materials provided with the
+ *    distribution.
+ * 3. Neither the name NuttX nor the names of its contributors may be
+ *    used to endorse or promote products derived from this software
+ *    without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS
+ * OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER CAUSED
+ * AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ ****************************************************************************/
+
+/****************************************************************************
+ * Included Files
+ ****************************************************************************/
+
+#include <nuttx/config.h>
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <strings.h>
+#include <assert.h>
+
+#include <nuttx/wdog.h>
+
+#include "wdog/wdog.h"
+
+#ifdef CONFIG_WDOG_WHEEL
+
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The timing wheel consists of WHEEL_LEVELS levels of WHEEL_SLOTS slots.
+ * Each slot of level 'n' spans WHEEL_SLOTS^n ticks so that the levels
+ * together cover the full 32-bit range of expiration times.
+ */
+
+#define WHEEL_BITS        CONFIG_WDOG_WHEEL_BITS
+#define WHEEL_SLOTS       (1 << WHEEL_BITS)
+#define WHEEL_MASK        (WHEEL_SLOTS - 1)
+#define WHEEL_LEVELS      ((32 + WHEEL_BITS - 1) / WHEEL_BITS)
+
+#define WHEEL_SHIFT(l)    ((l) * WHEEL_BITS)
+#define WHEEL_INDEX(t,l)  ((int)((t) >> WHEEL_SHIFT(l)) & WHEEL_MASK)
+
+/* Find the first set bit in a non-zero slot map */
+
+#ifdef __GNUC__
+#  define wd_ffs(m)       __builtin_ctz(m)
+#else
+#  define wd_ffs(m)       (ffs((int)(m)) - 1)
+#endif
+
+/****************************************************************************
+ * Private Data
+ ****************************************************************************/
+
+/* The slots of the timing wheel.  Each slot holds an unordered, doubly
+ * linked list of watchdogs.  The slot maps mark the non-empty slots of each
+ * level.
+ */
+
+static FAR struct wdog_s *g_wdwheel[WHEEL_LEVELS][WHEEL_SLOTS];
+static uint32_t g_wdmap[WHEEL_LEVELS];
+
+/* g_wdbase is the next tick to be processed.  All watchdogs with an earlier
+ * expiration time have already expired.
+ */
+
+static uint32_t g_wdbase;
+
+/* The expiration time last reported by wd_wheelnext() */
+
+static uint32_t g_wdnext;
+static bool g_wdnextvalid;
+
+/****************************************************************************
+ * Private Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_link
+ *
+ * Description:
+ *   Add a watchdog to the head of a list.
+ *
+ ****************************************************************************/
+
+static inline void wd_link(FAR struct wdog_s **head, FAR struct wdog_s *wdog)
+{
+  wdog->next  = *head;
+  wdog->pprev = head;
+
+  if (*head != NULL)
+    {
+      (*head)->pprev = &wdog->next;
+    }
+
+  *head = wdog;
+}
+
+/****************************************************************************
+ * Name: wd_place
+ *
+ * Description:
+ *   Add a watchdog to the slot of the timing wheel for its expiration time.
+ *   The level is selected by the time remaining until expiration so that
+ *   a watchdog is cascaded to the next lower level each time that the
+ *   wheel reaches its slot.
+ *
+ ****************************************************************************/
+
+static void wd_place(FAR struct wdog_s *wdog)
+{
+  uint32_t delta = wdog->expire - g_wdbase;
+  int level;
+  int slot;
+
+  if ((int32_t)delta < 0)
+    {
+      /* Already expired:  Add it to the slot of the next tick */
+
+      level = 0;
+      slot  = WHEEL_INDEX(g_wdbase, 0);
+    }
+  else
+    {
+      for (level = 0;
+           level < WHEEL_LEVELS - 1 &&
+           delta >= ((uint32_t)1 << WHEEL_SHIFT(level + 1));
+           level++);
+
+      slot = WHEEL_INDEX(wdog->expire, level);
+    }
+
+  wd_link(&g_wdwheel[level][slot], wdog);
+  g_wdmap[level] |= (uint32_t)1 << slot;
+}
+
+/****************************************************************************
+ * Name: wd_unlink
+ *
+ * Description:
+ *   Remove a watchdog from whatever list it is in.
+ *
+ ****************************************************************************/
+
+static inline void wd_unlink(FAR struct wdog_s *wdog)
+{
+  *wdog->pprev = wdog->next;
+  if (wdog->next != NULL)
+    {
+      wdog->next->pprev = wdog->pprev;
+    }
+
+  wdog->next  = NULL;
+  wdog->pprev = NULL;
+}
+
+/****************************************************************************
+ * Name: wd_updatemap
+ *
+ * Description:
+ *   Clear the bit in the slot map if the slot containing a (just removed)
+ *   watchdog is now empty.  The slot list head is recognized by its
+ *   address within g_wdwheel[][].
+ *
+ ****************************************************************************/
+
+static inline void wd_updatemap(FAR struct wdog_s **pprev)
+{
+  FAR struct wdog_s **first = &g_wdwheel[0][0];
+  uintptr_t ndx;
+
+  if (pprev >= first && pprev < first + WHEEL_LEVELS * WHEEL_SLOTS &&
+      *pprev == NULL)
+    {
+      ndx = pprev - first;
+      g_wdmap[ndx >> WHEEL_BITS] &= ~((uint32_t)1 << (ndx & WHEEL_MASK));
+    }
+}
+
+/****************************************************************************
+ * Name: wd_detach
+ *
+ * Description:
+ *   Detach the entire list of one slot.
+ *
+ ****************************************************************************/
+
+static FAR struct wdog_s *wd_detach(int level, int slot)
+{
+  FAR struct wdog_s *list = g_wdwheel[level][slot];
+
+  g_wdwheel[level][slot] = NULL;
+  g_wdmap[level] &= ~((uint32_t)1 << slot);
+  return list;
+}
+
+/****************************************************************************
+ * Name: wd_cascade
+ *
+ * Description:
+ *   Called when the wheel reaches the beginning of a new span of level 0.
+ *   The watchdogs in the corresponding slots of the higher levels are
+ *   redistributed to the lower levels.
+ *
+ ****************************************************************************/
+
+static void wd_cascade(void)
+{
+  FAR struct wdog_s *list;
+  FAR struct wdog_s *wdog;
+  int level;
+  int slot;
+
+  for (level = 1; level < WHEEL_LEVELS; level++)
+    {
+      slot = WHEEL_INDEX(g_wdbase, level);
+      list = wd_detach(level, slot);
+
+      while (list != NULL)
+        {
+          wdog = list;
+          list = wdog->next;
+          wd_place(wdog);
+        }
+
+      /* Only continue to the next level if this level wrapped too */
+
+      if (slot != 0)
+        {
+          break;
+        }
+    }
+}
+
+/****************************************************************************
+ * Name: wd_step
+ *
+ * Description:
+ *   Advance g_wdbase by 'nticks' ticks.  This must not cross more than one
+ *   span of level 0.  The higher levels are cascaded as soon as a new span
+ *   is entered so that level 0 always holds every watchdog that expires in
+ *   the current span.
+ *
+ ****************************************************************************/
+
+static inline void wd_step(unsigned int nticks)
+{
+  g_wdbase += nticks;
+  if (WHEEL_INDEX(g_wdbase, 0) == 0)
+    {
+      wd_cascade();
+    }
+}
+
+/****************************************************************************
+ * Name: wd_slotmin
+ *
+ * Description:
+ *   Return the earliest expiration time of the watchdogs in one slot,
+ *   relative to g_wdbase.
+ *
+ ****************************************************************************/
+
+static uint32_t wd_slotmin(int level, int slot)
+{
+  FAR struct wdog_s *wdog;
+  uint32_t mindelta = UINT32_MAX;
+  uint32_t delta;
+
+  for (wdog = g_wdwheel[level][slot]; wdog != NULL; wdog = wdog->next)
+    {
+      delta = wdog->expire - g_wdbase;
+      if (delta < mindelta)
+        {
+          mindelta = delta;
+        }
+    }
+
+  return mindelta;
+}
+
+/****************************************************************************
+ * Public Functions
+ ****************************************************************************/
+
+/****************************************************************************
+ * Name: wd_wheeladd
+ *
+ * Description:
+ *   Add a watchdog to the timing wheel.  The watchdog will expire when the
+ *   wheel is advanced by 'delay' ticks.
+ *
+ * Assumptions:
+ *   Called from a critical section.  'delay' is at least one.
+ *
+ ****************************************************************************/
+
+void wd_wheeladd(FAR struct wdog_s *wdog, uint32_t delay)
+{
+  DEBUGASSERT(delay > 0);
+
+  wdog->expire = g_wdbase + delay - 1;
+  wd_place(wdog);
+
+  /* The next expiration time is no longer known if this one is earlier */
+
+  if (g_wdnextvalid && (int32_t)(wdog->expire - g_wdnext) < 0)
+    {
+      g_wdnextvalid = false;
+    }
+}
+
+/****************************************************************************
+ * Name: wd_wheelremove
+ *
+ * Description:
+ *   Remove a watchdog from the timing wheel (or from the list of expired
+ *   watchdogs returned by wd_wheeladvance()).
+ *
+ * Returned Value:
+ *   True if the watchdog may have been the next watchdog to expire.
+ *
+ * Assumptions:
+ *   Called from a critical section.
+ *
+ ****************************************************************************/
+
+bool wd_wheelremove(FAR struct wdog_s *wdog)
+{
+  FAR struct wdog_s **pprev = wdog->pprev;
+
+  DEBUGASSERT(pprev != NULL);
+
+  wd_unlink(wdog);
+  wd_updatemap(pprev);
+
+  return !g_wdnextvalid || wdog->expire == g_wdnext;
+}
+
+/****************************************************************************
+ * Name: wd_wheelremaining
+ *
+ * Description:
+ *   Return the number of ticks that the wheel must be advanced for an
+ *   active watchdog to expire.
+ *
+ * Assumptions:
+ *   Called from a critical section.
+ *
+ ****************************************************************************/
+
+uint32_t wd_wheelremaining(FAR struct wdog_s *wdog)
+{
+  return wdog->expire - g_wdbase + 1;
+}
+
+/****************************************************************************
+ * Name: wd_wheeladvance
+ *
+ * Description:
+ *   Advance the timing wheel by up to 'ticks' ticks, stopping just after
+ *   the first tick at which any watchdogs expire.  Empty ticks are skipped
+ *   in a single step.
+ *
+ * Input Parameters:
+ *   ticks   - The maximum number of ticks to advance
+ *   expired - The location to return the list of expired watchdogs.  This
+ *             must remain valid while the watchdogs are removed from the
+ *             list with wd_wheelremove().
+ *
+ * Returned Value:
+ *   The number of ticks that the wheel was actually advanced.
+ *
+ * Assumptions:
+ *   Called from a critical section.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheeladvance(unsigned int ticks,
+                             FAR struct wdog_s **expired)
+{
+  unsigned int advanced = 0;
+  uint32_t pending;
+  int index;
+  int next;
+
+  *expired = NULL;
+
+  while (advanced < ticks)
+    {
+      /* Find the next non-empty slot in the remainder of this span */
+
+      index   = WHEEL_INDEX(g_wdbase, 0);
+      pending = g_wdmap[0] & ((uint32_t)-1 << index);
+      next    = pending != 0 ? wd_ffs(pending) : WHEEL_SLOTS;
+
+      if (next > index)
+        {
+          /* Skip the empty slots */
+
+          unsigned int nskip = next - index;
+          if (nskip > ticks - advanced)
+            {
+              nskip = ticks - advanced;
+            }
+
+          wd_step(nskip);
+          advanced += nskip;
+        }
+      else
+        {
+          /* All of the watchdogs in this slot expire now */
+
+          *expired = wd_detach(0, index);
+          (*expired)->pprev = expired;
+
+          wd_step(1);
+          advanced++;
+          break;
+        }
+    }
+
+  return advanced;
+}
+
+/****************************************************************************
+ * Name: wd_wheelnext
+ *
+ * Description:
+ *   Return the number of ticks that the wheel must be advanced for the
+ *   next watchdog to expire (zero if there are no active watchdogs).
+ *
+ * Assumptions:
+ *   Called from a critical section.
+ *
+ ****************************************************************************/
+
+unsigned int wd_wheelnext(void)
+{
+  uint32_t mindelta = UINT32_MAX;
+  uint32_t pending;
+  uint32_t delta;
+  int index;
+  int level;
+  int slot;
+
+  /* The first non-empty slot in the remainder of the current span of level
+   * zero holds the earliest watchdogs.
+   */
+
+  index   = WHEEL_INDEX(g_wdbase, 0);
+  pending = g_wdmap[0] & ((uint32_t)-1 << index);
+  if (pending != 0)
+    {
+      mindelta = wd_ffs(pending) - index;
+    }
+  else
+    {
+      /* Otherwise, the earliest watchdog is in the next span of level zero
+       * or in the first non-empty slot (following the current slot) of
+       * one of the higher levels.
+       */
+
+      if (g_wdmap[0] != 0)
+        {
+          mindelta = WHEEL_SLOTS - index + wd_ffs(g_wdmap[0]);
+        }
+
+      for (level = 1; level < WHEEL_LEVELS; level++)
+        {
+          if (g_wdmap[level] != 0)
+            {
+              /* Rotate the slot map so that bit zero corresponds to the
+               * slot following the current slot.
+               */
+
+              index   = (WHEEL_INDEX(g_wdbase, level) + 1) & WHEEL_MASK;
+              pending = g_wdmap[level] >> index;
+#if WHEEL_SLOTS < 32
+              pending |= g_wdmap[level] << (WHEEL_SLOTS - index);
+              pending &= (((uint32_t)1 << WHEEL_SLOTS) - 1);
+#else
+              if (index > 0)
+                {
+                  pending |= g_wdmap[level] << (WHEEL_SLOTS - index);
+                }
+#endif
+
+              slot  = (index + wd_ffs(pending)) & WHEEL_MASK;
+              delta = wd_slotmin(level, slot);
+              if (delta < mindelta)
+                {
+                  mindelta = delta;
+                }
+            }
+        }
+
+      if (mindelta == UINT32_MAX)
+        {
+          g_wdnextvalid = false;
+          return 0;
+        }
+    }
+
+  g_wdnext      = g_wdbase + mindelta;
+  g_wdnextvalid = true;
+  return mindelta + 1;
+}
+
+#endif /* CONFIG_WDOG_WHEEL */
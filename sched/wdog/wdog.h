@@ -46,8 +46,30 @@
 #include <stdbool.h>
 
 #include <nuttx/compiler.h>
+#include <nuttx/irqlock.h>
+#include <nuttx/mm/pool.h>
 #include <nuttx/wdog.h>
 
+/****************************************************************************
+ * Pre-processor Definitions
+ ****************************************************************************/
+
+/* The watchdog timer queue has its own subsystem lock if
+ * CONFIG_SMP_FINE_LOCKS is selected.  In the tickless mode, the interval
+ * timer is reprogrammed from within the watchdog logic under the global
+ * critical section, so the global critical section is still used then.
+ */
+
+#if defined(CONFIG_SMP_FINE_LOCKS) && !defined(CONFIG_SCHED_TICKLESS)
+#  define WDOG_FINE_LOCK 1
+#  define wd_lock()      irqlock_enter(&g_wdlock)
+#  define wd_unlock(f)   irqlock_leave(&g_wdlock, f)
+#else
+#  undef  WDOG_FINE_LOCK
+#  define wd_lock()      enter_critical_section()
+#  define wd_unlock(f)   leave_critical_section(f)
+#endif
+
 /****************************************************************************
  * Public Data
  ****************************************************************************/
@@ -60,25 +82,28 @@ extern "C"
 #define EXTERN extern
 #endif
 
-/* The g_wdfreelist data structure is a singly linked list of watchdogs
- * available to the system for delayed function use.
+/* g_wdpool is the pool of watchdogs available to the system for delayed
+ * function use.
  */
 
-extern sq_queue_t g_wdfreelist;
+extern struct mm_pool_s g_wdpool;
 
+#ifndef CONFIG_WDOG_WHEEL
 /* The g_wdactivelist data structure is a singly linked list ordered by
  * watchdog expiration time. When watchdog timers expire,the functions on
  * this linked list are removed and the function is called.
  */
 
 extern sq_queue_t g_wdactivelist;
+#endif
 
-/* This is the number of free, pre-allocated watchdog structures in the
- * g_wdfreelist.  This value is used to enforce a reserve for interrupt
- * handlers.
+#ifdef WDOG_FINE_LOCK
+/* g_wdlock protects the active watchdogs.  Watchdog functions are called
+ * with this lock released.
  */
 
-extern uint16_t g_wdnfree;
+extern struct irqlock_s g_wdlock;
+#endif
 
 /****************************************************************************
  * Public Function Prototypes
@@ -136,6 +161,28 @@ unsigned int wd_timer(int ticks);
 void wd_timer(void);
 #endif
 
+/****************************************************************************
+ * Name: wd_wheeladd, wd_wheelremove, wd_wheelremaining, wd_wheeladvance,
+ *       and wd_wheelnext
+ *
+ * Description:
+ *   Hierarchical timing wheel that replaces g_wdactivelist when
+ *   CONFIG_WDOG_WHEEL is selected.  See wd_wheel.c for details.
+ *
+ * Assumptions:
+ *   Called with the watchdog lock held (see wd_lock()).
+ *
+ ****************************************************************************/
+
+#ifdef CONFIG_WDOG_WHEEL
+void wd_wheeladd(FAR struct wdog_s *wdog, uint32_t delay);
+bool wd_wheelremove(FAR struct wdog_s *wdog);
+uint32_t wd_wheelremaining(FAR struct wdog_s *wdog);
+unsigned int wd_wheeladvance(unsigned int ticks,
+                             FAR struct wdog_s **expired);
+unsigned int wd_wheelnext(void);
+#endif
+
 /****************************************************************************
  * Name: wd_recover
  *